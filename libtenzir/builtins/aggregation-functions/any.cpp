@@ -102,6 +102,20 @@ public:
     return false;
   }
 
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = any_instance{expr_};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    any_ = any_ or other.any_;
+    if (state_ == state::failed or other.state_ == state::failed) {
+      state_ = state::failed;
+    } else if (other.state_ == state::nulled) {
+      state_ = state::nulled;
+    }
+    return true;
+  }
+
   auto reset() -> void override {
     any_ = {};
     state_ = state::none;
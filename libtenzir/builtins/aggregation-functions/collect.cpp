@@ -88,6 +88,17 @@ public:
     return true;
   }
 
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = collect_instance{expr_};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    result_.insert(result_.end(),
+                   std::make_move_iterator(other.result_.begin()),
+                   std::make_move_iterator(other.result_.end()));
+    return true;
+  }
+
   auto reset() -> void override {
     result_ = {};
   }
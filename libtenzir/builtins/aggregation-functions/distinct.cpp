@@ -137,6 +137,17 @@ public:
     return true;
   }
 
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = distinct_instance{expr_, count_only_};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    for (auto& element : other.distinct_) {
+      distinct_.insert(std::move(element));
+    }
+    return true;
+  }
+
   auto reset() -> void override {
     distinct_ = {};
   }
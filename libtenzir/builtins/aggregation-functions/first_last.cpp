@@ -91,6 +91,23 @@ public:
     return true;
   }
 
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = first_last_instance{expr_};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    // Partial results are merged in the order of the input they were computed
+    // from, so the first non-null result wins for `first`, and the last one
+    // for `last`.
+    if (is<caf::none_t>(other.result_)) {
+      return true;
+    }
+    if (Mode == mode::last or is<caf::none_t>(result_)) {
+      result_ = std::move(other.result_);
+    }
+    return true;
+  }
+
   auto reset() -> void override {
     result_ = {};
   }
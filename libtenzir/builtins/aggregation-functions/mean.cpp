@@ -6,6 +6,7 @@
 // SPDX-FileCopyrightText: (c) 2024 The Tenzir Contributors
 // SPDX-License-Identifier: BSD-3-Clause
 
+#include <tenzir/detail/narrow.hpp>
 #include <tenzir/fbs/aggregation.hpp>
 #include <tenzir/flatbuffer.hpp>
 #include <tenzir/logger.hpp>
@@ -17,140 +18,292 @@ namespace tenzir::plugins::mean {
 
 namespace {
 
-class mean_instance final : public aggregation_instance {
-public:
-  explicit mean_instance(ast::expression expr) : expr_{std::move(expr)} {
+/// The running mean of a single group.
+struct mean_state {
+  enum class kind { none, failed, dur, numeric } state{};
+  double mean{};
+  size_t count{};
+
+  /// Transitions into the state for the given argument type, and returns
+  /// whether the argument is compatible with the values seen so far.
+  template <class T>
+  auto accept() -> bool {
+    const auto next
+      = std::same_as<T, arrow::DurationArray> ? kind::dur : kind::numeric;
+    if (state != next and state != kind::none) {
+      state = kind::failed;
+      return false;
+    }
+    state = next;
+    return true;
   }
 
-  auto update(const table_slice& input, session ctx) -> void override {
-    if (state_ == state::failed) {
+  template <class T>
+  auto add(const T& array, int64_t i) -> void {
+    if constexpr (std::same_as<T, arrow::DoubleArray>) {
+      if (std::isnan(array.Value(i))) {
+        return;
+      }
+    }
+    count += 1;
+    mean += (static_cast<double>(array.Value(i)) - mean) / count;
+  }
+
+  auto merge(const mean_state& other) -> void {
+    if (other.state == kind::none) {
       return;
     }
-    for (auto& arg : eval(expr_, input, ctx)) {
-      auto f = detail::overload{
-        [](const arrow::NullArray&) {},
-        [&]<class T>(const T& array)
-          requires numeric_type<type_from_arrow_t<T>>
-                     or std::same_as<T, arrow::DurationArray>
-        {
-          if constexpr (std::same_as<T, arrow::DurationArray>) {
-            if (state_ != state::dur and state_ != state::none) {
-              diagnostic::warning(
-                "expected `int`, `uint` or `double`, got `{}`", arg.type.kind())
-                .primary(expr_)
-                .emit(ctx);
-              state_ = state::failed;
-              return;
-            }
-            state_ = state::dur;
-          } else {
-            if (state_ != state::numeric and state_ != state::none) {
-              diagnostic::warning("got incompatible types `duration` and `{}`",
-                                  arg.type.kind())
-                .primary(expr_)
-                .emit(ctx);
-              state_ = state::failed;
-              return;
-            }
-            state_ = state::numeric;
-          }
-          for (auto i = int64_t{}; i < array.length(); ++i) {
-            if (array.IsValid(i)) {
-              if constexpr (std::same_as<T, arrow::DoubleArray>) {
-                if (std::isnan(array.Value(i))) {
-                  continue;
-                }
-              }
-              count_ += 1;
-              mean_ += (static_cast<double>(array.Value(i)) - mean_) / count_;
-            }
-          }
-        },
-        [&](const auto&) {
-          diagnostic::warning("expected types `int`, `uint`, "
-                              "`double` or `duration`, got `{}`",
-                              arg.type.kind())
-            .primary(expr_)
-            .emit(ctx);
-          state_ = state::failed;
-        }};
-      match(*arg.array, f);
+    if (state == kind::none) {
+      state = other.state;
+    } else if (state != other.state) {
+      state = kind::failed;
+    }
+    if (state == kind::failed or other.count == 0) {
+      return;
     }
+    count += other.count;
+    mean += (other.mean - mean) * static_cast<double>(other.count) / count;
   }
 
-  auto get() const -> data override {
-    switch (state_) {
-      case state::none:
-      case state::failed:
+  auto get() const -> data {
+    switch (state) {
+      case kind::none:
+      case kind::failed:
         return data{};
-      case state::dur:
-        return duration{static_cast<duration::rep>(mean_)};
-      case state::numeric:
-        return count_ ? data{mean_} : data{};
+      case kind::dur:
+        return duration{static_cast<duration::rep>(mean)};
+      case kind::numeric:
+        return count ? data{mean} : data{};
     }
     TENZIR_UNREACHABLE();
   }
 
-  auto save() const -> chunk_ptr override {
+  auto save() const -> chunk_ptr {
     auto fbb = flatbuffers::FlatBufferBuilder{};
     const auto fb_state = [&] {
-      switch (state_) {
-        case state::none:
+      switch (state) {
+        case kind::none:
           return fbs::aggregation::MeanState::None;
-        case state::failed:
+        case kind::failed:
           return fbs::aggregation::MeanState::Failed;
-        case state::dur:
+        case kind::dur:
           return fbs::aggregation::MeanState::Duration;
-        case state::numeric:
+        case kind::numeric:
           return fbs::aggregation::MeanState::Numeric;
       }
       TENZIR_UNREACHABLE();
     }();
     const auto fb_mean
-      = fbs::aggregation::CreateMean(fbb, mean_, count_, fb_state);
+      = fbs::aggregation::CreateMean(fbb, mean, count, fb_state);
     fbb.Finish(fb_mean);
     return chunk::make(fbb.Release());
   }
 
-  auto restore(chunk_ptr chunk) noexcept -> bool override {
+  auto restore(chunk_ptr chunk) noexcept -> bool {
     const auto fb = flatbuffer<fbs::aggregation::Mean>::make(std::move(chunk));
     if (not fb) {
       TENZIR_WARN(
         "failed to restore `mean` aggregation instance: invalid FlatBuffer");
       return false;
     }
-    mean_ = (*fb)->result();
-    count_ = (*fb)->count();
+    mean = (*fb)->result();
+    count = (*fb)->count();
     switch ((*fb)->state()) {
       case fbs::aggregation::MeanState::None:
-        state_ = state::none;
+        state = kind::none;
         return true;
       case fbs::aggregation::MeanState::Failed:
-        state_ = state::failed;
+        state = kind::failed;
         return true;
       case fbs::aggregation::MeanState::Duration:
-        state_ = state::dur;
+        state = kind::dur;
         return true;
       case fbs::aggregation::MeanState::Numeric:
-        state_ = state::numeric;
+        state = kind::numeric;
         return true;
     }
     TENZIR_WARN(
       "failed to restore `mean` aggregation instance: unknown state value");
     return false;
   }
+};
+
+template <class T>
+auto incompatible_mean_type(const series& arg, const ast::expression& expr,
+                            session ctx) -> void {
+  if constexpr (std::same_as<T, arrow::DurationArray>) {
+    diagnostic::warning("expected `int`, `uint` or `double`, got `{}`",
+                        arg.type.kind())
+      .primary(expr)
+      .emit(ctx);
+  } else {
+    diagnostic::warning("got incompatible types `duration` and `{}`",
+                        arg.type.kind())
+      .primary(expr)
+      .emit(ctx);
+  }
+}
+
+auto unsupported_mean_type(const series& arg, const ast::expression& expr,
+                           session ctx) -> void {
+  diagnostic::warning("expected types `int`, `uint`, "
+                      "`double` or `duration`, got `{}`",
+                      arg.type.kind())
+    .primary(expr)
+    .emit(ctx);
+}
+
+class mean_instance final : public aggregation_instance {
+public:
+  explicit mean_instance(ast::expression expr) : expr_{std::move(expr)} {
+  }
+
+  auto update(const table_slice& input, session ctx) -> void override {
+    if (state_.state == mean_state::kind::failed) {
+      return;
+    }
+    for (auto& arg : eval(expr_, input, ctx)) {
+      auto f = detail::overload{
+        [](const arrow::NullArray&) {},
+        [&]<class T>(const T& array)
+          requires numeric_type<type_from_arrow_t<T>>
+                     or std::same_as<T, arrow::DurationArray>
+        {
+          if (not state_.accept<T>()) {
+            incompatible_mean_type<T>(arg, expr_, ctx);
+            return;
+          }
+          for (auto i = int64_t{}; i < array.length(); ++i) {
+            if (array.IsValid(i)) {
+              state_.add(array, i);
+            }
+          }
+        },
+        [&](const auto&) {
+          unsupported_mean_type(arg, expr_, ctx);
+          state_.state = mean_state::kind::failed;
+        }};
+      match(*arg.array, f);
+    }
+  }
+
+  auto get() const -> data override {
+    return state_.get();
+  }
+
+  auto save() const -> chunk_ptr override {
+    return state_.save();
+  }
+
+  auto restore(chunk_ptr chunk) noexcept -> bool override {
+    return state_.restore(std::move(chunk));
+  }
+
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = mean_state{};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    state_.merge(other);
+    return true;
+  }
 
   auto reset() -> void override {
-    mean_ = {};
-    count_ = {};
-    state_ = state::none;
+    state_ = {};
+  }
+
+private:
+  ast::expression expr_;
+  mean_state state_;
+};
+
+class grouped_mean_instance final : public grouped_aggregation_instance {
+public:
+  explicit grouped_mean_instance(ast::expression expr)
+    : expr_{std::move(expr)} {
+  }
+
+  auto update(const table_slice& input, std::span<const uint32_t> groups,
+              session ctx) -> void override {
+    TENZIR_ASSERT(groups.size() == input.rows());
+    auto offset = size_t{0};
+    for (auto& arg : eval(expr_, input, ctx)) {
+      const auto part_groups
+        = groups.subspan(offset, detail::narrow<size_t>(arg.length()));
+      offset += part_groups.size();
+      auto f = detail::overload{
+        [](const arrow::NullArray&) {},
+        [&]<class T>(const T& array)
+          requires numeric_type<type_from_arrow_t<T>>
+                     or std::same_as<T, arrow::DurationArray>
+        {
+          auto incompatible = false;
+          for (auto i = int64_t{}; i < array.length(); ++i) {
+            auto& state = states_[part_groups[i]];
+            if (state.state == mean_state::kind::failed) {
+              continue;
+            }
+            if (not state.accept<T>()) {
+              incompatible = true;
+              continue;
+            }
+            if (array.IsValid(i)) {
+              state.add(array, i);
+            }
+          }
+          if (incompatible) {
+            incompatible_mean_type<T>(arg, expr_, ctx);
+          }
+        },
+        [&](const auto&) {
+          auto failed = false;
+          for (auto group : part_groups) {
+            auto& state = states_[group];
+            if (state.state != mean_state::kind::failed) {
+              state.state = mean_state::kind::failed;
+              failed = true;
+            }
+          }
+          if (failed) {
+            unsupported_mean_type(arg, expr_, ctx);
+          }
+        }};
+      match(*arg.array, f);
+    }
+  }
+
+  auto get(uint32_t group) const -> data override {
+    return states_[group].get();
+  }
+
+  auto size() const -> size_t override {
+    return states_.size();
+  }
+
+  auto resize(size_t groups) -> void override {
+    states_.resize(groups);
+  }
+
+  auto save(uint32_t group) const -> chunk_ptr override {
+    return states_[group].save();
+  }
+
+  auto restore(uint32_t group, chunk_ptr chunk) noexcept -> bool override {
+    return states_[group].restore(std::move(chunk));
+  }
+
+  auto merge(uint32_t group, chunk_ptr partial) noexcept -> bool override {
+    auto other = mean_state{};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    states_[group].merge(other);
+    return true;
   }
 
 private:
   ast::expression expr_;
-  enum class state { none, failed, dur, numeric } state_{};
-  double mean_{};
-  size_t count_{};
+  std::vector<mean_state> states_;
 };
 
 class plugin : public virtual aggregation_plugin {
@@ -170,6 +323,15 @@ class plugin : public virtual aggregation_plugin {
           .parse(inv, ctx));
     return std::make_unique<mean_instance>(std::move(expr));
   }
+
+  auto make_grouped_aggregation(function_invocation inv, session ctx) const
+    -> failure_or<std::unique_ptr<grouped_aggregation_instance>> override {
+    auto expr = ast::expression{};
+    TRY(argument_parser2::function(name())
+          .positional("x", expr, "number|duration")
+          .parse(inv, ctx));
+    return std::make_unique<grouped_mean_instance>(std::move(expr));
+  }
 };
 
 } // namespace
@@ -7,6 +7,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <tenzir/data.hpp>
+#include <tenzir/detail/narrow.hpp>
 #include <tenzir/fbs/aggregation.hpp>
 #include <tenzir/flatbuffer.hpp>
 #include <tenzir/logger.hpp>
@@ -26,6 +27,9 @@ enum class mode {
   min,
 };
 
+template <mode Mode>
+class grouped_min_max_instance;
+
 template <mode Mode>
 class min_max_instance final : public aggregation_instance {
 public:
@@ -203,17 +207,358 @@ public:
     return true;
   }
 
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = min_max_instance{expr_};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    if (not type_) {
+      type_ = other.type_;
+    }
+    if (not other.result_) {
+      return true;
+    }
+    if (not result_) {
+      result_ = other.result_;
+      return true;
+    }
+    const auto pick = [](auto lhs, auto rhs) {
+      return Mode == mode::min ? std::min(lhs, rhs) : std::max(lhs, rhs);
+    };
+    result_ = match(
+      std::tie(*result_, *other.result_),
+      []<class L, class R>(L, R) -> result_t {
+        // Incompatible types or a failed partial result.
+        return caf::none;
+      },
+      [&](std::integral auto lhs, std::integral auto rhs) -> result_t {
+        if (Mode == mode::min ? std::cmp_less(rhs, lhs)
+                              : std::cmp_greater(rhs, lhs)) {
+          return rhs;
+        }
+        return lhs;
+      },
+      [&]<class L, class R>(L lhs, R rhs) -> result_t
+        requires(concepts::one_of<double, L, R>
+                 and concepts::arithmetic<L> and concepts::arithmetic<R>)
+      {
+        return pick(static_cast<double>(lhs), static_cast<double>(rhs));
+      },
+      [&](duration lhs, duration rhs) -> result_t {
+        return pick(lhs, rhs);
+      },
+      [&](time lhs, time rhs) -> result_t {
+        return pick(lhs, rhs);
+      });
+    return true;
+  }
+
   auto reset() -> void override {
     type_ = {};
     result_ = {};
   }
 
 private:
+  friend class grouped_min_max_instance<Mode>;
+
   ast::expression expr_ = {};
   type type_ = {};
   std::optional<result_t> result_ = {};
 };
 
+/// The minimum or maximum of many groups at once.
+///
+/// Instead of one `result_t` per group, the state lives in flat vectors: the
+/// kind of every group's result, and its value as an 8-byte slot. Updates
+/// dispatch on the array type once per batch, and rows whose group already
+/// holds a result of the same type take a fast path that never touches a
+/// variant. The rare case of mixed types goes through `min_max_instance`,
+/// which also provides the format for saving and restoring a group.
+template <mode Mode>
+class grouped_min_max_instance final : public grouped_aggregation_instance {
+public:
+  using result_t = min_max_instance<Mode>::result_t;
+
+  explicit grouped_min_max_instance(ast::expression expr)
+    : expr_{std::move(expr)} {
+  }
+
+  auto update(const table_slice& input, std::span<const uint32_t> groups,
+              session ctx) -> void override {
+    TENZIR_ASSERT(groups.size() == input.rows());
+    auto offset = size_t{0};
+    for (auto& arg : eval(expr_, input, ctx)) {
+      const auto part_groups
+        = groups.subspan(offset, detail::narrow<size_t>(arg.length()));
+      offset += part_groups.size();
+      // Warnings are emitted at most once per batch instead of once per group.
+      auto incompatible = std::optional<type_kind>{};
+      const auto prepare = [&](uint32_t group) {
+        if (kinds_[group] == kind::failed) {
+          return false;
+        }
+        if (not types_[group]) {
+          types_[group] = arg.type;
+        }
+        return true;
+      };
+      auto f = detail::overload{
+        [&](const arrow::NullArray&) {
+          for (auto group : part_groups) {
+            prepare(group);
+          }
+        },
+        [&]<class T>(const T& array)
+          requires numeric_type<type_from_arrow_t<T>>
+                   or concepts::one_of<type_from_arrow_t<T>, duration_type,
+                                       time_type>
+        {
+          using Ty = type_from_arrow_t<T>;
+          constexpr auto k = kind_of<Ty>();
+          for (auto i = int64_t{}; i < array.length(); ++i) {
+            const auto group = part_groups[i];
+            if (not prepare(group) or not array.IsValid(i)) {
+              continue;
+            }
+            const auto value = array.Value(i);
+            if (kinds_[group] == k) {
+              auto& current = slot_value<k>(values_[group]);
+              if (Mode == mode::min ? value < current : current < value) {
+                current = value;
+              }
+              continue;
+            }
+            if (kinds_[group] == kind::empty) {
+              kinds_[group] = k;
+              slot_value<k>(values_[group]) = value;
+              continue;
+            }
+            update_mixed(group, to_result<Ty>(value), incompatible);
+          }
+        },
+        [&](const auto&) {
+          diagnostic::warning("expected types `int`, `uint`, `double`, "
+                              "`duration`, or `time`, but got `{}`",
+                              arg.type.kind())
+            .primary(expr_)
+            .emit(ctx);
+          for (auto group : part_groups) {
+            if (prepare(group)) {
+              kinds_[group] = kind::failed;
+            }
+          }
+        }};
+      match(*arg.array, f);
+      if (incompatible) {
+        diagnostic::warning("got incompatible types `{}` and `{}`",
+                            *incompatible, arg.type.kind())
+          .primary(expr_)
+          .emit(ctx);
+      }
+    }
+  }
+
+  auto get(uint32_t group) const -> data override {
+    if (auto result = load(group)) {
+      return result->match([](auto result) {
+        return data{result};
+      });
+    }
+    return {};
+  }
+
+  auto size() const -> size_t override {
+    return kinds_.size();
+  }
+
+  auto resize(size_t groups) -> void override {
+    kinds_.resize(groups, kind::empty);
+    values_.resize(groups);
+    types_.resize(groups);
+  }
+
+  auto save(uint32_t group) const -> chunk_ptr override {
+    return to_instance(group).save();
+  }
+
+  auto restore(uint32_t group, chunk_ptr chunk) noexcept -> bool override {
+    auto instance = min_max_instance<Mode>{expr_};
+    if (not instance.restore(std::move(chunk))) {
+      return false;
+    }
+    from_instance(group, instance);
+    return true;
+  }
+
+  auto merge(uint32_t group, chunk_ptr partial) noexcept -> bool override {
+    auto instance = to_instance(group);
+    if (not instance.merge(std::move(partial))) {
+      return false;
+    }
+    from_instance(group, instance);
+    return true;
+  }
+
+private:
+  enum class kind : uint8_t {
+    empty,
+    failed,
+    int64,
+    uint64,
+    double_,
+    duration,
+    time,
+  };
+
+  /// The value of a group, whose type is given by its kind. Durations and
+  /// times are stored as their number of ticks.
+  union slot {
+    int64_t int64 = 0;
+    uint64_t uint64;
+    double double_;
+  };
+
+  template <class Ty>
+  static constexpr auto kind_of() -> kind {
+    if constexpr (std::same_as<Ty, int64_type>) {
+      return kind::int64;
+    } else if constexpr (std::same_as<Ty, uint64_type>) {
+      return kind::uint64;
+    } else if constexpr (std::same_as<Ty, double_type>) {
+      return kind::double_;
+    } else if constexpr (std::same_as<Ty, duration_type>) {
+      return kind::duration;
+    } else {
+      static_assert(std::same_as<Ty, time_type>);
+      return kind::time;
+    }
+  }
+
+  template <kind K>
+  static auto slot_value(slot& x) -> auto& {
+    if constexpr (K == kind::uint64) {
+      return x.uint64;
+    } else if constexpr (K == kind::double_) {
+      return x.double_;
+    } else {
+      return x.int64;
+    }
+  }
+
+  template <class Ty, class Value>
+  static auto to_result(Value value) -> result_t {
+    if constexpr (std::same_as<Ty, duration_type>) {
+      return duration{value};
+    } else if constexpr (std::same_as<Ty, time_type>) {
+      return time{duration{value}};
+    } else {
+      return value;
+    }
+  }
+
+  auto load(uint32_t group) const -> std::optional<result_t> {
+    const auto& value = values_[group];
+    switch (kinds_[group]) {
+      case kind::empty:
+        return std::nullopt;
+      case kind::failed:
+        return caf::none;
+      case kind::int64:
+        return value.int64;
+      case kind::uint64:
+        return value.uint64;
+      case kind::double_:
+        return value.double_;
+      case kind::duration:
+        return duration{value.int64};
+      case kind::time:
+        return time{duration{value.int64}};
+    }
+    TENZIR_UNREACHABLE();
+  }
+
+  auto store(uint32_t group, const std::optional<result_t>& result) -> void {
+    auto& value = values_[group];
+    if (not result) {
+      kinds_[group] = kind::empty;
+      return;
+    }
+    kinds_[group] = result->match(
+      [](caf::none_t) {
+        return kind::failed;
+      },
+      [&](int64_t x) {
+        value.int64 = x;
+        return kind::int64;
+      },
+      [&](uint64_t x) {
+        value.uint64 = x;
+        return kind::uint64;
+      },
+      [&](double x) {
+        value.double_ = x;
+        return kind::double_;
+      },
+      [&](duration x) {
+        value.int64 = x.count();
+        return kind::duration;
+      },
+      [&](time x) {
+        value.int64 = x.time_since_epoch().count();
+        return kind::time;
+      });
+  }
+
+  /// Combines a group whose result has a different type than the value, with
+  /// the same semantics as `min_max_instance::update`.
+  auto update_mixed(uint32_t group, result_t value,
+                    std::optional<type_kind>& incompatible) -> void {
+    auto current = load(group);
+    TENZIR_ASSERT(current);
+    const auto pick = [](auto lhs, auto rhs) {
+      return Mode == mode::min ? std::min(lhs, rhs) : std::max(lhs, rhs);
+    };
+    auto result = match(
+      std::tie(*current, value),
+      [&]<class L, class R>(L, R) -> result_t {
+        incompatible = types_[group].kind();
+        return caf::none;
+      },
+      [&](std::integral auto self, std::integral auto val) -> result_t {
+        if (Mode == mode::min ? std::cmp_less(val, self)
+                              : std::cmp_greater(val, self)) {
+          return val;
+        }
+        return self;
+      },
+      [&]<class L, class R>(L self, R val) -> result_t
+        requires(concepts::one_of<double, L, R>
+                 and concepts::arithmetic<L> and concepts::arithmetic<R>)
+      {
+        return pick(static_cast<double>(self), static_cast<double>(val));
+      });
+    store(group, result);
+  }
+
+  auto to_instance(uint32_t group) const -> min_max_instance<Mode> {
+    auto result = min_max_instance<Mode>{expr_};
+    result.type_ = types_[group];
+    result.result_ = load(group);
+    return result;
+  }
+
+  auto from_instance(uint32_t group, const min_max_instance<Mode>& instance)
+    -> void {
+    types_[group] = instance.type_;
+    store(group, instance.result_);
+  }
+
+  ast::expression expr_ = {};
+  std::vector<kind> kinds_ = {};
+  std::vector<slot> values_ = {};
+  std::vector<type> types_ = {};
+};
+
 template <mode Mode>
 class plugin : public virtual aggregation_plugin {
 public:
@@ -233,6 +578,15 @@ public:
           .parse(inv, ctx));
     return std::make_unique<min_max_instance<Mode>>(std::move(expr));
   }
+
+  auto make_grouped_aggregation(function_invocation inv, session ctx) const
+    -> failure_or<std::unique_ptr<grouped_aggregation_instance>> override {
+    auto expr = ast::expression{};
+    TRY(argument_parser2::function(name())
+          .positional("x", expr, "number|duration|time")
+          .parse(inv, ctx));
+    return std::make_unique<grouped_min_max_instance<Mode>>(std::move(expr));
+  }
 };
 
 } // namespace
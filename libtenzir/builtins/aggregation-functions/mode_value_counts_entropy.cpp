@@ -160,6 +160,17 @@ public:
     return true;
   }
 
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = instance{expr_, normalize_};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    for (auto& [value, count] : other.counts_) {
+      counts_[value] += count;
+    }
+    return true;
+  }
+
   auto reset() -> void override {
     counts_ = {};
   }
@@ -76,6 +76,20 @@ public:
     return true;
   }
 
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = once_instance{expr_};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    // If both partial results saw an event, the one that was merged first wins,
+    // just like the first event wins in `update`.
+    if (other.done_ and not done_) {
+      done_ = true;
+      result_ = std::move(other.result_);
+    }
+    return true;
+  }
+
   auto reset() -> void override {
     done_ = false;
     result_ = {};
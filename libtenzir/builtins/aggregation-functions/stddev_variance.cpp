@@ -174,6 +174,30 @@ public:
     return false;
   }
 
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = stddev_variance_instance{expr_, mode_};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    if (other.state_ == state::none) {
+      return true;
+    }
+    if (state_ == state::none) {
+      state_ = other.state_;
+    } else if (state_ != other.state_) {
+      state_ = state::failed;
+    }
+    if (state_ == state::failed or other.count_ == 0) {
+      return true;
+    }
+    const auto count = count_ + other.count_;
+    const auto weight = static_cast<double>(other.count_) / count;
+    mean_ += (other.mean_ - mean_) * weight;
+    mean_squared_ += (other.mean_squared_ - mean_squared_) * weight;
+    count_ = count;
+    return true;
+  }
+
   auto reset() -> void override {
     mean_ = {};
     mean_squared_ = {};
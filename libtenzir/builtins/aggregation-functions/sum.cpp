@@ -7,6 +7,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <tenzir/checked_math.hpp>
+#include <tenzir/detail/narrow.hpp>
 #include <tenzir/fbs/aggregation.hpp>
 #include <tenzir/flatbuffer.hpp>
 #include <tenzir/logger.hpp>
@@ -18,13 +19,132 @@ namespace tenzir::plugins::sum {
 
 namespace {
 
+using sum_t = variant<caf::none_t, int64_t, uint64_t, double, duration>;
+
+/// The running sum of a single group.
+struct sum_state {
+  type input_type;
+  std::optional<sum_t> sum;
+
+  auto get() const -> data {
+    if (sum) {
+      return sum->match([](auto sum) {
+        return data{sum};
+      });
+    }
+    return data{};
+  }
+
+  /// Adds the sum of another state. Incompatible types and overflows yield
+  /// `null`, just like they do when updating the state with events.
+  auto merge(const sum_state& other) -> void {
+    if (not input_type) {
+      input_type = other.input_type;
+    }
+    if (not other.sum) {
+      return;
+    }
+    if (not sum) {
+      sum = other.sum;
+      return;
+    }
+    sum = match(
+      std::tie(*sum, *other.sum),
+      []<class L, class R>(L, R) -> sum_t {
+        return caf::none;
+      },
+      [](std::integral auto lhs, std::integral auto rhs) -> sum_t {
+        if (auto checked = checked_add(lhs, rhs)) {
+          return checked.value();
+        }
+        return caf::none;
+      },
+      []<class L, class R>(L lhs, R rhs) -> sum_t
+        requires(concepts::one_of<double, L, R>
+                 and concepts::arithmetic<L> and concepts::arithmetic<R>)
+      {
+        return static_cast<double>(lhs) + static_cast<double>(rhs);
+      },
+      [](duration lhs, duration rhs) -> sum_t {
+        if (auto checked = checked_add(lhs.count(), rhs.count())) {
+          return duration{checked.value()};
+        }
+        return caf::none;
+      });
+  }
+
+  auto save() const -> chunk_ptr {
+    auto fbb = flatbuffers::FlatBufferBuilder{};
+    const auto result
+      = not sum ? data{} : sum->match<data>([](const auto& x) {
+          return data{x};
+        });
+    const auto fb_result = pack(fbb, result);
+    const auto type_bytes = as_bytes(input_type);
+    auto fb_type = fbb.CreateVector(
+      reinterpret_cast<const uint8_t*>(type_bytes.data()), type_bytes.size());
+    const auto fb_min_max
+      = fbs::aggregation::CreateMinMaxSum(fbb, fb_result, fb_type);
+    fbb.Finish(fb_min_max);
+    return chunk::make(fbb.Release());
+  }
+
+  auto restore(chunk_ptr chunk) noexcept -> bool {
+    const auto fb
+      = flatbuffer<fbs::aggregation::MinMaxSum>::make(std::move(chunk));
+    if (not fb) {
+      TENZIR_WARN(
+        "failed to restore `sum` aggregation instance: invalid FlatBuffer");
+      return false;
+    }
+    const auto* fb_result = (*fb)->result();
+    if (not fb_result) {
+      TENZIR_WARN(
+        "failed to restore `sum` aggregation instance: missing field `result`");
+      return false;
+    }
+    auto result = data{};
+    if (auto err = unpack(*fb_result, result); err.valid()) {
+      TENZIR_WARN("failed to restore `sum` aggregation instance: {}", err);
+      return false;
+    }
+    auto ok = true;
+    match(result, [&]<class T>(const T& x) {
+      if constexpr (std::is_same_v<T, caf::none_t>) {
+        sum.reset();
+      } else if constexpr (sum_t::can_have<T>) {
+        sum.emplace(x);
+      } else {
+        TENZIR_WARN("failed to restore `sum` aggregation instance: invalid "
+                    "value for field `result`: `{}`",
+                    result);
+        ok = false;
+      }
+    });
+    if (not ok) {
+      return false;
+    }
+    const auto* fb_type = (*fb)->type();
+    if (not fb_type) {
+      TENZIR_WARN(
+        "failed to restore `sum` aggregation instance: missing field `type`");
+      return false;
+    }
+    const auto* fb_type_nested_root = (*fb)->type_nested_root();
+    TENZIR_ASSERT(fb_type_nested_root);
+    input_type = type{fb->slice(*fb_type_nested_root, *fb_type)};
+    return true;
+  }
+};
+
 class sum_instance : public aggregation_instance {
 public:
-  using sum_t = variant<caf::none_t, int64_t, uint64_t, double, duration>;
   sum_instance(ast::expression expr) : expr_{std::move(expr)} {
   }
 
   auto update(const table_slice& input, session ctx) -> void override {
+    auto& type_ = state_.input_type;
+    auto& sum_ = state_.sum;
     if (sum_ and std::holds_alternative<caf::none_t>(sum_.value())) {
       return;
     }
@@ -131,86 +251,237 @@ public:
   }
 
   auto get() const -> data override {
-    if (sum_) {
-      return sum_->match([](auto sum) {
-        return data{sum};
-      });
-    }
-    return data{};
+    return state_.get();
   }
 
   auto save() const -> chunk_ptr override {
-    auto fbb = flatbuffers::FlatBufferBuilder{};
-    const auto result
-      = not sum_ ? data{} : sum_->match<data>([](const auto& x) {
-          return data{x};
-        });
-    const auto fb_result = pack(fbb, result);
-    const auto type_bytes = as_bytes(type_);
-    auto fb_type = fbb.CreateVector(
-      reinterpret_cast<const uint8_t*>(type_bytes.data()), type_bytes.size());
-    const auto fb_min_max
-      = fbs::aggregation::CreateMinMaxSum(fbb, fb_result, fb_type);
-    fbb.Finish(fb_min_max);
-    return chunk::make(fbb.Release());
+    return state_.save();
   }
 
   auto restore(chunk_ptr chunk) noexcept -> bool override {
-    const auto fb
-      = flatbuffer<fbs::aggregation::MinMaxSum>::make(std::move(chunk));
-    if (not fb) {
-      TENZIR_WARN(
-        "failed to restore `sum` aggregation instance: invalid FlatBuffer");
-      return false;
-    }
-    const auto* fb_result = (*fb)->result();
-    if (not fb_result) {
-      TENZIR_WARN(
-        "failed to restore `sum` aggregation instance: missing field `result`");
-      return false;
-    }
-    auto result = data{};
-    if (auto err = unpack(*fb_result, result); err.valid()) {
-      TENZIR_WARN("failed to restore `sum` aggregation instance: {}", err);
+    return state_.restore(std::move(chunk));
+  }
+
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = sum_state{};
+    if (not other.restore(std::move(partial))) {
       return false;
     }
-    auto ok = true;
-    match(result, [&]<class T>(const T& x) {
-      if constexpr (std::is_same_v<T, caf::none_t>) {
-        sum_.reset();
-      } else if constexpr (sum_t::can_have<T>) {
-        sum_.emplace(x);
-      } else {
-        TENZIR_WARN("failed to restore `sum` aggregation instance: invalid "
-                    "value for field `result`: `{}`",
-                    result);
-        ok = false;
+    state_.merge(other);
+    return true;
+  }
+
+  auto reset() -> void override {
+    state_ = {};
+  }
+
+private:
+  ast::expression expr_;
+  sum_state state_;
+};
+
+class grouped_sum_instance final : public grouped_aggregation_instance {
+public:
+  explicit grouped_sum_instance(ast::expression expr)
+    : expr_{std::move(expr)} {
+  }
+
+  auto update(const table_slice& input, std::span<const uint32_t> groups,
+              session ctx) -> void override {
+    TENZIR_ASSERT(groups.size() == input.rows());
+    auto offset = size_t{0};
+    for (auto& s : eval(expr_, input, ctx)) {
+      const auto part_groups
+        = groups.subspan(offset, detail::narrow<size_t>(s.length()));
+      offset += part_groups.size();
+      // Warnings are emitted at most once per batch instead of once per group.
+      auto incompatible = std::optional<type_kind>{};
+      auto overflow = std::optional<std::string_view>{};
+      const auto warn = [&](const sum_state& state) {
+        return [&](const auto&) -> sum_t {
+          incompatible = state.input_type.kind();
+          return caf::none;
+        };
+      };
+      // Groups that already failed keep their null result.
+      const auto failed = [](const sum_state& state) {
+        return state.sum and std::holds_alternative<caf::none_t>(*state.sum);
+      };
+      auto f = detail::overload{
+        [&](const arrow::NullArray&) {
+          for (auto group : part_groups) {
+            auto& state = states_[group];
+            if (not failed(state) and not state.input_type) {
+              state.input_type = s.type;
+            }
+          }
+        },
+        [&]<class T>(const T& array)
+          requires integral_type<type_from_arrow_t<T>>
+        {
+          using Type = T::value_type;
+          for (auto i = int64_t{}; i < array.length(); ++i) {
+            auto& state = states_[part_groups[i]];
+            if (failed(state)) {
+              continue;
+            }
+            if (not state.input_type) {
+              state.input_type = s.type;
+            }
+            if (not state.sum) {
+              state.sum = Type{};
+            }
+            if (not array.IsValid(i)) {
+              continue;
+            }
+            // Most groups only ever see one type, so we avoid the full
+            // dispatch of the variant whenever the types match.
+            if (auto* sum = std::get_if<Type>(&*state.sum)) {
+              if (auto checked = checked_add(*sum, array.Value(i))) {
+                *sum = checked.value();
+              } else {
+                overflow = "integer overflow";
+                state.sum = caf::none;
+              }
+              continue;
+            }
+            state.sum = state.sum->match(
+              warn(state),
+              [&](std::integral auto self) -> sum_t {
+                auto checked = checked_add(self, array.Value(i));
+                if (not checked) {
+                  overflow = "integer overflow";
+                  return caf::none;
+                }
+                return checked.value();
+              },
+              [&](double self) -> sum_t {
+                return self + static_cast<double>(array.Value(i));
+              });
+          }
+        },
+        [&](const arrow::DoubleArray& array) {
+          for (auto i = int64_t{}; i < array.length(); ++i) {
+            auto& state = states_[part_groups[i]];
+            if (failed(state)) {
+              continue;
+            }
+            if (not state.input_type) {
+              state.input_type = s.type;
+            }
+            if (not state.sum) {
+              state.sum = double{};
+            }
+            if (auto* sum = std::get_if<double>(&*state.sum)) {
+              if (array.IsValid(i)) {
+                *sum += array.Value(i);
+              }
+              continue;
+            }
+            state.sum = state.sum->match(
+              warn(state), [&](concepts::arithmetic auto self) -> sum_t {
+                auto result = static_cast<double>(self);
+                if (array.IsValid(i)) {
+                  result += array.Value(i);
+                }
+                return result;
+              });
+          }
+        },
+        [&](const arrow::DurationArray& array) {
+          for (auto i = int64_t{}; i < array.length(); ++i) {
+            auto& state = states_[part_groups[i]];
+            if (failed(state)) {
+              continue;
+            }
+            if (not state.input_type) {
+              state.input_type = s.type;
+            }
+            if (not state.sum) {
+              state.sum = duration{};
+            }
+            if (not array.IsValid(i)) {
+              continue;
+            }
+            if (auto* sum = std::get_if<duration>(&*state.sum)) {
+              if (checked_add(sum->count(), array.Value(i))) {
+                *sum += duration{array.Value(i)};
+              } else {
+                overflow = "duration overflow";
+                state.sum = caf::none;
+              }
+              continue;
+            }
+            state.sum
+              = state.sum->match(warn(state), [&](duration self) -> sum_t {
+                  auto checked = checked_add(self.count(), array.Value(i));
+                  if (not checked) {
+                    overflow = "duration overflow";
+                    return caf::none;
+                  }
+                  return self + duration{array.Value(i)};
+                });
+          }
+        },
+        [&](const auto&) {
+          diagnostic::warning("expected `int`, `uint`, `double` or `duration`, "
+                              "got `{}`",
+                              s.type.kind())
+            .primary(expr_)
+            .emit(ctx);
+          for (auto group : part_groups) {
+            auto& state = states_[group];
+            if (not state.input_type) {
+              state.input_type = s.type;
+            }
+            state.sum = caf::none;
+          }
+        }};
+      match(*s.array, f);
+      if (incompatible) {
+        diagnostic::warning("got incompatible types `{}` and `{}`",
+                            *incompatible, s.type.kind())
+          .primary(expr_)
+          .emit(ctx);
+      }
+      if (overflow) {
+        diagnostic::warning("{}", *overflow).primary(expr_).emit(ctx);
       }
-    });
-    if (not ok) {
-      return false;
     }
-    const auto* fb_type = (*fb)->type();
-    if (not fb_type) {
-      TENZIR_WARN(
-        "failed to restore `sum` aggregation instance: missing field `type`");
+  }
+
+  auto get(uint32_t group) const -> data override {
+    return states_[group].get();
+  }
+
+  auto size() const -> size_t override {
+    return states_.size();
+  }
+
+  auto resize(size_t groups) -> void override {
+    states_.resize(groups);
+  }
+
+  auto save(uint32_t group) const -> chunk_ptr override {
+    return states_[group].save();
+  }
+
+  auto restore(uint32_t group, chunk_ptr chunk) noexcept -> bool override {
+    return states_[group].restore(std::move(chunk));
+  }
+
+  auto merge(uint32_t group, chunk_ptr partial) noexcept -> bool override {
+    auto other = sum_state{};
+    if (not other.restore(std::move(partial))) {
       return false;
     }
-    const auto* fb_type_nested_root = (*fb)->type_nested_root();
-    TENZIR_ASSERT(fb_type_nested_root);
-    type_ = type{fb->slice(*fb_type_nested_root, *fb_type)};
+    states_[group].merge(other);
     return true;
   }
 
-  auto reset() -> void override {
-    type_ = {};
-    sum_ = {};
-  }
-
 private:
   ast::expression expr_;
-  type type_;
-  std::optional<sum_t> sum_;
+  std::vector<sum_state> states_;
 };
 
 class plugin : public virtual aggregation_plugin {
@@ -230,6 +501,15 @@ class plugin : public virtual aggregation_plugin {
           .parse(inv, ctx));
     return std::make_unique<sum_instance>(std::move(expr));
   }
+
+  auto make_grouped_aggregation(function_invocation inv, session ctx) const
+    -> failure_or<std::unique_ptr<grouped_aggregation_instance>> override {
+    auto expr = ast::expression{};
+    TRY(argument_parser2::function("sum")
+          .positional("x", expr, "number|duration")
+          .parse(inv, ctx));
+    return std::make_unique<grouped_sum_instance>(std::move(expr));
+  }
 };
 
 } // namespace
@@ -8,6 +8,7 @@
 
 #include "tenzir/location.hpp"
 
+#include <tenzir/checkpoint_store.hpp>
 #include <tenzir/detail/env.hpp>
 #include <tenzir/detail/load_contents.hpp>
 #include <tenzir/diagnostics.hpp>
@@ -130,6 +131,18 @@ auto exec_command(const invocation& inv, caf::actor_system& sys) -> bool {
     filename = "<input>";
     content = args[0];
   }
+  auto checkpoint_interval = caf::get_or(
+    inv.options, "tenzir.exec.checkpoint-interval", duration::zero());
+  if (checkpoint_interval < duration::zero()) {
+    printer->emit(
+      diagnostic::error("`--checkpoint-interval` must not be negative").done());
+    return false;
+  }
+  if (checkpoint_interval > duration::zero()) {
+    cfg.checkpoint_interval = checkpoint_interval;
+    cfg.checkpoint_directory
+      = checkpoint_directory(caf::content(sys.config()), content);
+  }
   auto source
     = Source::new_source(std::move(content), std::move(filename), false);
   auto source_map = SourceMap{};
@@ -199,7 +212,11 @@ public:
                    "return a non-zero exit code if any warnings occured")
         .add<std::string>("profile",
                           "write a channel profile to a file (Chrome Trace "
-                          "Format, viewable in ui.perfetto.dev)"));
+                          "Format, viewable in ui.perfetto.dev)")
+        .add<duration>("checkpoint-interval",
+                       "periodically checkpoint the pipeline state and "
+                       "resume from the last checkpoint on restart (new "
+                       "executor only)"));
     auto factory = command::factory{
       {"exec",
        [=](const invocation& inv, caf::actor_system& sys) -> caf::message {
@@ -15,6 +15,7 @@
 #include <tenzir/context.hpp>
 #include <tenzir/data.hpp>
 #include <tenzir/detail/assert.hpp>
+#include <tenzir/detail/lpm_table.hpp>
 #include <tenzir/detail/range_map.hpp>
 #include <tenzir/detail/subnet_tree.hpp>
 #include <tenzir/expression.hpp>
@@ -248,6 +249,13 @@ struct value_data {
 using map_type = tsl::robin_map<key_data, value_data>;
 using subnet_tree_type = detail::subnet_tree<value_data>;
 
+/// A flat copy of the subnet tree for matching many IP addresses at once. The
+/// labels of the table index into `entries`, which point into the tree.
+struct subnet_index_type {
+  detail::lpm_table table;
+  std::vector<std::pair<subnet, value_data*>> entries;
+};
+
 class lookup_table_context final : public virtual context {
 public:
   lookup_table_context() noexcept = default;
@@ -255,33 +263,107 @@ public:
                                 subnet_tree_type subnet_entries) noexcept
     : context_entries{std::move(context_entries)},
       subnet_entries{std::move(subnet_entries)} {
-    // nop
+    for (auto entry : this->subnet_entries.nodes()) {
+      TENZIR_UNUSED(entry);
+      ++num_subnet_entries;
+    }
   }
 
   auto context_type() const -> std::string override {
     return "lookup-table";
   }
 
-  auto subnet_lookup(const auto& value) -> std::pair<subnet, value_data*> {
+  /// Finds the longest-prefix match of an IP address or a subnet. For IP
+  /// addresses, `label` is the result of `match_subnets` for the value.
+  auto subnet_lookup(const auto& value, std::optional<uint32_t> label = {})
+    -> std::pair<subnet, value_data*> {
     auto match = detail::overload{
       [&](const auto&) -> std::pair<subnet, value_data*> {
         return {{}, nullptr};
       },
-      [&](view<ip> addr) {
+      [&](view<ip> addr) -> std::pair<subnet, value_data*> {
+        // The index is gone if we erased an expired subnet in the meantime.
+        if (label and subnet_index) {
+          if (*label == detail::lpm_table::none) {
+            return {{}, nullptr};
+          }
+          return subnet_index->entries[*label];
+        }
         return subnet_entries.match(materialize(addr));
       },
-      [&](view<subnet> sn) {
+      [&](view<subnet> sn) -> std::pair<subnet, value_data*> {
         return subnet_entries.match(materialize(sn));
       },
     };
     return tenzir::match(value, match);
   };
 
+  /// Matches an entire array of IP addresses against the subnets at once.
+  /// Returns the label of the longest-prefix match for every row, or nothing
+  /// if the array holds no IP addresses or the index does not pay off yet.
+  auto match_subnets(const series& array) -> std::vector<uint32_t> {
+    const auto* addrs = try_as<ip_type::array_type>(&*array.array);
+    if (not addrs or num_subnet_entries == 0) {
+      return {};
+    }
+    // Building the index costs about as much as a tree lookup per subnet, so
+    // we only build it once the lookups since the last change make up for
+    // that. Until then, we keep using the tree.
+    subnet_lookups_since_change += array.length();
+    if (not subnet_index) {
+      if (subnet_lookups_since_change < num_subnet_entries) {
+        return {};
+      }
+      auto index = subnet_index_type{};
+      auto prefixes = std::vector<std::pair<subnet, uint32_t>>{};
+      for (auto [key, value] : subnet_entries.nodes()) {
+        prefixes.emplace_back(key,
+                              detail::narrow<uint32_t>(index.entries.size()));
+        index.entries.emplace_back(key, value);
+      }
+      index.table = detail::lpm_table{prefixes};
+      subnet_index = std::move(index);
+    }
+    const auto& storage = *addrs->storage();
+    const auto* bytes = reinterpret_cast<const std::byte*>(storage.raw_values());
+    auto result = std::vector<uint32_t>(storage.length());
+    subnet_index->table.match(
+      std::span{bytes, static_cast<size_t>(storage.length()) * 16}, result);
+    return result;
+  }
+
+  auto insert_subnet(subnet key, value_data value) -> bool {
+    const auto created = subnet_entries.insert(key, std::move(value));
+    if (created) {
+      ++num_subnet_entries;
+      invalidate_subnet_index();
+    }
+    return created;
+  }
+
+  auto erase_subnet(subnet key) -> void {
+    if (subnet_entries.erase(key)) {
+      --num_subnet_entries;
+      invalidate_subnet_index();
+    }
+  }
+
+  auto invalidate_subnet_index() -> void {
+    subnet_index.reset();
+    subnet_lookups_since_change = 0;
+  }
+
   auto legacy_apply(series array, bool replace)
     -> caf::expected<std::vector<series>> override {
     auto builder = series_builder{};
     const auto now = time::clock::now();
+    const auto subnet_matches = match_subnets(array);
+    auto row = size_t{0};
     for (auto value : array.values()) {
+      const auto subnet_match
+        = subnet_matches.empty() ? std::nullopt
+                                 : std::optional{subnet_matches[row]};
+      ++row;
       // TODO: This should really be making use of heterogeneous map lookups
       // instead of materializing, but we're not using `data` and `data_view`
       // directly here, but rather a custom wrapper around them to make mixed
@@ -299,9 +381,9 @@ public:
       // We need to retry the lookup if we had an expired hit, as a matched IP
       // address in an expired subnet may very well be part of another subnet.
     retry:
-      if (auto [subnet, entry] = subnet_lookup(value); entry) {
+      if (auto [subnet, entry] = subnet_lookup(value, subnet_match); entry) {
         if (entry->is_expired(now)) {
-          subnet_entries.erase(subnet);
+          erase_subnet(subnet);
           goto retry; // NOLINT(cppcoreguidelines-avoid-goto)
         }
         entry->refresh_read_timeout(now);
@@ -321,7 +403,13 @@ public:
     TENZIR_UNUSED(ctx);
     auto builder = series_builder{};
     const auto now = time::clock::now();
+    const auto subnet_matches = match_subnets(array);
+    auto row = size_t{0};
     for (auto value : array.values()) {
+      const auto subnet_match
+        = subnet_matches.empty() ? std::nullopt
+                                 : std::optional{subnet_matches[row]};
+      ++row;
       // TODO: This should really be making use of heterogeneous map lookups
       // instead of materializing, but we're not using `data` and `data_view`
       // directly here, but rather a custom wrapper around them to make mixed
@@ -339,9 +427,9 @@ public:
       // We need to retry the lookup if we had an expired hit, as a matched IP
       // address that was expired may very well be part of another subnet.
     retry:
-      if (auto [subnet, entry] = subnet_lookup(value); entry) {
+      if (auto [subnet, entry] = subnet_lookup(value, subnet_match); entry) {
         if (entry->is_expired(now)) {
-          subnet_entries.erase(subnet);
+          erase_subnet(subnet);
           goto retry; // NOLINT(cppcoreguidelines-avoid-goto)
         }
         entry->refresh_read_timeout(now);
@@ -502,7 +590,7 @@ public:
           if (not key) {
             continue;
           }
-          subnet_entries.erase(*key);
+          erase_subnet(*key);
         }
       } else {
         for (const auto& key : values(key_type, *key_array)) {
@@ -526,7 +614,7 @@ public:
       // Subnets never make it into the regular map of entries.
       if (is<subnet_type>(key_type)) {
         const auto& key = as<tenzir::subnet>(materialized_key);
-        subnet_entries.insert(key, std::move(value_val));
+        insert_subnet(key, std::move(value_val));
       } else {
         context_entries.insert_or_assign(materialized_key,
                                          std::move(value_val));
@@ -584,7 +672,7 @@ public:
       auto context = context_gen.next();
       TENZIR_ASSERT(context);
       if (const auto* sn = try_as<tenzir::subnet>(&materialized_key)) {
-        const auto created = subnet_entries.insert(*sn, value_data{});
+        const auto created = insert_subnet(*sn, value_data{});
         auto* entry = subnet_entries.lookup(*sn);
         TENZIR_ASSERT(entry);
         update_entry(created, *entry, materialize(*context));
@@ -630,7 +718,7 @@ public:
           if (not key) {
             continue;
           }
-          subnet_entries.erase(*key);
+          erase_subnet(*key);
         }
         return {};
       }
@@ -647,6 +735,8 @@ public:
   auto reset() -> caf::expected<void> override {
     context_entries.clear();
     subnet_entries.clear();
+    num_subnet_entries = 0;
+    invalidate_subnet_index();
     return {};
   }
 
@@ -711,6 +801,9 @@ public:
 private:
   map_type context_entries;
   subnet_tree_type subnet_entries;
+  size_t num_subnet_entries = 0;
+  std::optional<subnet_index_type> subnet_index;
+  size_t subnet_lookups_since_change = 0;
 };
 
 struct v1_loader : public context_loader {
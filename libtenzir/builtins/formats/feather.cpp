@@ -14,8 +14,11 @@
 #include <tenzir/chunk.hpp>
 #include <tenzir/collect.hpp>
 #include <tenzir/data.hpp>
+#include <tenzir/detail/base64.hpp>
 #include <tenzir/detail/narrow.hpp>
+#include <tenzir/detail/overload.hpp>
 #include <tenzir/error.hpp>
+#include <tenzir/expression.hpp>
 #include <tenzir/fwd.hpp>
 #include <tenzir/generator.hpp>
 #include <tenzir/make_byte_reader.hpp>
@@ -25,7 +28,10 @@
 #include <tenzir/store.hpp>
 #include <tenzir/table_slice.hpp>
 #include <tenzir/tql2/plugin.hpp>
+#include <tenzir/view3.hpp>
 
+#include <arrow/array.h>
+#include <arrow/builder.h>
 #include <arrow/io/memory.h>
 #include <arrow/ipc/feather.h>
 #include <arrow/ipc/reader.h>
@@ -34,12 +40,21 @@
 #include <arrow/table.h>
 #include <arrow/util/iterator.h>
 #include <arrow/util/key_value_metadata.h>
+#include <caf/binary_deserializer.hpp>
+#include <caf/binary_serializer.hpp>
 #include <caf/expected.hpp>
 
 #include <chrono>
+#include <cmath>
+#include <compare>
+#include <functional>
 #include <optional>
 #include <queue>
+#include <span>
 #include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 namespace tenzir::plugins::feather {
 
@@ -128,18 +143,207 @@ auto derive_import_time(const std::shared_ptr<arrow::Array>& time_col) {
   return *view_at<time_type>(*time_col, row);
 }
 
+/// String columns whose number of distinct values in a store is at most this
+/// fraction of its rows are dictionary-encoded.
+constexpr auto dictionary_rows_per_value = uint64_t{8};
+
+/// The maximum number of distinct values of a dictionary-encoded column.
+constexpr auto max_dictionary_size = size_t{1} << 16;
+
+/// The dictionary of a string column that all record batches of a store
+/// share, so that the Arrow IPC file stores it only once.
+struct store_dictionary {
+  offset index = {};
+  std::shared_ptr<arrow::StringArray> values = {};
+  /// Maps the values to their codes. The keys point into `values`.
+  std::unordered_map<std::string_view, int32_t> codes = {};
+};
+
+/// Returns the child at `path` of nested struct array data without applying
+/// the validity of the parents.
+auto child_data_at(std::shared_ptr<arrow::ArrayData> data,
+                   std::span<const size_t> path)
+  -> std::shared_ptr<arrow::ArrayData> {
+  for (auto i : path) {
+    TENZIR_ASSERT(data->type->id() == arrow::Type::STRUCT);
+    data = data->child_data[i];
+  }
+  return data;
+}
+
+/// Creates dictionaries for the string columns of the slices of a store that
+/// have few distinct values.
+auto make_store_dictionaries(const std::vector<table_slice>& slices)
+  -> std::vector<store_dictionary> {
+  if (slices.empty()) {
+    return {};
+  }
+  const auto& schema = slices.front().schema();
+  if (std::ranges::any_of(slices, [&](const table_slice& slice) {
+        return slice.schema() != schema;
+      })) {
+    return {};
+  }
+  const auto total_rows = rows(slices);
+  // We gather the values from the same unflattened child data that
+  // `encode_dictionary` walks later. Flattening would turn values below a
+  // null parent record into nulls, but the raw child data still holds them.
+  auto events = std::vector<std::shared_ptr<arrow::ArrayData>>{};
+  events.reserve(slices.size());
+  for (const auto& slice : slices) {
+    events.push_back(check(to_record_batch(slice)->ToStructArray())->data());
+  }
+  auto result = std::vector<store_dictionary>{};
+  for (auto&& [field, index] : as<record_type>(schema).leaves()) {
+    if (not is<string_type>(field.type)) {
+      continue;
+    }
+    // The views point into the slices, which outlive this function.
+    auto distinct = std::unordered_set<std::string_view>{};
+    auto low_cardinality = true;
+    for (const auto& event : events) {
+      const auto strings = arrow::StringArray{child_data_at(event, index)};
+      for (auto i = int64_t{0}; i < strings.length(); ++i) {
+        if (strings.IsNull(i)
+            or not distinct.insert(strings.GetView(i)).second) {
+          continue;
+        }
+        if (distinct.size() > max_dictionary_size
+            or distinct.size() * dictionary_rows_per_value > total_rows) {
+          low_cardinality = false;
+          break;
+        }
+      }
+      if (not low_cardinality) {
+        break;
+      }
+    }
+    if (not low_cardinality or distinct.empty()) {
+      continue;
+    }
+    auto sorted = std::vector<std::string_view>{distinct.begin(),
+                                                distinct.end()};
+    std::ranges::sort(sorted);
+    auto builder = arrow::StringBuilder{arrow_memory_pool()};
+    check(builder.Reserve(detail::narrow_cast<int64_t>(sorted.size())));
+    for (auto x : sorted) {
+      check(builder.Append(x));
+    }
+    auto& dictionary = result.emplace_back();
+    dictionary.index = index;
+    dictionary.values = std::static_pointer_cast<arrow::StringArray>(
+      check(builder.Finish()));
+    dictionary.codes.reserve(sorted.size());
+    for (auto i = int64_t{0}; i < dictionary.values->length(); ++i) {
+      dictionary.codes.emplace(dictionary.values->GetView(i),
+                               detail::narrow_cast<int32_t>(i));
+    }
+  }
+  return result;
+}
+
+/// Replaces the child at `path` of nested struct array data.
+template <class Function>
+auto replace_child_data(const std::shared_ptr<arrow::ArrayData>& data,
+                        std::span<const size_t> path, Function&& f)
+  -> std::shared_ptr<arrow::ArrayData> {
+  if (path.empty()) {
+    return std::invoke(std::forward<Function>(f), data);
+  }
+  TENZIR_ASSERT(data->type->id() == arrow::Type::STRUCT);
+  const auto i = path.front();
+  auto child = replace_child_data(data->child_data[i], path.subspan(1),
+                                  std::forward<Function>(f));
+  auto fields = data->type->fields();
+  fields[i] = fields[i]->WithType(child->type);
+  auto result = data->Copy();
+  result->type = arrow::struct_(std::move(fields));
+  result->child_data[i] = std::move(child);
+  return result;
+}
+
+auto encode_dictionary(const std::shared_ptr<arrow::ArrayData>& data,
+                       const store_dictionary& dictionary)
+  -> std::shared_ptr<arrow::ArrayData> {
+  const auto strings = arrow::StringArray{data};
+  auto builder = arrow::Int32Builder{arrow_memory_pool()};
+  check(builder.Reserve(strings.length()));
+  for (auto i = int64_t{0}; i < strings.length(); ++i) {
+    if (strings.IsNull(i)) {
+      builder.UnsafeAppendNull();
+    } else {
+      const auto code = dictionary.codes.find(strings.GetView(i));
+      TENZIR_ASSERT(code != dictionary.codes.end());
+      builder.UnsafeAppend(code->second);
+    }
+  }
+  auto result = check(builder.Finish())->data()->Copy();
+  result->type = arrow::dictionary(arrow::int32(), arrow::utf8());
+  result->dictionary = dictionary.values->data();
+  return result;
+}
+
+/// Replaces dictionary-encoded strings in nested struct array data with plain
+/// strings, which is what table slices expect.
+auto decode_dictionaries(const std::shared_ptr<arrow::ArrayData>& data)
+  -> std::shared_ptr<arrow::ArrayData> {
+  if (data->type->id() == arrow::Type::DICTIONARY) {
+    const auto column = arrow::DictionaryArray{data};
+    const auto* dictionary
+      = dynamic_cast<const arrow::StringArray*>(column.dictionary().get());
+    if (not dictionary) {
+      return data;
+    }
+    auto builder = arrow::StringBuilder{arrow_memory_pool()};
+    check(builder.Reserve(column.length()));
+    for (auto i = int64_t{0}; i < column.length(); ++i) {
+      if (column.IsNull(i)) {
+        check(builder.AppendNull());
+      } else {
+        check(builder.Append(dictionary->GetView(column.GetValueIndex(i))));
+      }
+    }
+    return check(builder.Finish())->data();
+  }
+  if (data->type->id() != arrow::Type::STRUCT) {
+    return data;
+  }
+  auto result = std::shared_ptr<arrow::ArrayData>{};
+  auto fields = data->type->fields();
+  for (auto i = size_t{0}; i < data->child_data.size(); ++i) {
+    auto child = decode_dictionaries(data->child_data[i]);
+    if (child == data->child_data[i]) {
+      continue;
+    }
+    if (not result) {
+      result = data->Copy();
+    }
+    fields[i] = fields[i]->WithType(child->type);
+    result->child_data[i] = std::move(child);
+  }
+  if (not result) {
+    return data;
+  }
+  result->type = arrow::struct_(std::move(fields));
+  return result;
+}
+
 /// Extract event column from record batch and transform into new record batch.
 /// The record batch contains a message envelope with the actual event data
 /// alongside Tenzir-related meta data (currently limited to the import time).
 /// Message envelope is unwrapped and the metadata, attached to the to-level
 /// schema the input record batch is copied to the newly created record batch.
+/// Dictionary-encoded strings are decoded.
 auto unwrap_record_batch(const std::shared_ptr<arrow::RecordBatch>& rb)
   -> std::shared_ptr<arrow::RecordBatch> {
-  const auto& event_col = as<arrow::StructArray>(*rb->GetColumnByName("event"));
+  const auto event_data
+    = decode_dictionaries(rb->GetColumnByName("event")->data());
+  const auto event_col = std::static_pointer_cast<arrow::StructArray>(
+    arrow::MakeArray(event_data));
   auto schema_metadata = rb->schema()->GetFieldByName("event")->metadata();
   auto event_schema
-    = arrow::schema(event_col.type()->fields(), std::move(schema_metadata));
-  return record_batch_from_struct_array(std::move(event_schema), event_col);
+    = arrow::schema(event_col->type()->fields(), std::move(schema_metadata));
+  return record_batch_from_struct_array(std::move(event_schema), *event_col);
 }
 
 /// Create a constant column for the given import time with `rows` rows
@@ -156,11 +360,23 @@ auto make_import_time_col(const time& import_time, int64_t rows) {
 
 /// Wrap a record batch into an event envelope containing the event data
 /// as a nested struct alongside metadata as separate columns, containing
-/// the `import_time`.
-auto wrap_record_batch(const table_slice& slice)
+/// the `import_time`. The given string columns are dictionary-encoded.
+auto wrap_record_batch(const table_slice& slice,
+                       std::span<const store_dictionary> dictionaries = {})
   -> std::shared_ptr<arrow::RecordBatch> {
   auto rb = to_record_batch(slice);
-  auto event_array = check(rb->ToStructArray());
+  auto event_array = std::shared_ptr<arrow::Array>{check(rb->ToStructArray())};
+  if (not dictionaries.empty()) {
+    auto event_data = event_array->data();
+    for (const auto& dictionary : dictionaries) {
+      event_data = replace_child_data(
+        event_data, dictionary.index,
+        [&](const std::shared_ptr<arrow::ArrayData>& strings) {
+          return encode_dictionary(strings, dictionary);
+        });
+    }
+    event_array = arrow::MakeArray(std::move(event_data));
+  }
   auto time_col = make_import_time_col(slice.import_time(), rb->num_rows());
   auto schema = arrow::schema(
     {arrow::field("import_time", time_type::to_arrow_type()),
@@ -222,6 +438,355 @@ auto decode_ipc_file(chunk_ptr chunk) -> caf::expected<
   }(std::move(reader), std::move(gen));
 }
 
+/// The schema metadata key under which a store records its zone maps.
+constexpr auto zone_maps_key = std::string_view{"TENZIR:store:zone_maps"};
+
+/// Values longer than this do not get string statistics, so that a single
+/// long string cannot bloat the store metadata.
+constexpr auto max_zone_map_string_size = size_t{64};
+
+/// The statistics of a single column of a record batch.
+struct column_zone_map {
+  /// The smallest and largest value of the column, or null if there is none
+  /// or if the column type does not support statistics.
+  data min = {};
+  data max = {};
+  uint64_t null_count = {};
+
+  friend auto inspect(auto& f, column_zone_map& x) -> bool {
+    return f.object(x)
+      .pretty_name("tenzir.plugins.feather.column_zone_map")
+      .fields(f.field("min", x.min), f.field("max", x.max),
+              f.field("null_count", x.null_count));
+  }
+};
+
+/// The statistics of a record batch in a store, with one entry per leaf field
+/// of the schema in the order of their flat index.
+struct batch_zone_map {
+  uint64_t rows = {};
+  time import_time = {};
+  std::vector<column_zone_map> columns = {};
+
+  friend auto inspect(auto& f, batch_zone_map& x) -> bool {
+    return f.object(x)
+      .pretty_name("tenzir.plugins.feather.batch_zone_map")
+      .fields(f.field("rows", x.rows), f.field("import_time", x.import_time),
+              f.field("columns", x.columns));
+  }
+};
+
+auto make_column_zone_map(const type& ty, const arrow::Array& array)
+  -> column_zone_map {
+  auto result = column_zone_map{
+    .null_count = detail::narrow_cast<uint64_t>(array.null_count()),
+  };
+  match(ty, [&]<concrete_type Type>(const Type& concrete) {
+    if constexpr (detail::is_any_v<Type, int64_type, uint64_type, double_type,
+                                   duration_type, time_type, ip_type,
+                                   string_type>) {
+      using view_type = view3<type_to_data_t<Type>>;
+      auto min = std::optional<view_type>{};
+      auto max = std::optional<view_type>{};
+      for (auto&& x :
+           values(concrete, as<type_to_arrow_array_t<Type>>(array))) {
+        if (not x) {
+          continue;
+        }
+        if constexpr (std::same_as<Type, double_type>) {
+          // NaN is unordered, and no comparison with it can ever match.
+          if (std::isnan(*x)) {
+            continue;
+          }
+        }
+        if (not min or *x < *min) {
+          min = *x;
+        }
+        if (not max or *x > *max) {
+          max = *x;
+        }
+      }
+      if (not min) {
+        return;
+      }
+      if constexpr (std::same_as<Type, string_type>) {
+        if (min->size() > max_zone_map_string_size
+            or max->size() > max_zone_map_string_size) {
+          return;
+        }
+        result.min = std::string{*min};
+        result.max = std::string{*max};
+      } else {
+        result.min = *min;
+        result.max = *max;
+      }
+    }
+  });
+  return result;
+}
+
+auto make_batch_zone_map(const table_slice& slice) -> batch_zone_map {
+  const auto& schema = as<record_type>(slice.schema());
+  auto result = batch_zone_map{
+    .rows = slice.rows(),
+    .import_time = slice.import_time(),
+  };
+  result.columns.reserve(slice.columns());
+  for (auto column = size_t{0}; column < slice.columns(); ++column) {
+    auto [ty, array] = schema.resolve_flat_index(column).get(slice);
+    result.columns.push_back(make_column_zone_map(ty, *array));
+  }
+  return result;
+}
+
+/// Compares two values of the same type. Signed and unsigned integers compare
+/// by value; all other combinations of types are incomparable.
+auto compare_zone_map_value(const data& lhs, const data& rhs)
+  -> std::optional<std::partial_ordering> {
+  if (lhs.get_data().index() == rhs.get_data().index()) {
+    if (lhs < rhs) {
+      return std::partial_ordering::less;
+    }
+    if (rhs < lhs) {
+      return std::partial_ordering::greater;
+    }
+    return std::partial_ordering::equivalent;
+  }
+  auto compare_integers = [](auto x, auto y) {
+    if (std::cmp_less(x, y)) {
+      return std::partial_ordering::less;
+    }
+    if (std::cmp_greater(x, y)) {
+      return std::partial_ordering::greater;
+    }
+    return std::partial_ordering::equivalent;
+  };
+  if (const auto* x = try_as<int64_t>(&lhs)) {
+    if (const auto* y = try_as<uint64_t>(&rhs)) {
+      return compare_integers(*x, *y);
+    }
+  }
+  if (const auto* x = try_as<uint64_t>(&lhs)) {
+    if (const auto* y = try_as<int64_t>(&rhs)) {
+      return compare_integers(*x, *y);
+    }
+  }
+  return std::nullopt;
+}
+
+/// Checks whether any value of a column may satisfy `column op rhs`. Returns
+/// true whenever the statistics do not suffice to rule out a match.
+auto zone_map_allows(const column_zone_map& column, uint64_t rows,
+                     relational_operator op, const data& rhs) -> bool {
+  if (is<caf::none_t>(rhs)) {
+    switch (op) {
+      case relational_operator::equal:
+        return column.null_count > 0;
+      case relational_operator::not_equal:
+        return column.null_count < rows;
+      default:
+        return true;
+    }
+  }
+  if (is<caf::none_t>(column.min)) {
+    return true;
+  }
+  auto in_range = [&](const data& x) {
+    const auto lower = compare_zone_map_value(column.min, x);
+    const auto upper = compare_zone_map_value(column.max, x);
+    return not lower or not upper or (*lower <= 0 and *upper >= 0);
+  };
+  switch (op) {
+    case relational_operator::equal:
+      return in_range(rhs);
+    case relational_operator::in: {
+      const auto* xs = try_as<list>(&rhs);
+      return not xs or std::ranges::any_of(*xs, in_range);
+    }
+    case relational_operator::less: {
+      const auto order = compare_zone_map_value(column.min, rhs);
+      return not order or *order < 0;
+    }
+    case relational_operator::less_equal: {
+      const auto order = compare_zone_map_value(column.min, rhs);
+      return not order or *order <= 0;
+    }
+    case relational_operator::greater: {
+      const auto order = compare_zone_map_value(column.max, rhs);
+      return not order or *order > 0;
+    }
+    case relational_operator::greater_equal: {
+      const auto order = compare_zone_map_value(column.max, rhs);
+      return not order or *order >= 0;
+    }
+    default:
+      return true;
+  }
+}
+
+/// Checks whether any row of a record batch may match an expression that is
+/// tailored to the schema of the store, given a check that decides the same
+/// for a single predicate. Negations conservatively match.
+template <class Check>
+auto may_match(const expression& expr, const Check& check) -> bool {
+  return match(
+    expr,
+    detail::overload{
+      [](caf::none_t) {
+        return true;
+      },
+      [&](const conjunction& x) {
+        return std::ranges::all_of(x, [&](const expression& operand) {
+          return may_match(operand, check);
+        });
+      },
+      [&](const disjunction& x) {
+        return std::ranges::any_of(x, [&](const expression& operand) {
+          return may_match(operand, check);
+        });
+      },
+      [](const negation&) {
+        return true;
+      },
+      [&](const predicate& x) -> bool {
+        return check(x);
+      },
+    });
+}
+
+/// Checks whether any row of a record batch may satisfy a predicate, given
+/// the zone map of the batch.
+auto zone_map_allows(const predicate& x, const batch_zone_map& zone_map)
+  -> bool {
+  return match(
+    std::tie(x.lhs, x.rhs),
+    detail::overload{
+      [&](const data_extractor& lhs, const data& rhs) {
+        if (lhs.column >= zone_map.columns.size()) {
+          return true;
+        }
+        return zone_map_allows(zone_map.columns[lhs.column], zone_map.rows,
+                               x.op, rhs);
+      },
+      [&](const meta_extractor& lhs, const data& rhs) {
+        // All rows of a batch share the same import time.
+        if (lhs.kind != meta_extractor::import_time or not is<time>(rhs)) {
+          return true;
+        }
+        return evaluate(data{zone_map.import_time}, x.op, rhs);
+      },
+      [](const auto&, const auto&) {
+        return true;
+      },
+    });
+}
+
+/// Checks whether any value of a dictionary-encoded string column may satisfy
+/// `column op rhs`. We evaluate the predicate once per dictionary entry and
+/// then only look for the codes of the matching entries.
+auto dictionary_allows(const arrow::DictionaryArray& column,
+                       relational_operator op, const data& rhs) -> bool {
+  switch (op) {
+    case relational_operator::equal:
+    case relational_operator::in:
+    case relational_operator::ni:
+      break;
+    case relational_operator::not_equal:
+    case relational_operator::not_in:
+    case relational_operator::not_ni:
+      // Null values may satisfy a negated predicate.
+      if (column.null_count() > 0) {
+        return true;
+      }
+      break;
+    default:
+      return true;
+  }
+  if (not is<std::string>(rhs) and not is<pattern>(rhs)
+      and not is<list>(rhs)) {
+    return true;
+  }
+  const auto* dictionary
+    = dynamic_cast<const arrow::StringArray*>(column.dictionary().get());
+  if (not dictionary) {
+    return true;
+  }
+  auto matches = std::vector<bool>(dictionary->length());
+  auto any_matches = false;
+  for (auto i = int64_t{0}; i < dictionary->length(); ++i) {
+    if (dictionary->IsValid(i)
+        and evaluate(data{std::string{dictionary->GetView(i)}}, op, rhs)) {
+      matches[i] = true;
+      any_matches = true;
+    }
+  }
+  if (not any_matches) {
+    return false;
+  }
+  for (auto i = int64_t{0}; i < column.length(); ++i) {
+    if (column.IsValid(i) and matches[column.GetValueIndex(i)]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Checks whether any row of a record batch may satisfy a predicate, given the
+/// dictionary-encoded columns of the batch.
+auto dictionary_allows(const predicate& x, const arrow::StructArray& events,
+                       const record_type& schema) -> bool {
+  const auto* lhs = try_as<data_extractor>(&x.lhs);
+  const auto* rhs = try_as<data>(&x.rhs);
+  if (not lhs or not rhs or lhs->column >= schema.num_leaves()) {
+    return true;
+  }
+  const auto column = schema.resolve_flat_index(lhs->column).get(events);
+  const auto* dictionary
+    = dynamic_cast<const arrow::DictionaryArray*>(column.get());
+  if (not dictionary) {
+    return true;
+  }
+  return dictionary_allows(*dictionary, x.op, *rhs);
+}
+
+auto encode_zone_maps(const std::vector<batch_zone_map>& zone_maps)
+  -> std::string {
+  auto buffer = caf::byte_buffer{};
+  auto serializer = caf::binary_serializer{buffer};
+  const auto success = serializer.apply(zone_maps);
+  TENZIR_ASSERT(success, "failed to serialize zone maps: {}",
+                serializer.get_error());
+  return detail::base64::encode(buffer);
+}
+
+/// Reads the zone maps of a store file. Returns `std::nullopt` for stores that
+/// were written without zone maps, or whose zone maps do not describe the
+/// record batches of the file.
+auto decode_zone_maps(const arrow::ipc::RecordBatchFileReader& reader)
+  -> std::optional<std::vector<batch_zone_map>> {
+  const auto& metadata = reader.schema()->metadata();
+  if (not metadata) {
+    return std::nullopt;
+  }
+  const auto index = metadata->FindKey(std::string{zone_maps_key});
+  if (index < 0) {
+    return std::nullopt;
+  }
+  const auto buffer
+    = detail::base64::try_decode<caf::byte_buffer>(metadata->value(index));
+  if (not buffer) {
+    return std::nullopt;
+  }
+  auto result = std::vector<batch_zone_map>{};
+  auto deserializer = caf::binary_deserializer{*buffer};
+  if (not deserializer.apply(result)
+      or result.size()
+           != detail::narrow_cast<size_t>(reader.num_record_batches())) {
+    return std::nullopt;
+  }
+  return result;
+}
+
 class passive_feather_store final : public passive_store {
   [[nodiscard]] auto load(chunk_ptr chunk) -> caf::error override {
     TENZIR_ASSERT(chunk);
@@ -252,55 +817,89 @@ class passive_feather_store final : public passive_store {
     }
     auto batches = std::move(*decode_result);
     auto offset = id{};
-    auto schema = schema_;
     for (auto it = batches.begin(); it != batches.end(); ++it) {
-      auto batch_result = std::move(*it);
-      if (not batch_result) {
-        co_yield std::move(batch_result.error());
+      auto batch = std::move(*it);
+      if (not batch) {
+        co_yield std::move(batch.error());
         co_return;
       }
-      auto batch = std::move(*batch_result);
-      // A damaged store can decode as a valid Arrow IPC file whose batches
-      // are not store envelopes (e.g. a missing or non-struct `event`
-      // column); `unwrap_record_batch` would dereference the missing column,
-      // so validate the envelope shape first.
-      if (not is_store_envelope(batch)) {
-        co_yield caf::make_error(ec::format_error,
-                                 "record batch in feather store is not a "
-                                 "valid store envelope");
+      auto slice = make_slice(std::move(*batch), offset);
+      if (not slice) {
+        co_yield std::move(slice.error());
         co_return;
       }
-      // `is_store_envelope` only inspects the schema and `try_from` below
-      // only validates the unwrapped `event` batch, so corrupt array data in
-      // the envelope itself (e.g. an undersized `import_time` buffer) would
-      // still assert in `derive_import_time`. Structurally validate the
-      // whole envelope batch before taking it apart.
-      if (auto status = batch->Validate(); not status.ok()) {
+      offset += slice->rows();
+      co_yield std::move(*slice);
+    }
+  }
+
+  /// Reads only the record batches whose zone maps and dictionaries do not
+  /// rule out a match, and falls back to reading all batches for stores
+  /// without zone maps.
+  [[nodiscard]] auto extract(expression expr) const
+    -> generator<caf::expected<table_slice>> override {
+    if (not chunk_) {
+      co_return;
+    }
+    auto reader = open_reader();
+    if (not reader) {
+      co_yield std::move(reader.error());
+      co_return;
+    }
+    auto zone_maps = decode_zone_maps(**reader);
+    if (not zone_maps) {
+      for (auto&& slice : base_store::extract(std::move(expr))) {
+        co_yield std::move(slice);
+      }
+      co_return;
+    }
+    auto offset = id{};
+    for (auto i = size_t{0}; i < zone_maps->size(); ++i) {
+      const auto& zone_map = (*zone_maps)[i];
+      if (not may_match(expr, [&](const predicate& x) {
+            return zone_map_allows(x, zone_map);
+          })) {
+        offset += zone_map.rows;
+        continue;
+      }
+      auto batch = (*reader)->ReadRecordBatch(detail::narrow_cast<int>(i));
+      if (not batch.ok()) {
         co_yield caf::make_error(
           ec::format_error,
-          fmt::format("record batch in feather store failed validation: {}",
-                      status.ToStringWithoutContextLines()));
+          fmt::format("failed to read record batch: {}",
+                      batch.status().ToStringWithoutContextLines()));
         co_return;
       }
-      auto import_time_column = batch->GetColumnByName("import_time");
-      auto slice_result
-        = schema ? table_slice::try_from(unwrap_record_batch(batch), *schema)
-                 : table_slice::try_from(unwrap_record_batch(batch));
-      if (not slice_result) {
+      // The offsets of all later batches depend on the row counts of the
+      // skipped ones, so the zone maps must agree with the data.
+      if (detail::narrow_cast<uint64_t>((*batch)->num_rows())
+          != zone_map.rows) {
         co_yield caf::make_error(ec::format_error,
-                                 fmt::format("failed to read record batch: {}",
-                                             slice_result.error().message));
+                                 "zone map of feather store does not match "
+                                 "its record batch");
+        co_return;
+      }
+      // Predicates on dictionary-encoded columns can rule out the batch
+      // before we decode its strings.
+      if (schema_ and is_store_envelope(*batch) and (*batch)->Validate().ok()
+          and not may_match(expr, [&](const predicate& x) {
+                return dictionary_allows(
+                  x,
+                  as<arrow::StructArray>(*(*batch)->GetColumnByName("event")),
+                  as<record_type>(*schema_));
+              })) {
+        offset += zone_map.rows;
+        continue;
+      }
+      auto slice = make_slice(batch.MoveValueUnsafe(), offset);
+      if (not slice) {
+        co_yield std::move(slice.error());
         co_return;
       }
-      auto slice = std::move(*slice_result);
-      if (not schema) {
-        schema = slice.schema();
-        schema_ = schema;
+      offset += slice->rows();
+      if (auto filtered_slice = filter(*slice, expr)) {
+        co_yield std::move(*filtered_slice);
       }
-      slice.offset(offset);
-      slice.import_time(derive_import_time(import_time_column));
-      offset += slice.rows();
-      co_yield std::move(slice);
     }
   }
 
@@ -335,17 +934,68 @@ private:
     return chunk_->slice(0, chunk_->size());
   }
 
-  [[nodiscard]] auto count_rows() const -> caf::expected<uint64_t> {
-    auto reader_result = arrow::ipc::RecordBatchFileReader::Open(
+  [[nodiscard]] auto open_reader() const -> caf::expected<
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader>> {
+    auto reader = arrow::ipc::RecordBatchFileReader::Open(
       as_arrow_file(make_chunk_view()), arrow_ipc_read_options());
-    if (not reader_result.ok()) {
+    if (not reader.ok()) {
       return caf::make_error(
         ec::format_error,
-        fmt::format("failed to open feather store for counting: {}",
-                    reader_result.status().ToStringWithoutContextLines()));
+        fmt::format("failed to open feather store: {}",
+                    reader.status().ToStringWithoutContextLines()));
     }
-    auto reader = reader_result.MoveValueUnsafe();
-    auto rows = reader->CountRows();
+    return reader.MoveValueUnsafe();
+  }
+
+  /// Converts a record batch of the store into a table slice that starts at
+  /// the given offset.
+  [[nodiscard]] auto make_slice(std::shared_ptr<arrow::RecordBatch> batch,
+                                id offset) const
+    -> caf::expected<table_slice> {
+    // A damaged store can decode as a valid Arrow IPC file whose batches
+    // are not store envelopes (e.g. a missing or non-struct `event`
+    // column); `unwrap_record_batch` would dereference the missing column,
+    // so validate the envelope shape first.
+    if (not is_store_envelope(batch)) {
+      return caf::make_error(ec::format_error,
+                             "record batch in feather store is not a "
+                             "valid store envelope");
+    }
+    // `is_store_envelope` only inspects the schema and `try_from` below
+    // only validates the unwrapped `event` batch, so corrupt array data in
+    // the envelope itself (e.g. an undersized `import_time` buffer) would
+    // still assert in `derive_import_time`. Structurally validate the
+    // whole envelope batch before taking it apart.
+    if (auto status = batch->Validate(); not status.ok()) {
+      return caf::make_error(
+        ec::format_error,
+        fmt::format("record batch in feather store failed validation: {}",
+                    status.ToStringWithoutContextLines()));
+    }
+    auto import_time_column = batch->GetColumnByName("import_time");
+    auto slice_result
+      = schema_ ? table_slice::try_from(unwrap_record_batch(batch), *schema_)
+                : table_slice::try_from(unwrap_record_batch(batch));
+    if (not slice_result) {
+      return caf::make_error(ec::format_error,
+                             fmt::format("failed to read record batch: {}",
+                                         slice_result.error().message));
+    }
+    auto slice = std::move(*slice_result);
+    if (not schema_) {
+      schema_ = slice.schema();
+    }
+    slice.offset(offset);
+    slice.import_time(derive_import_time(import_time_column));
+    return slice;
+  }
+
+  [[nodiscard]] auto count_rows() const -> caf::expected<uint64_t> {
+    auto reader = open_reader();
+    if (not reader) {
+      return std::move(reader.error());
+    }
+    auto rows = (*reader)->CountRows();
     if (not rows.ok()) {
       return caf::make_error(
         ec::format_error,
@@ -399,21 +1049,34 @@ public:
 
   [[nodiscard]] auto finish() -> caf::expected<chunk_ptr> override {
     rebatch();
+    // After rebatching, no slice exceeds the chunk size that we write with,
+    // so every non-empty slice becomes exactly one record batch of the file.
+    // String columns with few distinct values share one dictionary across
+    // all batches, which the file stores only once.
+    const auto dictionaries = make_store_dictionaries(slices_);
     auto record_batches = arrow::RecordBatchVector{};
+    auto zone_maps = std::vector<batch_zone_map>{};
     record_batches.reserve(slices_.size());
+    zone_maps.reserve(slices_.size());
     for (const auto& slice : slices_) {
-      record_batches.push_back(wrap_record_batch(slice));
+      TENZIR_ASSERT(slice.rows() <= defaults::import::table_slice_size);
+      record_batches.push_back(wrap_record_batch(slice, dictionaries));
+      if (slice.rows() > 0) {
+        zone_maps.push_back(make_batch_zone_map(slice));
+      }
     }
     auto table = ::arrow::Table::FromRecordBatches(record_batches);
     if (not table.ok()) {
       return caf::make_error(ec::system_error, table.status().ToString());
     }
-    // Attach origin metadata to the table schema.
+    // Attach origin metadata and zone maps to the table schema.
     {
       auto metadata = table.ValueUnsafe()->schema()->metadata()
                         ? table.ValueUnsafe()->schema()->metadata()->Copy()
                         : std::make_shared<arrow::KeyValueMetadata>();
       metadata->Append("TENZIR:store:origin", origin());
+      metadata->Append(std::string{zone_maps_key},
+                       encode_zone_maps(zone_maps));
       table = table.ValueUnsafe()->ReplaceSchemaMetadata(std::move(metadata));
     }
     auto output_stream
@@ -8,6 +8,7 @@
 
 #include <tenzir/argument_parser.hpp>
 #include <tenzir/arrow_table_slice.hpp>
+#include <tenzir/async/parallel_lines.hpp>
 #include <tenzir/async/pusher.hpp>
 #include <tenzir/concept/parseable/tenzir/data.hpp>
 #include <tenzir/multi_series_builder.hpp>
@@ -763,6 +764,46 @@ struct ReadGrokArgs {
   bool indexed_captures = false;
   bool include_unnamed = false;
   multi_series_builder::options msb_options = {};
+  uint64_t jobs = 0;
+};
+
+/// Attributes diagnostics without a location to the operator.
+auto make_operator_dh(diagnostic_handler& dh, location operator_location)
+  -> transforming_diagnostic_handler {
+  return transforming_diagnostic_handler{
+    dh, [operator_location](diagnostic diag) {
+      if (not diag.has_location()) {
+        diag.annotations.emplace_back(true, std::string{}, operator_location);
+      }
+      return diag;
+    }};
+}
+
+/// The per-worker state of `read_grok _jobs=...`.
+class GrokWorker final : public LineParserWorker {
+public:
+  GrokWorker(grok_parser parser, const ReadGrokArgs& args,
+             diagnostic_handler& dh)
+    : parser_{std::move(parser)},
+      dh_{make_operator_dh(dh, args.operator_location)},
+      builder_{args.msb_options, dh_} {
+  }
+
+  auto parse_line(std::string_view line, size_t line_number) -> void override {
+    TENZIR_UNUSED(line_number);
+    if (not parser_.parse_line(builder_, dh_, line)) {
+      builder_.remove_last();
+    }
+  }
+
+  auto finish() -> std::vector<table_slice> override {
+    return builder_.finalize_as_table_slice();
+  }
+
+private:
+  grok_parser parser_;
+  transforming_diagnostic_handler dh_;
+  multi_series_builder builder_;
 };
 
 class ReadGrok final : public Operator<chunk_ptr, table_slice> {
@@ -782,29 +823,53 @@ public:
     if (not parser) {
       co_return;
     }
-    dh_.emplace(ctx.dh(), [loc = args_.operator_location](diagnostic diag) {
-      if (not diag.has_location()) {
-        diag.annotations.emplace_back(true, std::string{}, loc);
-      }
-      return diag;
-    });
+    if (args_.jobs > 0) {
+      parallel_.emplace(args_.jobs, args_.msb_options.settings.ordered,
+                        [args = args_, parser = std::move(*parser)](
+                          diagnostic_handler& dh)
+                          -> std::unique_ptr<LineParserWorker> {
+                          return std::make_unique<GrokWorker>(parser, args,
+                                                              dh);
+                        });
+      parallel_->start(ctx);
+      co_return;
+    }
+    dh_.emplace(make_operator_dh(ctx.dh(), args_.operator_location));
     parser_.emplace(std::move(*parser));
     builder_.emplace(args_.msb_options, *dh_);
   }
 
   auto await_task(diagnostic_handler&) const -> Task<Any> override {
+    if (parallel_) {
+      co_return co_await parallel_->next();
+    }
     co_await pusher_.wait();
     co_return {};
   }
 
-  auto process_task(Any, Push<table_slice>& push, OpCtx&)
+  auto state() -> OperatorState override {
+    if (not parallel_ or not draining_) {
+      return OperatorState::normal;
+    }
+    return parallel_->done() ? OperatorState::done : OperatorState::normal;
+  }
+
+  auto process_task(Any result, Push<table_slice>& push, OpCtx&)
     -> Task<void> override {
+    if (parallel_) {
+      co_await parallel_->handle(std::move(result), push);
+      co_return;
+    }
     TENZIR_ASSERT(builder_);
     co_await pusher_.push(builder_->yield_ready_as_table_slice(), push);
   }
 
   auto process(chunk_ptr input, Push<table_slice>& push, OpCtx&)
     -> Task<void> override {
+    if (parallel_) {
+      co_await parallel_->add(std::move(input));
+      co_return;
+    }
     if (not parser_ or not builder_) {
       co_return;
     }
@@ -842,6 +907,14 @@ public:
 
   auto finalize(Push<table_slice>& push, OpCtx&)
     -> Task<FinalizeBehavior> override {
+    draining_ = true;
+    if (parallel_) {
+      if (parallel_->done()) {
+        co_return FinalizeBehavior::done;
+      }
+      co_await parallel_->finish();
+      co_return FinalizeBehavior::continue_;
+    }
     if (not parser_ or not builder_) {
       co_return FinalizeBehavior::done;
     }
@@ -857,6 +930,10 @@ public:
 
   auto prepare_snapshot(Push<table_slice>& push, OpCtx&)
     -> Task<void> override {
+    if (parallel_) {
+      co_await parallel_->flush(push);
+      co_return;
+    }
     TENZIR_ASSERT(builder_);
     for (auto& slice : builder_->finalize_as_table_slice()) {
       co_await push(std::move(slice));
@@ -864,6 +941,10 @@ public:
   }
 
   auto snapshot(Serde& serde) -> void override {
+    if (parallel_) {
+      parallel_->snapshot(serde);
+      return;
+    }
     serde("buffer", buffer_);
     serde("ended_on_carriage_return", ended_on_carriage_return_);
   }
@@ -885,6 +966,8 @@ private:
   std::string buffer_;
   bool ended_on_carriage_return_ = false;
   SeriesPusher pusher_;
+  bool draining_ = false;
+  Option<ParallelLineParser> parallel_;
 };
 
 class read_grok_plugin
@@ -909,8 +992,10 @@ public:
     auto include_unnamed
       = d.named("include_unnamed", &ReadGrokArgs::include_unnamed);
     auto msb = add_msb_to_describer(d, &ReadGrokArgs::msb_options);
+    auto jobs = d.named_optional("_jobs", &ReadGrokArgs::jobs);
     d.validate([=](DescribeCtx& ctx) -> Empty {
       msb(ctx);
+      validate_jobs(ctx, jobs);
       auto grok_pattern = ctx.get(pattern);
       if (not grok_pattern) {
         return {};
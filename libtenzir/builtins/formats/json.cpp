@@ -26,6 +26,7 @@
 #include <tenzir/diagnostics.hpp>
 #include <tenzir/generator.hpp>
 #include <tenzir/ir.hpp>
+#include <tenzir/json_slice_printer.hpp>
 #include <tenzir/modules.hpp>
 #include <tenzir/multi_series_builder.hpp>
 #include <tenzir/multi_series_builder_argument_parser.hpp>
@@ -912,6 +913,36 @@ struct printer_args {
   }
 };
 
+/// Returns what goes between two rows of the output.
+auto row_separator(const json_printer_options& opts, bool arrays_of_objects)
+  -> std::string_view {
+  if (not arrays_of_objects) {
+    return "\n";
+  }
+  return opts.oneline ? "," : ",\n";
+}
+
+/// Appends the rows of a slice to `buffer`. We print column by column unless
+/// the options require colors or TQL output, which only `json_printer` knows.
+auto print_rows(const table_slice& slice, const json_printer_options& opts,
+                std::string_view separator, std::vector<char>& buffer) -> void {
+  if (json_slice_printer::supports(opts)) {
+    json_slice_printer{opts}.print(slice, separator, buffer);
+    return;
+  }
+  auto printer = tenzir::json_printer{opts};
+  auto out_iter = std::back_inserter(buffer);
+  auto first = true;
+  for (auto&& row : values3(slice)) {
+    if (not first) {
+      out_iter = std::copy(separator.begin(), separator.end(), out_iter);
+    }
+    first = false;
+    const auto ok = printer.print(out_iter, row);
+    TENZIR_ASSERT(ok);
+  }
+}
+
 class json_printer final : public plugin_printer {
 public:
   json_printer() = default;
@@ -941,15 +972,9 @@ public:
         co_yield {};
         co_return;
       }
-      auto printer = tenzir::json_printer{opts_};
-      // TODO: Since this printer is per-schema we can write an optimized
-      // version of it that gets the schema ahead of time and only expects
-      // data corresponding to exactly that schema.
       auto buffer = std::vector<char>{};
       auto resolved_slice = resolve_enumerations(slice);
       auto out_iter = std::back_inserter(buffer);
-      auto rows = values3(resolved_slice);
-      auto row = rows.begin();
       if (arrays_of_objects_) {
         if (array_open_written_) {
           *out_iter++ = ',';
@@ -961,23 +986,8 @@ public:
           array_open_written_ = true;
         }
       }
-      if (row != rows.end()) {
-        const auto ok = printer.print(out_iter, *row);
-        TENZIR_ASSERT(ok);
-        ++row;
-      }
-      for (; row != rows.end(); ++row) {
-        if (arrays_of_objects_) {
-          *out_iter++ = ',';
-          if (not opts_.oneline) {
-            *out_iter++ = '\n';
-          }
-        } else {
-          out_iter = fmt::format_to(out_iter, "\n");
-        }
-        const auto ok = printer.print(out_iter, *row);
-        TENZIR_ASSERT(ok);
-      }
+      print_rows(resolved_slice, opts_,
+                 row_separator(opts_, arrays_of_objects_), buffer);
       if (not arrays_of_objects_) {
         *out_iter++ = '\n';
       }
@@ -2271,15 +2281,9 @@ public:
   }
 
   auto print_slice(table_slice const& input) const -> chunk_ptr {
-    auto printer = tenzir::json_printer{opts_};
-    // TODO: Since this printer is per-schema we can write an optimized
-    // version of it that gets the schema ahead of time and only expects
-    // data corresponding to exactly that schema.
     auto buffer = std::vector<char>{};
     auto resolved_slice = resolve_enumerations(input);
     auto out_iter = std::back_inserter(buffer);
-    auto rows = values3(resolved_slice);
-    auto row = rows.begin();
     if (args_.arrays_of_objects) {
       if (array_open_written_) {
         *out_iter++ = ',';
@@ -2291,23 +2295,8 @@ public:
         array_open_written_ = true;
       }
     }
-    if (row != rows.end()) {
-      auto const ok = printer.print(out_iter, *row);
-      TENZIR_ASSERT(ok);
-      ++row;
-    }
-    for (; row != rows.end(); ++row) {
-      if (args_.arrays_of_objects) {
-        *out_iter++ = ',';
-        if (not opts_.oneline) {
-          *out_iter++ = '\n';
-        }
-      } else {
-        out_iter = fmt::format_to(out_iter, "\n");
-      }
-      auto const ok = printer.print(out_iter, *row);
-      TENZIR_ASSERT(ok);
-    }
+    print_rows(resolved_slice, opts_,
+               row_separator(opts_, args_.arrays_of_objects), buffer);
     if (not args_.arrays_of_objects) {
       *out_iter++ = '\n';
     }
@@ -9,6 +9,7 @@
 #include <tenzir/argument_parser.hpp>
 #include <tenzir/arrow_table_slice.hpp>
 #include <tenzir/arrow_utils.hpp>
+#include <tenzir/async/parallel_lines.hpp>
 #include <tenzir/async/pusher.hpp>
 #include <tenzir/box.hpp>
 #include <tenzir/collect.hpp>
@@ -502,6 +503,94 @@ struct ReadKvArgs {
   located<std::string> quotes
     = {detail::quoting_escaping_policy{}.quotes, location::unknown};
   location operator_location = location::unknown;
+  uint64_t jobs = 0;
+};
+
+/// Parses a single line of key-value pairs into a new event.
+auto parse_kv_line(std::string_view line, multi_series_builder& msb,
+                   const splitter& field_split, const splitter& value_split,
+                   const detail::quoting_escaping_policy& quoting,
+                   diagnostic_handler& dh) -> void {
+  auto event = msb.record();
+  struct previous_t {
+    std::string_view key;
+    std::string_view value;
+  };
+  auto previous = std::optional<previous_t>{};
+  const auto commit = [&quoting, &event, &previous]() {
+    if (not previous) {
+      return;
+    }
+    auto key = quoting.unquote_unescape(previous->key);
+    if (previous->value.empty()) {
+      event.unflattened_field(key).null();
+      return;
+    }
+    auto value = quoting.unquote_unescape(previous->value);
+    event.unflattened_field(key).data_unparsed(std::move(value));
+  };
+  while (not line.empty()) {
+    const auto [head, tail, field_sep] = field_split.split(line, quoting);
+    const auto [key_view, value_view, value_sep]
+      = value_split.split(head, quoting);
+    if (value_sep.found()) {
+      commit();
+      previous.emplace(key_view, value_view);
+    } else if (previous) {
+      if (previous->value.empty()) {
+        previous->value = value_view;
+      } else {
+        previous->value = std::string_view{
+          previous->value.data(),
+          previous->value.size() + field_sep.length() + key_view.length(),
+        };
+      }
+    } else {
+      previous.emplace(key_view, value_view);
+    }
+    if (line == tail) {
+      diagnostic::error("`kv` parsing did not make progress")
+        .note("make sure `field_split` is a regular expression")
+        .emit(dh);
+      return;
+    }
+    line = tail;
+  }
+  commit();
+}
+
+/// The per-worker state of `read_kv _jobs=...`.
+class KvWorker final : public LineParserWorker {
+public:
+  KvWorker(const ReadKvArgs& args, diagnostic_handler& dh)
+    : quoting_{.quotes = args.quotes.inner},
+      field_split_{located<std::string_view>{args.field_split.inner,
+                                             args.field_split.source}},
+      value_split_{located<std::string_view>{args.value_split.inner,
+                                             args.value_split.source}},
+      dh_{dh,
+          [this, loc = args.operator_location](diagnostic d) {
+            return annotate_line(std::move(d), loc, line_number_);
+          }},
+      msb_{args.msb_options, dh_} {
+  }
+
+  auto parse_line(std::string_view line, size_t line_number) -> void override {
+    line_number_ = line_number;
+    parse_kv_line(line, msb_, field_split_, value_split_, quoting_, dh_);
+  }
+
+  auto finish() -> std::vector<table_slice> override {
+    return msb_.finalize_as_table_slice();
+  }
+
+private:
+  size_t line_number_ = 0;
+  detail::quoting_escaping_policy quoting_;
+  splitter field_split_;
+  splitter value_split_;
+  transforming_diagnostic_handler dh_;
+  multi_series_builder msb_;
 };
 
 class ReadKv final : public Operator<chunk_ptr, table_slice> {
@@ -516,32 +605,54 @@ public:
   }
 
   auto start(OpCtx& ctx) -> Task<void> override {
+    if (args_.jobs > 0) {
+      parallel_.emplace(args_.jobs, args_.msb_options.settings.ordered,
+                        [args = args_](diagnostic_handler& dh)
+                          -> std::unique_ptr<LineParserWorker> {
+                          return std::make_unique<KvWorker>(args, dh);
+                        });
+      parallel_->start(ctx);
+      co_return;
+    }
     dh_.emplace(std::in_place, ctx.dh(), [this](diagnostic d) {
-      if (args_.operator_location and not d.has_location()) {
-        d.annotations.emplace_back(true, std::string{},
-                                   args_.operator_location);
-      }
-      d.notes.emplace(d.notes.begin(), diagnostic_note_kind::note,
-                      fmt::format("line {}", line_counter_));
-      return d;
+      return annotate_line(std::move(d), args_.operator_location,
+                           line_counter_);
     });
     msb_ = multi_series_builder{args_.msb_options, *dh_};
     co_return;
   }
 
   auto await_task(diagnostic_handler&) const -> Task<Any> override {
+    if (parallel_) {
+      co_return co_await parallel_->next();
+    }
     co_await pusher_.wait();
     co_return {};
   }
 
-  auto process_task(Any, Push<table_slice>& push, OpCtx&)
+  auto state() -> OperatorState override {
+    if (not parallel_ or not draining_) {
+      return OperatorState::normal;
+    }
+    return parallel_->done() ? OperatorState::done : OperatorState::normal;
+  }
+
+  auto process_task(Any result, Push<table_slice>& push, OpCtx&)
     -> Task<void> override {
+    if (parallel_) {
+      co_await parallel_->handle(std::move(result), push);
+      co_return;
+    }
     TENZIR_ASSERT(msb_);
     co_await pusher_.push(msb_->yield_ready_as_table_slice(), push);
   }
 
   auto process(chunk_ptr input, Push<table_slice>& push, OpCtx&)
     -> Task<void> override {
+    if (parallel_) {
+      co_await parallel_->add(std::move(input));
+      co_return;
+    }
     TENZIR_ASSERT(msb_);
     auto const* begin = reinterpret_cast<const char*>(input->data());
     auto const* const end = begin + input->size();
@@ -582,6 +693,14 @@ public:
 
   auto finalize(Push<table_slice>& push, OpCtx&)
     -> Task<FinalizeBehavior> override {
+    draining_ = true;
+    if (parallel_) {
+      if (parallel_->done()) {
+        co_return FinalizeBehavior::done;
+      }
+      co_await parallel_->finish();
+      co_return FinalizeBehavior::continue_;
+    }
     TENZIR_ASSERT(msb_);
     if (not buffer_.empty()) {
       process_line(buffer_);
@@ -595,6 +714,10 @@ public:
 
   auto prepare_snapshot(Push<table_slice>& push, OpCtx&)
     -> Task<void> override {
+    if (parallel_) {
+      co_await parallel_->flush(push);
+      co_return;
+    }
     TENZIR_ASSERT(msb_);
     for (auto& slice : msb_->finalize_as_table_slice()) {
       co_await push(std::move(slice));
@@ -602,6 +725,10 @@ public:
   }
 
   auto snapshot(Serde& serde) -> void override {
+    if (parallel_) {
+      parallel_->snapshot(serde);
+      return;
+    }
     serde("buffer", buffer_);
     serde("ended_on_carriage_return", ended_on_carriage_return_);
     serde("line_counter", line_counter_);
@@ -612,52 +739,7 @@ private:
     TENZIR_ASSERT(msb_);
     TENZIR_ASSERT(dh_);
     ++line_counter_;
-    auto event = msb_->record();
-    struct previous_t {
-      std::string_view key;
-      std::string_view value;
-    };
-    auto previous = std::optional<previous_t>{};
-    const auto commit = [this, &event, &previous]() {
-      if (not previous) {
-        return;
-      }
-      auto key = quoting_.unquote_unescape(previous->key);
-      if (previous->value.empty()) {
-        event.unflattened_field(key).null();
-        return;
-      }
-      auto value = quoting_.unquote_unescape(previous->value);
-      event.unflattened_field(key).data_unparsed(std::move(value));
-    };
-    while (not line.empty()) {
-      const auto [head, tail, field_sep] = field_split_.split(line, quoting_);
-      const auto [key_view, value_view, value_sep]
-        = value_split_.split(head, quoting_);
-      if (value_sep.found()) {
-        commit();
-        previous.emplace(key_view, value_view);
-      } else if (previous) {
-        if (previous->value.empty()) {
-          previous->value = value_view;
-        } else {
-          previous->value = std::string_view{
-            previous->value.data(),
-            previous->value.size() + field_sep.length() + key_view.length(),
-          };
-        }
-      } else {
-        previous.emplace(key_view, value_view);
-      }
-      if (line == tail) {
-        diagnostic::error("`kv` parsing did not make progress")
-          .note("make sure `field_split` is a regular expression")
-          .emit(**dh_);
-        return;
-      }
-      line = tail;
-    }
-    commit();
+    parse_kv_line(line, *msb_, field_split_, value_split_, quoting_, **dh_);
   }
 
   ReadKvArgs args_;
@@ -670,6 +752,8 @@ private:
   Option<Box<transforming_diagnostic_handler>> dh_;
   Option<multi_series_builder> msb_;
   SeriesPusher pusher_;
+  bool draining_ = false;
+  Option<ParallelLineParser> parallel_;
 };
 
 struct WriteKvArgs {
@@ -885,6 +969,7 @@ public:
       = d.named_optional("value_split", &ReadKvArgs::value_split);
     d.named_optional("quotes", &ReadKvArgs::quotes);
     auto msb = add_msb_to_describer(d, &ReadKvArgs::msb_options);
+    auto jobs = d.named_optional("_jobs", &ReadKvArgs::jobs);
     d.operator_location(&ReadKvArgs::operator_location);
     d.validate([=](DescribeCtx& ctx) -> Empty {
       // `DescribeCtx::get()` returns `nullopt` for omitted named arguments,
@@ -894,6 +979,7 @@ public:
       (void)validate_splitter(fs ? *fs : defaults.field_split, ctx);
       (void)validate_splitter(vs ? *vs : defaults.value_split, ctx);
       msb(ctx);
+      validate_jobs(ctx, jobs);
       return {};
     });
     return d.without_optimize();
@@ -9,6 +9,7 @@
 #include <tenzir/argument_parser.hpp>
 #include <tenzir/arrow_utils.hpp>
 #include <tenzir/async.hpp>
+#include <tenzir/async/parallel_lines.hpp>
 #include <tenzir/async/pusher.hpp>
 #include <tenzir/box.hpp>
 #include <tenzir/concept/convertible/to.hpp>
@@ -304,6 +305,40 @@ struct ReadLeefArgs {
   multi_series_builder::options msb_options;
   location operator_location = location::unknown;
   event_order order = event_order::ordered;
+  uint64_t jobs = 0;
+};
+
+/// The per-worker state of `read_leef _jobs=...`.
+class LeefWorker final : public LineParserWorker {
+public:
+  LeefWorker(const ReadLeefArgs& args, diagnostic_handler& dh)
+    : dh_{dh,
+          [this, loc = args.operator_location](diagnostic d) {
+            return annotate_line(std::move(d), loc, line_number_);
+          }},
+      msb_{args.msb_options, dh_} {
+  }
+
+  auto parse_line(std::string_view line, size_t line_number) -> void override {
+    line_number_ = line_number;
+    if (line.empty()) {
+      return;
+    }
+    auto d = leef::parse_line(line, msb_, quoting_);
+    if (d) {
+      dh_.emit(std::move(*d));
+    }
+  }
+
+  auto finish() -> std::vector<table_slice> override {
+    return msb_.finalize_as_table_slice();
+  }
+
+private:
+  size_t line_number_ = 0;
+  detail::quoting_escaping_policy quoting_{.unescape_operation = unescape};
+  transforming_diagnostic_handler dh_;
+  multi_series_builder msb_;
 };
 
 class ReadLeef final : public Operator<chunk_ptr, table_slice> {
@@ -315,38 +350,46 @@ public:
   }
 
   auto start(OpCtx& ctx) -> Task<void> override {
+    args_.msb_options.settings.ordered = args_.order == event_order::ordered;
+    if (args_.jobs > 0) {
+      parallel_.emplace(args_.jobs, args_.order == event_order::ordered,
+                        [args = args_](diagnostic_handler& dh)
+                          -> std::unique_ptr<LineParserWorker> {
+                          return std::make_unique<LeefWorker>(args, dh);
+                        });
+      parallel_->start(ctx);
+      co_return;
+    }
     quoting_ = detail::quoting_escaping_policy{.unescape_operation = unescape};
     dh_.emplace(std::in_place, ctx.dh(), [this](diagnostic d) {
-      if (args_.operator_location) {
-        auto replaced_unknown_location = false;
-        for (auto& annotation : d.annotations) {
-          if (annotation.source) {
-            continue;
-          }
-          annotation.source = args_.operator_location;
-          replaced_unknown_location = true;
-        }
-        if (not replaced_unknown_location and d.annotations.empty()) {
-          d.annotations.emplace(d.annotations.begin(), true, "",
-                                args_.operator_location);
-        }
-      }
-      d.notes.emplace(d.notes.begin(), diagnostic_note_kind::note,
-                      fmt::format("line {}", line_counter_));
-      return d;
+      return annotate_line(std::move(d), args_.operator_location,
+                           line_counter_);
     });
-    args_.msb_options.settings.ordered = args_.order == event_order::ordered;
     msb_ = multi_series_builder{args_.msb_options, *dh_};
     co_return;
   }
 
   auto await_task(diagnostic_handler&) const -> Task<Any> override {
+    if (parallel_) {
+      co_return co_await parallel_->next();
+    }
     co_await pusher_.wait();
     co_return {};
   }
 
-  auto process_task(Any, Push<table_slice>& push, OpCtx&)
+  auto state() -> OperatorState override {
+    if (not parallel_ or not draining_) {
+      return OperatorState::normal;
+    }
+    return parallel_->done() ? OperatorState::done : OperatorState::normal;
+  }
+
+  auto process_task(Any result, Push<table_slice>& push, OpCtx&)
     -> Task<void> override {
+    if (parallel_) {
+      co_await parallel_->handle(std::move(result), push);
+      co_return;
+    }
     TENZIR_ASSERT(msb_);
     co_await pusher_.push(msb_->yield_ready_as_table_slice(), push);
   }
@@ -354,6 +397,10 @@ public:
   auto process(chunk_ptr input, Push<table_slice>& push, OpCtx& ctx)
     -> Task<void> override {
     TENZIR_UNUSED(ctx);
+    if (parallel_) {
+      co_await parallel_->add(std::move(input));
+      co_return;
+    }
     TENZIR_ASSERT(msb_);
     auto& dh = **dh_;
     auto const* begin = reinterpret_cast<char const*>(input->data());
@@ -391,6 +438,14 @@ public:
 
   auto finalize(Push<table_slice>& push, OpCtx&)
     -> Task<FinalizeBehavior> override {
+    draining_ = true;
+    if (parallel_) {
+      if (parallel_->done()) {
+        co_return FinalizeBehavior::done;
+      }
+      co_await parallel_->finish();
+      co_return FinalizeBehavior::continue_;
+    }
     TENZIR_ASSERT(msb_);
     if (not buffer_.empty()) {
       process_line(buffer_, **dh_);
@@ -404,6 +459,10 @@ public:
 
   auto prepare_snapshot(Push<table_slice>& push, OpCtx&)
     -> Task<void> override {
+    if (parallel_) {
+      co_await parallel_->flush(push);
+      co_return;
+    }
     TENZIR_ASSERT(msb_);
     for (auto& slice : msb_->finalize_as_table_slice()) {
       co_await push(std::move(slice));
@@ -411,6 +470,10 @@ public:
   }
 
   auto snapshot(Serde& serde) -> void override {
+    if (parallel_) {
+      parallel_->snapshot(serde);
+      return;
+    }
     serde("buffer", buffer_);
     serde("ended_on_carriage_return", ended_on_carriage_return_);
     serde("line_counter", line_counter_);
@@ -437,6 +500,8 @@ private:
   Option<Box<transforming_diagnostic_handler>> dh_;
   Option<multi_series_builder> msb_;
   SeriesPusher pusher_;
+  bool draining_ = false;
+  Option<ParallelLineParser> parallel_;
 };
 
 class leef_parser final : public plugin_parser {
@@ -503,7 +568,13 @@ public:
     auto d = Describer<ReadLeefArgs, ReadLeef>{ReadLeefArgs{
       .msb_options = {.settings = {.default_schema_name = "leef.event"}},
     }};
-    d.validate(add_msb_to_describer(d, &ReadLeefArgs::msb_options));
+    auto msb = add_msb_to_describer(d, &ReadLeefArgs::msb_options);
+    auto jobs = d.named_optional("_jobs", &ReadLeefArgs::jobs);
+    d.validate([=](DescribeCtx& ctx) -> Empty {
+      msb(ctx);
+      validate_jobs(ctx, jobs);
+      return {};
+    });
     d.operator_location(&ReadLeefArgs::operator_location);
     d.optimization_order(&ReadLeefArgs::order);
     return d.without_optimize();
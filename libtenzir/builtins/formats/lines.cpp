@@ -8,6 +8,7 @@
 
 #include <tenzir/argument_parser.hpp>
 #include <tenzir/arrow_utils.hpp>
+#include <tenzir/async/parallel_lines.hpp>
 #include <tenzir/async/pusher.hpp>
 #include <tenzir/async/task.hpp>
 #include <tenzir/defaults.hpp>
@@ -318,6 +319,49 @@ struct ReadLinesArgs {
   }
 };
 
+auto add_line(std::string_view line, const ReadLinesArgs& args,
+              series_builder& builder, diagnostic_handler& dh) -> void {
+  if (line.empty() and args.skip_empty) {
+    return;
+  }
+  if (args.binary) {
+    builder.record().field("line", as_bytes(line));
+  } else {
+    if (not arrow::util::ValidateUTF8(line)) {
+      diagnostic::warning("got invalid UTF-8")
+        .hint("use `binary=true` if you are reading binary data")
+        .emit(dh);
+      return;
+    }
+    builder.record().field("line", line);
+  }
+}
+
+/// The per-worker state of `read_lines _jobs=...`.
+class LinesWorker final : public LineParserWorker {
+public:
+  LinesWorker(ReadLinesArgs args, diagnostic_handler& dh)
+    : args_{args}, dh_{dh} {
+  }
+
+  auto parse_line(std::string_view line, size_t line_number) -> void override {
+    TENZIR_UNUSED(line_number);
+    add_line(line, args_, builder_, dh_);
+  }
+
+  auto finish() -> std::vector<table_slice> override {
+    if (builder_.length() == 0) {
+      return {};
+    }
+    return builder_.finish_as_table_slice("tenzir.line");
+  }
+
+private:
+  ReadLinesArgs args_;
+  diagnostic_handler& dh_;
+  series_builder builder_;
+};
+
 /// The read_lines operator using the new async execution API.
 /// Transforms chunk_ptr input into table_slice output by splitting on newlines.
 class ReadLines final : public Operator<chunk_ptr, table_slice> {
@@ -328,18 +372,18 @@ public:
   auto start(OpCtx& ctx) -> Task<void> override {
     co_await Operator<chunk_ptr, table_slice>::start(ctx);
     if (args_.jobs > 0) {
-      auto capacity = static_cast<uint32_t>(args_.jobs * 2);
-      read_input_queue_ = std::make_shared<ReadInputQueue>(capacity);
-      read_output_queue_ = std::make_shared<ReadOutputQueue>();
-      for (auto i = uint64_t{0}; i < args_.jobs; ++i) {
-        ctx.spawn_task(read_worker_loop(ctx.dh()));
-      }
+      parallel_.emplace(args_.jobs, true,
+                        [args = args_](diagnostic_handler& dh)
+                          -> std::unique_ptr<LineParserWorker> {
+                          return std::make_unique<LinesWorker>(args, dh);
+                        });
+      parallel_->start(ctx);
     }
   }
 
   auto await_task(diagnostic_handler&) const -> Task<Any> override {
-    if (args_.jobs > 0) {
-      co_return co_await read_output_queue_->dequeue();
+    if (parallel_) {
+      co_return co_await parallel_->next();
     } else {
       co_await pusher_.wait();
       co_return {};
@@ -347,33 +391,26 @@ public:
   }
 
   auto state() -> OperatorState override {
-    if (not draining_) {
+    if (not draining_ or not parallel_) {
       return OperatorState::normal;
     }
-    return finished_workers_ == args_.jobs ? OperatorState::done
-                                           : OperatorState::normal;
+    return parallel_->done() ? OperatorState::done : OperatorState::normal;
   }
 
   auto process_task(Any result, Push<table_slice>& push, OpCtx& ctx)
     -> Task<void> override {
     TENZIR_UNUSED(ctx);
-    if (args_.jobs > 0) {
-      auto slice = std::move(result).as<table_slice>();
-      if (slice.rows() == 0) {
-        ++finished_workers_;
-        co_return;
-      }
-      co_await push(std::move(slice));
+    if (parallel_) {
+      co_await parallel_->handle(std::move(result), push);
     } else {
       co_await pusher_.push(builder_.yield_ready(TNAME), push);
-      co_return;
     }
   }
 
   auto process(chunk_ptr input, Push<table_slice>& push, OpCtx& ctx)
     -> Task<void> override {
-    if (args_.jobs > 0) {
-      co_await process_parallel(std::move(input));
+    if (parallel_) {
+      co_await parallel_->add(std::move(input));
     } else {
       process_sequential(std::move(input), ctx);
       co_await pusher_.push(builder_.yield_ready(TNAME), push);
@@ -383,23 +420,16 @@ public:
   auto finalize(Push<table_slice>& push, OpCtx& ctx)
     -> Task<FinalizeBehavior> override {
     draining_ = true;
-    if (args_.jobs > 0) {
-      if (finished_workers_ >= args_.jobs) {
+    if (parallel_) {
+      if (parallel_->done()) {
         co_return FinalizeBehavior::done;
       }
-      // Send any remaining buffered data to a worker.
-      if (not buffer_.empty()) {
-        auto batch = chunk::make(std::string{buffer_},
-                                 chunk_metadata{.content_type = "text/plain"});
-        buffer_.clear();
-        co_await read_input_queue_->enqueue(std::move(batch));
-      }
-      co_await read_input_queue_->enqueue(None{});
+      co_await parallel_->finish();
       co_return FinalizeBehavior::continue_;
     }
     // Non-parallel: emit any remaining buffered data as the final line.
     if (not buffer_.empty()) {
-      emit_line(buffer_, ctx);
+      add_line(buffer_, args_, builder_, ctx.dh());
       buffer_.clear();
     }
     co_await flush_non_parallel(push);
@@ -409,12 +439,18 @@ public:
   auto prepare_snapshot(Push<table_slice>& push, OpCtx& ctx)
     -> Task<void> override {
     TENZIR_UNUSED(ctx);
-    if (args_.jobs == 0) {
+    if (parallel_) {
+      co_await parallel_->flush(push);
+    } else {
       co_await flush_non_parallel(push);
     }
   }
 
   auto snapshot(Serde& serde) -> void override {
+    if (parallel_) {
+      parallel_->snapshot(serde);
+      return;
+    }
     serde("buffer", buffer_);
     serde("ended_on_carriage_return", ended_on_carriage_return_);
   }
@@ -426,41 +462,6 @@ private:
     }
   }
 
-  auto emit_line(std::string_view line, OpCtx& ctx) -> void {
-    if (line.empty() and args_.skip_empty) {
-      return;
-    }
-    if (args_.binary) {
-      builder_.record().field("line", as_bytes(line));
-    } else {
-      if (not arrow::util::ValidateUTF8(line)) {
-        diagnostic::warning("got invalid UTF-8")
-          .hint("use `binary=true` if you are reading binary data")
-          .emit(ctx);
-        return;
-      }
-      builder_.record().field("line", line);
-    }
-  }
-
-  auto emit_line(std::string_view line, diagnostic_handler& dh,
-                 series_builder& builder) const -> void {
-    if (line.empty() and args_.skip_empty) {
-      return;
-    }
-    if (args_.binary) {
-      builder.record().field("line", as_bytes(line));
-    } else {
-      if (not arrow::util::ValidateUTF8(line)) {
-        diagnostic::warning("got invalid UTF-8")
-          .hint("use `binary=true` if you are reading binary data")
-          .emit(dh);
-        return;
-      }
-      builder.record().field("line", line);
-    }
-  }
-
   /// Sequential (non-parallel) processing of a chunk.
   auto process_sequential(chunk_ptr input, OpCtx& ctx) -> void {
     auto const* begin = reinterpret_cast<char const*>(input->data());
@@ -482,7 +483,7 @@ private:
         buffer_.append(begin, current);
         line = buffer_;
       }
-      emit_line(line, ctx);
+      add_line(line, args_, builder_, ctx.dh());
       if (not buffer_.empty()) {
         buffer_.clear();
       }
@@ -501,163 +502,17 @@ private:
     buffer_.append(begin, end);
   }
 
-  /// Find the last newline (\n or \r) position in a string view.
-  static auto rfind_newline(std::string_view sv)
-    -> std::string_view::size_type {
-    auto pos = sv.rfind('\n');
-    if (pos == std::string_view::npos) {
-      pos = sv.rfind('\r');
-    }
-    return pos;
-  }
-
-  /// Determine the batch end accounting for \r\n pairs and set the
-  /// ended_on_carriage_return_ flag when the delimiter is a bare \r at the
-  /// very end of the available data.
-  auto batch_end_for(std::string_view data, std::string_view::size_type delim)
-    -> std::string_view::size_type {
-    auto batch_end = delim + 1;
-    if (data[delim] == '\r' and batch_end < data.size()
-        and data[batch_end] == '\n') {
-      ++batch_end;
-    } else if (data[delim] == '\r' and batch_end == data.size()) {
-      ended_on_carriage_return_ = true;
-    }
-    return batch_end;
-  }
-
-  /// Parallel processing: split at newline boundaries and dispatch to workers.
-  auto process_parallel(chunk_ptr input) -> Task<void> {
-    auto data = std::string_view{reinterpret_cast<char const*>(input->data()),
-                                 input->size()};
-    // Handle case where previous chunk ended on carriage return.
-    if (ended_on_carriage_return_ and not data.empty()
-        and data.front() == '\n') {
-      data.remove_prefix(1);
-    }
-    ended_on_carriage_return_ = false;
-    if (data.empty()) {
-      co_return;
-    }
-    // Compute offset of data within the original chunk.
-    auto offset = static_cast<size_t>(
-      data.data() - reinterpret_cast<char const*>(input->data()));
-    if (not buffer_.empty()) {
-      // Find the first newline in the new data to complete the buffered line.
-      auto first_delim = data.find('\n');
-      if (first_delim == std::string_view::npos) {
-        first_delim = data.find('\r');
-      }
-      if (first_delim == std::string_view::npos) {
-        // No newline in this chunk at all; keep accumulating.
-        buffer_.append(data);
-        co_return;
-      }
-      // Complete the buffered line with data up to the first delimiter.
-      auto first_end = first_delim + 1;
-      if (data[first_delim] == '\r' and first_end < data.size()
-          and data[first_end] == '\n') {
-        ++first_end;
-      } else if (data[first_delim] == '\r' and first_end == data.size()) {
-        ended_on_carriage_return_ = true;
-      }
-      buffer_.append(data.substr(0, first_end));
-      auto head = chunk::make(std::exchange(buffer_, {}),
-                              chunk_metadata{.content_type = "text/plain"});
-      co_await read_input_queue_->enqueue(std::move(head));
-      // Continue with the remainder of data as the fast path.
-      data.remove_prefix(first_end);
-      offset += first_end;
-      if (data.empty()) {
-        co_return;
-      }
-    }
-    // Fast path: slice the chunk directly.
-    auto last_delim = rfind_newline(data);
-    if (last_delim == std::string_view::npos) {
-      buffer_.append(data);
-      co_return;
-    }
-    auto end = batch_end_for(data, last_delim);
-    auto batch = input->slice(offset, end);
-    // Buffer the incomplete tail after the last delimiter.
-    if (end < data.size()) {
-      buffer_.append(data.substr(end));
-    }
-    co_await read_input_queue_->enqueue(std::move(batch));
-  }
-
-  /// Worker coroutine that splits lines on the CPU executor.
-  auto read_worker_loop(diagnostic_handler& dh) const -> Task<void> {
-    auto builder = series_builder{};
-    try {
-      while (true) {
-        co_await folly::coro::co_reschedule_on_current_executor;
-        auto next = co_await read_input_queue_->dequeue();
-        if (not next) {
-          // Pass the stop sentinel to the next worker.
-          co_await read_input_queue_->enqueue(None{});
-          break;
-        }
-        auto const* begin = reinterpret_cast<char const*>((*next)->data());
-        auto const* const end = begin + (*next)->size();
-        for (auto const* current = begin; current != end; ++current) {
-          if (*current != '\n' and *current != '\r') {
-            continue;
-          }
-          auto line = std::string_view{begin, current};
-          emit_line(line, dh, builder);
-          // Handle \r\n.
-          if (*current == '\r') {
-            auto const* after = current + 1;
-            if (after != end and *after == '\n') {
-              ++current;
-            }
-          }
-          begin = current + 1;
-        }
-        // Emit any trailing data (incomplete line within this chunk).
-        if (begin != end) {
-          auto line = std::string_view{begin, end};
-          emit_line(line, dh, builder);
-        }
-        // Yield ready results to the output queue.
-        if (builder.length() > 0) {
-          for (auto& slice : builder.finish_as_table_slice("tenzir.line")) {
-            read_output_queue_->enqueue(std::move(slice));
-          }
-        }
-      }
-    } catch (folly::OperationCancelled const&) {
-    }
-    // Finalize: flush remaining data.
-    if (builder.length() > 0) {
-      for (auto& slice : builder.finish_as_table_slice("tenzir.line")) {
-        read_output_queue_->enqueue(std::move(slice));
-      }
-    }
-    read_output_queue_->enqueue(table_slice{});
-  }
-
   constexpr static const auto TNAME = "tenzir.line";
 
-  using ReadInputQueue = folly::coro::BoundedQueue<Option<chunk_ptr>>;
-  /// The output queue is unbounded to avoid a theoretical deadlock where the
-  /// main thread wants to push to a full input queue while all workers want to
-  /// push to a full output queue.
-  using ReadOutputQueue = folly::coro::UnboundedQueue<table_slice>;
-
   ReadLinesArgs args_;
-  std::string buffer_;
-  bool ended_on_carriage_return_ = false;
   bool draining_ = false;
-  size_t finished_workers_ = 0;
   // Non-parallel mode state.
+  std::string buffer_;
+  bool ended_on_carriage_return_ = false;
   series_builder builder_;
   SeriesPusher pusher_;
   // Parallel mode state.
-  std::shared_ptr<ReadInputQueue> read_input_queue_;
-  std::shared_ptr<ReadOutputQueue> read_output_queue_;
+  Option<ParallelLineParser> parallel_;
 };
 
 } // namespace
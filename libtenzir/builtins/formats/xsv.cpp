@@ -16,6 +16,7 @@
 #include "tenzir/detail/string.hpp"
 #include "tenzir/detail/string_literal.hpp"
 #include "tenzir/detail/to_xsv_sep.hpp"
+#include "tenzir/detail/xsv_scanner.hpp"
 #include "tenzir/modules.hpp"
 #include "tenzir/multi_series_builder.hpp"
 #include "tenzir/multi_series_builder_argument_parser.hpp"
@@ -692,15 +693,36 @@ struct xsv_printer_impl {
   std::string_view null;
 };
 
+/// Splits lines into fields and fields into list elements.
+struct xsv_tokenizer {
+  xsv_tokenizer(const xsv_parser_options& args,
+                const detail::quoting_escaping_policy& quoting)
+    : fields{quoting, args.field_separator},
+      list_elements{quoting, args.list_separator} {
+  }
+
+  detail::xsv_scanner fields;
+  detail::xsv_scanner list_elements;
+  /// Buffers that are reused across lines to avoid allocations.
+  std::vector<detail::xsv_field> field_buffer = {};
+  std::vector<detail::xsv_field> element_buffer = {};
+};
+
 auto parse_line(std::string_view line, std::vector<std::string>& fields,
                 const size_t original_field_count, auto builder,
                 const xsv_parser_options& args, const size_t line_counter,
-                const detail::quoting_escaping_policy& quoting,
-                diagnostic_handler& dh) -> void {
+                xsv_tokenizer& tokenizer, diagnostic_handler& dh) -> void {
+  const auto& quoting = tokenizer.fields.quoting();
+  auto& values = tokenizer.field_buffer;
+  values.clear();
+  tokenizer.fields.split(line, values);
+  // A line that ends with a separator has no value after it.
+  if (values.back().text.empty()) {
+    values.pop_back();
+  }
   auto field_idx = size_t{0};
-  auto field_text = std::string_view{};
   for (field_idx = 0; true; ++field_idx) {
-    if (line.empty()) {
+    if (field_idx >= values.size()) {
       if (field_idx < original_field_count) {
         if (not args.auto_fill) {
           diagnostic::warning("{} parser found too few values in a line",
@@ -729,11 +751,13 @@ auto parse_line(std::string_view line, std::vector<std::string>& fields,
           }
         }
       } else {
+        const auto rest
+          = line.substr(values[field_idx].text.data() - line.data());
         auto excess_values = 1;
         auto it = size_t{0};
         while ((it = quoting.find_not_in_quotes(
-                  line, args.field_separator, it + args.field_separator.size()))
-               != line.npos) {
+                  rest, args.field_separator, it + args.field_separator.size()))
+               != rest.npos) {
           ++excess_values;
         }
         diagnostic::warning("{} parser skipped excess values in a line",
@@ -746,39 +770,32 @@ auto parse_line(std::string_view line, std::vector<std::string>& fields,
       }
     }
     auto field = builder.unflattened_field(fields[field_idx]);
-    if (auto split = quoting.split_at_unquoted(line, args.field_separator)) {
-      std::tie(field_text, line) = *split;
-    } else {
-      field_text = line;
-      line = std::string_view{};
-    }
-    const auto add_value
-      = [&quoting](std::string_view text, std::string_view null_value,
-                   auto& builder) {
-          if (text == null_value) {
-            builder.null();
-          } else {
-            builder.data_unparsed(quoting.unquote_unescape(text));
-          }
-        };
-    if (args.list_separator.empty()) {
-      add_value(field_text, args.null_value, field);
-    } else {
-      if (auto split
-          = quoting.split_at_unquoted(field_text, args.list_separator)) {
-        auto list = field.list();
-        // Iterate the list
-        do {
-          auto list_element_text = std::string_view{};
-          std::tie(list_element_text, field_text) = *split;
-          add_value(list_element_text, args.null_value, list);
-        } while (
-          (split = quoting.split_at_unquoted(field_text, args.list_separator)));
-        // Add the final element (for which the split would have failed)
-        add_value(field_text, args.null_value, list);
+    const auto& field_value = values[field_idx];
+    const auto add_value = [&quoting](const detail::xsv_field& token,
+                                      std::string_view null_value,
+                                      auto& builder) {
+      if (token.text == null_value) {
+        builder.null();
+      } else if (token.value) {
+        builder.data_unparsed(*token.value);
       } else {
-        add_value(field_text, args.null_value, field);
+        builder.data_unparsed(quoting.unquote_unescape(token.text));
       }
+    };
+    if (args.list_separator.empty()) {
+      add_value(field_value, args.null_value, field);
+      continue;
+    }
+    auto& elements = tokenizer.element_buffer;
+    elements.clear();
+    tokenizer.list_elements.split(field_value.text, elements);
+    if (elements.size() == 1) {
+      add_value(field_value, args.null_value, field);
+      continue;
+    }
+    auto list = field.list();
+    for (const auto& element : elements) {
+      add_value(element, args.null_value, list);
     }
   }
   for (; field_idx < fields.size(); ++field_idx) {
@@ -829,6 +846,7 @@ auto parse_loop(generator<std::optional<std::string_view>> lines,
   TENZIR_ASSERT(args.header);
   // parse the body
   const auto original_field_count = args.header->size();
+  auto tokenizer = xsv_tokenizer{args, quoting_options};
   args.builder_options.settings.default_schema_name
     = fmt::format("tenzir.{}", args.name);
   auto dh = transforming_diagnostic_handler{
@@ -862,7 +880,7 @@ auto parse_loop(generator<std::optional<std::string_view>> lines,
     }
     auto r = msb.record();
     parse_line(*line, *args.header, original_field_count, r, args, line_counter,
-               quoting_options, ctrl.diagnostics());
+               tokenizer, ctrl.diagnostics());
   }
   for (auto& v : msb.finalize_as_table_slice()) {
     co_yield std::move(v);
@@ -1011,6 +1029,7 @@ public:
       .header = {},
       .builder_options = std::move(msb_opts),
     };
+    tokenizer_.emplace(opts_, quoting_);
     // ── Eagerly evaluate the header expression if provided ───────────────────
     if (args_.header) {
       auto result = const_eval(*args_.header, ctx.dh());
@@ -1107,10 +1126,11 @@ public:
     }
     ended_on_carriage_return_ = false;
     auto now = multi_series_builder::clock::now();
-    for (const auto* current = begin; current != end; ++current) {
-      if (*current != '\n' and *current != '\r') {
-        continue;
-      }
+    static const auto line_breaks = detail::byte_set{"\r\n"};
+    const auto text = std::string_view{begin, end};
+    auto pos = size_t{0};
+    while ((pos = line_breaks.find(text, begin - text.data())) != text.npos) {
+      const auto* current = text.data() + pos;
       if (buffer_.empty()) {
         process_line({begin, current}, dh);
       } else {
@@ -1178,7 +1198,7 @@ private:
     }
     auto r = msb_->record();
     parse_line(line, *header_, *original_field_count_, r, opts_, line_counter_,
-               quoting_, dh);
+               *tokenizer_, dh);
   }
 
   ReadXsvArgs args_;
@@ -1189,6 +1209,7 @@ private:
   size_t line_counter_ = 0;
   xsv_parser_options opts_;
   detail::quoting_escaping_policy quoting_;
+  Option<xsv_tokenizer> tokenizer_;
   std::unique_ptr<transforming_diagnostic_handler> dh_;
   Option<multi_series_builder> msb_;
   SeriesPusher pusher_;
@@ -1684,7 +1705,8 @@ auto make_xsv_parsing_function(ast::expression input, xsv_parser_options opts,
   -> function_ptr {
   return function_use::make(
     [input = std::move(input), original_field_count = opts.header->size(),
-     opts = std::move(opts), quoting = std::move(quoting_options)](
+     tokenizer = xsv_tokenizer{opts, quoting_options},
+     opts = std::move(opts)](
       function_plugin::evaluator eval, session ctx) mutable {
       return map_series(eval(input), [&](series data) -> multi_series {
         if (data.type.kind().is<null_type>()) {
@@ -1704,7 +1726,7 @@ auto make_xsv_parsing_function(ast::expression input, xsv_parser_options opts,
             continue;
           }
           parse_line(*line, *opts.header, original_field_count,
-                     builder.record(), opts, 0, quoting, ctx);
+                     builder.record(), opts, 0, tokenizer, ctx);
         }
         return multi_series{builder.finalize()};
       });
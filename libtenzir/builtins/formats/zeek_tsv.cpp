@@ -7,7 +7,9 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include "tenzir/argument_parser.hpp"
+#include "tenzir/arrow_memory_pool.hpp"
 #include "tenzir/arrow_table_slice.hpp"
+#include "tenzir/arrow_utils.hpp"
 #include "tenzir/async.hpp"
 #include "tenzir/async/pusher.hpp"
 #include "tenzir/box.hpp"
@@ -20,13 +22,15 @@
 #include "tenzir/data.hpp"
 #include "tenzir/defaults.hpp"
 #include "tenzir/detail/assert.hpp"
+#include "tenzir/detail/narrow.hpp"
 #include "tenzir/detail/string.hpp"
 #include "tenzir/detail/string_literal.hpp"
 #include "tenzir/detail/to_xsv_sep.hpp"
+#include "tenzir/detail/type_traits.hpp"
 #include "tenzir/detail/zeekify.hpp"
 #include "tenzir/generator.hpp"
-#include "tenzir/modules.hpp"
 #include "tenzir/operator_plugin.hpp"
+#include "tenzir/option.hpp"
 #include "tenzir/plugin/parser.hpp"
 #include "tenzir/plugin/register.hpp"
 #include "tenzir/read_detection.hpp"
@@ -36,6 +40,7 @@
 #include "tenzir/type.hpp"
 #include "tenzir/view.hpp"
 
+#include <arrow/builder.h>
 #include <arrow/record_batch.h>
 #include <arrow/util/utf8.h>
 #include <caf/error.hpp>
@@ -111,25 +116,6 @@ struct zeek_parser<time_type> {
   }
 };
 
-template <>
-struct zeek_parser<string_type> {
-  auto operator()(const string_type&, char separator,
-                  const std::string& set_separator) const
-    -> rule<std::string_view::const_iterator, std::string> {
-    auto decode = [](std::string x) {
-      auto unescaped = detail::byte_unescape(x);
-      if (arrow::util::ValidateUTF8(unescaped)) {
-        return unescaped;
-      }
-      return detail::byte_escape(x);
-    };
-    if (set_separator.empty()) {
-      return (+(parsers::any - separator)).then(decode);
-    }
-    return (+(parsers::any - separator - set_separator)).then(decode);
-  }
-};
-
 template <>
 struct zeek_parser<ip_type> {
   auto operator()(const ip_type&, char, const std::string&) const {
@@ -144,24 +130,151 @@ struct zeek_parser<subnet_type> {
   }
 };
 
-template <>
-struct zeek_parser<list_type> {
-  auto operator()(const list_type& lt, char separator,
-                  const std::string& set_separator) const
-    -> rule<std::string_view::const_iterator, list> {
-    auto f
-      = [&]<concrete_type Type>(
-          const Type& type) -> rule<std::string_view::const_iterator, list> {
-      return (zeek_parser<Type>{}(type, separator, set_separator)
-                .then([](type_to_data_t<Type> value) {
-                  return data{value};
-                })
-              % set_separator);
-    };
-    return match(lt.value_type(), f);
+// A Zeek `string` is not necessarily valid UTF-8, but our `string_type`
+// requires it, so we keep the escape sequences of invalid strings.
+auto decode_zeek_string(std::string_view x) -> std::string {
+  auto unescaped = detail::byte_unescape(x);
+  if (arrow::util::ValidateUTF8(unescaped)) {
+    return unescaped;
   }
+  return detail::byte_escape(x);
+}
+
+/// Parses the values of one Zeek type and appends them to an Arrow builder of
+/// the corresponding Tenzir type.
+class zeek_value_parser {
+public:
+  virtual ~zeek_value_parser() = default;
+
+  /// Parses a value from the beginning of `text` and appends it to `builder`.
+  /// @returns The number of consumed bytes, or `None` if there is no value.
+  virtual auto append(std::string_view text, arrow::ArrayBuilder& builder)
+    -> Option<size_t>
+    = 0;
+
+  /// Appends the value that the `#empty_field` marker stands for.
+  virtual auto append_empty(arrow::ArrayBuilder& builder) -> void = 0;
 };
 
+template <concrete_type Type>
+class zeek_scalar_parser final : public zeek_value_parser {
+public:
+  auto append(std::string_view text, arrow::ArrayBuilder& builder)
+    -> Option<size_t> override {
+    auto f = text.begin();
+    auto value = type_to_data_t<Type>{};
+    if (not parser_(f, text.end(), value)) {
+      return None{};
+    }
+    check(append_builder(Type{}, as_builder(builder), make_view(value)));
+    return static_cast<size_t>(f - text.begin());
+  }
+
+  auto append_empty(arrow::ArrayBuilder& builder) -> void override {
+    check(append_builder(Type{}, as_builder(builder),
+                         make_view(Type::construct())));
+  }
+
+private:
+  static auto as_builder(arrow::ArrayBuilder& builder)
+    -> type_to_arrow_builder_t<Type>& {
+    return static_cast<type_to_arrow_builder_t<Type>&>(builder);
+  }
+
+  decltype(zeek_parser<Type>{}(Type{}, char{}, std::string{})) parser_
+    = zeek_parser<Type>{}(Type{}, char{}, std::string{});
+};
+
+class zeek_string_parser final : public zeek_value_parser {
+public:
+  auto append(std::string_view text, arrow::ArrayBuilder& builder)
+    -> Option<size_t> override {
+    if (text.empty()) {
+      return None{};
+    }
+    auto& string_builder = static_cast<arrow::StringBuilder&>(builder);
+    if (text.find('\\') == text.npos and arrow::util::ValidateUTF8(text)) {
+      check(string_builder.Append(text));
+    } else {
+      check(string_builder.Append(decode_zeek_string(text)));
+    }
+    return text.size();
+  }
+
+  auto append_empty(arrow::ArrayBuilder& builder) -> void override {
+    check(static_cast<arrow::StringBuilder&>(builder).Append(""));
+  }
+};
+
+class zeek_list_parser final : public zeek_value_parser {
+public:
+  zeek_list_parser(std::unique_ptr<zeek_value_parser> element,
+                   std::string set_separator)
+    : element_{std::move(element)}, set_separator_{std::move(set_separator)} {
+  }
+
+  auto append(std::string_view text, arrow::ArrayBuilder& builder)
+    -> Option<size_t> override {
+    auto& list_builder = static_cast<arrow::ListBuilder&>(builder);
+    auto& values = *list_builder.value_builder();
+    const auto offset = detail::narrow<int32_t>(values.length());
+    // A list ends at the first element that fails to parse, but it must have
+    // at least one element. We only add the list once its first element
+    // parsed, so that a rejected line leaves nothing behind. Elements never
+    // append anything when they fail.
+    auto pos = size_t{0};
+    while (true) {
+      const auto end = set_separator_.empty()
+                         ? text.size()
+                         : std::min(text.find(set_separator_, pos), text.size());
+      const auto consumed = element_->append(text.substr(pos, end - pos), values);
+      if (not consumed) {
+        if (pos == 0) {
+          return None{};
+        }
+        return pos - set_separator_.size();
+      }
+      if (pos == 0) {
+        check(list_builder.AppendValues(&offset, 1));
+      }
+      if (pos + *consumed != end or end == text.size()) {
+        return pos + *consumed;
+      }
+      pos = end + set_separator_.size();
+    }
+  }
+
+  auto append_empty(arrow::ArrayBuilder& builder) -> void override {
+    check(static_cast<arrow::ListBuilder&>(builder).Append());
+  }
+
+private:
+  std::unique_ptr<zeek_value_parser> element_;
+  std::string set_separator_;
+};
+
+auto make_zeek_value_parser(const type& t, const std::string& set_separator)
+  -> std::unique_ptr<zeek_value_parser> {
+  return match(
+    t,
+    [](const string_type&) -> std::unique_ptr<zeek_value_parser> {
+      return std::make_unique<zeek_string_parser>();
+    },
+    [&](const list_type& lt) -> std::unique_ptr<zeek_value_parser> {
+      return std::make_unique<zeek_list_parser>(
+        make_zeek_value_parser(lt.value_type(), set_separator), set_separator);
+    },
+    []<concrete_type Type>(const Type&) -> std::unique_ptr<zeek_value_parser> {
+      if constexpr (detail::is_any_v<Type, bool_type, int64_type, uint64_type,
+                                     double_type, duration_type, time_type,
+                                     ip_type, subnet_type>) {
+        return std::make_unique<zeek_scalar_parser<Type>>();
+      } else {
+        TENZIR_UNREACHABLE();
+      }
+    });
+}
+
 // Creates a Tenzir type from an ASCII Zeek type in a log header.
 auto parse_type(std::string_view zeek_type) -> caf::expected<type> {
   type t;
@@ -506,12 +619,157 @@ struct zeek_log_state {
   }
 };
 
+/// Builds the events of a Zeek log column by column, parsing every value with
+/// the parser for the type of its column from the `#types` header.
+class zeek_table_builder {
+public:
+  using clock = series_builder::clock;
+
+  zeek_table_builder(const zeek_log_state& log, diagnostic_handler& dh,
+                     size_t line_nr)
+    : separator_{log.separator},
+      empty_field_{log.empty_field},
+      unset_field_{log.unset_field} {
+    auto record_fields = std::vector<record_type::field_view>{};
+    record_fields.reserve(log.fields.size());
+    columns_.reserve(log.fields.size());
+    for (const auto& [field, zeek_type] :
+         std::views::zip(log.fields, log.types)) {
+      auto parsed_type = parse_type(zeek_type);
+      if (not parsed_type) {
+        diagnostic::warning("failed to parse Zeek type `{}`", zeek_type)
+          .note("line {}", line_nr)
+          .note("falling back to `string`")
+          .emit(dh);
+        parsed_type = type{string_type{}};
+      }
+      columns_.push_back({
+        .builder = parsed_type->make_arrow_builder(arrow_memory_pool()),
+        .parser = make_zeek_value_parser(*parsed_type, log.set_separator),
+      });
+      record_fields.push_back({field, std::move(*parsed_type)});
+    }
+    schema_ = type{fmt::format("zeek.{}", log.path),
+                   record_type{record_fields}};
+  }
+
+  /// Parses a line into a new event.
+  /// @returns Whether the line was valid.
+  auto add(std::string_view line, diagnostic_handler& dh, size_t line_nr)
+    -> bool {
+    TENZIR_ASSERT(not columns_.empty());
+    auto pos = size_t{0};
+    for (auto i = size_t{0}; i < columns_.size(); ++i) {
+      auto& column = columns_[i];
+      const auto last = i + 1 == columns_.size();
+      const auto end = std::min(line.find(separator_, pos), line.size());
+      const auto text = line.substr(pos, end - pos);
+      auto consumed = text.size();
+      if (text == unset_field_) {
+        check(column.builder->AppendNull());
+      } else if (text == empty_field_) {
+        column.parser->append_empty(*column.builder);
+      } else if (auto parsed = column.parser->append(text, *column.builder)) {
+        consumed = *parsed;
+      } else {
+        diagnostic::error("failed to parse Zeek value at index {} in `{}`", i,
+                          line)
+          .note("line {}", line_nr)
+          .emit(dh);
+        return reject();
+      }
+      if (last) {
+        if (pos + consumed != line.size()) {
+          diagnostic::warning("unparsed values at end of Zeek line: `{}`",
+                              line.substr(pos + consumed))
+            .note("line {}", line_nr)
+            .emit(dh);
+        }
+        break;
+      }
+      if (consumed != text.size() or end == line.size()) {
+        diagnostic::error("failed to parse Zeek separator at index {} in `{}`",
+                          i, line)
+          .note("line {}", line_nr)
+          .emit(dh);
+        return reject();
+      }
+      pos = end + 1;
+    }
+    ++rows_;
+    return true;
+  }
+
+  auto length() const -> int64_t {
+    return rows_;
+  }
+
+  /// Returns all events since the last call as a single table slice.
+  auto finish() -> table_slice {
+    auto arrays = arrow::ArrayVector{};
+    arrays.reserve(columns_.size());
+    for (auto& column : columns_) {
+      arrays.push_back(check(column.builder->Finish()));
+    }
+    auto batch = arrow::RecordBatch::Make(schema_.to_arrow_schema(), rows_,
+                                          std::move(arrays));
+    rows_ = 0;
+    oldest_event_ = None{};
+    return unflatten(table_slice{batch, schema_}, ".");
+  }
+
+  /// Returns the events once there are enough of them or the oldest one waited
+  /// for long enough, with the same policy as `series_builder::yield_ready`.
+  auto yield_ready(clock::time_point now = clock::now())
+    -> series_builder::YieldReadyResult {
+    if (rows_ == 0) {
+      oldest_event_ = None{};
+      return {};
+    }
+    if (rows_ >= detail::narrow_cast<int64_t>(
+                   defaults::import::table_slice_size)) {
+      return {.slices = {finish()}};
+    }
+    if (not oldest_event_) {
+      oldest_event_ = now;
+      return {.wait_for = defaults::import::batch_timeout};
+    }
+    const auto waiting = now - *oldest_event_;
+    if (waiting >= defaults::import::batch_timeout) {
+      return {.slices = {finish()}};
+    }
+    return {.wait_for = defaults::import::batch_timeout - waiting};
+  }
+
+private:
+  struct column {
+    std::shared_ptr<arrow::ArrayBuilder> builder;
+    std::unique_ptr<zeek_value_parser> parser;
+  };
+
+  /// Keeps the columns aligned after a line failed to parse halfway through.
+  auto reject() -> bool {
+    for (auto& column : columns_) {
+      if (column.builder->length() == rows_) {
+        check(column.builder->AppendNull());
+      }
+    }
+    ++rows_;
+    return false;
+  }
+
+  char separator_;
+  std::string empty_field_;
+  std::string unset_field_;
+  type schema_;
+  std::vector<column> columns_;
+  int64_t rows_ = 0;
+  Option<clock::time_point> oldest_event_ = None{};
+};
+
 struct zeek_log : zeek_log_state {
   /// A builder generated from the above metadata.
-  std::optional<series_builder> builder = {};
-  std::optional<record_ref> event = {};
-  std::vector<rule<std::string_view::const_iterator, bool>> parsers = {};
-  type target_schema = {};
+  std::optional<zeek_table_builder> builder = {};
 };
 
 auto parser_impl(generator<std::optional<std::string_view>> lines,
@@ -521,7 +779,7 @@ auto parser_impl(generator<std::optional<std::string_view>> lines,
   auto line_nr = size_t{0};
   // Helper for finishing and casting.
   auto finish = [&] {
-    return unflatten(log.builder->finish_assert_one_slice(), ".");
+    return log.builder->finish();
   };
   for (auto&& line : lines) {
     const auto now = std::chrono::steady_clock::now();
@@ -641,9 +899,7 @@ auto parser_impl(generator<std::optional<std::string_view>> lines,
     }
     // If we don't have a builder yet, then we create one lazily.
     if (not log.builder) {
-      // We parse the header into three things:
-      // 1. A schema that we create the builder with.
-      // 2. A rule that parses lines according to the schema.
+      // The header determines the schema and the parser of every column.
       if (log.path.empty()) {
         diagnostic::error("failed to parse Zeek log: missing #path")
           .note("line {}", line_nr)
@@ -665,117 +921,15 @@ auto parser_impl(generator<std::optional<std::string_view>> lines,
           .emit(ctrl.diagnostics());
         co_return;
       }
-      // Now we create the schema and the parser rule.
-      log.parsers.reserve(log.fields.size());
-      auto record_fields = std::vector<record_type::field_view>{};
-      record_fields.reserve(log.fields.size());
-      for (const auto& [field, zeek_type] :
-           std::views::zip(log.fields, log.types)) {
-        auto parsed_type = parse_type(zeek_type);
-        if (not parsed_type) {
-          diagnostic::warning("failed to parse Zeek type `{}`", zeek_type)
-            .note("line {}", line_nr)
-            .note("falling back to `string`")
-            .emit(ctrl.diagnostics());
-          parsed_type = type{string_type{}};
-        }
-        const auto make_unset_parser = [&, field]() {
-          return ignore(parsers::str{log.unset_field}
-                        >> &(parsers::chr{log.separator} | parsers::eoi))
-            .then([&, field]() {
-              log.event->field(field).null();
-              return true;
-            });
-        };
-        const auto make_empty_parser
-          = [&, field]<concrete_type Type>(const Type& type) {
-              return ignore(parsers::str{log.empty_field}
-                            >> &(parsers::chr{log.separator} | parsers::eoi))
-                .then([&, field]() {
-                  if constexpr (std::is_same_v<Type, map_type>) {
-                    TENZIR_UNREACHABLE();
-                  } else {
-                    log.event->field(field, std::move(type.construct()));
-                  }
-                  return true;
-                });
-            };
-        auto make_field_parser =
-          [&]<concrete_type Type>(
-            const Type& type) -> rule<std::string_view::const_iterator, bool> {
-          return make_unset_parser() | make_empty_parser(type)
-                 | zeek_parser<Type>{}(type, log.separator,
-                                       std::is_same_v<Type, list_type>
-                                         ? log.set_separator
-                                         : std::string{})
-                     .then([&, field](type_to_data_t<Type> value) {
-                       // TODO: A zeek `string` is not necessarily valid UTF-8,
-                       // but our `string_type` requires it. We must use `blob`
-                       // here instead of the string turns out to contain
-                       // invalid UTF-8.
-                       if constexpr (std::is_same_v<Type, map_type>) {
-                         TENZIR_UNREACHABLE();
-                       } else {
-                         log.event->field(field, std::move(value));
-                       }
-                       return true;
-                     });
-        };
-        log.parsers.push_back(match(*parsed_type, make_field_parser));
-        record_fields.push_back({field, std::move(*parsed_type)});
-      }
-      const auto schema_name = fmt::format("zeek.{}", log.path);
-      auto schema = type{schema_name, record_type{record_fields}};
-      log.builder = series_builder{std::move(schema)};
-      // If there is a schema with the exact matching name, then we set it as a
-      // target schema and use that for casting.
-      auto target_schema = modules::get_schema(schema_name);
-      log.target_schema = target_schema ? std::move(*target_schema) : type{};
+      log.builder.emplace(log, ctrl.diagnostics(), line_nr);
       // We intentionally fall through here; we create the builder lazily
       // when we encounter the first event, but that we still need to parse
       // now.
     }
-    // Lastly, we can apply our rules and parse the builder.
-    auto f = line->begin();
-    const auto l = line->end();
-    auto add_ok = false;
-    const auto separator = ignore(parsers::chr{log.separator});
-    log.event = log.builder->record();
-    for (size_t i = 0; i < log.parsers.size() - 1; ++i) {
-      const auto parse_ok = log.parsers[i](f, l, add_ok);
-      if (not parse_ok) [[unlikely]] {
-        diagnostic::error("failed to parse Zeek value at index {} in `{}`", i,
-                          *line)
-          .note("line {}", line_nr)
-          .emit(ctrl.diagnostics());
-        co_return;
-      }
-      TENZIR_ASSERT_EXPENSIVE(add_ok);
-      const auto separator_ok = separator(f, l, unused);
-      if (not separator_ok) [[unlikely]] {
-        diagnostic::error("failed to parse Zeek separator at index {} in `{}`",
-                          i, *line)
-          .note("line {}", line_nr)
-          .emit(ctrl.diagnostics());
-        co_return;
-      }
-    }
-    const auto parse_ok = log.parsers.back()(f, l, add_ok);
-    if (not parse_ok) [[unlikely]] {
-      diagnostic::error("failed to parse Zeek value at index {} in `{}`",
-                        log.parsers.size() - 1, *line)
-        .note("line {}", line_nr)
-        .emit(ctrl.diagnostics());
+    // Lastly, we can parse the line into the builder.
+    if (not log.builder->add(*line, ctrl.diagnostics(), line_nr)) {
       co_return;
     }
-    const auto eoi_ok = parsers::eoi(f, l, unused);
-    if (not eoi_ok) [[unlikely]] {
-      diagnostic::warning("unparsed values at end of Zeek line: `{}`",
-                          std::string_view{f, l})
-        .note("line {}", line_nr)
-        .emit(ctrl.diagnostics());
-    }
-    log.event = {};
   }
   if (log.builder and log.builder->length() > 0) {
     co_yield finish();
@@ -917,18 +1071,14 @@ private:
     if (not log_.builder or log_.builder->length() == 0) {
       co_return;
     }
-    co_await push(unflatten(log_.builder->finish_assert_one_slice(), "."));
+    co_await push(log_.builder->finish());
   }
 
   auto maybe_emit_ready(Push<table_slice>& push) -> Task<void> {
     if (not log_.builder) {
       co_return;
     }
-    auto result = log_.builder->yield_ready();
-    for (auto& slice : result.slices) {
-      slice = unflatten(slice, ".");
-    }
-    co_await pusher_.push(std::move(result), push);
+    co_await pusher_.push(log_.builder->yield_ready(), push);
   }
 
   auto process_line(std::string_view line, Push<table_slice>& push,
@@ -1019,52 +1169,9 @@ private:
     if (not ensure_log_builder(dh)) {
       co_return;
     }
-    auto f = line.begin();
-    auto const l = line.end();
-    auto add_ok = false;
-    auto const separator = ignore(parsers::chr{log_.separator});
-    log_.event = log_.builder->record();
-    for (auto i = size_t{0}; i < log_.parsers.size() - 1; ++i) {
-      auto const parse_ok = log_.parsers[i](f, l, add_ok);
-      if (not parse_ok) [[unlikely]] {
-        diagnostic::error("failed to parse Zeek value at index {} in `{}`", i,
-                          line)
-          .note("line {}", line_nr_)
-          .emit(dh);
-        failed_ = true;
-        log_.event = {};
-        co_return;
-      }
-      TENZIR_ASSERT_EXPENSIVE(add_ok);
-      auto const separator_ok = separator(f, l, unused);
-      if (not separator_ok) [[unlikely]] {
-        diagnostic::error("failed to parse Zeek separator at index {} in `{}`",
-                          i, line)
-          .note("line {}", line_nr_)
-          .emit(dh);
-        failed_ = true;
-        log_.event = {};
-        co_return;
-      }
-    }
-    auto const parse_ok = log_.parsers.back()(f, l, add_ok);
-    if (not parse_ok) [[unlikely]] {
-      diagnostic::error("failed to parse Zeek value at index {} in `{}`",
-                        log_.parsers.size() - 1, line)
-        .note("line {}", line_nr_)
-        .emit(dh);
+    if (not log_.builder->add(line, dh, line_nr_)) {
       failed_ = true;
-      log_.event = {};
-      co_return;
     }
-    auto const eoi_ok = parsers::eoi(f, l, unused);
-    if (not eoi_ok) [[unlikely]] {
-      diagnostic::warning("unparsed values at end of Zeek line: `{}`",
-                          std::string_view{f, l})
-        .note("line {}", line_nr_)
-        .emit(dh);
-    }
-    log_.event = {};
   }
 
   auto ensure_log_builder(diagnostic_handler& dh) -> bool {
@@ -1095,66 +1202,7 @@ private:
       failed_ = true;
       return false;
     }
-    log_.parsers.clear();
-    log_.parsers.reserve(log_.fields.size());
-    auto record_fields = std::vector<record_type::field_view>{};
-    record_fields.reserve(log_.fields.size());
-    for (auto const& [field, zeek_type] :
-         std::views::zip(log_.fields, log_.types)) {
-      auto parsed_type = parse_type(zeek_type);
-      if (not parsed_type) {
-        diagnostic::warning("failed to parse Zeek type `{}`", zeek_type)
-          .note("line {}", line_nr_)
-          .note("falling back to `string`")
-          .emit(dh);
-        parsed_type = type{string_type{}};
-      }
-      auto const make_unset_parser = [&, field]() {
-        return ignore(parsers::str{log_.unset_field}
-                      >> &(parsers::chr{log_.separator} | parsers::eoi))
-          .then([&, field]() {
-            log_.event->field(field).null();
-            return true;
-          });
-      };
-      auto const make_empty_parser
-        = [&, field]<concrete_type Type>(Type const& type) {
-            return ignore(parsers::str{log_.empty_field}
-                          >> &(parsers::chr{log_.separator} | parsers::eoi))
-              .then([&, field]() {
-                if constexpr (std::same_as<Type, map_type>) {
-                  TENZIR_UNREACHABLE();
-                } else {
-                  log_.event->field(field, std::move(type.construct()));
-                }
-                return true;
-              });
-          };
-      auto make_field_parser
-        = [&]<concrete_type Type>(
-            Type const& type) -> rule<std::string_view::const_iterator, bool> {
-        return make_unset_parser() | make_empty_parser(type)
-               | zeek_parser<Type>{}(type, log_.separator,
-                                     std::same_as<Type, list_type>
-                                       ? log_.set_separator
-                                       : std::string{})
-                   .then([&, field](type_to_data_t<Type> value) {
-                     if constexpr (std::same_as<Type, map_type>) {
-                       TENZIR_UNREACHABLE();
-                     } else {
-                       log_.event->field(field, std::move(value));
-                     }
-                     return true;
-                   });
-      };
-      log_.parsers.push_back(match(*parsed_type, make_field_parser));
-      record_fields.push_back({field, std::move(*parsed_type)});
-    }
-    auto const schema_name = fmt::format("zeek.{}", log_.path);
-    log_.builder
-      = series_builder{type{schema_name, record_type{record_fields}}};
-    auto target_schema = modules::get_schema(schema_name);
-    log_.target_schema = target_schema ? std::move(*target_schema) : type{};
+    log_.builder.emplace(log_, dh, line_nr_);
     log_has_body_ = true;
     return true;
   }
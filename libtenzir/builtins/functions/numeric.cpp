@@ -129,28 +129,53 @@ public:
   }
 };
 
+/// Patches the body of a `count_if` predicate from `left => body` to
+/// `left => body if left != null else false`, because aggregation functions do
+/// not evaluate their arguments for null values.
+auto make_null_safe(ast::lambda_expr lambda) -> ast::lambda_expr {
+  if (not lambda.is_unary()) {
+    return lambda;
+  }
+  lambda.body = ast::binary_expr{
+    ast::binary_expr{
+      lambda.body,
+      ast::binary_op::if_,
+      ast::binary_expr{
+        lambda.unary_param_as_field_path().inner(),
+        ast::binary_op::neq,
+        ast::constant{caf::none, location::unknown},
+      },
+    },
+    ast::binary_op::else_,
+    ast::constant{false, location::unknown},
+  };
+  return lambda;
+}
+
+auto save_count(int64_t count) -> chunk_ptr {
+  auto fbb = flatbuffers::FlatBufferBuilder{};
+  const auto fb_count = fbs::aggregation::CreateCount(fbb, count);
+  fbb.Finish(fb_count);
+  return chunk::make(fbb.Release());
+}
+
+auto restore_count(chunk_ptr chunk) noexcept -> std::optional<int64_t> {
+  const auto fb = flatbuffer<fbs::aggregation::Count>::make(std::move(chunk));
+  if (not fb) {
+    TENZIR_WARN(
+      "failed to restore `count` aggregation instance: invalid FlatBuffer");
+    return std::nullopt;
+  }
+  return (*fb)->result();
+}
+
 class count_instance final : public aggregation_instance {
 public:
   explicit count_instance(std::optional<ast::expression> expr,
                           std::optional<ast::lambda_expr> lambda)
-    : expr_{std::move(expr)}, lambda_{std::move(lambda)} {
-    if (lambda_ and lambda_->is_unary()) {
-      // Aggregation functions do not evaluate their arguments for null values,
-      // so we patch the lambda body from `left => body` to
-      // `left => body if left != null else false`.
-      lambda_->body = ast::binary_expr{
-        ast::binary_expr{
-          lambda_->body,
-          ast::binary_op::if_,
-          ast::binary_expr{
-            lambda_->unary_param_as_field_path().inner(),
-            ast::binary_op::neq,
-            ast::constant{caf::none, location::unknown},
-          },
-        },
-        ast::binary_op::else_,
-        ast::constant{false, location::unknown},
-      };
+    : expr_{std::move(expr)} {
+    if (lambda) {
+      lambda_ = make_null_safe(std::move(*lambda));
     }
   }
 
@@ -185,20 +210,24 @@ public:
   }
 
   auto save() const -> chunk_ptr override {
-    auto fbb = flatbuffers::FlatBufferBuilder{};
-    const auto fb_count = fbs::aggregation::CreateCount(fbb, count_);
-    fbb.Finish(fb_count);
-    return chunk::make(fbb.Release());
+    return save_count(count_);
   }
 
   auto restore(chunk_ptr chunk) noexcept -> bool override {
-    const auto fb = flatbuffer<fbs::aggregation::Count>::make(std::move(chunk));
-    if (not fb) {
-      TENZIR_WARN(
-        "failed to restore `count` aggregation instance: invalid FlatBuffer");
+    auto count = restore_count(std::move(chunk));
+    if (not count) {
+      return false;
+    }
+    count_ = *count;
+    return true;
+  }
+
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto count = restore_count(std::move(partial));
+    if (not count) {
       return false;
     }
-    count_ = (*fb)->result();
+    count_ += *count;
     return true;
   }
 
@@ -212,6 +241,107 @@ private:
   int64_t count_ = 0;
 };
 
+class grouped_count_instance final : public grouped_aggregation_instance {
+public:
+  explicit grouped_count_instance(std::optional<ast::expression> expr,
+                                  std::optional<ast::lambda_expr> lambda)
+    : expr_{std::move(expr)} {
+    if (lambda) {
+      lambda_ = make_null_safe(std::move(*lambda));
+    }
+  }
+
+  void update(const table_slice& input, std::span<const uint32_t> groups,
+              session ctx) override {
+    TENZIR_ASSERT(groups.size() == input.rows());
+    const auto subject
+      = expr_ ? eval(*expr_, input, ctx) : multi_series{series{input}};
+    auto offset = size_t{0};
+    if (not lambda_) {
+      for (const auto& part : subject) {
+        const auto length = detail::narrow<size_t>(part.length());
+        const auto part_groups = groups.subspan(offset, length);
+        offset += length;
+        if (part.array->null_count() == 0) {
+          for (auto group : part_groups) {
+            counts_[group] += 1;
+          }
+          continue;
+        }
+        for (auto i = size_t{0}; i < length; ++i) {
+          if (part.array->IsValid(detail::narrow<int64_t>(i))) {
+            counts_[part_groups[i]] += 1;
+          }
+        }
+      }
+      return;
+    }
+    for (const auto& pred : eval(*lambda_, subject, ctx)) {
+      const auto length = detail::narrow<size_t>(pred.length());
+      const auto part_groups = groups.subspan(offset, length);
+      offset += length;
+      const auto typed_pred = pred.as<bool_type>();
+      if (not typed_pred) {
+        diagnostic::warning("expected `bool`, got `{}`", pred.type.kind())
+          .primary(lambda_->body)
+          .emit(ctx);
+        continue;
+      }
+      if (typed_pred->array->null_count() > 0) {
+        diagnostic::warning("expected `bool`, got `null`")
+          .primary(lambda_->body)
+          .emit(ctx);
+      }
+      const auto& array = *typed_pred->array;
+      for (auto i = size_t{0}; i < length; ++i) {
+        const auto row = detail::narrow<int64_t>(i);
+        if (array.IsValid(row) and array.Value(row)) {
+          counts_[part_groups[i]] += 1;
+        }
+      }
+    }
+  }
+
+  auto get(uint32_t group) const -> data override {
+    return counts_[group];
+  }
+
+  auto size() const -> size_t override {
+    return counts_.size();
+  }
+
+  auto resize(size_t groups) -> void override {
+    counts_.resize(groups);
+  }
+
+  auto save(uint32_t group) const -> chunk_ptr override {
+    return save_count(counts_[group]);
+  }
+
+  auto restore(uint32_t group, chunk_ptr chunk) noexcept -> bool override {
+    auto count = restore_count(std::move(chunk));
+    if (not count) {
+      return false;
+    }
+    counts_[group] = *count;
+    return true;
+  }
+
+  auto merge(uint32_t group, chunk_ptr partial) noexcept -> bool override {
+    auto count = restore_count(std::move(partial));
+    if (not count) {
+      return false;
+    }
+    counts_[group] += *count;
+    return true;
+  }
+
+private:
+  std::optional<ast::expression> expr_;
+  std::optional<ast::lambda_expr> lambda_;
+  std::vector<int64_t> counts_;
+};
+
 class count final : public aggregation_plugin {
 public:
   auto name() const -> std::string override {
@@ -230,6 +360,16 @@ public:
           .parse(inv, ctx));
     return std::make_unique<count_instance>(std::move(expr), std::nullopt);
   }
+
+  auto make_grouped_aggregation(function_invocation inv, session ctx) const
+    -> failure_or<std::unique_ptr<grouped_aggregation_instance>> override {
+    auto expr = std::optional<ast::expression>{};
+    TRY(argument_parser2::function("count")
+          .positional("x", expr, "any")
+          .parse(inv, ctx));
+    return std::make_unique<grouped_count_instance>(std::move(expr),
+                                                    std::nullopt);
+  }
 };
 
 class count_if final : public aggregation_plugin {
@@ -244,6 +384,21 @@ public:
 
   auto make_aggregation(function_invocation inv, session ctx) const
     -> failure_or<std::unique_ptr<aggregation_instance>> override {
+    TRY(auto args, parse(std::move(inv), ctx));
+    return std::make_unique<count_instance>(std::move(args.first),
+                                            std::move(args.second));
+  }
+
+  auto make_grouped_aggregation(function_invocation inv, session ctx) const
+    -> failure_or<std::unique_ptr<grouped_aggregation_instance>> override {
+    TRY(auto args, parse(std::move(inv), ctx));
+    return std::make_unique<grouped_count_instance>(std::move(args.first),
+                                                    std::move(args.second));
+  }
+
+private:
+  static auto parse(function_invocation inv, session ctx)
+    -> failure_or<std::pair<ast::expression, ast::lambda_expr>> {
     auto expr = ast::expression{};
     auto lambda = ast::lambda_expr{};
     TRY(argument_parser2::function("count_if")
@@ -257,7 +412,7 @@ public:
         .emit(ctx);
       return failure::promise();
     }
-    return std::make_unique<count_instance>(std::move(expr), std::move(lambda));
+    return std::pair{std::move(expr), std::move(lambda)};
   }
 };
 
@@ -265,7 +420,11 @@ class quantile_instance final : public aggregation_instance {
 public:
   quantile_instance(ast::expression expr, double quantile, uint32_t delta,
                     uint32_t buffer_size)
-    : expr_{std::move(expr)}, quantile_{quantile}, digest_{delta, buffer_size} {
+    : expr_{std::move(expr)},
+      quantile_{quantile},
+      delta_{delta},
+      buffer_size_{buffer_size},
+      digest_{delta, buffer_size} {
   }
 
   void update(const table_slice& input, session ctx) override {
@@ -340,14 +499,89 @@ public:
   }
 
   auto save() const -> chunk_ptr override {
-    return {};
+    auto fbb = flatbuffers::FlatBufferBuilder{};
+    const auto fb_state = [&] {
+      switch (state_) {
+        case state::none:
+          return fbs::aggregation::QuantileState::None;
+        case state::failed:
+          return fbs::aggregation::QuantileState::Failed;
+        case state::dur:
+          return fbs::aggregation::QuantileState::Duration;
+        case state::numeric:
+          return fbs::aggregation::QuantileState::Numeric;
+      }
+      TENZIR_UNREACHABLE();
+    }();
+    const auto digest = digest_.save();
+    const auto fb_means = fbb.CreateVector(digest.means);
+    const auto fb_weights = fbb.CreateVector(digest.weights);
+    const auto fb_quantile = fbs::aggregation::CreateQuantile(
+      fbb, fb_state, fb_means, fb_weights, digest.min, digest.max);
+    fbb.Finish(fb_quantile);
+    return chunk::make(fbb.Release());
   }
 
   auto restore(chunk_ptr chunk) noexcept -> bool override {
-    TENZIR_UNUSED(chunk);
-    TENZIR_WARN("restoring `quantile` aggregation instance from snapshot is "
-                "not yet implemented");
-    return false;
+    const auto fb
+      = flatbuffer<fbs::aggregation::Quantile>::make(std::move(chunk));
+    if (not fb) {
+      TENZIR_WARN("failed to restore `quantile` aggregation instance: invalid "
+                  "FlatBuffer");
+      return false;
+    }
+    const auto* fb_means = (*fb)->means();
+    const auto* fb_weights = (*fb)->weights();
+    if (not fb_means or not fb_weights
+        or fb_means->size() != fb_weights->size()) {
+      TENZIR_WARN("failed to restore `quantile` aggregation instance: invalid "
+                  "fields `means` and `weights`");
+      return false;
+    }
+    switch ((*fb)->state()) {
+      case fbs::aggregation::QuantileState::None:
+        state_ = state::none;
+        break;
+      case fbs::aggregation::QuantileState::Failed:
+        state_ = state::failed;
+        break;
+      case fbs::aggregation::QuantileState::Duration:
+        state_ = state::dur;
+        break;
+      case fbs::aggregation::QuantileState::Numeric:
+        state_ = state::numeric;
+        break;
+      default:
+        TENZIR_WARN("failed to restore `quantile` aggregation instance: "
+                    "unknown state value");
+        return false;
+    }
+    digest_.load({
+      .means = {fb_means->begin(), fb_means->end()},
+      .weights = {fb_weights->begin(), fb_weights->end()},
+      .min = (*fb)->min(),
+      .max = (*fb)->max(),
+    });
+    return true;
+  }
+
+  auto merge(chunk_ptr partial) noexcept -> bool override {
+    auto other = quantile_instance{expr_, quantile_, delta_, buffer_size_};
+    if (not other.restore(std::move(partial))) {
+      return false;
+    }
+    if (other.state_ == state::none) {
+      return true;
+    }
+    if (state_ == state::none) {
+      state_ = other.state_;
+    } else if (state_ != other.state_) {
+      state_ = state::failed;
+    }
+    if (state_ != state::failed) {
+      digest_.merge(other.digest_);
+    }
+    return true;
   }
 
   auto reset() -> void override {
@@ -359,6 +593,8 @@ public:
 private:
   ast::expression expr_;
   double quantile_;
+  uint32_t delta_;
+  uint32_t buffer_size_;
   enum class state { none, failed, dur, numeric } state_{};
   detail::tdigest digest_;
 };
@@ -208,6 +208,10 @@ public:
     serde("done", done_);
   }
 
+  auto resumable() const -> bool override {
+    return true;
+  }
+
 private:
   ApiArgs args_;
   std::string request_body_ = "{}";
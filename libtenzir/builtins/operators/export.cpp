@@ -68,6 +68,8 @@ struct ExportArgs {
   bool high_priority = true;
   /// The filter pushed down by `describer.optimize_filter`.
   ir::optimize_filter filter;
+  /// The ordering that downstream operators require.
+  event_order order = event_order::ordered;
   /// Setting for a special filter added by the `diagnostics` or `metrics`
   /// operators.
   export_special_filter special_filter;
@@ -224,7 +226,8 @@ public:
                   : expression{conjunction{std::move(legacy_clauses)}};
     auto mode
       = export_mode{args_.live ? args_.retro : true, args_.live, args_.internal,
-                    args_.parallel, args_.high_priority};
+                    args_.parallel, args_.high_priority,
+                    args_.order == event_order::ordered};
     auto result
       = co_await async_mail(atom::spawn_v, std::move(expr), mode).request(*node);
     if (not result) {
@@ -448,7 +451,8 @@ public:
 
   auto optimize(expression const& filter, event_order order) const
     -> optimize_result override {
-    (void)order;
+    auto mode = mode_;
+    mode.ordered = order == event_order::ordered;
     auto clauses = std::vector<expression>{};
     if (expr_ != caf::none and expr_ != trivially_true_expression()) {
       clauses.push_back(expr_);
@@ -462,7 +466,7 @@ public:
                                          : conjunction{std::move(clauses)});
     return optimize_result{trivially_true_expression(), event_order::ordered,
                            std::make_unique<export_operator>(std::move(expr),
-                                                             mode_)};
+                                                             mode)};
   }
 
   friend auto inspect(auto& f, export_operator& x) -> bool {
@@ -503,6 +507,7 @@ public:
       }
       return {};
     });
+    d.optimization_order(&ExportArgs::order);
     return d.optimize_filter(&ExportArgs::filter);
   }
 
@@ -605,6 +610,7 @@ public:
       }
       return {};
     });
+    d.optimization_order(&ExportArgs::order);
     return d.optimize_filter(&ExportArgs::filter);
   }
 
@@ -718,6 +724,7 @@ public:
       }
       return {};
     });
+    d.optimization_order(&ExportArgs::order);
     return d.optimize_filter(&ExportArgs::filter);
   }
 
@@ -126,6 +126,10 @@ public:
     serde("done", done_);
   }
 
+  auto resumable() const -> bool override {
+    return true;
+  }
+
 private:
   FieldsArgs args_;
   catalog_actor catalog_ = {};
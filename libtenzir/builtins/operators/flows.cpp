@@ -0,0 +1,507 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <tenzir/argument_parser2.hpp>
+#include <tenzir/arrow_table_slice.hpp>
+#include <tenzir/async.hpp>
+#include <tenzir/async/notify.hpp>
+#include <tenzir/async/task.hpp>
+#include <tenzir/community_id.hpp>
+#include <tenzir/defaults.hpp>
+#include <tenzir/detail/packet_headers.hpp>
+#include <tenzir/flow_table.hpp>
+#include <tenzir/frame_type.hpp>
+#include <tenzir/operator_plugin.hpp>
+#include <tenzir/plugin.hpp>
+#include <tenzir/series_builder.hpp>
+#include <tenzir/tql2/plugin.hpp>
+
+#include <arrow/array.h>
+
+#include <chrono>
+
+namespace tenzir::plugins::flows {
+
+namespace {
+
+using detail::ethernet_frame;
+using detail::packet;
+using detail::segment;
+using detail::sll2_frame;
+using std::chrono::steady_clock;
+
+constexpr auto ipproto_icmpv6 = uint8_t{58};
+
+struct FlowsArgs {
+  duration idle_timeout = flow_table_options{}.idle_timeout;
+  duration active_timeout = flow_table_options{}.active_timeout;
+
+  friend auto inspect(auto& f, FlowsArgs& x) -> bool {
+    return f.object(x).fields(f.field("idle_timeout", x.idle_timeout),
+                              f.field("active_timeout", x.active_timeout));
+  }
+};
+
+auto output_type() -> const type& {
+  static const auto result = type{
+    "tenzir.flow",
+    record_type{
+      {"community_id", string_type{}},
+      {"src_ip", ip_type{}},
+      {"src_port", uint64_type{}},
+      {"dst_ip", ip_type{}},
+      {"dst_port", uint64_type{}},
+      {"protocol", uint64_type{}},
+      {"start", time_type{}},
+      {"end", time_type{}},
+      {"src_packets", uint64_type{}},
+      {"src_bytes", uint64_type{}},
+      {"dst_packets", uint64_type{}},
+      {"dst_bytes", uint64_type{}},
+      {"tcp_flags", uint64_type{}},
+      {"end_reason", string_type{}},
+    },
+  };
+  return result;
+}
+
+/// A packet that we account to a flow.
+struct flow_packet {
+  flow id;
+  uint64_t bytes = 0;
+  uint8_t tcp_flags = 0;
+};
+
+/// Extracts the flow of a packet, or returns `std::nullopt` for packets that
+/// are not IP.
+auto parse(std::span<const std::byte> bytes, uint64_t wire_length,
+           frame_type type) -> std::optional<flow_packet> {
+  auto payload = std::span<const std::byte>{};
+  auto ether = ether_type::invalid;
+  switch (type) {
+    default:
+      return std::nullopt;
+    case frame_type::ethernet: {
+      auto frame = ethernet_frame::make(bytes);
+      if (not frame) {
+        return std::nullopt;
+      }
+      payload = frame->payload;
+      ether = frame->type;
+      break;
+    }
+    case frame_type::sll2: {
+      auto frame = sll2_frame::make(bytes);
+      if (not frame) {
+        return std::nullopt;
+      }
+      payload = frame->payload;
+      ether = frame->type;
+      break;
+    }
+  }
+  auto ip_packet = packet::make(payload, ether);
+  if (not ip_packet) {
+    return std::nullopt;
+  }
+  // We count bytes at the IP layer, where both directions and all link types
+  // are comparable. The wire length may exceed the captured bytes.
+  const auto link_header_size = bytes.size() - payload.size();
+  auto result = flow_packet{};
+  result.bytes = wire_length > link_header_size ? wire_length - link_header_size
+                                                : 0;
+  auto src_port = uint16_t{0};
+  auto dst_port = uint16_t{0};
+  auto proto = static_cast<port_type>(ip_packet->type);
+  // Fragments other than the first carry no ports, so they form a flow of
+  // their own between the two hosts.
+  if (not ip_packet->is_fragment) {
+    if (auto seg = segment::make(ip_packet->payload, ip_packet->type)) {
+      src_port = seg->src;
+      dst_port = seg->dst;
+      result.tcp_flags = seg->tcp_flags;
+    } else if (ip_packet->type == ipproto_icmpv6
+               and ip_packet->payload.size() >= 4) {
+      // ICMPv6 needs type and code to pair requests with their replies.
+      src_port = std::to_integer<uint8_t>(ip_packet->payload[0]);
+      dst_port = std::to_integer<uint8_t>(ip_packet->payload[1]);
+    }
+  }
+  result.id
+    = make_flow(ip_packet->src, ip_packet->dst, src_port, dst_port, proto);
+  return result;
+}
+
+auto has_ports(port_type x) -> bool {
+  switch (x) {
+    case port_type::icmp:
+    case port_type::tcp:
+    case port_type::udp:
+    case port_type::icmp6:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// Turns a stream of `pcap.packet` events into flow records.
+class flow_tracker {
+public:
+  explicit flow_tracker(const FlowsArgs& args)
+    : table_{flow_table_options{
+        .idle_timeout = args.idle_timeout,
+        .active_timeout = args.active_timeout,
+      }} {
+  }
+
+  /// Accounts all packets of a slice.
+  auto add(const table_slice& slice, diagnostic_handler& dh) -> void {
+    last_input_ = steady_clock::now();
+    live_ = false;
+    const auto batch = to_record_batch(slice);
+    arrays_.clear();
+    const auto* linktypes
+      = column<arrow::UInt64Array>(slice, *batch, "linktype", "uint64", dh);
+    const auto* timestamps
+      = column<arrow::TimestampArray>(slice, *batch, "timestamp", "time", dh);
+    const auto* lengths = column<arrow::UInt64Array>(
+      slice, *batch, "original_packet_length", "uint64", dh);
+    const auto* data
+      = column<arrow::BinaryArray>(slice, *batch, "data", "blob", dh);
+    if (not linktypes or not timestamps or not lengths or not data) {
+      return;
+    }
+    for (auto i = int64_t{0}; i < batch->num_rows(); ++i) {
+      if (timestamps->IsNull(i) or data->IsNull(i)) {
+        continue;
+      }
+      const auto bytes = as_bytes(data->GetView(i));
+      const auto wire_length = lengths->IsNull(i) ? bytes.size()
+                                                  : lengths->Value(i);
+      const auto linktype = linktypes->IsNull(i) ? 0 : linktypes->Value(i);
+      auto p = parse(bytes, wire_length, static_cast<frame_type>(linktype));
+      if (not p) {
+        continue;
+      }
+      const auto ts = time{duration{timestamps->Value(i)}};
+      table_.add(p->id, ts, p->bytes, p->tcp_flags, records_);
+    }
+    const auto lag = time::clock::now() - table_.now();
+    live_ = lag < live_tolerance and lag > -live_tolerance;
+  }
+
+  /// Lets the time of the flow table pass along with the wall clock while we
+  /// receive no packets, so that flows of a quiet live capture still expire.
+  ///
+  /// This mixes wall-clock time into packet time, so we only do it when the
+  /// latest packets were live, i.e., their timestamps were close to the wall
+  /// clock when they arrived. Replaying a recorded capture thus stays
+  /// deterministic, regardless of how long the input stalls.
+  auto advance(steady_clock::time_point now) -> void {
+    if (not live_ or table_.size() == 0
+        or now - last_input_ < std::chrono::seconds{1}) {
+      return;
+    }
+    table_.advance(table_.now() + (now - last_input_), records_);
+    last_input_ = now;
+  }
+
+  auto flush() -> void {
+    table_.flush(records_);
+  }
+
+  /// Returns whether there are flows that we track or have yet to emit.
+  auto busy() const -> bool {
+    return table_.size() > 0 or not records_.empty();
+  }
+
+  /// Returns the expired flows as events once we have a full batch, the
+  /// batch timeout passed, or `force` is set.
+  auto take(bool force) -> std::vector<table_slice> {
+    const auto now = steady_clock::now();
+    if (records_.empty()) {
+      last_output_ = now;
+      return {};
+    }
+    if (not force and records_.size() < defaults::import::table_slice_size
+        and now - last_output_ < defaults::import::batch_timeout) {
+      return {};
+    }
+    last_output_ = now;
+    auto result = std::vector<table_slice>{};
+    auto builder = series_builder{output_type()};
+    for (const auto& r : records_) {
+      append(builder, r);
+      if (builder.length()
+          == static_cast<int64_t>(defaults::import::table_slice_size)) {
+        result.push_back(builder.finish_assert_one_slice());
+      }
+    }
+    if (builder.length() > 0) {
+      result.push_back(builder.finish_assert_one_slice());
+    }
+    records_.clear();
+    return result;
+  }
+
+  /// Serializes the flow table. The caller must take all expired flows first.
+  friend auto inspect(auto& f, flow_tracker& x) -> bool {
+    TENZIR_ASSERT(x.records_.empty());
+    return f.object(x).fields(f.field("table", x.table_),
+                              f.field("live", x.live_));
+  }
+
+private:
+  /// How far the timestamps of live packets may be off the wall clock.
+  static constexpr auto live_tolerance = duration{std::chrono::minutes{1}};
+
+  /// Returns a column of the input, or `nullptr` if it is missing or has the
+  /// wrong type.
+  template <class Array>
+  auto column(const table_slice& slice, const arrow::RecordBatch& batch,
+              std::string_view name, std::string_view expected,
+              diagnostic_handler& dh) -> const Array* {
+    auto index = as<record_type>(slice.schema()).resolve_key(name);
+    if (not index) {
+      warn(fmt::format("schema `{}` must have a `{}` field", slice.schema(),
+                       name),
+           dh);
+      return nullptr;
+    }
+    auto array = index->get(batch);
+    const auto* result = try_as<Array>(&*array);
+    if (not result) {
+      warn(fmt::format("field `{}` must be of type `{}`", name, expected), dh);
+      return nullptr;
+    }
+    // Keeps nested arrays alive until we processed the slice.
+    arrays_.push_back(std::move(array));
+    return result;
+  }
+
+  auto warn(std::string note, diagnostic_handler& dh) -> void {
+    if (warned_) {
+      return;
+    }
+    warned_ = true;
+    diagnostic::warning("got a malformed `pcap.packet` event")
+      .note("{}", note)
+      .emit(dh);
+  }
+
+  static auto append(series_builder& builder, const flow_record& r) -> void {
+    const auto proto = protocol(r.id);
+    auto event = builder.record();
+    if (has_ports(proto)) {
+      event.field("community_id").data(community_id::make(r.id));
+      event.field("src_port").data(uint64_t{r.id.src_port.number()});
+      event.field("dst_port").data(uint64_t{r.id.dst_port.number()});
+    } else {
+      event.field("community_id")
+        .data(community_id::make(r.id.src_addr, r.id.dst_addr, proto));
+    }
+    event.field("src_ip").data(r.id.src_addr);
+    event.field("dst_ip").data(r.id.dst_addr);
+    event.field("protocol").data(static_cast<uint64_t>(proto));
+    event.field("start").data(r.start);
+    event.field("end").data(r.end);
+    event.field("src_packets").data(r.src_packets);
+    event.field("src_bytes").data(r.src_bytes);
+    event.field("dst_packets").data(r.dst_packets);
+    event.field("dst_bytes").data(r.dst_bytes);
+    if (proto == port_type::tcp) {
+      event.field("tcp_flags").data(uint64_t{r.tcp_flags});
+    }
+    event.field("end_reason").data(to_string(r.reason));
+  }
+
+  flow_table table_;
+  std::vector<flow_record> records_;
+  std::vector<std::shared_ptr<arrow::Array>> arrays_;
+  steady_clock::time_point last_input_ = steady_clock::now();
+  steady_clock::time_point last_output_ = steady_clock::now();
+  /// Whether the timestamps of the latest packets were close to the wall
+  /// clock.
+  bool live_ = false;
+  bool warned_ = false;
+};
+
+class flows_operator final : public crtp_operator<flows_operator> {
+public:
+  flows_operator() = default;
+
+  explicit flows_operator(FlowsArgs args) : args_{args} {
+  }
+
+  auto
+  operator()(generator<table_slice> input, operator_control_plane& ctrl) const
+    -> generator<table_slice> {
+    auto tracker = flow_tracker{args_};
+    for (auto&& slice : input) {
+      if (slice.rows() == 0) {
+        tracker.advance(steady_clock::now());
+      } else {
+        tracker.add(slice, ctrl.diagnostics());
+      }
+      auto output = tracker.take(false);
+      if (output.empty()) {
+        co_yield {};
+        continue;
+      }
+      for (auto& x : output) {
+        co_yield std::move(x);
+      }
+    }
+    tracker.flush();
+    for (auto& x : tracker.take(true)) {
+      co_yield std::move(x);
+    }
+  }
+
+  auto name() const -> std::string override {
+    return "flows";
+  }
+
+  auto optimize(const expression& filter, event_order order) const
+    -> optimize_result override {
+    TENZIR_UNUSED(filter, order);
+    return do_not_optimize(*this);
+  }
+
+  friend auto inspect(auto& f, flows_operator& x) -> bool {
+    return f.apply(x.args_);
+  }
+
+private:
+  FlowsArgs args_;
+};
+
+class Flows final : public Operator<table_slice, table_slice> {
+public:
+  explicit Flows(FlowsArgs args) : tracker_{args} {
+  }
+
+  auto process(table_slice input, Push<table_slice>& push, OpCtx& ctx)
+    -> Task<void> override {
+    const auto was_busy = tracker_.busy();
+    tracker_.add(input, ctx);
+    co_await emit(push, false);
+    if (not was_busy and tracker_.busy()) {
+      busy_->notify_one();
+    }
+  }
+
+  auto await_task(diagnostic_handler& dh) const -> Task<Any> override {
+    TENZIR_UNUSED(dh);
+    if (not tracker_.busy()) {
+      co_await busy_->wait();
+    }
+    co_await sleep_for(std::chrono::seconds{1});
+    co_return {};
+  }
+
+  auto process_task(Any result, Push<table_slice>& push, OpCtx& ctx)
+    -> Task<void> override {
+    TENZIR_UNUSED(result, ctx);
+    tracker_.advance(steady_clock::now());
+    co_await emit(push, false);
+  }
+
+  auto finalize(Push<table_slice>& push, OpCtx& ctx)
+    -> Task<FinalizeBehavior> override {
+    TENZIR_UNUSED(ctx);
+    tracker_.flush();
+    co_await emit(push, true);
+    co_return FinalizeBehavior::done;
+  }
+
+  auto prepare_snapshot(Push<table_slice>& push, OpCtx& ctx)
+    -> Task<void> override {
+    TENZIR_UNUSED(ctx);
+    // Flows that already expired are emitted before the checkpoint, so that
+    // the snapshot only needs to cover the flows that we still track.
+    co_await emit(push, true);
+  }
+
+  auto snapshot(Serde& serde) -> void override {
+    serde("tracker", tracker_);
+  }
+
+private:
+  auto emit(Push<table_slice>& push, bool force) -> Task<void> {
+    for (auto& x : tracker_.take(force)) {
+      co_await push(std::move(x));
+    }
+  }
+
+  flow_tracker tracker_;
+  mutable std::unique_ptr<Notify> busy_ = std::make_unique<Notify>();
+};
+
+auto validate_timeout(const Option<located<duration>>& x,
+                      diagnostic_handler& dh) -> bool {
+  if (x and x->inner <= duration::zero()) {
+    diagnostic::error("timeout must be a positive duration")
+      .primary(x->source)
+      .emit(dh);
+    return false;
+  }
+  return true;
+}
+
+class Plugin final : public operator_plugin2<flows_operator>,
+                     public virtual OperatorPlugin {
+public:
+  auto make(operator_factory_invocation inv, session ctx) const
+    -> failure_or<operator_ptr> override {
+    auto idle_timeout = Option<located<duration>>{};
+    auto active_timeout = Option<located<duration>>{};
+    TRY(argument_parser2::operator_("flows")
+          .named("idle_timeout", idle_timeout)
+          .named("active_timeout", active_timeout)
+          .parse(inv, ctx));
+    auto valid = validate_timeout(idle_timeout, ctx);
+    valid = validate_timeout(active_timeout, ctx) and valid;
+    if (not valid) {
+      return failure::promise();
+    }
+    auto args = FlowsArgs{};
+    if (idle_timeout) {
+      args.idle_timeout = idle_timeout->inner;
+    }
+    if (active_timeout) {
+      args.active_timeout = active_timeout->inner;
+    }
+    return std::make_unique<flows_operator>(args);
+  }
+
+  auto describe() const -> Description override {
+    auto d = Describer<FlowsArgs, Flows>{};
+    auto idle_timeout
+      = d.named_optional("idle_timeout", &FlowsArgs::idle_timeout);
+    auto active_timeout
+      = d.named_optional("active_timeout", &FlowsArgs::active_timeout);
+    d.validate([=](DescribeCtx& ctx) -> Empty {
+      for (auto arg : {idle_timeout, active_timeout}) {
+        if (auto value = ctx.get(arg); value and *value <= duration::zero()) {
+          diagnostic::error("timeout must be a positive duration")
+            .primary(ctx.get_location(arg).value())
+            .emit(ctx);
+        }
+      }
+      return {};
+    });
+    return d.without_optimize();
+  }
+};
+
+} // namespace
+
+} // namespace tenzir::plugins::flows
+
+TENZIR_REGISTER_PLUGIN(tenzir::plugins::flows::Plugin)
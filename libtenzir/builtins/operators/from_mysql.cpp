@@ -17,7 +17,9 @@
 #include <tenzir/pipeline_metrics.hpp>
 #include <tenzir/plugin.hpp>
 #include <tenzir/series_builder.hpp>
+#include <tenzir/sql_filter.hpp>
 #include <tenzir/tls_options.hpp>
+#include <tenzir/tql2/filter.hpp>
 #include <tenzir/tql2/plugin.hpp>
 #include <tenzir/try.hpp>
 
@@ -1405,6 +1407,27 @@ auto parse_first_optional_int64(std::vector<result_row> const& rows)
   return parse_optional_int64(cell);
 }
 
+/// Returns the kind of a column for translating filters from its
+/// `information_schema.columns.data_type`. We leave out types whose values do
+/// not compare the same way after conversion, e.g., `float` and `decimal`,
+/// which we read as `double`.
+auto column_kind(std::string_view data_type) -> std::optional<sql_column_kind> {
+  if (data_type == "tinyint" or data_type == "smallint"
+      or data_type == "mediumint" or data_type == "int"
+      or data_type == "bigint") {
+    return sql_column_kind::integer;
+  }
+  if (data_type == "double") {
+    return sql_column_kind::floating_point;
+  }
+  if (data_type == "char" or data_type == "varchar" or data_type == "tinytext"
+      or data_type == "text" or data_type == "mediumtext"
+      or data_type == "longtext") {
+    return sql_column_kind::string;
+  }
+  return std::nullopt;
+}
+
 /// Parse a row packet into a series_builder.
 void parse_row_into_builder(std::span<std::byte const> data,
                             std::vector<column_info> const& cols,
@@ -1717,6 +1740,10 @@ struct FromMySQLArgs {
   Option<located<bool>> live;
   Option<located<std::string>> tracking_column;
   Option<located<data>> tls;
+  /// The filter pushed down by `describer.optimize_filter`.
+  ir::optimize_filter filter;
+  /// The limit of the operator directly downstream.
+  Option<ir::Limit> limit;
 };
 
 class FromMySQL final : public Operator<void, table_slice> {
@@ -1749,6 +1776,55 @@ private:
     has_client_ = false;
   }
 
+  /// Moves as much of the filter and the limit into the query for a table as
+  /// possible. The limit only moves if the entire filter does.
+  auto push_down() -> Task<void> {
+    TENZIR_ASSERT(args_.table);
+    if (not filter_.empty()) {
+      auto rows = co_await client_->query_rows_prepared(
+        "SELECT column_name, data_type "
+        "FROM information_schema.columns "
+        "WHERE table_schema = DATABASE() "
+        "AND table_name = ?",
+        {prepared_param{args_.table->inner}});
+      if (rows.is_err()) {
+        // Without the columns, we keep filtering locally.
+        co_return;
+      }
+      auto columns = sql_columns{};
+      for (auto& row : std::move(rows).unwrap()) {
+        if (row.size() < 2 or not row[0] or not row[1]) {
+          continue;
+        }
+        if (auto kind = column_kind(*row[1])) {
+          columns.emplace(std::move(*row[0]), *kind);
+        }
+      }
+      // Strings compare according to the collation of their column, which
+      // usually ignores case and trailing spaces.
+      auto filter = make_sql_filter(filter_, columns,
+                                    sql_dialect{.binary_strings = false});
+      if (not filter.condition.empty()) {
+        query_ += fmt::format(" WHERE {}", filter.condition);
+      }
+      if (not filter.exact) {
+        co_return;
+      }
+      filter_.clear();
+    }
+    if (args_.limit and not args_.limit->from_end) {
+      query_ += fmt::format(" LIMIT {}", args_.limit->count);
+    }
+  }
+
+  /// Applies the part of the filter that did not move into the query.
+  auto apply_filter(table_slice slice, OpCtx& ctx) const -> table_slice {
+    for (auto const& expr : filter_) {
+      slice = filter2(slice, expr, ctx, false);
+    }
+    return slice;
+  }
+
   auto
   find_tracking_candidates(std::string const& table, bool auto_increment_only)
     -> Task<MysqlResult<std::vector<tracking_candidate>>> {
@@ -2024,7 +2100,10 @@ private:
       }
       auto slice = std::move(*slice_result).unwrap();
       events_read_counter_.add(slice.rows());
-      co_await push(std::move(slice));
+      slice = apply_filter(std::move(slice), ctx);
+      if (slice.rows() > 0) {
+        co_await push(std::move(slice));
+      }
     }
     co_return true;
   }
@@ -2170,6 +2249,10 @@ public:
     }
     client_ = std::move(result).unwrap();
     has_client_ = true;
+    filter_ = args_.filter;
+    if (args_.table and not args_.sql and not args_.show and not live_) {
+      co_await push_down();
+    }
   }
 
   auto await_task(diagnostic_handler&) const -> Task<Any> override {
@@ -2230,7 +2313,10 @@ public:
       }
       auto slice = std::move(*slice_result).unwrap();
       events_read_counter_.add(slice.rows());
-      co_await push(std::move(slice));
+      slice = apply_filter(std::move(slice), ctx);
+      if (slice.rows() > 0) {
+        co_await push(std::move(slice));
+      }
     }
     done_ = true;
     co_await close_client(ctx);
@@ -2264,6 +2350,11 @@ public:
     serde("live_watermark_unsigned", live_watermark_unsigned_);
   }
 
+  auto resumable() const -> bool override {
+    // Only live mode tracks a watermark that tells where to continue.
+    return args_.live and args_.live->inner;
+  }
+
 private:
   FromMySQLArgs args_;
   Box<async_client> client_;
@@ -2272,6 +2363,8 @@ private:
   MetricsCounter events_read_counter_;
   std::string query_;
   std::string schema_name_;
+  /// The part of the filter that we apply to the result of the query.
+  ir::optimize_filter filter_;
   std::string table_name_;
   std::string tracking_column_;
   bool tracking_column_resolved_ = false;
@@ -2394,7 +2487,8 @@ public:
       }
       return {};
     });
-    return d.without_optimize();
+    d.absorb_limit(&FromMySQLArgs::limit);
+    return d.optimize_filter(&FromMySQLArgs::filter);
   }
 };
 
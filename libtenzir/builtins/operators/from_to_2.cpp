@@ -150,6 +150,10 @@ public:
     serde("next", next_);
   }
 
+  auto resumable() const -> bool override {
+    return true;
+  }
+
 private:
   size_t next_ = 0;
   std::vector<ast::expression> events_;
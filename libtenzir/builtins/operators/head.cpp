@@ -57,7 +57,17 @@ public:
 
   auto describe() const -> Description override {
     auto d = Describer<HeadArgs, Head>{};
-    d.optional_positional("count", &HeadArgs::count);
+    auto count = d.optional_positional("count", &HeadArgs::count);
+    d.limit([count](DescribeCtx& ctx) -> Option<ir::Limit> {
+      if (auto value = ctx.get(count)) {
+        return ir::Limit{.count = *value};
+      }
+      if (ctx.get_location(count)) {
+        // The count is not evaluated yet.
+        return None{};
+      }
+      return ir::Limit{.count = HeadArgs{}.count};
+    });
     return d.without_optimize();
   }
 };
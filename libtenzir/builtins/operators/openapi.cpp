@@ -168,6 +168,10 @@ public:
     serde("done", done_);
   }
 
+  auto resumable() const -> bool override {
+    return true;
+  }
+
 private:
   bool done_ = false;
 };
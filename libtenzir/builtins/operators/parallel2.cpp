@@ -263,6 +263,9 @@ public:
     auto route_by = d.named("route_by", &ParallelArgs::route_by, "any");
     d.named_optional("_fuse", &ParallelArgs::fuse);
     auto pipe = d.pipeline(&ParallelArgs::pipe, SubOptimize::from_downstream);
+    // Every subpipeline sees a disjoint part of the input, so a downstream
+    // aggregation can compute partial results within each of them.
+    d.absorb_partial();
     d.validate([jobs](DescribeCtx& ctx) -> Empty {
       if (auto j = ctx.get(jobs); j and j->inner == 0) {
         diagnostic::error("`jobs` must not be zero").primary(*j).emit(ctx);
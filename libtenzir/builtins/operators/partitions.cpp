@@ -231,6 +231,10 @@ public:
     serde("done", done_);
   }
 
+  auto resumable() const -> bool override {
+    return true;
+  }
+
 private:
   PartitionsArgs args_;
   catalog_actor catalog_ = {};
@@ -6,6 +6,7 @@
 // SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
 // SPDX-License-Identifier: BSD-3-Clause
 
+#include <tenzir/async/parallel_lines.hpp>
 #include <tenzir/async/pusher.hpp>
 #include <tenzir/detail/string.hpp>
 #include <tenzir/detail/syslog.hpp>
@@ -19,8 +20,10 @@
 
 #include <algorithm>
 #include <cctype>
+#include <iterator>
 #include <limits>
 #include <string_view>
+#include <utility>
 
 namespace tenzir::plugins::read_syslog {
 
@@ -44,6 +47,213 @@ struct ReadSyslogArgs {
   Option<ast::field_path> raw_message;
   multi_series_builder::options msb_options;
   location operator_location = location::unknown;
+  uint64_t jobs = 0;
+};
+
+/// Returns whether a line parses as a syslog message of any dialect, as
+/// opposed to continuing the previous message.
+auto starts_message(std::string_view line) -> bool {
+  auto const* f = line.begin();
+  auto const* const l = line.end();
+  if (syslog::message_parser{}.parse(f, l, unused)) {
+    return true;
+  }
+  f = line.begin();
+  if (syslog::legacy_message_parser{}.parse(f, l, unused)) {
+    return true;
+  }
+  f = line.begin();
+  // The Cisco parser does not support parsing into `unused`.
+  auto cisco_msg = syslog::legacy_message{};
+  return syslog::cisco_legacy_message_parser{}.parse(f, l, cisco_msg);
+}
+
+/// Parses syslog lines into the builder of their dialect, and appends lines
+/// that match no dialect to the previous message. Shared between the
+/// sequential code path and the workers of `read_syslog _jobs=...`.
+class SyslogParser {
+public:
+  SyslogParser(const ReadSyslogArgs& args, diagnostic_handler& dh)
+    : raw_message_{static_cast<bool>(args.raw_message)},
+      ordered_{args.msb_options.settings.ordered},
+      new_builder_{syslog::infuse_new_schema(args.msb_options), dh,
+                   args.raw_message},
+      legacy_builder_{syslog::infuse_legacy_schema(args.msb_options), dh,
+                      args.raw_message},
+      legacy_structured_builder_{
+        syslog::infuse_legacy_structured_schema(args.msb_options), dh,
+        args.raw_message, true},
+      unknown_builder_{args.msb_options, dh} {
+  }
+
+  /// Parses a single non-empty line. Returns the events that must be emitted
+  /// before it because it switches the schema in ordered mode.
+  auto parse_line(std::string_view line, size_t line_nr)
+    -> std::vector<table_slice> {
+    TENZIR_ASSERT(not line.empty());
+    auto const* f = line.begin();
+    auto const* const l = line.end();
+    // Try RFC 5424.
+    {
+      auto msg = syslog::message{};
+      if (syslog::message_parser{}.parse(f, l, msg)) {
+        auto result = switch_to(syslog::builder_tag::syslog_builder);
+        new_builder_.add_new({std::move(msg), line_nr, raw(line)});
+        return result;
+      }
+    }
+    // Try RFC 3164.
+    {
+      f = line.begin();
+      auto legacy_msg = syslog::legacy_message{};
+      if (syslog::legacy_message_parser{}.parse(f, l, legacy_msg)) {
+        auto tag = syslog::get_legacy_builder_tag(legacy_msg);
+        auto result = switch_to(tag);
+        auto& target = (tag == syslog::builder_tag::legacy_syslog_builder)
+                         ? legacy_builder_
+                         : legacy_structured_builder_;
+        target.add_new({std::move(legacy_msg), line_nr, raw(line)});
+        return result;
+      }
+    }
+    // Try Cisco legacy dialect, e.g. `<189>: 2026 Apr 14 08:45:52 UTC: ...`.
+    {
+      f = line.begin();
+      auto cisco_msg = syslog::legacy_message{};
+      if (syslog::cisco_legacy_message_parser{}.parse(f, l, cisco_msg)) {
+        auto result = switch_to(syslog::builder_tag::legacy_syslog_builder);
+        legacy_builder_.add_new({std::move(cisco_msg), line_nr, raw(line)});
+        return result;
+      }
+    }
+    // Multiline continuation: try to append to the most recent message.
+    if (last_ == syslog::builder_tag::syslog_builder
+        and new_builder_.add_line_to_latest(line)) {
+      return {};
+    }
+    if (last_ == syslog::builder_tag::legacy_syslog_builder
+        and legacy_builder_.add_line_to_latest(line)) {
+      return {};
+    }
+    if (last_ == syslog::builder_tag::legacy_structured_syslog_builder
+        and legacy_structured_builder_.add_line_to_latest(line)) {
+      return {};
+    }
+    // Unknown format.
+    auto result = switch_to(syslog::builder_tag::unknown_syslog_builder);
+    unknown_builder_.add_new({std::string{line}, line_nr});
+    return result;
+  }
+
+  auto yield_ready() -> series_builder::YieldReadyResult {
+    auto ready = series_builder::YieldReadyResult{};
+    ready.merge(new_builder_.yield_ready());
+    ready.merge(legacy_builder_.yield_ready());
+    ready.merge(legacy_structured_builder_.yield_ready());
+    ready.merge(unknown_builder_.yield_ready());
+    return ready;
+  }
+
+  /// Returns the rows already committed to the underlying multi-series
+  /// builders, but keeps pending multiline messages intact.
+  auto flush() -> std::vector<table_slice> {
+    auto result = new_builder_.builder.finalize_as_table_slice();
+    std::ranges::move(legacy_builder_.builder.finalize_as_table_slice(),
+                      std::back_inserter(result));
+    std::ranges::move(
+      legacy_structured_builder_.builder.finalize_as_table_slice(),
+      std::back_inserter(result));
+    std::ranges::move(unknown_builder_.finalize_as_table_slice(),
+                      std::back_inserter(result));
+    return result;
+  }
+
+  /// Returns all rows, including pending multiline messages.
+  auto finalize() -> std::vector<table_slice> {
+    auto result = new_builder_.finalize_as_table_slice();
+    std::ranges::move(legacy_builder_.finalize_as_table_slice(),
+                      std::back_inserter(result));
+    std::ranges::move(legacy_structured_builder_.finalize_as_table_slice(),
+                      std::back_inserter(result));
+    std::ranges::move(unknown_builder_.finalize_as_table_slice(),
+                      std::back_inserter(result));
+    return result;
+  }
+
+  auto snapshot(Serde& serde) -> void {
+    auto last_int = static_cast<uint32_t>(last_);
+    serde("last", last_int);
+    last_ = static_cast<syslog::builder_tag>(last_int);
+    serde("pending_new", new_builder_.last_message);
+    serde("pending_new_time", new_builder_.last_message_time);
+    serde("pending_legacy", legacy_builder_.last_message);
+    serde("pending_legacy_time", legacy_builder_.last_message_time);
+    serde("pending_legacy_structured",
+          legacy_structured_builder_.last_message);
+    serde("pending_legacy_structured_time",
+          legacy_structured_builder_.last_message_time);
+  }
+
+private:
+  auto raw(std::string_view line) const -> std::string {
+    return raw_message_ ? std::string{line} : std::string{};
+  }
+
+  /// Makes `tag` the current builder. Returns the events of the previous
+  /// builder in ordered mode, which must be emitted before the new ones.
+  auto switch_to(syslog::builder_tag tag) -> std::vector<table_slice> {
+    auto previous = std::exchange(last_, tag);
+    if (not ordered_ or previous == tag) {
+      return {};
+    }
+    switch (previous) {
+      using enum syslog::builder_tag;
+      case syslog_builder:
+        return new_builder_.finalize_as_table_slice();
+      case legacy_syslog_builder:
+        return legacy_builder_.finalize_as_table_slice();
+      case legacy_structured_syslog_builder:
+        return legacy_structured_builder_.finalize_as_table_slice();
+      case unknown_syslog_builder:
+        return unknown_builder_.finalize_as_table_slice();
+    }
+    TENZIR_UNREACHABLE();
+  }
+
+  bool raw_message_;
+  bool ordered_;
+  syslog::syslog_builder new_builder_;
+  syslog::legacy_syslog_builder legacy_builder_;
+  syslog::legacy_syslog_builder legacy_structured_builder_;
+  syslog::unknown_syslog_builder unknown_builder_;
+  syslog::builder_tag last_ = syslog::builder_tag::unknown_syslog_builder;
+};
+
+/// The per-worker state of `read_syslog _jobs=...`.
+class SyslogWorker final : public LineParserWorker {
+public:
+  SyslogWorker(const ReadSyslogArgs& args, diagnostic_handler& dh)
+    : dh_{make_dh(dh, args.operator_location)}, parser_{args, dh_} {
+  }
+
+  auto parse_line(std::string_view line, size_t line_number) -> void override {
+    if (line.empty()) {
+      return;
+    }
+    std::ranges::move(parser_.parse_line(line, line_number),
+                      std::back_inserter(slices_));
+  }
+
+  auto finish() -> std::vector<table_slice> override {
+    // Batches start with a message, so no message continues in the next one.
+    std::ranges::move(parser_.finalize(), std::back_inserter(slices_));
+    return std::exchange(slices_, {});
+  }
+
+private:
+  transforming_diagnostic_handler dh_;
+  SyslogParser parser_;
+  std::vector<table_slice> slices_;
 };
 
 class ReadSyslog final : public Operator<chunk_ptr, table_slice> {
@@ -53,17 +263,21 @@ public:
 
   auto start(OpCtx& ctx) -> Task<void> override {
     co_await Operator<chunk_ptr, table_slice>::start(ctx);
+    if (args_.jobs > 0) {
+      // Batches must not split a multiline message, so they only start at
+      // lines that begin a new message.
+      parallel_.emplace(
+        args_.jobs, args_.msb_options.settings.ordered,
+        [args = args_](diagnostic_handler& dh)
+          -> std::unique_ptr<LineParserWorker> {
+          return std::make_unique<SyslogWorker>(args, dh);
+        },
+        starts_message);
+      parallel_->start(ctx);
+      co_return;
+    }
     dh_.emplace(make_dh(ctx.dh(), args_.operator_location));
-    auto raw = args_.raw_message;
-    new_builder_.emplace(syslog::infuse_new_schema(args_.msb_options), *dh_,
-                         raw);
-    legacy_builder_.emplace(syslog::infuse_legacy_schema(args_.msb_options),
-                            *dh_, raw);
-    legacy_structured_builder_.emplace(
-      syslog::infuse_legacy_structured_schema(args_.msb_options), *dh_, raw,
-      true);
-    unknown_builder_.emplace(args_.msb_options, *dh_);
-    ordered_ = args_.msb_options.settings.ordered;
+    parser_.emplace(args_, *dh_);
   }
 
   auto process(chunk_ptr input, Push<table_slice>& push, OpCtx& ctx)
@@ -71,42 +285,65 @@ public:
     if (done_) {
       co_return;
     }
+    if (parallel_) {
+      co_await parallel_->add(std::move(input));
+      co_return;
+    }
     if (args_.octet_counting) {
       TENZIR_ASSERT(dh_);
       auto result = co_await process_octet(input, push, *dh_);
       if (not result) {
         // malformed octet framing is terminal
-        co_await finalize_builders(push);
+        co_await push_all(parser_->finalize(), push);
         done_ = true;
         co_return;
       }
     } else {
       co_await process_lines(input, push);
     }
-    co_await push_ready(push);
+    co_await pusher_.push(parser_->yield_ready(), push);
   }
 
   auto await_task(diagnostic_handler& dh) const -> Task<Any> override {
     TENZIR_UNUSED(dh);
+    if (parallel_) {
+      co_return co_await parallel_->next();
+    }
     co_await pusher_.wait();
     co_return PeriodicTick{};
   }
 
   auto process_task(Any result, Push<table_slice>& push, OpCtx& ctx)
     -> Task<void> override {
-    TENZIR_ASSERT(result.try_as<PeriodicTick>());
     TENZIR_UNUSED(ctx);
+    if (parallel_) {
+      co_await parallel_->handle(std::move(result), push);
+      co_return;
+    }
+    TENZIR_ASSERT(result.try_as<PeriodicTick>());
     if (not done_) {
-      co_await push_ready(push);
+      co_await pusher_.push(parser_->yield_ready(), push);
     }
   }
 
   auto state() -> OperatorState override {
+    if (parallel_) {
+      return draining_ and parallel_->done() ? OperatorState::done
+                                             : OperatorState::normal;
+    }
     return done_ ? OperatorState::done : OperatorState::normal;
   }
 
   auto finalize(Push<table_slice>& push, OpCtx&)
     -> Task<FinalizeBehavior> override {
+    if (parallel_) {
+      draining_ = true;
+      if (parallel_->done()) {
+        co_return FinalizeBehavior::done;
+      }
+      co_await parallel_->finish();
+      co_return FinalizeBehavior::continue_;
+    }
     TENZIR_ASSERT(dh_);
     if (args_.octet_counting) {
       if (remaining_message_length_ > 0) {
@@ -130,198 +367,53 @@ public:
       co_await process_one_line(buffer_, push);
       buffer_.clear();
     }
-    co_await finalize_builders(push);
+    co_await push_all(parser_->finalize(), push);
     co_return FinalizeBehavior::done;
   }
 
   auto prepare_snapshot(Push<table_slice>& push, OpCtx& ctx)
     -> Task<void> override {
     TENZIR_UNUSED(ctx);
+    if (parallel_) {
+      co_await parallel_->flush(push);
+      co_return;
+    }
     // Flush only committed rows. Keep pending multiline state (`last_message`)
     // in builders, and serialize it in snapshot().
-    co_await flush_builders(push);
+    co_await push_all(parser_->flush(), push);
   }
 
   auto snapshot(Serde& serde) -> void override {
+    if (parallel_) {
+      parallel_->snapshot(serde);
+      return;
+    }
     serde("buffer", buffer_);
     serde("line_nr", line_nr_);
     serde("ended_on_cr", ended_on_carriage_return_);
     serde("remaining_msg_len", remaining_message_length_);
     serde("done", done_);
-    auto last_int = static_cast<uint32_t>(last_);
-    serde("last", last_int);
-    last_ = static_cast<syslog::builder_tag>(last_int);
-
-    serde("pending_new", new_builder_->last_message);
-    serde("pending_new_time", new_builder_->last_message_time);
-    serde("pending_legacy", legacy_builder_->last_message);
-    serde("pending_legacy_time", legacy_builder_->last_message_time);
-    serde("pending_legacy_structured",
-          legacy_structured_builder_->last_message);
-    serde("pending_legacy_structured_time",
-          legacy_structured_builder_->last_message_time);
+    parser_->snapshot(serde);
   }
 
 private:
   struct PeriodicTick {};
 
-  // Returns slices that must be pushed immediately when switching schema
-  // (ordered mode only).
-  auto flush_for_schema_change(syslog::builder_tag new_tag)
-    -> std::vector<table_slice> {
-    if (not ordered_ or new_tag == last_) {
-      return {};
-    }
-    switch (last_) {
-      using enum syslog::builder_tag;
-      case syslog_builder:
-        return new_builder_->finalize_as_table_slice();
-      case legacy_syslog_builder:
-        return legacy_builder_->finalize_as_table_slice();
-      case legacy_structured_syslog_builder:
-        return legacy_structured_builder_->finalize_as_table_slice();
-      case unknown_syslog_builder:
-        return unknown_builder_->finalize_as_table_slice();
-    }
-    TENZIR_UNREACHABLE();
-  }
-
-  auto push_ready(Push<table_slice>& push) -> Task<void> {
-    auto ready = series_builder::YieldReadyResult{};
-    ready.merge(new_builder_->yield_ready());
-    ready.merge(legacy_builder_->yield_ready());
-    ready.merge(legacy_structured_builder_->yield_ready());
-    ready.merge(unknown_builder_->yield_ready());
-    co_await pusher_.push(std::move(ready), push);
-  }
-
-  // Flush rows already committed to the underlying multi-series builders,
-  // but keep pending multiline state (`last_message`) intact.
-  auto flush_builders(Push<table_slice>& push) -> Task<void> {
-    for (auto& s : new_builder_->builder.finalize_as_table_slice()) {
-      co_await push(std::move(s));
-    }
-    for (auto& s : legacy_builder_->builder.finalize_as_table_slice()) {
-      co_await push(std::move(s));
-    }
-    for (auto& s :
-         legacy_structured_builder_->builder.finalize_as_table_slice()) {
-      co_await push(std::move(s));
-    }
-    for (auto& s : unknown_builder_->finalize_as_table_slice()) {
-      co_await push(std::move(s));
-    }
-  }
-
-  // Flush all four builders, including pending multiline messages.
-  auto finalize_builders(Push<table_slice>& push) -> Task<void> {
-    for (auto& s : new_builder_->finalize_as_table_slice()) {
-      co_await push(std::move(s));
-    }
-    for (auto& s : legacy_builder_->finalize_as_table_slice()) {
-      co_await push(std::move(s));
-    }
-    for (auto& s : legacy_structured_builder_->finalize_as_table_slice()) {
-      co_await push(std::move(s));
-    }
-    for (auto& s : unknown_builder_->finalize_as_table_slice()) {
-      co_await push(std::move(s));
+  static auto push_all(std::vector<table_slice> slices,
+                       Push<table_slice>& push) -> Task<void> {
+    for (auto& slice : slices) {
+      co_await push(std::move(slice));
     }
   }
 
   // Parse and dispatch a single complete line.
-  // Diagnostics are handled by the builders (initialised in start() with
-  // the transforming_diagnostic_handler); no dh parameter is needed here.
   auto process_one_line(std::string_view line, Push<table_slice>& push)
     -> Task<void> {
     if (line.empty()) {
       co_return;
     }
     ++line_nr_;
-    auto const* f = line.begin();
-    auto const* const l = line.end();
-
-    // Try RFC 5424.
-    {
-      auto msg = syslog::message{};
-      if (syslog::message_parser{}.parse(f, l, msg)) {
-        for (auto& s :
-             flush_for_schema_change(syslog::builder_tag::syslog_builder)) {
-          co_await push(std::move(s));
-        }
-        last_ = syslog::builder_tag::syslog_builder;
-        if (args_.raw_message) {
-          new_builder_->add_new({std::move(msg), line_nr_, std::string{line}});
-        } else {
-          new_builder_->add_new({std::move(msg), line_nr_});
-        }
-        co_return;
-      }
-    }
-
-    // Try RFC 3164.
-    {
-      f = line.begin();
-      auto legacy_msg = syslog::legacy_message{};
-      if (syslog::legacy_message_parser{}.parse(f, l, legacy_msg)) {
-        auto tag = syslog::get_legacy_builder_tag(legacy_msg);
-        for (auto& s : flush_for_schema_change(tag)) {
-          co_await push(std::move(s));
-        }
-        last_ = tag;
-        auto& target = (tag == syslog::builder_tag::legacy_syslog_builder)
-                         ? *legacy_builder_
-                         : *legacy_structured_builder_;
-        if (args_.raw_message) {
-          target.add_new({std::move(legacy_msg), line_nr_, std::string{line}});
-        } else {
-          target.add_new({std::move(legacy_msg), line_nr_});
-        }
-        co_return;
-      }
-    }
-
-    // Try Cisco legacy dialect, e.g. `<189>: 2026 Apr 14 08:45:52 UTC: ...`.
-    {
-      f = line.begin();
-      auto cisco_msg = syslog::legacy_message{};
-      if (syslog::cisco_legacy_message_parser{}.parse(f, l, cisco_msg)) {
-        constexpr auto tag = syslog::builder_tag::legacy_syslog_builder;
-        for (auto& s : flush_for_schema_change(tag)) {
-          co_await push(std::move(s));
-        }
-        last_ = tag;
-        if (args_.raw_message) {
-          legacy_builder_->add_new(
-            {std::move(cisco_msg), line_nr_, std::string{line}});
-        } else {
-          legacy_builder_->add_new({std::move(cisco_msg), line_nr_});
-        }
-        co_return;
-      }
-    }
-
-    // Multiline continuation: try to append to the most recent message.
-    if (last_ == syslog::builder_tag::syslog_builder
-        and new_builder_->add_line_to_latest(line)) {
-      co_return;
-    }
-    if (last_ == syslog::builder_tag::legacy_syslog_builder
-        and legacy_builder_->add_line_to_latest(line)) {
-      co_return;
-    }
-    if (last_ == syslog::builder_tag::legacy_structured_syslog_builder
-        and legacy_structured_builder_->add_line_to_latest(line)) {
-      co_return;
-    }
-
-    // Unknown format.
-    for (auto& s :
-         flush_for_schema_change(syslog::builder_tag::unknown_syslog_builder)) {
-      co_await push(std::move(s));
-    }
-    last_ = syslog::builder_tag::unknown_syslog_builder;
-    unknown_builder_->add_new({std::string{line}, line_nr_});
+    co_await push_all(parser_->parse_line(line, line_nr_), push);
   }
 
   // Scan `input` for newlines and dispatch each complete line.
@@ -438,13 +530,11 @@ private:
   ReadSyslogArgs args_;
 
   // Initialised in start().
-  Option<syslog::syslog_builder> new_builder_;
-  Option<syslog::legacy_syslog_builder> legacy_builder_;
-  Option<syslog::legacy_syslog_builder> legacy_structured_builder_;
-  Option<syslog::unknown_syslog_builder> unknown_builder_;
   Option<transforming_diagnostic_handler> dh_;
-  bool ordered_ = true;
+  Option<SyslogParser> parser_;
+  Option<ParallelLineParser> parallel_;
   bool done_ = false;
+  bool draining_ = false;
   SeriesPusher pusher_;
 
   // Snapshotted mutable state.
@@ -452,7 +542,6 @@ private:
   size_t line_nr_ = 0;
   bool ended_on_carriage_return_ = false;
   size_t remaining_message_length_ = 0;
-  syslog::builder_tag last_ = syslog::builder_tag::unknown_syslog_builder;
 };
 
 class plugin final : public virtual ReadOperatorPlugin {
@@ -463,10 +552,22 @@ public:
 
   auto describe() const -> Description override {
     auto d = Describer<ReadSyslogArgs, ReadSyslog>{};
-    d.named("octet_counting", &ReadSyslogArgs::octet_counting);
+    auto octet_counting
+      = d.named("octet_counting", &ReadSyslogArgs::octet_counting);
     d.named("raw_message", &ReadSyslogArgs::raw_message);
+    auto msb = add_msb_to_describer(d, &ReadSyslogArgs::msb_options);
+    auto jobs = d.named_optional("_jobs", &ReadSyslogArgs::jobs);
     d.operator_location(&ReadSyslogArgs::operator_location);
-    d.validate(add_msb_to_describer(d, &ReadSyslogArgs::msb_options));
+    d.validate([=](DescribeCtx& ctx) -> Empty {
+      msb(ctx);
+      validate_jobs(ctx, jobs);
+      if (ctx.get(jobs) and ctx.get(octet_counting).value_or(false)) {
+        diagnostic::error("`_jobs` is incompatible with `octet_counting`")
+          .primary(ctx.get_location(jobs).value_or(location::unknown))
+          .emit(ctx);
+      }
+      return {};
+    });
     return d.without_optimize();
   }
 
@@ -504,22 +605,7 @@ private:
     if (not line.starts_with('<')) {
       return rd::reject();
     }
-    auto const* f = line.begin();
-    auto const* const l = line.end();
-    if (syslog::message_parser{}.parse(f, l, unused)) {
-      return rd::match();
-    }
-    f = line.begin();
-    if (syslog::legacy_message_parser{}.parse(f, l, unused)) {
-      return rd::match();
-    }
-    f = line.begin();
-    // The Cisco parser does not support parsing into `unused`.
-    auto cisco_msg = syslog::legacy_message{};
-    if (syslog::cisco_legacy_message_parser{}.parse(f, l, cisco_msg)) {
-      return rd::match();
-    }
-    return rd::reject();
+    return starts_message(line) ? rd::match() : rd::reject();
   }
 };
 
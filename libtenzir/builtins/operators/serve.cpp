@@ -52,13 +52,16 @@
 #include "tenzir/detail/fanout_counter.hpp"
 
 #include <tenzir/actors.hpp>
+#include <tenzir/arrow_memory_pool.hpp>
 #include <tenzir/arrow_table_slice.hpp>
+#include <tenzir/arrow_utils.hpp>
 #include <tenzir/concept/convertible/to.hpp>
 #include <tenzir/concept/parseable/numeric.hpp>
 #include <tenzir/concept/parseable/tenzir/expression.hpp>
 #include <tenzir/concept/parseable/tenzir/pipeline.hpp>
 #include <tenzir/concept/parseable/to.hpp>
 #include <tenzir/concept/printable/tenzir/json.hpp>
+#include <tenzir/detail/string.hpp>
 #include <tenzir/detail/weak_run_delayed.hpp>
 #include <tenzir/node.hpp>
 #include <tenzir/operator_plugin.hpp>
@@ -70,7 +73,11 @@
 #include <tenzir/table_slice.hpp>
 #include <tenzir/tql2/plugin.hpp>
 
+#include <arrow/io/memory.h>
+#include <arrow/ipc/writer.h>
 #include <arrow/record_batch.h>
+#include <arrow/util/compression.h>
+#include <arrow/util/key_value_metadata.h>
 #include <caf/actor_addr.hpp>
 #include <caf/actor_registry.hpp>
 #include <caf/scoped_actor.hpp>
@@ -79,13 +86,17 @@
 #include <caf/typed_event_based_actor.hpp>
 #include <folly/coro/BoundedQueue.h>
 
+#include <algorithm>
 #include <chrono>
+#include <span>
 #include <sstream>
 
 namespace tenzir::plugins::serve {
 
 TENZIR_ENUM(serve_state, running, completed, failed);
 TENZIR_ENUM(schema, legacy, exact, never);
+TENZIR_ENUM(response_format, json, arrow);
+TENZIR_ENUM(arrow_compression, none, zstd);
 
 namespace {
 
@@ -97,6 +108,44 @@ constexpr auto serve_multi_endpoint_id = 1;
 constexpr auto initial_continuation_token
   = "00000000-0000-0000-0000-000000000000";
 
+/// The media type of Arrow IPC streams.
+constexpr auto arrow_stream_media_type = "application/vnd.apache.arrow.stream";
+
+/// Picks the response format from the value of an `Accept` header.
+///
+/// We answer with Arrow only when the client prefers it over JSON. Wildcards
+/// count towards JSON, but a client that lists Arrow explicitly with the same
+/// quality as a wildcard gets Arrow.
+auto negotiate_format(std::string_view accept) -> response_format {
+  auto arrow = 0.0;
+  auto json = 0.0;
+  auto wildcard = 0.0;
+  for (auto range : detail::split(accept, ",")) {
+    auto [media_type, parameters] = detail::split_once(range, ";");
+    media_type = detail::trim(media_type);
+    auto quality = 1.0;
+    for (auto parameter : detail::split(parameters, ";")) {
+      const auto [key, value] = detail::split_once(parameter, "=");
+      if (detail::trim(key) == "q") {
+        auto parsed = to<double>(detail::trim(value));
+        quality = parsed ? *parsed : 0.0;
+      }
+    }
+    if (detail::ascii_icase_equal(media_type, arrow_stream_media_type)) {
+      arrow = std::max(arrow, quality);
+    } else if (detail::ascii_icase_equal(media_type, "application/json")) {
+      json = std::max(json, quality);
+    } else if (media_type == "*/*"
+               or detail::ascii_icase_equal(media_type, "application/*")) {
+      wildcard = std::max(wildcard, quality);
+    }
+  }
+  if (arrow > 0.0 and arrow > json and arrow >= wildcard) {
+    return response_format::arrow;
+  }
+  return response_format::json;
+}
+
 constexpr auto serve_spec = R"_(
 /serve:
   post:
@@ -145,6 +194,17 @@ constexpr auto serve_spec = R"_(
                 example: "exact"
                 default: "legacy"
                 description: The schema representation to include in the response. Use `exact` for a representation that matches Tenzir's type system exactly, and `never` to omit schema definitions.
+              accept:
+                type: string
+                example: "application/vnd.apache.arrow.stream"
+                default: "application/json"
+                description: The media types that the client accepts for the response, with the syntax of the `Accept` header. Defaults to the `Accept` header of the request. The endpoint answers with an Arrow IPC stream when the client prefers `application/vnd.apache.arrow.stream` over JSON.
+              compression:
+                type: string
+                enum: [none, zstd]
+                example: "zstd"
+                default: "none"
+                description: The compression of record batches in Arrow IPC responses. Has no effect on JSON responses.
           example:
             serve_id: "query-1"
             max_events: 1024
@@ -250,6 +310,16 @@ constexpr auto serve_spec = R"_(
                     timestamp: "2023-04-26T12:00:00Z"
                     schema: "zeek.conn"
                     events: 50
+          application/vnd.apache.arrow.stream:
+            schema:
+              type: string
+              format: binary
+              description: "An Arrow IPC stream. The schema metadata of every stream in an Arrow response contains the keys `TENZIR:serve:serve_id`, `TENZIR:serve:next_continuation_token`, and `TENZIR:serve:state`. The continuation token is empty when the pipeline reached a terminal state. A response without events consists of a single stream with an empty schema."
+          multipart/mixed:
+            schema:
+              type: string
+              format: binary
+              description: "The response when the events have more than one schema. Every run of events with the same schema becomes a part with the content type `application/vnd.apache.arrow.stream` that holds one Arrow IPC stream, described above."
       400:
         description: The request body is invalid.
         content:
@@ -323,6 +393,17 @@ constexpr auto serve_multi_spec = R"_(
                 example: "exact"
                 default: "legacy"
                 description: The default schema representation to include in each response. Use `exact` for a representation that matches Tenzir's type system exactly, and `never` to omit schema definitions. Individual output streams can override this with their own `schema` field.
+              accept:
+                type: string
+                example: "application/vnd.apache.arrow.stream"
+                default: "application/json"
+                description: The media types that the client accepts for the response, with the syntax of the `Accept` header. Defaults to the `Accept` header of the request. The endpoint answers with an Arrow IPC stream when the client prefers `application/vnd.apache.arrow.stream` over JSON.
+              compression:
+                type: string
+                enum: [none, zstd]
+                example: "zstd"
+                default: "none"
+                description: The compression of record batches in Arrow IPC responses. Has no effect on JSON responses.
           example:
             requests:
               - serve_id: "query-1"
@@ -434,6 +515,16 @@ constexpr auto serve_multi_spec = R"_(
                 state: completed
                 schemas: []
                 events: []
+          application/vnd.apache.arrow.stream:
+            schema:
+              type: string
+              format: binary
+              description: "The Arrow IPC stream of the only requested output stream when its events have a single schema. See the `/serve` endpoint for details."
+          multipart/mixed:
+            schema:
+              type: string
+              format: binary
+              description: "The Arrow IPC streams of all requested output streams, each in a part with the content type `application/vnd.apache.arrow.stream`. The `TENZIR:serve:serve_id` key in the schema metadata of every stream identifies its output stream. See the `/serve` endpoint for details."
       400:
         description: The request body is invalid.
         content:
@@ -480,6 +571,9 @@ struct request_meta {
   uint64_t min_events = defaults::api::serve::min_events;
   duration timeout = defaults::api::serve::timeout;
   enum schema schema = schema::legacy;
+  enum response_format format = response_format::json;
+  /// The compression of record batches in Arrow responses.
+  enum arrow_compression compression = arrow_compression::none;
 };
 
 struct request_base {
@@ -1260,6 +1354,27 @@ struct serve_handler_state {
     if (auto& opt = as<std::optional<enum schema>>(schema)) {
       result.schema = *opt;
     }
+    auto accept = try_get_nullable_string(params, "accept");
+    if (auto* err = try_as<parse_error>(accept)) {
+      return std::move(*err);
+    }
+    if (const auto* value = as<const std::string*>(accept)) {
+      result.format = negotiate_format(*value);
+    }
+    auto compression = try_get_nullable_string(params, "compression");
+    if (auto* err = try_as<parse_error>(compression)) {
+      return std::move(*err);
+    }
+    if (const auto* value = as<const std::string*>(compression)) {
+      auto opt = from_string<enum arrow_compression>(*value);
+      if (not opt) {
+        return parse_error{.message = "invalid compression parameter",
+                           .detail = caf::make_error(
+                             ec::invalid_argument,
+                             fmt::format("got `{}`", *value))};
+      }
+      result.compression = *opt;
+    }
     return result;
   }
 
@@ -1425,6 +1540,125 @@ struct serve_handler_state {
     return result;
   }
 
+  /// Appends the result for a single serve id to `out` as Arrow IPC streams.
+  ///
+  /// A stream cannot change its schema, so every run of slices with the same
+  /// schema becomes a stream of its own. The schema metadata of each stream
+  /// carries the serve id, the next continuation token, which is empty once the
+  /// pipeline reached a terminal state, and the state. A result without events
+  /// is a single stream with an empty schema and no record batches.
+  static auto append_arrow_streams(std::vector<std::string>& out,
+                                   std::string_view serve_id,
+                                   const std::string& next_continuation_token,
+                                   const std::vector<table_slice>& results,
+                                   serve_state state,
+                                   enum arrow_compression compression)
+    -> void {
+    auto options = arrow::ipc::IpcWriteOptions::Defaults();
+    options.memory_pool = arrow_memory_pool();
+    if (compression == arrow_compression::zstd) {
+      options.codec
+        = check(arrow::util::Codec::Create(arrow::Compression::ZSTD));
+    }
+    const auto metadata = arrow::KeyValueMetadata::Make(
+      {
+        "TENZIR:serve:serve_id",
+        "TENZIR:serve:next_continuation_token",
+        "TENZIR:serve:state",
+      },
+      {
+        std::string{serve_id},
+        next_continuation_token,
+        fmt::to_string(state),
+      });
+    const auto write_stream = [&](std::shared_ptr<arrow::Schema> schema,
+                                  std::span<const table_slice> slices) {
+      auto sink = check(
+        arrow::io::BufferOutputStream::Create(4096, arrow_memory_pool()));
+      auto writer = check(arrow::ipc::MakeStreamWriter(sink, schema, options));
+      for (const auto& slice : slices) {
+        check(writer->WriteRecordBatch(*to_record_batch(slice)));
+      }
+      check(writer->Close());
+      const auto buffer = check(sink->Finish());
+      out.emplace_back(reinterpret_cast<const char*>(buffer->data()),
+                       buffer->size());
+    };
+    auto slices = std::vector<table_slice>{};
+    for (const auto& slice : results) {
+      if (slice.rows() > 0) {
+        slices.push_back(slice);
+      }
+    }
+    if (slices.empty()) {
+      write_stream(arrow::schema(arrow::FieldVector{}, metadata), {});
+    }
+    for (auto begin = size_t{0}; begin < slices.size();) {
+      auto end = begin + 1;
+      while (end < slices.size()
+             and slices[end].schema() == slices[begin].schema()) {
+        ++end;
+      }
+      auto schema = to_record_batch(slices[begin])->schema();
+      schema = schema->WithMetadata(
+        schema->HasMetadata() ? schema->metadata()->Merge(*metadata)
+                              : metadata);
+      write_stream(std::move(schema),
+                   std::span{slices}.subspan(begin, end - begin));
+      begin = end;
+    }
+  }
+
+  /// Creates an Arrow response from a list of IPC streams.
+  ///
+  /// Standard IPC readers stop at the end of the first stream, so we cannot
+  /// simply concatenate streams. A single stream is the body of the response.
+  /// Multiple streams become the parts of a `multipart/mixed` body, each with
+  /// the Arrow stream media type.
+  static auto make_arrow_response(std::vector<std::string> streams)
+    -> rest_response {
+    TENZIR_ASSERT(not streams.empty());
+    if (streams.size() == 1) {
+      return rest_response::from_bytes(std::move(streams.front()),
+                                       arrow_stream_media_type);
+    }
+    // The boundary must not occur in any of the parts. A random UUID makes a
+    // collision practically impossible, but checking is cheap.
+    auto boundary = std::string{};
+    do {
+      boundary = fmt::format("tenzir-{}", uuid::random());
+    } while (std::ranges::any_of(streams, [&](const auto& stream) {
+      return stream.find(boundary) != std::string::npos;
+    }));
+    auto body = std::string{};
+    for (const auto& stream : streams) {
+      body += fmt::format("--{}\r\nContent-Type: {}\r\n\r\n", boundary,
+                          arrow_stream_media_type);
+      body += stream;
+      body += "\r\n";
+    }
+    body += fmt::format("--{}--\r\n", boundary);
+    return rest_response::from_bytes(
+      std::move(body),
+      fmt::format("multipart/mixed; boundary={}", boundary));
+  }
+
+  /// Creates the response to a /serve request in the negotiated format.
+  static auto make_single_response(const std::string& serve_id,
+                                   const std::string& next_continuation_token,
+                                   const std::vector<table_slice>& results,
+                                   serve_state state, const request_meta& meta)
+    -> rest_response {
+    if (meta.format == response_format::json) {
+      return rest_response::from_json_string(create_response(
+        next_continuation_token, results, state, meta.schema));
+    }
+    auto streams = std::vector<std::string>{};
+    append_arrow_streams(streams, serve_id, next_continuation_token, results,
+                         state, meta.compression);
+    return make_arrow_response(std::move(streams));
+  }
+
   /// Handles a request to /serve by
   /// * "parsing" `params`
   /// * Making a request to the serve-manager for events according to `params`
@@ -1438,21 +1672,24 @@ struct serve_handler_state {
     }
     auto& request = as<single_serve_request>(maybe_request);
     auto rp = self->make_response_promise<rest_response>();
+    const auto& meta = static_cast<const request_meta&>(request);
     self
-      ->mail(atom::get_v, std::move(request.serve_id),
+      ->mail(atom::get_v, request.serve_id,
              std::move(request.continuation_token), request.min_events,
              request.timeout, request.max_events)
       .request(serve_manager, caf::infinite)
       .then(
-        [rp, schema = request.schema](const serve_response& result) mutable {
+        [rp, serve_id = request.serve_id,
+         meta](const serve_response& result) mutable {
           const auto& [continuation_token, results] = result;
-          rp.deliver(rest_response::from_json_string(
-            create_response(continuation_token, results,
-                            continuation_token.empty() ? serve_state::completed
-                                                       : serve_state::running,
-                            schema)));
+          rp.deliver(make_single_response(
+            serve_id, continuation_token, results,
+            continuation_token.empty() ? serve_state::completed
+                                       : serve_state::running,
+            meta));
         },
-        [rp, schema = request.schema](const caf::error& err) mutable {
+        [rp, serve_id = request.serve_id,
+         meta](const caf::error& err) mutable {
           if (err == caf::exit_reason::user_shutdown
               or err.context().match_elements<diagnostic>()) {
             // The pipeline has either shut down naturally or we got an
@@ -1460,11 +1697,11 @@ struct serve_handler_state {
             // error as an internal error from the /serve endpoint, but
             // rather report that we're done. The user must get the
             // diagnostic from the `diagnostics` operator.
-            rp.deliver(rest_response::from_json_string(create_response(
-              {}, {},
+            rp.deliver(make_single_response(
+              serve_id, {}, {},
               err == caf::exit_reason::user_shutdown ? serve_state::completed
                                                      : serve_state::failed,
-              schema)));
+              meta));
             return;
           }
           rp.deliver(rest_response::make_error(400, fmt::to_string(err), {}));
@@ -1515,7 +1752,18 @@ struct serve_handler_state {
     }
     auto fan = detail::make_fanout_counter(
       request.requests.size(),
-      [rp, st]() mutable {
+      [rp, st, format = request.format,
+       compression = request.compression]() mutable {
+        if (format == response_format::arrow) {
+          auto streams = std::vector<std::string>{};
+          for (auto& [id, result] : st->results) {
+            const auto& [next_token, data] = result.response;
+            append_arrow_streams(streams, id, next_token, data, result.state,
+                                 compression);
+          }
+          rp.deliver(make_arrow_response(std::move(streams)));
+          return;
+        }
         auto json_text = std::string{'{'};
         auto first = true;
         for (auto& [id, result] : st->results) {
@@ -2027,6 +2275,8 @@ public:
           {"min_events", uint64_type{}},
           {"timeout", duration_type{}},
           {"schema", string_type{}},
+          {"accept", string_type{}},
+          {"compression", string_type{}},
         },
         .version = api_version::v0,
         .content_type = http_content_type::json,
@@ -2047,6 +2297,8 @@ public:
           {"min_events", uint64_type{}},
           {"timeout", duration_type{}},
           {"schema", string_type{}},
+          {"accept", string_type{}},
+          {"compression", string_type{}},
         },
         .version = api_version::v0,
         .content_type = http_content_type::json,
@@ -9,7 +9,9 @@
 #include "tenzir/tql2/plugin.hpp"
 
 #include <tenzir/argument_parser.hpp>
+#include <tenzir/arrow_memory_pool.hpp>
 #include <tenzir/arrow_table_slice.hpp>
+#include <tenzir/arrow_utils.hpp>
 #include <tenzir/bitmap.hpp>
 #include <tenzir/concept/convertible/to.hpp>
 #include <tenzir/concept/parseable/core.hpp>
@@ -31,18 +33,23 @@
 #include <tenzir/series_builder.hpp>
 #include <tenzir/session.hpp>
 #include <tenzir/tql2/ast.hpp>
+#include <tenzir/tql2/eval.hpp>
 #include <tenzir/tql2/filter.hpp>
 #include <tenzir/tql2/resolve.hpp>
 
 #include <arrow/record_batch.h>
+#include <caf/binary_serializer.hpp>
 #include <fmt/format.h>
+#include <re2/filtered_re2.h>
 #include <re2/re2.h>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <filesystem>
 #include <functional>
 #include <map>
+#include <queue>
 #include <ranges>
 #include <string>
 #include <string_view>
@@ -682,29 +689,532 @@ auto load_rules(const std::filesystem::path& path, RuleMap& rules,
   rules[path.string()] = {std::move(*yaml), std::move(rule)};
 }
 
+/// Reloads the rules from disk and returns whether any rule changed. The
+/// entries of `rules` remain untouched if nothing changed.
 auto update_rules(const std::filesystem::path& path, RuleMap& rules,
-                  diagnostic_handler& dh) -> void {
+                  diagnostic_handler& dh) -> bool {
   auto old_rules = std::exchange(rules, {});
   load_rules(path, rules, dh);
+  auto changed = false;
   for (const auto& [rule_path, rule] : rules) {
     const auto old_rule = old_rules.find(rule_path);
     if (old_rule == old_rules.end()) {
       TENZIR_VERBOSE("added Sigma rule {}", rule_path);
+      changed = true;
     } else if (old_rule->second.yaml != rule.yaml) {
       TENZIR_VERBOSE("updated Sigma rule {}", rule_path);
+      changed = true;
     }
   }
   for (const auto& [rule_path, _] : old_rules) {
     if (not rules.contains(rule_path)) {
       TENZIR_VERBOSE("removed Sigma rule {}", rule_path);
+      changed = true;
     }
   }
+  if (not changed) {
+    // Keep the previous entries, which a `SigmaPlan` may still refer to.
+    rules = std::move(old_rules);
+  }
+  return changed;
 }
 
-auto make_sigma_slice(const table_slice& input, const data& yaml,
-                      const ast::expression& rule, diagnostic_handler& dh)
+/// Finds all occurrences of a fixed set of strings in a text in a single pass,
+/// using the Aho-Corasick automaton.
+class AtomMatcher {
+public:
+  explicit AtomMatcher(const std::vector<std::string>& atoms) {
+    states_.emplace_back();
+    for (auto i = size_t{0}; i < atoms.size(); ++i) {
+      auto state = uint32_t{0};
+      for (auto c : atoms[i]) {
+        auto next = find(state, static_cast<uint8_t>(c));
+        if (not next) {
+          next = detail::narrow<uint32_t>(states_.size());
+          insert(state, static_cast<uint8_t>(c), *next);
+          states_.emplace_back();
+        }
+        state = *next;
+      }
+      states_[state].outputs.push_back(detail::narrow<int>(i));
+    }
+    // Compute the failure links breadth-first, so that the failure link of a
+    // state always points to a state that is already complete.
+    auto queue = std::queue<uint32_t>{};
+    for (auto [_, child] : states_[0].edges) {
+      queue.push(child);
+    }
+    while (not queue.empty()) {
+      auto state = queue.front();
+      queue.pop();
+      for (auto [c, child] : states_[state].edges) {
+        auto fail = states_[state].fail;
+        while (fail != 0 and not find(fail, c)) {
+          fail = states_[fail].fail;
+        }
+        auto target = find(fail, c);
+        states_[child].fail = target and *target != child ? *target : 0;
+        const auto& inherited = states_[states_[child].fail].outputs;
+        states_[child].outputs.insert(states_[child].outputs.end(),
+                                      inherited.begin(), inherited.end());
+        queue.push(child);
+      }
+    }
+  }
+
+  /// Replaces `result` with the sorted indices of all atoms in `text`.
+  auto find_all(std::string_view text, std::vector<int>& result) const
+    -> void {
+    result.clear();
+    auto state = uint32_t{0};
+    for (auto c : text) {
+      auto byte = static_cast<uint8_t>(c);
+      auto next = find(state, byte);
+      while (not next and state != 0) {
+        state = states_[state].fail;
+        next = find(state, byte);
+      }
+      state = next.value_or(0);
+      result.insert(result.end(), states_[state].outputs.begin(),
+                    states_[state].outputs.end());
+    }
+    std::ranges::sort(result);
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+  }
+
+private:
+  struct State {
+    /// Outgoing edges, sorted by their byte.
+    std::vector<std::pair<uint8_t, uint32_t>> edges;
+    uint32_t fail = 0;
+    /// All atoms that end in this state, including those of failure states.
+    std::vector<int> outputs;
+  };
+
+  auto find(uint32_t state, uint8_t c) const -> std::optional<uint32_t> {
+    const auto& edges = states_[state].edges;
+    auto it = std::ranges::lower_bound(edges, c, std::less<>{},
+                                       &std::pair<uint8_t, uint32_t>::first);
+    if (it == edges.end() or it->first != c) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  auto insert(uint32_t state, uint8_t c, uint32_t next) -> void {
+    auto& edges = states_[state].edges;
+    auto it = std::ranges::lower_bound(edges, c, std::less<>{},
+                                       &std::pair<uint8_t, uint32_t>::first);
+    edges.emplace(it, c, next);
+  }
+
+  std::vector<State> states_;
+};
+
+/// A set of rows in a batch, stored as a bitmask.
+class RowSet {
+public:
+  RowSet() = default;
+
+  explicit RowSet(size_t rows) : words_((rows + 63) / 64) {
+  }
+
+  auto set(size_t row) -> void {
+    words_[row / 64] |= uint64_t{1} << (row % 64);
+  }
+
+  auto test(size_t row) const -> bool {
+    return (words_[row / 64] >> (row % 64)) & 1;
+  }
+
+  auto any() const -> bool {
+    return std::ranges::any_of(words_, [](auto word) {
+      return word != 0;
+    });
+  }
+
+  auto fill() -> void {
+    std::ranges::fill(words_, ~uint64_t{0});
+  }
+
+  auto operator&=(const RowSet& other) -> RowSet& {
+    for (auto i = size_t{0}; i < words_.size(); ++i) {
+      words_[i] &= other.words_[i];
+    }
+    return *this;
+  }
+
+  auto operator|=(const RowSet& other) -> RowSet& {
+    for (auto i = size_t{0}; i < words_.size(); ++i) {
+      words_[i] |= other.words_[i];
+    }
+    return *this;
+  }
+
+private:
+  std::vector<uint64_t> words_;
+};
+
+/// The three-valued result of a boolean expression for the rows of a batch.
+/// Rows that are in neither set are `null`.
+struct Truth {
+  RowSet is_true;
+  RowSet is_false;
+};
+
+/// Evaluates all loaded Sigma rules at once.
+///
+/// The rules are compiled into a shared plan: identical predicates across all
+/// rules are evaluated only once per batch, and every field is evaluated only
+/// once. All regular expressions on the same field go through a single
+/// `re2::FilteredRE2`, whose literal atoms we search for in one pass with an
+/// Aho-Corasick automaton, so that we only run the regular expressions that
+/// can possibly match. The results are then combined per rule with bitwise
+/// three-valued logic, matching the semantics of `and`, `or`, and `not`.
+class SigmaPlan {
+public:
+  SigmaPlan() = default;
+
+  explicit SigmaPlan(const RuleMap& rules) {
+    for (const auto& [_, entry] : rules) {
+      rules_.push_back({&entry, compile(entry.rule)});
+    }
+    for (auto& field : fields_) {
+      if (field.regexes.NumRegexps() == 0) {
+        continue;
+      }
+      auto atoms = std::vector<std::string>{};
+      field.regexes.Compile(&atoms);
+      field.atoms = std::make_unique<AtomMatcher>(atoms);
+    }
+  }
+
+  /// Returns every rule that matches the input together with the matching
+  /// rows.
+  auto evaluate(const table_slice& input, diagnostic_handler& dh) const
+    -> std::vector<std::pair<const RuleEntry*, table_slice>> {
+    auto result = std::vector<std::pair<const RuleEntry*, table_slice>>{};
+    if (rules_.empty() or input.rows() == 0) {
+      return result;
+    }
+    auto matches = std::vector<std::vector<size_t>>(rules_.size());
+    for (auto begin = size_t{0}; begin < input.rows(); begin += chunk_size) {
+      const auto end = std::min(begin + chunk_size, input.rows());
+      const auto chunk = subslice(input, begin, end);
+      auto leaves = evaluate_leaves(chunk, dh);
+      for (auto i = size_t{0}; i < rules_.size(); ++i) {
+        auto truth = evaluate_node(rules_[i].node, leaves, chunk.rows());
+        if (not truth.is_true.any()) {
+          continue;
+        }
+        for (auto row = size_t{0}; row < chunk.rows(); ++row) {
+          if (truth.is_true.test(row)) {
+            matches[i].push_back(begin + row);
+          }
+        }
+      }
+    }
+    for (auto i = size_t{0}; i < rules_.size(); ++i) {
+      if (matches[i].empty()) {
+        continue;
+      }
+      if (matches[i].size() == input.rows()) {
+        result.emplace_back(rules_[i].entry, input);
+        continue;
+      }
+      auto mask = arrow::BooleanBuilder{arrow_memory_pool()};
+      check(mask.Reserve(detail::narrow<int64_t>(input.rows())));
+      auto next = matches[i].begin();
+      for (auto row = size_t{0}; row < input.rows(); ++row) {
+        auto selected = next != matches[i].end() and *next == row;
+        if (selected) {
+          ++next;
+        }
+        mask.UnsafeAppend(selected);
+      }
+      result.emplace_back(rules_[i].entry, filter(input, *finish(mask)));
+    }
+    return result;
+  }
+
+private:
+  /// The number of rows that we evaluate at once, which bounds the memory
+  /// needed for the intermediate results of all predicates.
+  static constexpr auto chunk_size = size_t{4096};
+
+  /// A node of the boolean expression tree of a rule.
+  struct Node {
+    enum class Kind { constant, leaf, not_, and_, or_ };
+    Kind kind = Kind::constant;
+    bool value = false;
+    size_t index = 0;
+    std::vector<size_t> children;
+  };
+
+  /// A regular expression match on a field.
+  struct RegexLeaf {
+    size_t field;
+    int regex;
+  };
+
+  /// Any other predicate, which we evaluate with the regular evaluator.
+  struct ExprLeaf {
+    ast::expression expr;
+  };
+
+  using Leaf = variant<RegexLeaf, ExprLeaf>;
+
+  /// A field that is subject to regular expression matches.
+  struct Field {
+    ast::expression expr;
+    re2::FilteredRE2 regexes{min_atom_length};
+    /// The leaf for every regular expression, in the order of `regexes`.
+    std::vector<size_t> leaves;
+    std::unique_ptr<AtomMatcher> atoms;
+  };
+
+  /// Atoms shorter than this do not filter well and make the regular
+  /// expression unfiltered instead.
+  static constexpr auto min_atom_length = 3;
+
+  struct Rule {
+    const RuleEntry* entry;
+    size_t node;
+  };
+
+  static auto key_of(const ast::expression& expr) -> std::string {
+    auto buffer = caf::byte_buffer{};
+    auto f = caf::binary_serializer{buffer};
+    auto copy = expr;
+    auto ok = f.apply(copy);
+    TENZIR_ASSERT(ok);
+    return std::string{reinterpret_cast<const char*>(buffer.data()),
+                       buffer.size()};
+  }
+
+  auto add_node(Node node) -> size_t {
+    nodes_.push_back(std::move(node));
+    return nodes_.size() - 1;
+  }
+
+  auto compile(const ast::expression& expr) -> size_t {
+    if (const auto* binary = try_as<ast::binary_expr>(expr);
+        binary
+        and (binary->op == ast::binary_op::and_
+             or binary->op == ast::binary_op::or_)) {
+      auto left = compile(binary->left);
+      auto right = compile(binary->right);
+      return add_node({
+        .kind = binary->op == ast::binary_op::and_ ? Node::Kind::and_
+                                                   : Node::Kind::or_,
+        .children = {left, right},
+      });
+    }
+    if (const auto* unary = try_as<ast::unary_expr>(expr);
+        unary and unary->op == ast::unary_op::not_) {
+      auto child = compile(unary->expr);
+      return add_node({.kind = Node::Kind::not_, .children = {child}});
+    }
+    if (const auto* constant = try_as<ast::constant>(expr)) {
+      if (const auto* value = try_as<bool>(constant->value)) {
+        return add_node({.kind = Node::Kind::constant, .value = *value});
+      }
+    }
+    return add_node({.kind = Node::Kind::leaf, .index = add_leaf(expr)});
+  }
+
+  auto add_leaf(const ast::expression& expr) -> size_t {
+    auto key = key_of(expr);
+    if (auto it = leaf_ids_.find(key); it != leaf_ids_.end()) {
+      return it->second;
+    }
+    const auto id = leaves_.size();
+    leaf_ids_.emplace(std::move(key), id);
+    if (auto regex = add_regex(expr, id)) {
+      leaves_.emplace_back(*regex);
+    } else {
+      leaves_.emplace_back(ExprLeaf{expr});
+    }
+    return id;
+  }
+
+  /// Registers a `match_regex(field, "...")` call with the field.
+  auto add_regex(const ast::expression& expr, size_t leaf)
+    -> std::optional<RegexLeaf> {
+    const auto* call = try_as<ast::function_call>(expr);
+    if (not call or call->args.size() != 2 or call->fn.path.size() != 1
+        or call->fn.path[0].name != "match_regex") {
+      return std::nullopt;
+    }
+    const auto* pattern = try_as<ast::constant>(call->args[1]);
+    const auto* regex = pattern ? try_as<std::string>(pattern->value) : nullptr;
+    if (not regex) {
+      return std::nullopt;
+    }
+    auto field_key = key_of(call->args[0]);
+    auto it = field_ids_.find(field_key);
+    if (it == field_ids_.end()) {
+      it = field_ids_.emplace(std::move(field_key), fields_.size()).first;
+      fields_.push_back(Field{.expr = call->args[0]});
+    }
+    auto& field = fields_[it->second];
+    auto id = 0;
+    auto options = re2::RE2::Options{re2::RE2::CannedOptions::Quiet};
+    if (field.regexes.Add(*regex, options, &id) != re2::RE2::NoError) {
+      return std::nullopt;
+    }
+    TENZIR_ASSERT(detail::narrow<size_t>(id) == field.leaves.size());
+    field.leaves.push_back(leaf);
+    return RegexLeaf{it->second, id};
+  }
+
+  /// Evaluates every distinct predicate of all rules for the given rows.
+  auto evaluate_leaves(const table_slice& chunk, diagnostic_handler& dh) const
+    -> std::vector<Truth> {
+    const auto rows = chunk.rows();
+    auto result = std::vector<Truth>{};
+    result.reserve(leaves_.size());
+    for (auto i = size_t{0}; i < leaves_.size(); ++i) {
+      result.push_back({RowSet{rows}, RowSet{rows}});
+    }
+    for (auto i = size_t{0}; i < leaves_.size(); ++i) {
+      const auto* leaf = try_as<ExprLeaf>(leaves_[i]);
+      if (not leaf) {
+        continue;
+      }
+      auto offset = size_t{0};
+      for (const auto& part : eval(leaf->expr, chunk, dh)) {
+        if (const auto* array = try_as<arrow::BooleanArray>(*part.array)) {
+          for (auto row = int64_t{0}; row < array->length(); ++row) {
+            if (array->IsValid(row)) {
+              (array->GetView(row) ? result[i].is_true : result[i].is_false)
+                .set(offset + row);
+            }
+          }
+        }
+        offset += part.length();
+      }
+    }
+    for (const auto& field : fields_) {
+      evaluate_regexes(field, chunk, result, dh);
+    }
+    return result;
+  }
+
+  /// Evaluates all regular expressions on a field, matching the semantics of
+  /// `match_regex`.
+  auto evaluate_regexes(const Field& field, const table_slice& chunk,
+                        std::vector<Truth>& result,
+                        diagnostic_handler& dh) const -> void {
+    if (field.leaves.empty()) {
+      return;
+    }
+    auto lowered = std::string{};
+    auto atoms = std::vector<int>{};
+    auto matched = std::vector<int>{};
+    auto offset = size_t{0};
+    for (const auto& part : eval(field.expr, chunk, dh)) {
+      const auto* array = try_as<arrow::StringArray>(*part.array);
+      if (not array) {
+        if (not is<null_type>(part.type)) {
+          diagnostic::warning("`match_regex` expected `string`, but got `{}`",
+                              part.type.kind())
+            .primary(field.expr)
+            .emit(dh);
+        }
+        offset += part.length();
+        continue;
+      }
+      for (auto i = int64_t{0}; i < array->length(); ++i) {
+        const auto row = offset + i;
+        if (array->IsNull(i)) {
+          continue;
+        }
+        const auto value = array->GetView(i);
+        const auto text = std::string_view{value.data(), value.size()};
+        // The atoms are lowercase, and RE2 folds case per Unicode. For
+        // non-ASCII text, lowering just ASCII letters could thus miss atoms,
+        // so we check every regular expression instead.
+        const auto ascii = std::ranges::all_of(value, [](char c) {
+          return static_cast<unsigned char>(c) < 0x80;
+        });
+        if (ascii) {
+          lowered.assign(value.begin(), value.end());
+          for (auto& c : lowered) {
+            if (c >= 'A' and c <= 'Z') {
+              c = static_cast<char>(c - 'A' + 'a');
+            }
+          }
+          field.atoms->find_all(lowered, atoms);
+          field.regexes.AllMatches(text, atoms, &matched);
+        } else {
+          matched.clear();
+          for (auto id = 0; id < field.regexes.NumRegexps(); ++id) {
+            if (re2::RE2::PartialMatch(text, field.regexes.GetRE2(id))) {
+              matched.push_back(id);
+            }
+          }
+        }
+        std::ranges::sort(matched);
+        auto next = matched.begin();
+        for (auto id = size_t{0}; id < field.leaves.size(); ++id) {
+          auto& truth = result[field.leaves[id]];
+          if (next != matched.end() and detail::narrow<size_t>(*next) == id) {
+            truth.is_true.set(row);
+            ++next;
+          } else {
+            truth.is_false.set(row);
+          }
+        }
+      }
+      offset += part.length();
+    }
+  }
+
+  auto evaluate_node(size_t index, const std::vector<Truth>& leaves,
+                     size_t rows) const -> Truth {
+    const auto& node = nodes_[index];
+    switch (node.kind) {
+      case Node::Kind::constant: {
+        auto result = Truth{RowSet{rows}, RowSet{rows}};
+        (node.value ? result.is_true : result.is_false).fill();
+        return result;
+      }
+      case Node::Kind::leaf:
+        return leaves[node.index];
+      case Node::Kind::not_: {
+        auto child = evaluate_node(node.children[0], leaves, rows);
+        std::swap(child.is_true, child.is_false);
+        return child;
+      }
+      case Node::Kind::and_: {
+        auto left = evaluate_node(node.children[0], leaves, rows);
+        auto right = evaluate_node(node.children[1], leaves, rows);
+        left.is_true &= right.is_true;
+        left.is_false |= right.is_false;
+        return left;
+      }
+      case Node::Kind::or_: {
+        auto left = evaluate_node(node.children[0], leaves, rows);
+        auto right = evaluate_node(node.children[1], leaves, rows);
+        left.is_true |= right.is_true;
+        left.is_false &= right.is_false;
+        return left;
+      }
+    }
+    TENZIR_UNREACHABLE();
+  }
+
+  std::vector<Rule> rules_;
+  std::vector<Node> nodes_;
+  std::vector<Leaf> leaves_;
+  std::unordered_map<std::string, size_t> leaf_ids_;
+  std::vector<Field> fields_;
+  std::unordered_map<std::string, size_t> field_ids_;
+};
+
+auto make_sigma_slice(table_slice event, const data& yaml)
   -> std::optional<table_slice> {
-  auto event = filter2(input, rule, dh, false);
   if (event.rows() == 0) {
     return std::nullopt;
   }
@@ -744,6 +1254,7 @@ public:
     auto rules = RuleMap{};
     auto path = std::filesystem::path{path_};
     update_rules(path, rules, ctrl.diagnostics());
+    auto plan = SigmaPlan{rules};
     auto last_update = std::chrono::steady_clock::now();
     co_yield {}; // signal that we're done initializing
     for (auto&& slice : input) {
@@ -753,12 +1264,13 @@ public:
       }
       auto now = std::chrono::steady_clock::now();
       if (now - last_update > refresh_interval_) {
-        update_rules(path, rules, ctrl.diagnostics());
+        if (update_rules(path, rules, ctrl.diagnostics())) {
+          plan = SigmaPlan{rules};
+        }
         last_update = now;
       }
-      for (const auto& [_, entry] : rules) {
-        if (auto result = make_sigma_slice(slice, entry.yaml, entry.rule,
-                                           ctrl.diagnostics())) {
+      for (auto& [entry, events] : plan.evaluate(slice, ctrl.diagnostics())) {
+        if (auto result = make_sigma_slice(std::move(events), entry->yaml)) {
           co_yield std::move(*result);
         }
       }
@@ -805,6 +1317,7 @@ public:
 
   auto start(OpCtx& ctx) -> Task<void> override {
     update_rules(path_, rules_, ctx.dh());
+    plan_ = SigmaPlan{rules_};
     last_update_ = std::chrono::steady_clock::now();
     co_return;
   }
@@ -813,12 +1326,13 @@ public:
     -> Task<void> override {
     auto now = std::chrono::steady_clock::now();
     if (now - last_update_ > args_.refresh_interval) {
-      update_rules(path_, rules_, ctx.dh());
+      if (update_rules(path_, rules_, ctx.dh())) {
+        plan_ = SigmaPlan{rules_};
+      }
       last_update_ = now;
     }
-    for (const auto& [_, entry] : rules_) {
-      if (auto result
-          = make_sigma_slice(input, entry.yaml, entry.rule, ctx.dh())) {
+    for (auto& [entry, events] : plan_.evaluate(input, ctx.dh())) {
+      if (auto result = make_sigma_slice(std::move(events), entry->yaml)) {
         co_await push(std::move(*result));
       }
     }
@@ -828,6 +1342,7 @@ private:
   SigmaArgs args_;
   std::filesystem::path path_;
   RuleMap rules_;
+  SigmaPlan plan_;
   // Rules are reloaded from disk in `start()`, and `last_update_` uses
   // `steady_clock`, so the default no-op snapshot behavior is sufficient.
   std::chrono::steady_clock::time_point last_update_ = {};
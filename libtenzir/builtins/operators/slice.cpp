@@ -581,9 +581,29 @@ public:
 
   auto describe() const -> Description override {
     auto d = Describer<SliceArgs, Slice>{};
-    d.named("begin", &SliceArgs::begin);
-    d.named("end", &SliceArgs::end);
+    auto begin = d.named("begin", &SliceArgs::begin);
+    auto end = d.named("end", &SliceArgs::end);
     auto stride = d.named("stride", &SliceArgs::stride);
+    d.limit([=](DescribeCtx& ctx) -> Option<ir::Limit> {
+      auto begin_value = ctx.get(begin);
+      auto end_value = ctx.get(end);
+      if ((not begin_value and ctx.get_location(begin))
+          or (not end_value and ctx.get_location(end))) {
+        // The bounds are not evaluated yet.
+        return None{};
+      }
+      // The stride only affects which events within the bounds are emitted.
+      if (end_value and *end_value >= 0) {
+        return ir::Limit{.count = static_cast<uint64_t>(*end_value)};
+      }
+      if (begin_value and *begin_value < 0) {
+        return ir::Limit{
+          .count = static_cast<uint64_t>(-(*begin_value + 1)) + 1,
+          .from_end = true,
+        };
+      }
+      return None{};
+    });
     d.validate([=](DescribeCtx& ctx) -> Empty {
       TRY(auto value, ctx.get(stride));
       if (value == 0) {
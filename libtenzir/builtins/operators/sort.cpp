@@ -6,8 +6,10 @@
 // SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
 // SPDX-License-Identifier: BSD-3-Clause
 
+#include <tenzir/arrow_memory_pool.hpp>
 #include <tenzir/arrow_table_slice.hpp>
 #include <tenzir/arrow_utils.hpp>
+#include <tenzir/async/blocking_executor.hpp>
 #include <tenzir/concept/parseable/numeric/integral.hpp>
 #include <tenzir/concept/parseable/tenzir/pipeline.hpp>
 #include <tenzir/diagnostics.hpp>
@@ -16,6 +18,8 @@
 #include <tenzir/operator_plugin.hpp>
 #include <tenzir/pipeline.hpp>
 #include <tenzir/plugin.hpp>
+#include <tenzir/si_literals.hpp>
+#include <tenzir/spill_file.hpp>
 #include <tenzir/table_slice.hpp>
 #include <tenzir/tql2/eval.hpp>
 #include <tenzir/tql2/plugin.hpp>
@@ -24,6 +28,12 @@
 #include <arrow/compute/api_vector.h>
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <numeric>
 #include <optional>
 #include <ranges>
 
@@ -31,6 +41,8 @@ namespace tenzir::plugins::sort {
 
 namespace {
 
+using namespace tenzir::si_literals;
+
 class sort_state {
 public:
   sort_state(const std::string& key,
@@ -464,11 +476,261 @@ private:
 
 struct SortArgs {
   std::vector<ast::expression> exprs;
+  uint64_t memory_limit = 1_Gi;
+  location operator_location;
+  Option<ir::Limit> limit;
 };
 
+/// Compares the values of a single sort key for two rows. Nulls always sort
+/// last, independent of the sort direction.
+auto compare_sort_key(multi_series const& lhs, int64_t lhs_row,
+                      multi_series const& rhs, int64_t rhs_row, bool reverse)
+  -> std::weak_ordering {
+  auto const lhs_value = lhs.view3_at(lhs_row);
+  auto const rhs_value = rhs.view3_at(rhs_row);
+  auto const lhs_null = is<caf::none_t>(lhs_value);
+  auto const rhs_null = is<caf::none_t>(rhs_value);
+  if (lhs_null and rhs_null) {
+    return std::weak_ordering::equivalent;
+  }
+  if (lhs_null) {
+    return std::weak_ordering::greater;
+  }
+  if (rhs_null) {
+    return std::weak_ordering::less;
+  }
+  auto const relation = weak_order(lhs_value, rhs_value);
+  return reverse ? 0 <=> relation : relation;
+}
+
+/// Returns whether values of the given type can be encoded as normalized keys.
+auto is_normalizable(type const& ty) -> bool {
+  return is<bool_type>(ty) or is<int64_type>(ty) or is<uint64_type>(ty)
+         or is<double_type>(ty) or is<duration_type>(ty) or is<time_type>(ty)
+         or is<string_type>(ty) or is<ip_type>(ty);
+}
+
+/// Returns whether normalized keys of the given type fit into 64 bits.
+auto is_fixed_width(type const& ty) -> bool {
+  return is_normalizable(ty) and not is<string_type>(ty)
+         and not is<ip_type>(ty);
+}
+
+/// Maps a value onto an unsigned integer whose natural order matches the order
+/// of `weak_order` for values of the same type.
+auto normalize(bool x) -> uint64_t {
+  return x ? 1 : 0;
+}
+
+auto normalize(int64_t x) -> uint64_t {
+  return std::bit_cast<uint64_t>(x) ^ (uint64_t{1} << 63);
+}
+
+auto normalize(uint64_t x) -> uint64_t {
+  return x;
+}
+
+auto normalize(double x) -> uint64_t {
+  // NaN sorts after all other values, and negative zero is equivalent to zero.
+  if (std::isnan(x)) {
+    x = std::numeric_limits<double>::quiet_NaN();
+  } else if (x == 0.0) {
+    x = 0.0;
+  }
+  auto const bits = std::bit_cast<uint64_t>(x);
+  constexpr auto sign = uint64_t{1} << 63;
+  return (bits & sign) != 0 ? ~bits : bits ^ sign;
+}
+
+/// Calls `f(row, normalized)` for every non-null row and `g(row)` for every
+/// null row of a fixed-width series.
+auto for_each_normalized(series const& part, auto&& f, auto&& g) -> void {
+  auto const visit = [&](auto const& array, auto&& get) {
+    for (auto row = int64_t{0}; row < array.length(); ++row) {
+      if (array.IsNull(row)) {
+        g(row);
+      } else {
+        f(row, normalize(get(array, row)));
+      }
+    }
+  };
+  auto const get_view = [](auto const& xs, int64_t row) {
+    return xs.GetView(row);
+  };
+  match(
+    *part.array,
+    [&](arrow::NullArray const& array) {
+      for (auto row = int64_t{0}; row < array.length(); ++row) {
+        g(row);
+      }
+    },
+    [&](arrow::BooleanArray const& array) {
+      visit(array, [](auto const& xs, int64_t row) -> bool {
+        return xs.GetView(row);
+      });
+    },
+    [&](arrow::Int64Array const& array) {
+      visit(array, get_view);
+    },
+    [&](arrow::UInt64Array const& array) {
+      visit(array, get_view);
+    },
+    [&](arrow::DoubleArray const& array) {
+      visit(array, get_view);
+    },
+    [&](arrow::DurationArray const& array) {
+      visit(array, [](auto const& xs, int64_t row) -> int64_t {
+        return xs.GetView(row);
+      });
+    },
+    [&](arrow::TimestampArray const& array) {
+      visit(array, [](auto const& xs, int64_t row) -> int64_t {
+        return xs.GetView(row);
+      });
+    },
+    [](auto const&) {
+      TENZIR_UNREACHABLE();
+    });
+}
+
+/// Appends the memcomparable encodings of all rows of a series to `out`, and
+/// records the end offset of each row in `ends`.
+///
+/// Every row starts with a marker byte that places nulls last, followed by the
+/// value in an encoding whose bytewise order matches the sort order. We invert
+/// the value bytes for descending keys. Strings escape NUL bytes and are
+/// terminated by two NUL bytes, so that prefixes sort first.
+auto encode_normalized(series const& part, bool reverse, std::string& out,
+                       std::vector<size_t>& ends) -> void {
+  auto const invert_from = [&](size_t begin) {
+    if (reverse) {
+      for (auto i = begin; i < out.size(); ++i) {
+        out[i] = static_cast<char>(~out[i]);
+      }
+    }
+  };
+  auto const append_null = [&](int64_t) {
+    out.push_back('\1');
+    ends.push_back(out.size());
+  };
+  if (is_fixed_width(part.type) or is<null_type>(part.type)) {
+    auto const width = is<bool_type>(part.type) ? 1 : 8;
+    for_each_normalized(
+      part,
+      [&](int64_t, uint64_t value) {
+        out.push_back('\0');
+        auto const begin = out.size();
+        for (auto i = width; i > 0; --i) {
+          out.push_back(static_cast<char>(value >> ((i - 1) * 8)));
+        }
+        invert_from(begin);
+        ends.push_back(out.size());
+      },
+      append_null);
+    return;
+  }
+  match(
+    *part.array,
+    [&](arrow::StringArray const& array) {
+      for (auto row = int64_t{0}; row < array.length(); ++row) {
+        if (array.IsNull(row)) {
+          append_null(row);
+          continue;
+        }
+        out.push_back('\0');
+        auto const begin = out.size();
+        for (auto c : array.GetView(row)) {
+          out.push_back(c);
+          if (c == '\0') {
+            out.push_back('\xff');
+          }
+        }
+        out.append(2, '\0');
+        invert_from(begin);
+        ends.push_back(out.size());
+      }
+    },
+    [&](ip_type::array_type const& array) {
+      auto const& storage
+        = static_cast<arrow::FixedSizeBinaryArray const&>(*array.storage());
+      for (auto row = int64_t{0}; row < array.length(); ++row) {
+        if (array.IsNull(row)) {
+          append_null(row);
+          continue;
+        }
+        out.push_back('\0');
+        auto const begin = out.size();
+        out.append(reinterpret_cast<char const*>(storage.GetValue(row)), 16);
+        invert_from(begin);
+        ends.push_back(out.size());
+      }
+    },
+    [](auto const&) {
+      TENZIR_UNREACHABLE();
+    });
+}
+
+/// Gathers the given rows of a table slice, which must be in ascending order.
+auto take_rows(table_slice const& input, std::vector<int64_t> const& rows)
+  -> table_slice {
+  auto builder = arrow::Int64Builder{arrow_memory_pool()};
+  check(builder.AppendValues(rows));
+  auto datum
+    = check(arrow::compute::Take(to_record_batch(input), finish(builder)));
+  TENZIR_ASSERT(datum.kind() == arrow::Datum::Kind::RECORD_BATCH);
+  auto result = table_slice{datum.record_batch(), input.schema()};
+  result.import_time(input.import_time());
+  return result;
+}
+
+/// Gathers the given rows of a multi series, which must be in ascending order.
+auto take_rows(multi_series const& input, std::vector<int64_t> const& rows)
+  -> multi_series {
+  auto result = multi_series{};
+  auto it = rows.begin();
+  auto offset = int64_t{0};
+  for (auto const& part : input) {
+    auto const end = offset + part.length();
+    auto builder = arrow::Int64Builder{arrow_memory_pool()};
+    for (; it != rows.end() and *it < end; ++it) {
+      check(builder.Append(*it - offset));
+    }
+    if (builder.length() > 0) {
+      result.append(series{
+        part.type, check(arrow::compute::Take(*part.array, *finish(builder))),
+      });
+    }
+    offset = end;
+  }
+  return result;
+}
+
+/// Sorts pairs by their first element with a stable least-significant-digit
+/// radix sort, skipping all digits that are identical for all elements.
+auto radix_sort(std::vector<std::pair<uint64_t, size_t>>& values) -> void {
+  auto buffer = std::vector<std::pair<uint64_t, size_t>>(values.size());
+  for (auto shift = 0; shift < 64; shift += 8) {
+    auto counts = std::array<size_t, 257>{};
+    for (auto const& value : values) {
+      ++counts[((value.first >> shift) & 0xff) + 1];
+    }
+    if (std::ranges::contains(counts, values.size())) {
+      continue;
+    }
+    std::partial_sum(counts.begin(), counts.end(), counts.begin());
+    for (auto const& value : values) {
+      buffer[counts[(value.first >> shift) & 0xff]++] = value;
+    }
+    std::swap(values, buffer);
+  }
+}
+
 class Sort final : public Operator<table_slice, table_slice> {
 public:
-  explicit Sort(SortArgs args) {
+  explicit Sort(SortArgs args)
+    : memory_limit_{args.memory_limit},
+      operator_location_{args.operator_location},
+      limit_{args.limit} {
     if (args.exprs.empty()) {
       keys_.emplace_back(ast::expression{ast::this_{location::unknown}});
       return;
@@ -487,87 +749,513 @@ public:
   auto process(table_slice input, Push<table_slice>& push, OpCtx& ctx)
     -> Task<void> override {
     TENZIR_UNUSED(push);
+    if (limit_ and limit_->count == 0) {
+      co_return;
+    }
+    auto keys = std::vector<multi_series>{};
+    keys.reserve(keys_.size());
+    for (auto const& key : keys_) {
+      keys.push_back(eval(key.expr, input, ctx.dh()));
+    }
+    if (limit_ and not keep_candidates(input, keys)) {
+      co_return;
+    }
+    buffer(std::move(input), std::move(keys));
+    if (limit_) {
+      // We let the buffer grow to twice the limit, or at least one batch,
+      // before reducing it back to the limit. This amortizes the cost of
+      // sorting and gathering the buffered events.
+      auto const slack = std::max(
+        limit_->count, uint64_t{defaults::import::table_slice_size});
+      if (indices_.size() >= limit_->count
+          and indices_.size() - limit_->count >= slack) {
+        reduce();
+      }
+    }
+    if (buffered_bytes_ > memory_limit_) {
+      co_await spill(ctx);
+    }
+  }
+
+  auto finalize(Push<table_slice>& push, OpCtx& ctx)
+    -> Task<FinalizeBehavior> override {
+    if (runs_.empty()) {
+      sort_buffered();
+      truncate_to_limit();
+      for (auto&& slice : take_sorted()) {
+        co_await push(std::move(slice));
+      }
+      co_return FinalizeBehavior::done;
+    }
+    // Once we spilled, we also spill the remainder so that the merge only has
+    // to deal with a single kind of run.
+    if (not indices_.empty()) {
+      co_await spill(ctx);
+    }
+    co_await merge_runs(push, ctx);
+    co_return FinalizeBehavior::done;
+  }
+
+private:
+  struct Key {
+    ast::expression expr;
+    bool reverse = false;
+    std::vector<multi_series> chunks;
+  };
+
+  /// The read position within a spilled run during the final merge.
+  struct Cursor {
+    SpillFile::Reader reader;
+    table_slice slice;
+    std::vector<multi_series> keys;
+    int64_t row = 0;
+  };
+
+  /// Appends an input slice and its evaluated sort keys to the buffer.
+  auto buffer(table_slice input, std::vector<multi_series> keys) -> void {
+    TENZIR_ASSERT(keys.size() == keys_.size());
     auto const length = detail::narrow<int64_t>(input.rows());
     indices_.reserve(indices_.size() + input.rows());
     for (auto i = int64_t{0}; i < length; ++i) {
       indices_.emplace_back(events_.size(), i);
     }
-    for (auto& key : keys_) {
-      key.chunks.emplace_back(eval(key.expr, input, ctx.dh()));
+    for (auto i = size_t{0}; i < keys_.size(); ++i) {
+      keys_[i].chunks.push_back(std::move(keys[i]));
     }
-    events_.emplace_back(std::move(input));
-    co_return;
+    buffered_bytes_ += input.approx_bytes();
+    events_.push_back(std::move(input));
   }
 
-  auto finalize(Push<table_slice>& push, OpCtx& ctx)
-    -> Task<FinalizeBehavior> override {
-    TENZIR_UNUSED(ctx);
-    if (indices_.empty()) {
-      co_return FinalizeBehavior::done;
+  /// Removes the events of an input slice that cannot be among the top-k
+  /// events, because they do not sort before the boundary event. When keeping
+  /// the last events, events that tie with the boundary are kept as well, as
+  /// the stable sort places them after it. Returns false if no event remains.
+  auto keep_candidates(table_slice& input, std::vector<multi_series>& keys)
+    -> bool {
+    TENZIR_ASSERT(limit_);
+    if (not boundary_) {
+      return true;
+    }
+    auto const [boundary_slice, boundary_row] = *boundary_;
+    auto const better = limit_->from_end ? std::weak_ordering::greater
+                                         : std::weak_ordering::less;
+    auto const length = detail::narrow<int64_t>(input.rows());
+    auto rows = std::vector<int64_t>{};
+    for (auto row = int64_t{0}; row < length; ++row) {
+      auto relation = std::weak_ordering::equivalent;
+      for (auto i = size_t{0}; i < keys_.size(); ++i) {
+        relation = compare_sort_key(keys[i], row,
+                                    keys_[i].chunks[boundary_slice],
+                                    boundary_row, keys_[i].reverse);
+        if (relation != std::weak_ordering::equivalent) {
+          break;
+        }
+      }
+      if (relation == better
+          or (limit_->from_end
+              and relation == std::weak_ordering::equivalent)) {
+        rows.push_back(row);
+      }
+    }
+    if (rows.empty()) {
+      return false;
+    }
+    if (detail::narrow<int64_t>(rows.size()) < length) {
+      input = take_rows(input, rows);
+      for (auto& key : keys) {
+        key = take_rows(key, rows);
+      }
+    }
+    return true;
+  }
+
+  /// Drops the sorted events that do not pass the limit.
+  auto truncate_to_limit() -> void {
+    if (not limit_ or indices_.size() <= limit_->count) {
+      return;
+    }
+    auto const excess = indices_.size() - limit_->count;
+    if (limit_->from_end) {
+      indices_.erase(indices_.begin(),
+                     indices_.begin() + detail::narrow<ptrdiff_t>(excess));
+    } else {
+      indices_.resize(limit_->count);
+    }
+  }
+
+  /// Reduces the buffer to the top-k events and remembers the event that
+  /// incoming events must beat.
+  auto reduce() -> void {
+    TENZIR_ASSERT(limit_);
+    sort_buffered();
+    truncate_to_limit();
+    auto sorted = std::vector<table_slice>{};
+    for (auto&& slice : take_sorted()) {
+      sorted.push_back(std::move(slice));
+    }
+    // The keys were already evaluated once, so we discard diagnostics for the
+    // second evaluation.
+    auto dh = null_diagnostic_handler{};
+    for (auto& slice : sorted) {
+      auto keys = std::vector<multi_series>{};
+      keys.reserve(keys_.size());
+      for (auto const& key : keys_) {
+        keys.push_back(eval(key.expr, slice, dh));
+      }
+      buffer(std::move(slice), std::move(keys));
+    }
+    // The buffer is now in sorted order, so the boundary is the last event for
+    // the top-k, and the first event for the bottom-k.
+    if (indices_.size() == limit_->count) {
+      boundary_ = limit_->from_end ? indices_.front() : indices_.back();
+    }
+  }
+
+  auto sort_buffered() -> void {
+    if (sort_normalized()) {
+      return;
     }
-    // TODO: If all chunks for a sort key evaluate to the same type, we can
-    // choose a faster path where we do not need to evaluate the sort key's
-    // type for each row individually.
     std::ranges::sort(indices_, [&](std::pair<size_t, int64_t> const& lhs,
                                     std::pair<size_t, int64_t> const& rhs) {
       for (auto const& key : keys_) {
-        auto const& lhs_chunk = key.chunks[lhs.first];
-        auto const& rhs_chunk = key.chunks[rhs.first];
-        auto const lhs_value = lhs_chunk.view3_at(lhs.second);
-        auto const rhs_value = rhs_chunk.view3_at(rhs.second);
-        auto const lhs_null = is<caf::none_t>(lhs_value);
-        auto const rhs_null = is<caf::none_t>(rhs_value);
-        if (lhs_null and rhs_null) {
-          continue;
+        auto const relation
+          = compare_sort_key(key.chunks[lhs.first], lhs.second,
+                             key.chunks[rhs.first], rhs.second, key.reverse);
+        if (relation != std::weak_ordering::equivalent) {
+          return relation == std::weak_ordering::less;
         }
-        if (lhs_null) {
-          return false;
+      }
+      return false;
+    });
+  }
+
+  /// Sorts the buffered events by encoding their sort keys into normalized
+  /// keys, which avoids dispatching on the type of every value for every
+  /// comparison. Returns false if a sort key does not evaluate to a single
+  /// supported type, in which case the caller must fall back to comparing
+  /// individual values.
+  auto sort_normalized() -> bool {
+    auto single_fixed_width = keys_.size() == 1;
+    for (auto const& key : keys_) {
+      auto key_type = std::optional<type>{};
+      for (auto const& chunk : key.chunks) {
+        for (auto const& part : chunk) {
+          if (is<null_type>(part.type)) {
+            continue;
+          }
+          if (not is_normalizable(part.type)) {
+            return false;
+          }
+          if (key_type and key_type->kind() != part.type.kind()) {
+            return false;
+          }
+          key_type = part.type;
         }
-        if (rhs_null) {
-          return true;
+      }
+      single_fixed_width
+        = single_fixed_width and (not key_type or is_fixed_width(*key_type));
+    }
+    // The buffered indices are in row order, so the position of an index
+    // before sorting identifies its row.
+    auto permutation = std::vector<size_t>{};
+    permutation.reserve(indices_.size());
+    if (single_fixed_width) {
+      // With a single fixed-width key, we sort the normalized values directly
+      // with a radix sort and append the rows with null keys at the end.
+      auto const& key = keys_.front();
+      auto values = std::vector<std::pair<uint64_t, size_t>>{};
+      values.reserve(indices_.size());
+      auto nulls = std::vector<size_t>{};
+      auto row = size_t{0};
+      for (auto const& chunk : key.chunks) {
+        for (auto const& part : chunk) {
+          for_each_normalized(
+            part,
+            [&](int64_t, uint64_t value) {
+              values.emplace_back(key.reverse ? ~value : value, row++);
+            },
+            [&](int64_t) {
+              nulls.push_back(row++);
+            });
         }
-        auto const relation = weak_order(lhs_value, rhs_value);
-        if (relation != std::weak_ordering::equivalent) {
-          return (relation == std::weak_ordering::less) != key.reverse;
+      }
+      TENZIR_ASSERT(row == indices_.size());
+      radix_sort(values);
+      for (auto const& value : values) {
+        permutation.push_back(value.second);
+      }
+      std::ranges::copy(nulls, std::back_inserter(permutation));
+    } else {
+      // Otherwise, we concatenate the encoded keys of every row and compare
+      // the resulting byte strings.
+      auto columns = std::vector<std::pair<std::string, std::vector<size_t>>>{};
+      columns.reserve(keys_.size());
+      for (auto const& key : keys_) {
+        auto& [bytes, ends] = columns.emplace_back();
+        ends.reserve(indices_.size());
+        for (auto const& chunk : key.chunks) {
+          for (auto const& part : chunk) {
+            encode_normalized(part, key.reverse, bytes, ends);
+          }
         }
+        TENZIR_ASSERT(ends.size() == indices_.size());
       }
-      return false;
+      auto buffer = std::string{};
+      auto offsets = std::vector<size_t>{};
+      offsets.reserve(indices_.size() + 1);
+      offsets.push_back(0);
+      for (auto row = size_t{0}; row < indices_.size(); ++row) {
+        for (auto const& [bytes, ends] : columns) {
+          auto const begin = row == 0 ? 0 : ends[row - 1];
+          buffer.append(bytes, begin, ends[row] - begin);
+        }
+        offsets.push_back(buffer.size());
+      }
+      columns.clear();
+      auto const normalized = [&](size_t row) {
+        return std::string_view{buffer}.substr(offsets[row],
+                                               offsets[row + 1] - offsets[row]);
+      };
+      for (auto row = size_t{0}; row < indices_.size(); ++row) {
+        permutation.push_back(row);
+      }
+      std::ranges::sort(permutation, [&](size_t lhs, size_t rhs) {
+        return normalized(lhs) < normalized(rhs);
+      });
+    }
+    auto sorted = std::vector<std::pair<size_t, int64_t>>{};
+    sorted.reserve(indices_.size());
+    for (auto row : permutation) {
+      sorted.push_back(indices_[row]);
+    }
+    indices_ = std::move(sorted);
+    return true;
+  }
+
+  /// Assembles the buffered events in their sorted order and releases them.
+  ///
+  /// We gather the events of every schema with a single `Take` and then emit
+  /// contiguous ranges of the gathered events.
+  auto take_sorted() -> generator<table_slice> {
+    auto events = std::exchange(events_, {});
+    auto indices = std::exchange(indices_, {});
+    boundary_.reset();
+    for (auto& key : keys_) {
+      key.chunks.clear();
+    }
+    buffered_bytes_ = 0;
+    struct Group {
+      std::vector<table_slice> slices;
+      int64_t rows = 0;
+      std::vector<int64_t> take;
+      table_slice gathered;
+      int64_t position = 0;
+    };
+    auto groups = std::vector<Group>{};
+    auto group_ids = std::unordered_map<type, size_t>{};
+    auto group_of = std::vector<size_t>{};
+    auto offset_of = std::vector<int64_t>{};
+    group_of.reserve(events.size());
+    offset_of.reserve(events.size());
+    for (auto& slice : events) {
+      auto [it, inserted] = group_ids.try_emplace(slice.schema(), groups.size());
+      if (inserted) {
+        groups.emplace_back();
+      }
+      auto& group = groups[it->second];
+      group_of.push_back(it->second);
+      offset_of.push_back(group.rows);
+      group.rows += detail::narrow<int64_t>(slice.rows());
+      group.slices.push_back(std::move(slice));
+    }
+    events.clear();
+    // Determine the rows to take per schema, and the sequence of schema
+    // changes in the sorted order.
+    auto runs = std::vector<std::pair<size_t, int64_t>>{};
+    for (auto const& [slice_idx, event_idx] : indices) {
+      auto const group = group_of[slice_idx];
+      groups[group].take.push_back(offset_of[slice_idx] + event_idx);
+      if (runs.empty() or runs.back().first != group) {
+        runs.emplace_back(group, 0);
+      }
+      runs.back().second += 1;
+    }
+    indices.clear();
+    for (auto& group : groups) {
+      auto combined = concatenate(std::exchange(group.slices, {}));
+      auto builder = arrow::Int64Builder{arrow_memory_pool()};
+      check(builder.AppendValues(group.take));
+      group.take = {};
+      auto datum = check(
+        arrow::compute::Take(to_record_batch(combined), finish(builder)));
+      TENZIR_ASSERT(datum.kind() == arrow::Datum::Kind::RECORD_BATCH);
+      group.gathered = table_slice{datum.record_batch(), combined.schema()};
+    }
+    for (auto [group_idx, length] : runs) {
+      auto& group = groups[group_idx];
+      while (length > 0) {
+        auto const count = std::min(
+          length, detail::narrow<int64_t>(defaults::import::table_slice_size));
+        co_yield subslice(group.gathered, group.position,
+                          group.position + count);
+        group.position += count;
+        length -= count;
+      }
+    }
+  }
+
+  /// Sorts the buffered events and writes them to disk as a sorted run.
+  auto spill(OpCtx& ctx) -> Task<void> {
+    if (spill_directory_.empty()) {
+      spill_directory_
+        = spill_directory(caf::content(ctx.actor_system().config()));
+    }
+    auto file = co_await spawn_blocking([&] {
+      return SpillFile::make(spill_directory_);
     });
-    // Assemble result, rebatching for efficiency.
+    if (not file) {
+      diagnostic::error("failed to create spill file: {}", file.error())
+        .primary(operator_location_)
+        .note("exceeded `memory_limit` of {} bytes", memory_limit_)
+        .emit(ctx);
+      co_return;
+    }
+    TENZIR_DEBUG("sort spills {} events ({} bytes) to {}", indices_.size(),
+                 buffered_bytes_, file->path());
+    sort_buffered();
+    truncate_to_limit();
+    for (auto&& slice : take_sorted()) {
+      auto err = co_await spawn_blocking([&] {
+        return file->write(slice);
+      });
+      if (err) {
+        diagnostic::error("failed to write spill file: {}", err)
+          .primary(operator_location_)
+          .note("file: {}", file->path())
+          .emit(ctx);
+        co_return;
+      }
+    }
+    runs_.push_back(std::move(*file));
+  }
+
+  /// Loads the next slice of a run. Returns false if the run is exhausted.
+  auto advance(Cursor& cursor, OpCtx& ctx) -> Task<bool> {
+    auto slice = co_await spawn_blocking([&] {
+      return cursor.reader.next_slice();
+    });
+    if (not slice) {
+      diagnostic::error("failed to read spill file: {}", slice.error())
+        .primary(operator_location_)
+        .emit(ctx);
+      co_return false;
+    }
+    if (slice->rows() == 0) {
+      co_return false;
+    }
+    // The sort keys were already evaluated once before spilling, so we discard
+    // diagnostics for the second evaluation.
+    auto dh = null_diagnostic_handler{};
+    cursor.keys.clear();
+    for (auto const& key : keys_) {
+      cursor.keys.push_back(eval(key.expr, *slice, dh));
+    }
+    cursor.slice = std::move(*slice);
+    cursor.row = 0;
+    co_return true;
+  }
+
+  auto compare_cursors(Cursor const& lhs, Cursor const& rhs) const
+    -> std::weak_ordering {
+    for (auto i = size_t{0}; i < keys_.size(); ++i) {
+      auto const relation = compare_sort_key(lhs.keys[i], lhs.row, rhs.keys[i],
+                                             rhs.row, keys_[i].reverse);
+      if (relation != std::weak_ordering::equivalent) {
+        return relation;
+      }
+    }
+    return std::weak_ordering::equivalent;
+  }
+
+  /// Performs a k-way merge over all spilled runs.
+  auto merge_runs(Push<table_slice>& push, OpCtx& ctx) -> Task<void> {
+    auto cursors = std::vector<Cursor>{};
+    cursors.reserve(runs_.size());
+    for (auto const& run : runs_) {
+      auto reader = run.read();
+      if (not reader) {
+        diagnostic::error("failed to read spill file: {}", reader.error())
+          .primary(operator_location_)
+          .note("file: {}", run.path())
+          .emit(ctx);
+        co_return;
+      }
+      cursors.push_back(Cursor{std::move(*reader), {}, {}, 0});
+    }
+    // The heap contains the indices of all non-exhausted cursors, with the
+    // cursor whose current row sorts first at the front. Ties are broken by
+    // the run index so that the output is deterministic.
+    auto after = [&](size_t lhs, size_t rhs) {
+      auto const relation = compare_cursors(cursors[lhs], cursors[rhs]);
+      if (relation == std::weak_ordering::equivalent) {
+        return lhs > rhs;
+      }
+      return relation == std::weak_ordering::greater;
+    };
+    auto heap = std::vector<size_t>{};
+    heap.reserve(cursors.size());
+    for (auto i = size_t{0}; i < cursors.size(); ++i) {
+      if (co_await advance(cursors[i], ctx)) {
+        heap.push_back(i);
+      }
+    }
+    std::ranges::make_heap(heap, after);
     auto batch = std::vector<table_slice>{};
     auto batch_rows = size_t{0};
-    for (auto const& [slice_idx, event_idx] : indices_) {
+    while (not heap.empty()) {
+      std::ranges::pop_heap(heap, after);
+      auto const current = heap.back();
+      heap.pop_back();
+      auto& cursor = cursors[current];
+      // Take as many rows from the current run as possible before another run
+      // has a row that sorts first.
+      auto const begin = cursor.row;
+      auto const length = detail::narrow<int64_t>(cursor.slice.rows());
+      do {
+        ++cursor.row;
+      } while (cursor.row < length
+               and (heap.empty() or not after(current, heap.front())));
       if (not batch.empty()
-          and batch.back().schema() != events_[slice_idx].schema()) {
+          and (batch.back().schema() != cursor.slice.schema()
+               or batch_rows >= defaults::import::table_slice_size)) {
         co_await push(concatenate(std::exchange(batch, {})));
         batch_rows = 0;
       }
-      if (batch_rows >= defaults::import::table_slice_size) {
-        co_await push(concatenate(std::exchange(batch, {})));
-        batch_rows = 0;
+      batch.push_back(subslice(cursor.slice, begin, cursor.row));
+      batch_rows += cursor.row - begin;
+      if (cursor.row < length or co_await advance(cursor, ctx)) {
+        heap.push_back(current);
+        std::ranges::push_heap(heap, after);
       }
-      // TODO: This excessive slicing is quite bad for performance. We could
-      // merge consecutive entries from the same slice.
-      batch.emplace_back(
-        subslice(events_[slice_idx], event_idx, event_idx + 1));
-      batch_rows += 1;
     }
     if (not batch.empty()) {
       co_await push(concatenate(std::move(batch)));
     }
-    co_return FinalizeBehavior::done;
+    runs_.clear();
   }
 
-private:
-  struct Key {
-    ast::expression expr;
-    bool reverse = false;
-    std::vector<multi_series> chunks;
-  };
-
+  uint64_t memory_limit_;
+  location operator_location_;
+  Option<ir::Limit> limit_;
   std::vector<Key> keys_;
   std::vector<table_slice> events_;
   std::vector<std::pair<size_t, int64_t>> indices_;
+  uint64_t buffered_bytes_ = 0;
+  /// The worst of the top-k events, which is only set if the buffer contains
+  /// exactly the top-k events of the input so far.
+  std::optional<std::pair<size_t, int64_t>> boundary_;
+  std::filesystem::path spill_directory_;
+  std::vector<SpillFile> runs_;
 };
 
 class plugin2 final : public virtual operator_plugin2<sort_operator2>,
@@ -576,6 +1264,14 @@ public:
   auto make(operator_factory_invocation inv, session ctx) const
     -> failure_or<operator_ptr> override {
     TENZIR_UNUSED(ctx);
+    // The legacy executor always sorts in memory, so it ignores the memory
+    // limit that the new executor uses to decide when to spill.
+    std::erase_if(inv.args, [](const ast::expression& arg) {
+      const auto* assignment = try_as<ast::assignment>(arg);
+      const auto* field
+        = assignment ? try_as<ast::root_field>(assignment->left) : nullptr;
+      return field and field->id.name == "memory_limit";
+    });
     if (inv.args.empty()) {
       return std::make_unique<sort_operator2>(std::vector<sort_expression>{{
         .expr = ast::this_{inv.self.get_location()},
@@ -604,6 +1300,9 @@ public:
   auto describe() const -> Description override {
     auto d = Describer<SortArgs, Sort>{};
     d.optional_variadic("expr", &SortArgs::exprs, "any");
+    d.named_optional("memory_limit", &SortArgs::memory_limit);
+    d.operator_location(&SortArgs::operator_location);
+    d.absorb_limit(&SortArgs::limit);
     return d.optimize([](DescribeCtx&, event_order order,
                          ir::optimize_filter filter) -> Optimization {
       return {
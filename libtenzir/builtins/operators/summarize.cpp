@@ -12,6 +12,7 @@
 #include <tenzir/arrow_time_utils.hpp>
 #include <tenzir/arrow_utils.hpp>
 #include <tenzir/async.hpp>
+#include <tenzir/async/blocking_executor.hpp>
 #include <tenzir/async/task.hpp>
 #include <tenzir/atomic.hpp>
 #include <tenzir/compile_ctx.hpp>
@@ -22,6 +23,7 @@
 #include <tenzir/detail/weak_run_delayed.hpp>
 #include <tenzir/error.hpp>
 #include <tenzir/hash/hash_append.hpp>
+#include <tenzir/hash/xxhash.hpp>
 #include <tenzir/ir.hpp>
 #include <tenzir/operator_control_plane.hpp>
 #include <tenzir/operator_plugin.hpp>
@@ -31,6 +33,8 @@
 #include <tenzir/plugin.hpp>
 #include <tenzir/series_builder.hpp>
 #include <tenzir/session.hpp>
+#include <tenzir/si_literals.hpp>
+#include <tenzir/spill_file.hpp>
 #include <tenzir/substitute_ctx.hpp>
 #include <tenzir/tql2/eval.hpp>
 #include <tenzir/tql2/plugin.hpp>
@@ -49,12 +53,15 @@
 #include <algorithm>
 #include <chrono>
 #include <ranges>
+#include <span>
 #include <utility>
 
 namespace tenzir::plugins::summarize {
 
 namespace {
 
+using namespace tenzir::si_literals;
+
 using std::chrono::steady_clock;
 
 /// The key by which aggregations are grouped. Essentially, this is a vector of
@@ -64,20 +71,11 @@ struct group_by_key : std::vector<data> {
   using vector::vector;
 };
 
-/// A view on a group-by key.
-struct group_by_key_view : std::vector<data_view3> {
-  using vector::vector;
-
-  /// Materializes a view on a group-by key.
-  /// @param views The group-by key view to materialize.
-  friend group_by_key materialize(const group_by_key_view& views) {
-    auto result = group_by_key{};
-    result.reserve(views.size());
-    for (const auto& view : views) {
-      result.push_back(materialize(view));
-    }
-    return result;
-  }
+/// A row of the evaluated group-by columns of a batch. This allows for probing
+/// the group index without materializing the key.
+struct group_by_row {
+  std::span<const multi_series> columns;
+  int64_t row;
 };
 
 /// The hash functor for enabling use of *group_by_key* as a key in unordered
@@ -91,10 +89,10 @@ struct group_by_key_hash {
     return hasher.finish();
   }
 
-  size_t operator()(const group_by_key_view& x) const noexcept {
+  size_t operator()(const group_by_row& x) const noexcept {
     auto hasher = xxh64{};
-    for (const auto& value : x) {
-      hash_append(hasher, value);
+    for (const auto& column : x.columns) {
+      hash_append(hasher, column.view3_at(x.row));
     }
     return hasher.finish();
   }
@@ -105,29 +103,32 @@ struct group_by_key_hash {
 struct group_by_key_equal {
   using is_transparent = void;
 
-  bool
-  operator()(const group_by_key_view& x, const group_by_key& y) const noexcept {
-    return std::equal(x.begin(), x.end(), y.begin(), y.end(),
-                      [](const auto& lhs, const auto& rhs) {
-                        return lhs == rhs;
-                      });
+  bool operator()(const group_by_row& x, const group_by_key& y) const noexcept {
+    TENZIR_ASSERT(x.columns.size() == y.size());
+    for (auto i = size_t{0}; i < y.size(); ++i) {
+      if (not(x.columns[i].view3_at(x.row) == y[i])) {
+        return false;
+      }
+    }
+    return true;
   }
 
-  bool
-  operator()(const group_by_key& x, const group_by_key_view& y) const noexcept {
-    return std::equal(x.begin(), x.end(), y.begin(), y.end(),
-                      [](const auto& lhs, const auto& rhs) {
-                        return lhs == rhs;
-                      });
+  bool operator()(const group_by_key& x, const group_by_row& y) const noexcept {
+    return (*this)(y, x);
   }
 
   bool operator()(const group_by_key& x, const group_by_key& y) const noexcept {
     return x == y;
   }
 
-  bool operator()(const group_by_key_view& x,
-                  const group_by_key_view& y) const noexcept {
-    return x == y;
+  bool operator()(const group_by_row& x, const group_by_row& y) const noexcept {
+    TENZIR_ASSERT(x.columns.size() == y.columns.size());
+    for (auto i = size_t{0}; i < x.columns.size(); ++i) {
+      if (not(x.columns[i].view3_at(x.row) == y.columns[i].view3_at(y.row))) {
+        return false;
+      }
+    }
+    return true;
   }
 };
 
@@ -170,6 +171,11 @@ struct config {
   /// evaluate_options() after let-bindings are substituted.
   std::optional<ast::expression> mode_expr;
 
+  /// Unevaluated expression for the `memory_limit` option. Set by
+  /// build_config when parsing options={memory_limit: <expr>}. Evaluated and
+  /// written to `memory_limit` by evaluate_options().
+  std::optional<ast::expression> memory_limit_expr;
+
   /// Optional frequency for periodic emission of aggregation results.
   /// Populated by evaluate_options().
   std::optional<duration> frequency;
@@ -178,14 +184,30 @@ struct config {
   /// Populated by evaluate_options(). Defaults to "reset".
   std::string mode = "reset";
 
+  /// Aggregation phase: "complete", "partial", or "merge". The partial phase
+  /// emits the serialized aggregation state for every group, which the merge
+  /// phase combines into the final result. Set by the optimizer when running
+  /// the partial phase in parallel.
+  std::string phase = "complete";
+
+  /// The approximate number of bytes of group state to keep in memory before
+  /// spilling to disk. Populated by evaluate_options().
+  uint64_t memory_limit = 1_Gi;
+
+  // Snapshots serialize these fields positionally, so adding, removing, or
+  // reordering fields requires bumping `Summarize::snapshot_version`.
   friend auto inspect(auto& f, config& x) -> bool {
     return f.object(x).fields(f.field("aggregates", x.aggregates),
                               f.field("groups", x.groups),
                               f.field("indices", x.indices),
                               f.field("frequency_expr", x.frequency_expr),
                               f.field("mode_expr", x.mode_expr),
+                              f.field("memory_limit_expr",
+                                      x.memory_limit_expr),
                               f.field("frequency", x.frequency),
-                              f.field("mode", x.mode));
+                              f.field("mode", x.mode),
+                              f.field("phase", x.phase),
+                              f.field("memory_limit", x.memory_limit));
   }
 };
 
@@ -193,118 +215,59 @@ template <class Value>
 using group_map
   = tsl::robin_map<group_by_key, Value, group_by_key_hash, group_by_key_equal>;
 
-struct bucket2 {
-  std::vector<std::unique_ptr<aggregation_instance>> aggregations;
+using aggregations_t
+  = std::vector<std::unique_ptr<grouped_aggregation_instance>>;
 
-  // Only the saving direction is handled here. Loading is performed at the
-  // implementation2 level via a temporary staging map so that blobs are never
-  // stored as a permanent member of live buckets.
-  friend auto inspect(auto& f, bucket2& x) -> bool {
-    static_assert(not std::remove_reference_t<decltype(f)>::is_loading,
-                  "bucket2 does not support direct loading; use the "
-                  "implementation2 staging path");
-    auto blobs = std::vector<chunk_ptr>{};
-    blobs.reserve(x.aggregations.size());
-    for (const auto& aggr : x.aggregations) {
-      blobs.push_back(aggr->save());
-    }
-    return f.apply(blobs);
-  }
-};
-
-class implementation2 {
+/// Adapts an aggregation function without a grouped implementation by keeping
+/// one aggregation instance per group.
+class per_group_aggregation final : public grouped_aggregation_instance {
 public:
-  implementation2() = default;
-
-  explicit implementation2(config cfg) : cfg_{std::move(cfg)} {
-  }
-
-  auto cfg() const -> const config& {
-    return cfg_;
-  }
-
-  auto saw_input() const noexcept -> bool {
-    return saw_input_;
+  per_group_aggregation(const aggregation_plugin& fn, ast::function_call call)
+    : fn_{fn}, call_{std::move(call)} {
   }
 
-  auto make_bucket(session ctx) -> bucket2 {
-    auto bucket = bucket2{};
-    for (const auto& aggr : cfg_.aggregates) {
-      // We already checked the cast and instantiation before.
-      const auto* fn
-        = dynamic_cast<const aggregation_plugin*>(&ctx.reg().get(aggr.call));
-      TENZIR_ASSERT(fn);
-      bucket.aggregations.push_back(
-        fn->make_aggregation(function_invocation{aggr.call}, ctx).unwrap());
-    }
-    return bucket;
-  }
-
-  void add(const table_slice& slice, session ctx) {
-    saw_input_ = true;
-    auto group_values = std::vector<multi_series>{};
-    for (auto& group : cfg_.groups) {
-      group_values.push_back(eval(group.expr.inner(), slice, ctx));
+  auto update(const table_slice& input, std::span<const uint32_t> groups,
+              session ctx) -> void override {
+    TENZIR_ASSERT(groups.size() == input.rows());
+    if (groups.empty()) {
+      return;
     }
-    auto key = group_by_key_view{};
-    key.reserve(cfg_.groups.size());
-    auto fill_key = [&](int64_t row) {
-      key.clear();
-      for (auto&& group : group_values) {
-        key.emplace_back(group.view3_at(row));
-      }
-    };
     // Collect the row ranges of every group in this slice first, then update
-    // each group's aggregations exactly once. Aggregation instances evaluate
+    // each group's aggregation exactly once. Aggregation instances evaluate
     // their argument expression on every update() call, so the number of
     // updates must be proportional to the number of *distinct groups* per
-    // slice rather than the number of group-key transitions. The latter
+    // slice rather than the number of group transitions. The latter
     // degenerates to one transition per row for interleaved inputs, which
     // makes per-transition updates prohibitively expensive.
     struct slice_group {
-      group_by_key key;
+      uint32_t group;
       std::vector<std::pair<int64_t, int64_t>> runs;
     };
     auto slice_groups = std::vector<slice_group>{};
-    auto seen = group_map<size_t>{};
-    auto find_or_add = [&](const group_by_key& key) -> size_t {
-      auto it = seen.find(key);
+    auto seen = tsl::robin_map<uint32_t, size_t>{};
+    auto add_run = [&](uint32_t group, int64_t begin, int64_t end) {
+      auto it = seen.find(group);
       if (it == seen.end()) {
-        it = seen.emplace_hint(it, key, slice_groups.size());
-        slice_groups.push_back({key, {}});
+        it = seen.emplace_hint(it, group, slice_groups.size());
+        slice_groups.push_back({group, {}});
       }
-      return it->second;
+      slice_groups[it->second].runs.emplace_back(begin, end);
     };
-    auto total_rows = detail::narrow<int64_t>(slice.rows());
-    fill_key(0);
-    auto current_key = materialize(key);
-    auto current_index = find_or_add(current_key);
-    auto current_begin = int64_t{0};
+    auto begin = int64_t{0};
+    const auto total_rows = detail::narrow<int64_t>(groups.size());
     for (auto row = int64_t{1}; row < total_rows; ++row) {
-      fill_key(row);
-      // Comparing against the current run's key avoids hashing and probing
-      // for every row; a hash lookup happens only at run transitions.
-      if (group_by_key_equal{}(key, current_key)) {
-        continue;
-      }
-      slice_groups[current_index].runs.emplace_back(current_begin, row);
-      current_key = materialize(key);
-      current_index = find_or_add(current_key);
-      current_begin = row;
-    }
-    slice_groups[current_index].runs.emplace_back(current_begin, total_rows);
-    // Apply the collected rows group by group. Groups are created in
-    // first-seen order, matching the previous behavior.
-    for (auto& sg : slice_groups) {
-      auto it = groups_.find(sg.key);
-      if (it == groups_.end()) {
-        it = groups_.emplace_hint(it, std::move(sg.key), make_bucket(ctx));
+      if (groups[row] != groups[row - 1]) {
+        add_run(groups[row - 1], begin, row);
+        begin = row;
       }
+    }
+    add_run(groups.back(), begin, total_rows);
+    for (const auto& sg : slice_groups) {
       auto rows = std::invoke([&]() -> table_slice {
         if (sg.runs.size() == 1) {
           // A single contiguous run needs no gather; slice it zero-copy.
           const auto [begin, end] = sg.runs.front();
-          return subslice(slice, begin, end);
+          return subslice(input, begin, end);
         }
         auto num_rows = int64_t{0};
         for (const auto [begin, end] : sg.runs) {
@@ -318,16 +281,121 @@ public:
           }
         }
         auto gathered = table_slice{
-          check(arrow::compute::Take(to_record_batch(slice), tenzir::finish(b)))
+          check(arrow::compute::Take(to_record_batch(input), tenzir::finish(b)))
             .record_batch(),
-          slice.schema(),
+          input.schema(),
         };
-        gathered.import_time(slice.import_time());
+        gathered.import_time(input.import_time());
         return gathered;
       });
-      for (auto& aggr : it.value().aggregations) {
-        aggr->update(rows, ctx);
+      instances_[sg.group]->update(rows, ctx);
+    }
+  }
+
+  auto get(uint32_t group) const -> data override {
+    return instances_[group]->get();
+  }
+
+  auto size() const -> size_t override {
+    return instances_.size();
+  }
+
+  auto resize(size_t groups) -> void override {
+    if (groups <= instances_.size()) {
+      instances_.resize(groups);
+      return;
+    }
+    // The aggregation was already instantiated successfully when the pipeline
+    // was compiled, so no diagnostics are expected here.
+    auto null_dh = null_diagnostic_handler{};
+    auto null_sp = session_provider::make(null_dh);
+    instances_.reserve(groups);
+    while (instances_.size() < groups) {
+      instances_.push_back(
+        fn_.make_aggregation(function_invocation{call_}, null_sp.as_session())
+          .unwrap());
+    }
+  }
+
+  auto save(uint32_t group) const -> chunk_ptr override {
+    return instances_[group]->save();
+  }
+
+  auto restore(uint32_t group, chunk_ptr chunk) noexcept -> bool override {
+    return instances_[group]->restore(std::move(chunk));
+  }
+
+  auto merge(uint32_t group, chunk_ptr partial) noexcept -> bool override {
+    return instances_[group]->merge(std::move(partial));
+  }
+
+private:
+  const aggregation_plugin& fn_;
+  ast::function_call call_;
+  std::vector<std::unique_ptr<aggregation_instance>> instances_;
+};
+
+class implementation2 {
+public:
+  implementation2() = default;
+
+  explicit implementation2(config cfg) : cfg_{std::move(cfg)} {
+    auto null_dh = null_diagnostic_handler{};
+    auto null_sp = session_provider::make(null_dh);
+    aggregations_ = make_aggregations(null_sp.as_session());
+  }
+
+  auto cfg() const -> const config& {
+    return cfg_;
+  }
+
+  auto saw_input() const noexcept -> bool {
+    return saw_input_;
+  }
+
+  /// Creates one aggregation per configured aggregate, which holds the state
+  /// for all groups. Aggregation functions without a grouped implementation
+  /// fall back to one aggregation instance per group.
+  auto make_aggregations(session ctx) const -> aggregations_t {
+    auto result = aggregations_t{};
+    result.reserve(cfg_.aggregates.size());
+    for (const auto& aggr : cfg_.aggregates) {
+      // We already checked the cast and instantiation before.
+      const auto* fn
+        = dynamic_cast<const aggregation_plugin*>(&ctx.reg().get(aggr.call));
+      TENZIR_ASSERT(fn);
+      auto grouped
+        = fn->make_grouped_aggregation(function_invocation{aggr.call}, ctx)
+            .unwrap();
+      if (not grouped) {
+        grouped = std::make_unique<per_group_aggregation>(*fn, aggr.call);
       }
+      result.push_back(std::move(grouped));
+    }
+    return result;
+  }
+
+  void add(const table_slice& slice, session ctx) {
+    saw_input_ = true;
+    if (slice.rows() == 0) {
+      return;
+    }
+    batches_since_sample_ += 1;
+    if (cfg_.phase == "merge") {
+      merge_partial(slice, ctx);
+      return;
+    }
+    auto group_values = std::vector<multi_series>{};
+    group_values.reserve(cfg_.groups.size());
+    for (auto& group : cfg_.groups) {
+      group_values.push_back(eval(group.expr.inner(), slice, ctx));
+    }
+    assign_groups(group_values, detail::narrow<size_t>(slice.rows()));
+    // Every aggregation consumes the whole batch at once, scattering its
+    // values into the per-group state by group id.
+    for (auto& aggr : aggregations_) {
+      aggr->resize(index_.size());
+      aggr->update(slice, group_ids_, ctx);
     }
   }
 
@@ -344,7 +412,7 @@ public:
     if (cfg_.mode == "reset") {
       // Emit all groups and reset the complete aggregation state.
       auto result = finish_impl(ctx);
-      groups_.clear();
+      clear_groups();
       return result;
     }
     if (cfg_.mode == "cumulative") {
@@ -354,31 +422,34 @@ public:
     TENZIR_ASSERT(cfg_.mode == "update");
     // Emit only groups where values changed
     auto b = series_builder{};
-    for (const auto& [key, group] : groups_) {
+    for (const auto& [key, group] : index_) {
       // Get current aggregation values.
       auto current_values = std::vector<data>{};
-      current_values.reserve(group.aggregations.size());
-      for (const auto& aggr : group.aggregations) {
-        current_values.push_back(aggr->get());
+      current_values.reserve(aggregations_.size());
+      for (const auto& aggr : aggregations_) {
+        current_values.push_back(aggr->get(group));
       }
       // Check if values changed (or first emission for this group).
       auto it = previous_values_.find(key);
       auto should_emit
         = (it == previous_values_.end()) or (it->second != current_values);
       if (should_emit) {
-        b.data(finish_group(key, group));
+        b.data(finish_group(key, aggregations_, group));
         previous_values_[key] = current_values;
       }
     }
     // Special case: if there are no configured groups, and no groups were
     // created because we didn't get any input events.
-    if (cfg_.groups.empty() and groups_.empty()) {
-      b.data(finish_group(group_by_key{}, make_bucket(ctx)));
+    if (cfg_.groups.empty() and index_.empty()) {
+      b.data(finish_empty(ctx));
     }
     return b.finish_as_table_slice();
   }
 
   auto finish(session ctx) -> std::vector<table_slice> {
+    if (cfg_.phase == "partial") {
+      return finish_partial();
+    }
     if (cfg_.mode == "update") {
       // Reuse flush to honor change detection for the final emission.
       return flush(true, ctx);
@@ -386,32 +457,242 @@ public:
     return finish_impl(ctx);
   }
 
+  /// Returns an estimate of the number of bytes held by the group state.
+  ///
+  /// The estimate extrapolates the size of a few sampled groups, which is
+  /// refreshed as the number of groups grows and periodically thereafter.
+  auto memusage() -> uint64_t {
+    if (index_.empty()) {
+      return 0;
+    }
+    if (bytes_per_group_ == 0 or index_.size() >= 2 * sampled_groups_
+        or batches_since_sample_ >= 64) {
+      sample_memusage();
+    }
+    return index_.size() * bytes_per_group_;
+  }
+
+  /// Returns the groups that fall into the given hash partition in the format
+  /// of the partial phase.
+  auto partial_partition(size_t partition, size_t partitions) const
+    -> std::vector<table_slice> {
+    TENZIR_ASSERT(partition < partitions);
+    auto b = series_builder{};
+    for (const auto& [key, group] : index_) {
+      if (partition_of(key, partitions) == partition) {
+        b.data(partial_group(key, group));
+      }
+    }
+    return b.finish_as_table_slice();
+  }
+
+  /// Combines the aggregation states emitted by the partial phase.
+  auto merge_partial(const table_slice& slice, session ctx) -> void {
+    const auto input = basic_series<record_type>{slice};
+    auto group_values = std::vector<multi_series>{};
+    group_values.reserve(cfg_.groups.size());
+    for (auto i = size_t{0}; i < cfg_.groups.size(); ++i) {
+      auto column = input.field(partial_group_field(i));
+      TENZIR_ASSERT(column);
+      group_values.emplace_back(std::move(*column));
+    }
+    assign_groups(group_values, detail::narrow<size_t>(slice.rows()));
+    auto failed = false;
+    for (auto i = size_t{0}; i < aggregations_.size(); ++i) {
+      auto& aggr = aggregations_[i];
+      aggr->resize(index_.size());
+      auto column = input.field(partial_state_field(i));
+      TENZIR_ASSERT(column);
+      // The column has the null type if no group produced a state.
+      const auto states = column->as<blob_type>();
+      if (not states) {
+        continue;
+      }
+      for (auto row = int64_t{0}; row < states->length(); ++row) {
+        if (states->array->IsNull(row)) {
+          continue;
+        }
+        const auto state = states->array->GetView(row);
+        failed |= not aggr->merge(group_ids_[row],
+                                  chunk::copy(state.data(), state.size()));
+      }
+    }
+    if (failed) {
+      diagnostic::warning("failed to merge partial aggregation state")
+        .note("the result may be incomplete")
+        .emit(ctx);
+    }
+  }
+
+  /// Emits the groups that are currently in memory and removes them. Unlike
+  /// `finish`, this emits nothing if there are no groups.
+  auto finish_partition() -> std::vector<table_slice> {
+    auto result = cfg_.phase == "partial" ? finish_partial() : finish_groups();
+    clear_groups();
+    return result;
+  }
+
+  auto clear_groups() -> void {
+    // Clearing keeps the bucket count of the index, which keeps the order in
+    // which groups are emitted stable across flushes.
+    index_.clear();
+    for (auto& aggr : aggregations_) {
+      aggr->resize(0);
+    }
+  }
+
   auto take_restore_failed() noexcept -> bool {
     return std::exchange(restore_failed_, false);
   }
 
   auto discard_snapshot(bool signal_failure = false) noexcept -> void {
-    groups_.clear();
+    clear_groups();
     previous_values_.clear();
     saw_input_ = false;
     restore_failed_ = signal_failure;
   }
 
 private:
+  static auto partial_group_field(size_t index) -> std::string {
+    return fmt::format("group_{}", index);
+  }
+
+  static auto partial_state_field(size_t index) -> std::string {
+    return fmt::format("state_{}", index);
+  }
+
+  /// Emits the groups together with their serialized aggregation state.
+  auto finish_partial() const -> std::vector<table_slice> {
+    auto b = series_builder{};
+    for (const auto& [key, group] : index_) {
+      b.data(partial_group(key, group));
+    }
+    return b.finish_as_table_slice();
+  }
+
+  auto partial_group(const group_by_key& key, uint32_t group) const -> record {
+    auto result = record{};
+    for (auto i = size_t{0}; i < key.size(); ++i) {
+      result.emplace(partial_group_field(i), key[i]);
+    }
+    for (auto i = size_t{0}; i < aggregations_.size(); ++i) {
+      auto state = aggregations_[i]->save(group);
+      result.emplace(partial_state_field(i),
+                     state ? data{blob(as_bytes(state))} : data{});
+    }
+    return result;
+  }
+
+  /// Assigns a group to one of the given number of hash partitions.
+  static auto partition_of(const group_by_key& key, size_t partitions)
+    -> size_t {
+    // We use the high bits of the hash, because the index uses the low bits to
+    // select a bucket. Partitioning by the low bits would make all groups of a
+    // partition collide in the index when they are merged again.
+    const auto hash = static_cast<uint64_t>(group_by_key_hash{}(key));
+    return static_cast<size_t>((hash >> 32) % partitions);
+  }
+
+  auto sample_memusage() -> void {
+    constexpr auto max_samples = size_t{8};
+    auto bytes = uint64_t{0};
+    auto samples = size_t{0};
+    for (auto it = index_.begin();
+         it != index_.end() and samples < max_samples; ++it, ++samples) {
+      const auto& [key, group] = *it;
+      bytes += sizeof(std::pair<group_by_key, uint32_t>);
+      for (const auto& value : key) {
+        bytes += sizeof(data);
+        if (const auto* str = try_as<std::string>(&value)) {
+          bytes += str->size();
+        } else if (const auto* bytes_value = try_as<blob>(&value)) {
+          bytes += bytes_value->size();
+        }
+      }
+      for (const auto& aggr : aggregations_) {
+        if (auto state = aggr->save(group)) {
+          bytes += state->size();
+        }
+      }
+    }
+    bytes_per_group_ = std::max(bytes / samples, uint64_t{1});
+    sampled_groups_ = index_.size();
+    batches_since_sample_ = 0;
+  }
+
+  /// Assigns a dense group id to every row of a batch, and adds previously
+  /// unseen groups to the index.
+  auto assign_groups(std::span<const multi_series> columns, size_t rows)
+    -> void {
+    // Hash the group-by columns one column at a time. This yields the same
+    // hash as `group_by_key_hash`, but avoids resolving the part of every
+    // column for every row.
+    hashers_.assign(rows, xxh64{});
+    for (const auto& column : columns) {
+      auto row = size_t{0};
+      for (const auto& part : column) {
+        for (auto value : values3(*part.array)) {
+          hash_append(hashers_[row++], value);
+        }
+      }
+      TENZIR_ASSERT(row == rows);
+    }
+    group_ids_.resize(rows);
+    auto previous_hash = size_t{0};
+    for (auto row = size_t{0}; row < rows; ++row) {
+      const auto hash = static_cast<size_t>(hashers_[row].finish());
+      const auto probe = group_by_row{columns, detail::narrow<int64_t>(row)};
+      // Consecutive rows frequently belong to the same group, in which case we
+      // can skip probing the index.
+      if (row > 0 and hash == previous_hash
+          and group_by_key_equal{}(
+            probe, group_by_row{columns, detail::narrow<int64_t>(row - 1)})) {
+        group_ids_[row] = group_ids_[row - 1];
+        continue;
+      }
+      previous_hash = hash;
+      auto it = index_.find(probe, hash);
+      if (it == index_.end()) {
+        auto key = group_by_key{};
+        key.reserve(columns.size());
+        for (const auto& column : columns) {
+          key.push_back(materialize(column.view3_at(probe.row)));
+        }
+        it = index_
+               .emplace(std::move(key), detail::narrow<uint32_t>(index_.size()))
+               .first;
+      }
+      group_ids_[row] = it->second;
+    }
+  }
+
+  /// Finishes a fresh set of aggregations for the case where no group exists.
+  auto finish_empty(session ctx) const -> record {
+    auto aggregations = make_aggregations(ctx);
+    for (auto& aggr : aggregations) {
+      aggr->resize(1);
+    }
+    return finish_group(group_by_key{}, aggregations, 0);
+  }
+
   auto finish_impl(session ctx) -> std::vector<table_slice> {
     // Special case: if there are no configured groups, and no groups were
     // created because we didn't get any input events, then we create a new
-    // bucket and just finish it. That way, `from [] | summarize count()` will
+    // group and just finish it. That way, `from [] | summarize count()` will
     // return a single event showing a count of zero.
-    if (cfg_.groups.empty() and groups_.empty()) {
+    if (cfg_.groups.empty() and index_.empty()) {
       auto b = series_builder{};
-      b.data(finish_group(group_by_key{}, make_bucket(ctx)));
+      b.data(finish_empty(ctx));
       return b.finish_as_table_slice();
     }
+    return finish_groups();
+  }
+
+  auto finish_groups() const -> std::vector<table_slice> {
     // TODO: Group by schema again to make this more efficient.
     auto b = series_builder{};
-    for (const auto& [key, group] : groups_) {
-      b.data(finish_group(key, group));
+    for (const auto& [key, group] : index_) {
+      b.data(finish_group(key, aggregations_, group));
     }
     return b.finish_as_table_slice();
   }
@@ -443,14 +724,15 @@ private:
     }
   }
 
-  /// Builds the output record for one group bucket.
-  auto finish_group(const group_by_key& key, const bucket2& bucket) const
+  /// Builds the output record for one group.
+  auto finish_group(const group_by_key& key,
+                    const aggregations_t& aggregations, uint32_t group) const
     -> record {
     auto result = record{};
     for (auto index : cfg_.indices) {
       if (index >= 0) {
         const auto& dest = cfg_.aggregates[index].dest;
-        auto value = bucket.aggregations[index]->get();
+        auto value = aggregations[index]->get(group);
         if (dest) {
           emplace_value(result, *dest, value);
         } else {
@@ -497,19 +779,23 @@ private:
   }
 
   friend auto inspect(auto& f, implementation2& x) -> bool {
+    // The groups are (de)serialized as a map from key to one blob per
+    // aggregation via a temporary staging map, so that the group index in
+    // steady state never carries the serialized state.
+    auto staging = group_map<std::vector<chunk_ptr>>{};
     if constexpr (std::remove_reference_t<decltype(f)>::is_loading) {
-      // Load group blobs into a temporary staging map so that bucket2 objects
-      // in steady state never carry an extra vector<chunk_ptr>. The staging
-      // map is destroyed at the end of this inspect call.
-      auto staging = group_map<std::vector<chunk_ptr>>{};
       auto on_load = [&]() noexcept {
-        // Use a null diagnostic handler: make_bucket() is called only to
-        // instantiate fresh aggregation objects for restore; the pipeline was
-        // already validated at compile time so no real diagnostics are expected.
+        // Use a null diagnostic handler: the aggregations are instantiated
+        // only for restore; the pipeline was already validated at compile
+        // time so no real diagnostics are expected.
         auto null_dh = null_diagnostic_handler{};
         auto null_sp = session_provider::make(null_dh);
-        const auto expected
-          = x.make_bucket(null_sp.as_session()).aggregations.size();
+        x.aggregations_ = x.make_aggregations(null_sp.as_session());
+        x.index_.clear();
+        const auto expected = x.aggregations_.size();
+        for (auto& aggr : x.aggregations_) {
+          aggr->resize(staging.size());
+        }
         for (auto it = staging.begin(); it != staging.end(); ++it) {
           auto& blobs = it.value();
           if (blobs.size() != expected) {
@@ -520,16 +806,16 @@ private:
             x.discard_snapshot();
             return true;
           }
-          auto fresh = x.make_bucket(null_sp.as_session());
+          const auto group = detail::narrow<uint32_t>(x.index_.size());
           for (auto i = size_t{0}; i < blobs.size(); ++i) {
-            if (not fresh.aggregations[i]->restore(std::move(blobs[i]))) {
+            if (not x.aggregations_[i]->restore(group, std::move(blobs[i]))) {
               TENZIR_WARN("summarize: failed to restore aggregation state; "
                           "discarding snapshot and starting fresh");
               x.discard_snapshot(/*signal_failure=*/true);
               return true;
             }
           }
-          x.groups_.emplace(it->first, std::move(fresh));
+          x.index_.emplace(it->first, group);
         }
         return true;
       };
@@ -538,9 +824,18 @@ private:
         f.field("groups", staging),
         f.field("previous_values", x.previous_values_));
     } else {
+      staging.reserve(x.index_.size());
+      for (const auto& [key, group] : x.index_) {
+        auto blobs = std::vector<chunk_ptr>{};
+        blobs.reserve(x.aggregations_.size());
+        for (const auto& aggr : x.aggregations_) {
+          blobs.push_back(aggr->save(group));
+        }
+        staging.emplace(key, std::move(blobs));
+      }
       return f.object(x).fields(f.field("cfg", x.cfg_),
                                 f.field("saw_input", x.saw_input_),
-                                f.field("groups", x.groups_),
+                                f.field("groups", staging),
                                 f.field("previous_values", x.previous_values_));
     }
   }
@@ -554,11 +849,20 @@ private:
   }
 
   config cfg_;
-  group_map<bucket2> groups_;
+  /// Maps every group to its dense id, which indexes the aggregation state.
+  group_map<uint32_t> index_;
+  aggregations_t aggregations_;
   bool saw_input_ = false;
   bool restore_failed_ = false;
   /// Previous aggregation values for each group (used in "update" mode)
   group_map<std::vector<data>> previous_values_;
+  /// Scratch buffers for assigning group ids, reused across batches.
+  std::vector<xxh64> hashers_;
+  std::vector<uint32_t> group_ids_;
+  /// The memory usage per group as of the last sample.
+  uint64_t bytes_per_group_ = 0;
+  size_t sampled_groups_ = 0;
+  size_t batches_since_sample_ = 0;
 };
 
 // ---------------------------------------------------------------------------
@@ -594,6 +898,8 @@ auto build_config(std::vector<ast::expression> exprs, session ctx)
         cfg.frequency_expr = field->expr;
       } else if (name == "mode") {
         cfg.mode_expr = field->expr;
+      } else if (name == "memory_limit") {
+        cfg.memory_limit_expr = field->expr;
       } else {
         diagnostic::error("unknown option `{}`", name)
           .primary(field->name)
@@ -754,6 +1060,33 @@ auto evaluate_options(config& cfg, session ctx) -> failure_or<void> {
       return failure::promise();
     }
   }
+  if (cfg.memory_limit_expr) {
+    TRY(auto value, const_eval(*cfg.memory_limit_expr, ctx));
+    auto limit = match(
+      value,
+      [](int64_t x) -> std::optional<uint64_t> {
+        if (x <= 0) {
+          return std::nullopt;
+        }
+        return static_cast<uint64_t>(x);
+      },
+      [](uint64_t x) -> std::optional<uint64_t> {
+        if (x == 0) {
+          return std::nullopt;
+        }
+        return x;
+      },
+      [](const auto&) -> std::optional<uint64_t> {
+        return std::nullopt;
+      });
+    if (not limit) {
+      diagnostic::error("expected positive integer for `memory_limit`")
+        .primary(*cfg.memory_limit_expr)
+        .emit(ctx);
+      return failure::promise();
+    }
+    cfg.memory_limit = *limit;
+  }
   if (cfg.mode_expr and not cfg.frequency) {
     diagnostic::error("`mode` requires `frequency` to be set")
       .primary(*cfg.mode_expr)
@@ -875,8 +1208,9 @@ private:
 
 class Summarize final : public Operator<table_slice, table_slice> {
 public:
-  explicit Summarize(config cfg)
-    : impl_{std::make_unique<implementation2>(std::move(cfg))} {
+  Summarize(config cfg, location operator_location)
+    : impl_{std::make_unique<implementation2>(std::move(cfg))},
+      operator_location_{operator_location} {
   }
 
   auto start(OpCtx& ctx) -> Task<void> override {
@@ -910,17 +1244,22 @@ public:
                           "from snapshot; restarting from empty state")
         .emit(provider_->as_session());
     }
-    co_await flush_until(steady_clock::now(), push);
+    co_await flush_until(steady_clock::now(), push, ctx);
     if (impl_->cfg().frequency and not next_flush_) {
       arm_timer();
     }
     impl_->add(input, provider_->as_session());
-    co_return;
+    if (can_spill() and impl_->memusage() > impl_->cfg().memory_limit) {
+      co_await spill(ctx);
+    }
   }
 
   auto finalize(Push<table_slice>& push, OpCtx& ctx)
     -> Task<FinalizeBehavior> override {
-    TENZIR_UNUSED(ctx);
+    if (not partitions_.empty()) {
+      co_await finish_spilled(push, ctx);
+      co_return FinalizeBehavior::done;
+    }
     for (auto& slice : impl_->finish(provider_->as_session())) {
       co_await push(std::move(slice));
     }
@@ -938,17 +1277,40 @@ public:
 
   auto process_task(Any result, Push<table_slice>& push, OpCtx& ctx)
     -> Task<void> override {
-    TENZIR_UNUSED(ctx);
     auto* tick = result.try_as<TimerTick>();
     TENZIR_ASSERT(tick);
-    co_await flush_until(tick->deadline, push);
+    co_await flush_until(tick->deadline, push, ctx);
+  }
+
+  auto prepare_snapshot(Push<table_slice>& push, OpCtx& ctx)
+    -> Task<void> override {
+    TENZIR_UNUSED(push);
+    // The snapshot only covers the state in memory, so we have to load spilled
+    // groups back first. Snapshots are rare compared to the cost of losing the
+    // spilled state.
+    co_await unspill(ctx);
   }
 
   auto snapshot(Serde& serde) -> void override {
+    auto version = snapshot_version;
+    serde("version", version);
+    if (version != snapshot_version) {
+      // The remaining fields are positional, so we cannot make sense of them.
+      TENZIR_WARN("summarize: snapshot has unsupported version {:#x}; "
+                  "discarding snapshot and starting fresh",
+                  version);
+      impl_->discard_snapshot(/*signal_failure=*/true);
+      return;
+    }
     serde("state", *impl_);
   }
 
 private:
+  /// The version of the snapshot format, which precedes the state. Snapshots
+  /// from before the version was introduced start with the number of
+  /// aggregations instead, which the magic prefix keeps from matching.
+  static constexpr auto snapshot_version = uint64_t{0x7375'6d6d'0000'0001};
+
   struct TimerTick {
     steady_clock::time_point deadline;
   };
@@ -966,8 +1328,8 @@ private:
     frontier_queue_->enqueue(*next_flush_);
   }
 
-  auto flush_until(steady_clock::time_point deadline, Push<table_slice>& push)
-    -> Task<void> {
+  auto flush_until(steady_clock::time_point deadline, Push<table_slice>& push,
+                   OpCtx& ctx) -> Task<void> {
     if (not next_flush_) {
       co_return;
     }
@@ -975,8 +1337,12 @@ private:
     TENZIR_ASSERT(impl_->cfg().frequency);
     while (*next_flush_ <= deadline) {
       frontier_changed = true;
-      for (auto& slice : impl_->flush(provider_->as_session())) {
-        co_await push(std::move(slice));
+      if (not partitions_.empty()) {
+        co_await finish_spilled(push, ctx);
+      } else {
+        for (auto& slice : impl_->flush(provider_->as_session())) {
+          co_await push(std::move(slice));
+        }
       }
       *next_flush_ += *impl_->cfg().frequency;
     }
@@ -985,7 +1351,130 @@ private:
     }
   }
 
+  /// Whether the group state may be spilled to disk. We only spill if emitting
+  /// also resets the state, as every emission has to read all spilled groups
+  /// back. Spilling is pointless without groups, as it cannot split the state.
+  auto can_spill() const -> bool {
+    return not impl_->cfg().groups.empty() and impl_->cfg().mode == "reset";
+  }
+
+  /// Writes all groups in memory to the spill file of their hash partition.
+  auto spill(OpCtx& ctx) -> Task<void> {
+    if (partitions_.empty()) {
+      const auto directory
+        = spill_directory(caf::content(ctx.actor_system().config()));
+      for (auto i = size_t{0}; i < spill_partitions; ++i) {
+        auto file = co_await spawn_blocking([&] {
+          return SpillFile::make(directory);
+        });
+        if (not file) {
+          diagnostic::error("failed to create spill file: {}", file.error())
+            .primary(operator_location_)
+            .note("exceeded `memory_limit` of {} bytes",
+                  impl_->cfg().memory_limit)
+            .emit(ctx);
+          partitions_.clear();
+          co_return;
+        }
+        partitions_.push_back(std::move(*file));
+      }
+    }
+    TENZIR_DEBUG("summarize spills approximately {} bytes of group state",
+                 impl_->memusage());
+    for (auto i = size_t{0}; i < partitions_.size(); ++i) {
+      for (auto& slice : impl_->partial_partition(i, partitions_.size())) {
+        auto err = co_await spawn_blocking([&] {
+          return partitions_[i].write(slice);
+        });
+        if (err) {
+          diagnostic::error("failed to write spill file: {}", err)
+            .primary(operator_location_)
+            .note("file: {}", partitions_[i].path())
+            .emit(ctx);
+          co_return;
+        }
+      }
+    }
+    impl_->clear_groups();
+  }
+
+  /// Reads back one partition at a time, combines the spilled states of every
+  /// group, and emits the result.
+  auto finish_spilled(Push<table_slice>& push, OpCtx& ctx) -> Task<void> {
+    // Spilling the remaining groups first ensures that all state of a group
+    // ends up in the same partition.
+    co_await spill(ctx);
+    auto partitions = std::exchange(partitions_, {});
+    for (const auto& partition : partitions) {
+      auto reader = partition.read();
+      if (not reader) {
+        diagnostic::error("failed to read spill file: {}", reader.error())
+          .primary(operator_location_)
+          .note("file: {}", partition.path())
+          .emit(ctx);
+        co_return;
+      }
+      while (true) {
+        auto slice = co_await spawn_blocking([&] {
+          return reader->next_slice();
+        });
+        if (not slice) {
+          diagnostic::error("failed to read spill file: {}", slice.error())
+            .primary(operator_location_)
+            .note("file: {}", partition.path())
+            .emit(ctx);
+          co_return;
+        }
+        if (slice->rows() == 0) {
+          break;
+        }
+        impl_->merge_partial(*slice, provider_->as_session());
+      }
+      for (auto& slice : impl_->finish_partition()) {
+        co_await push(std::move(slice));
+      }
+    }
+  }
+
+  /// Merges all spilled groups back into memory.
+  auto unspill(OpCtx& ctx) -> Task<void> {
+    auto partitions = std::exchange(partitions_, {});
+    for (const auto& partition : partitions) {
+      auto reader = co_await spawn_blocking([&] {
+        return partition.read();
+      });
+      if (not reader) {
+        diagnostic::error("failed to read spill file: {}", reader.error())
+          .primary(operator_location_)
+          .note("file: {}", partition.path())
+          .emit(ctx);
+        co_return;
+      }
+      while (true) {
+        auto slice = co_await spawn_blocking([&] {
+          return reader->next_slice();
+        });
+        if (not slice) {
+          diagnostic::error("failed to read spill file: {}", slice.error())
+            .primary(operator_location_)
+            .note("file: {}", partition.path())
+            .emit(ctx);
+          co_return;
+        }
+        if (slice->rows() == 0) {
+          break;
+        }
+        impl_->merge_partial(*slice, provider_->as_session());
+      }
+    }
+  }
+
+  /// The number of hash partitions that the groups are spilled to.
+  static constexpr auto spill_partitions = size_t{16};
+
   std::unique_ptr<implementation2> impl_;
+  location operator_location_;
+  std::vector<SpillFile> partitions_;
   Option<session_provider> provider_;
   Option<steady_clock::time_point> next_flush_;
   Arc<FrontierQueue> frontier_queue_{std::in_place};
@@ -1020,6 +1509,9 @@ public:
     if (cfg_.mode_expr) {
       TRY(cfg_.mode_expr->substitute(ctx));
     }
+    if (cfg_.memory_limit_expr) {
+      TRY(cfg_.memory_limit_expr->substitute(ctx));
+    }
     // Validate aggregation arguments and evaluate options only when
     // instantiating, i.e., when all let-bindings are guaranteed to be
     // resolved.  Both make_aggregation (for aggregates) and const_eval (for
@@ -1034,7 +1526,7 @@ public:
 
   auto spawn(element_type_tag input) const -> AnyOperator override {
     TENZIR_ASSERT(input.is<table_slice>());
-    return Summarize{cfg_}.with_name("summarize");
+    return Summarize{cfg_, self_}.with_name("summarize");
   }
 
   auto infer_type(element_type_tag input, diagnostic_handler& dh) const
@@ -1046,6 +1538,22 @@ public:
     return tag_v<table_slice>;
   }
 
+  auto split_partial() const -> Option<ir::PartialSplit> override {
+    // Periodic emission depends on the arrival of events, which the merge phase
+    // cannot observe.
+    if (cfg_.phase != "complete" or cfg_.frequency_expr or cfg_.mode_expr) {
+      return None{};
+    }
+    auto partial = cfg_;
+    partial.phase = "partial";
+    auto merge = cfg_;
+    merge.phase = "merge";
+    return ir::PartialSplit{
+      .partial = summarize_ir{self_, std::move(partial)},
+      .merge = summarize_ir{self_, std::move(merge)},
+    };
+  }
+
   auto main_location() const -> location override {
     return self_;
   }
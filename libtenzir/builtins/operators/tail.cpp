@@ -78,7 +78,17 @@ public:
 
   auto describe() const -> Description override {
     auto d = Describer<TailArgs, Tail>{};
-    d.optional_positional("count", &TailArgs::count);
+    auto count = d.optional_positional("count", &TailArgs::count);
+    d.limit([count](DescribeCtx& ctx) -> Option<ir::Limit> {
+      if (auto value = ctx.get(count)) {
+        return ir::Limit{.count = *value, .from_end = true};
+      }
+      if (ctx.get_location(count)) {
+        // The count is not evaluated yet.
+        return None{};
+      }
+      return ir::Limit{.count = TailArgs{}.count, .from_end = true};
+    });
     return d.without_optimize();
   }
 };
@@ -182,6 +182,10 @@ public:
     serde("count", count_);
   }
 
+  auto resumable() const -> bool override {
+    return true;
+  }
+
   auto state() -> OperatorState override {
     if (count_ == total) {
       return OperatorState::done;
@@ -307,6 +307,8 @@ struct exec_node_sink_actor_traits {
   using signatures = caf::type_list<
     // Push events.
     auto(atom::push, table_slice events)->caf::result<void>,
+    // Push events through shared memory from a process on the same host.
+    auto(atom::push, shared_table_slice events)->caf::result<void>,
     // Push bytes.
     auto(atom::push, chunk_ptr bytes)->caf::result<void>>;
 };
@@ -368,16 +370,20 @@ struct export_mode {
   bool internal = false;
   uint64_t parallel = 3;
   bool high_priority = false;
+  /// Whether to emit the events of historical partitions in the order of
+  /// their import time.
+  bool ordered = false;
 
   export_mode() = default;
 
   export_mode(bool retro_, bool live_, bool internal_, uint64_t parallel_,
-              bool high_priority_ = false)
+              bool high_priority_ = false, bool ordered_ = false)
     : retro{retro_},
       live{live_},
       internal{internal_},
       parallel{parallel_},
-      high_priority{high_priority_} {
+      high_priority{high_priority_},
+      ordered{ordered_} {
     TENZIR_ASSERT(live or retro);
   }
 
@@ -386,7 +392,8 @@ struct export_mode {
                               f.field("live", x.live),
                               f.field("internal", x.internal),
                               f.field("parallel", x.parallel),
-                              f.field("high_priority", x.high_priority));
+                              f.field("high_priority", x.high_priority),
+                              f.field("ordered", x.ordered));
   }
 };
 
@@ -396,7 +403,10 @@ struct export_bridge_actor_traits {
     // Returns when a new table slice is available.
     auto(atom::get)->caf::result<table_slice>,
     // Insert a new table slice.
-    auto(table_slice slice)->caf::result<void>>;
+    auto(table_slice slice)->caf::result<void>,
+    // Insert a table slice of the historical partition with the given
+    // sequence number.
+    auto(table_slice slice, uint64_t sequence)->caf::result<void>>;
 };
 using export_bridge_actor = caf::typed_actor<export_bridge_actor_traits>;
 
@@ -42,6 +42,8 @@
 /// - Sources use `await_task()` to drive data production. To run indefinitely,
 ///   never return `done` from `state()`.
 /// - `snapshot()` handles both serialization and deserialization via `Serde`.
+/// - Sources must override `resumable()` to take part in checkpointing, as
+///   restoring downstream state without their read position duplicates input.
 
 #pragma once
 
@@ -425,6 +427,13 @@ public:
     TENZIR_UNUSED(serde);
   }
 
+  /// Whether a source persists its read position in its snapshot, so that a
+  /// pipeline restored from a checkpoint neither replays nor skips input. The
+  /// executor rejects checkpointing for pipelines whose source returns false.
+  virtual auto resumable() const -> bool {
+    return false;
+  }
+
   /// Return task for sources to await. See file-level docs.
   virtual auto await_task(diagnostic_handler& dh) const -> Task<Any> {
     TENZIR_UNUSED(dh);
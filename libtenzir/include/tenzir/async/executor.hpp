@@ -261,6 +261,18 @@ public:
   virtual auto checkpoint_settings() const -> Option<CheckpointSettings const&>
     = 0;
 
+  /// Persists the snapshot of an operator as part of the given checkpoint.
+  virtual auto save_checkpoint(OpId id, uuid checkpoint, chunk_ptr chunk)
+    -> Task<caf::error>
+    = 0;
+
+  /// Returns the snapshot of an operator from the checkpoint that the pipeline
+  /// was restored from, or `nullptr` if the operator starts from scratch.
+  virtual auto load_checkpoint(OpId id) -> Task<caf::expected<chunk_ptr>> = 0;
+
+  /// Marks a checkpoint as complete once it left the pipeline.
+  virtual auto commit_checkpoint(uuid checkpoint) -> Task<caf::error> = 0;
+
 protected:
   virtual auto make_void(ChannelId id) -> PushPull<OperatorMsg<void>> = 0;
 
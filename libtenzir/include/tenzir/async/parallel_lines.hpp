@@ -0,0 +1,162 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/any.hpp"
+#include "tenzir/async.hpp"
+#include "tenzir/chunk.hpp"
+#include "tenzir/diagnostics.hpp"
+#include "tenzir/location.hpp"
+#include "tenzir/operator_plugin.hpp"
+#include "tenzir/option.hpp"
+#include "tenzir/table_slice.hpp"
+
+#include <folly/coro/BoundedQueue.h>
+#include <folly/coro/UnboundedQueue.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tenzir {
+
+/// The parser state of a single worker of a `ParallelLineParser`.
+class LineParserWorker {
+public:
+  virtual ~LineParserWorker() = default;
+
+  /// Parses a single line. The line number counts from 1 across the entire
+  /// input, so that diagnostics can refer to it.
+  virtual auto parse_line(std::string_view line, size_t line_number) -> void
+    = 0;
+
+  /// Returns all events parsed since the last call.
+  virtual auto finish() -> std::vector<table_slice> = 0;
+};
+
+/// Creates the parser state of a worker from a thread-safe diagnostic handler.
+using MakeLineParserWorker
+  = std::function<std::unique_ptr<LineParserWorker>(diagnostic_handler& dh)>;
+
+/// Returns whether a complete line may start a batch, for formats where one
+/// record can span multiple lines. Batches start at arbitrary lines otherwise.
+using StartsBatch = std::function<bool(std::string_view line)>;
+
+/// Attributes a diagnostic of a line-based reader to the operator and to the
+/// line it stems from.
+auto annotate_line(diagnostic d, location operator_location, size_t line)
+  -> diagnostic;
+
+/// Rejects `_jobs=0` in the describer of a reader that supports parsing with
+/// a `ParallelLineParser`.
+template <class Args>
+auto validate_jobs(DescribeCtx& ctx, Argument<Args, uint64_t> jobs) -> void {
+  if (auto j = ctx.get(jobs); j and *j == 0) {
+    diagnostic::error("`_jobs` must be greater than zero")
+      .primary(ctx.get_location(jobs).value_or(location::unknown))
+      .emit(ctx);
+  }
+}
+
+/// Parses newline-delimited input on multiple threads.
+///
+/// The operator hands its input to `add()`, which splits it at the last line
+/// break, or before the last complete line that satisfies `starts_batch`, and
+/// dispatches the lines before as one batch to one of `jobs` workers. Every worker owns its own `LineParserWorker`, which usually wraps a
+/// `multi_series_builder`, and parses its batches independently. Results
+/// surface through `next()`, which the operator returns from `await_task()`,
+/// and must be passed to `handle()` from `process_task()`. Unless `ordered` is
+/// false, `handle()` reassembles the batches in input order.
+///
+/// Lines end at `\n`, `\r\n`, or `\r`, just like in the sequential code paths
+/// of the line-based readers.
+class ParallelLineParser {
+public:
+  ParallelLineParser(uint64_t jobs, bool ordered,
+                     MakeLineParserWorker make_worker,
+                     StartsBatch starts_batch = {});
+
+  /// Spawns the workers.
+  auto start(OpCtx& ctx) -> void;
+
+  /// Dispatches all complete lines of the input and buffers the rest.
+  auto add(chunk_ptr input) -> Task<void>;
+
+  /// Dispatches the remaining buffered input as the final line and stops the
+  /// workers once they processed all batches.
+  auto finish() -> Task<void>;
+
+  /// Waits for the next result of any worker.
+  auto next() const -> Task<Any>;
+
+  /// Emits the events from a result of `next()`.
+  auto handle(Any result, Push<table_slice>& push) -> Task<void>;
+
+  /// Waits until all dispatched batches are emitted, e.g., before a snapshot.
+  auto flush(Push<table_slice>& push) -> Task<void>;
+
+  /// Returns whether all workers stopped after `finish()`.
+  auto done() const -> bool;
+
+  auto snapshot(Serde& serde) -> void;
+
+private:
+  struct Batch {
+    size_t index;
+    size_t first_line;
+    chunk_ptr lines;
+  };
+
+  struct Result {
+    size_t index;
+    std::vector<table_slice> slices;
+  };
+
+  using InputQueue = folly::coro::BoundedQueue<Option<Batch>>;
+  /// The output queue is unbounded to avoid a deadlock where the operator
+  /// waits for room in the input queue while all workers wait for room in the
+  /// output queue. Its size is still bounded by the capacity of the input
+  /// queue, since the operator stops accepting input under backpressure.
+  using OutputQueue = folly::coro::UnboundedQueue<Option<Result>>;
+
+  auto dispatch(chunk_ptr lines) -> Task<void>;
+
+  /// Dispatches the buffered lines up to the last line that may start a
+  /// batch, where `scanned` is the size of the buffer that was checked before.
+  auto dispatch_until_last_start(size_t scanned) -> Task<void>;
+
+  static auto work(std::shared_ptr<InputQueue> input,
+                   std::shared_ptr<OutputQueue> output,
+                   std::unique_ptr<LineParserWorker> worker) -> Task<void>;
+
+  uint64_t jobs_;
+  bool ordered_;
+  MakeLineParserWorker make_worker_;
+  StartsBatch starts_batch_;
+  std::shared_ptr<InputQueue> input_;
+  std::shared_ptr<OutputQueue> output_;
+  /// The incomplete line at the end of the input so far. With `starts_batch_`,
+  /// this also holds the complete lines since the last batch start.
+  std::string buffer_;
+  bool ended_on_carriage_return_ = false;
+  /// The number of lines dispatched so far.
+  size_t lines_ = 0;
+  /// The number of batches that were dispatched and emitted so far.
+  size_t dispatched_ = 0;
+  size_t emitted_ = 0;
+  /// Results that arrived ahead of an earlier batch, keyed by batch index.
+  std::map<size_t, std::vector<table_slice>> reorder_buffer_;
+  bool finishing_ = false;
+  uint64_t finished_workers_ = 0;
+};
+
+} // namespace tenzir
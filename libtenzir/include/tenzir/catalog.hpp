@@ -12,6 +12,7 @@
 
 #include "tenzir/actors.hpp"
 #include "tenzir/detail/flat_map.hpp"
+#include "tenzir/detail/interval_index.hpp"
 #include "tenzir/detail/request_cache.hpp"
 #include "tenzir/expression.hpp"
 #include "tenzir/partition_synopsis.hpp"
@@ -23,6 +24,8 @@
 #include <caf/settings.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
+#include <ranges>
+#include <variant>
 #include <vector>
 
 namespace tenzir {
@@ -56,6 +59,57 @@ struct catalog_lookup_result {
   }
 };
 
+/// Indexes the partitions of a single schema by the range of their import
+/// times and by the min/max synopses of their fields, so that range predicates
+/// select their candidates without visiting every partition synopsis.
+class catalog_range_index {
+public:
+  /// Adds a partition to the index.
+  void add(const uuid& partition, const partition_synopsis& synopsis);
+
+  /// Removes a partition that was previously added with the same synopsis.
+  void remove(const uuid& partition, const partition_synopsis& synopsis);
+
+  /// Returns the sorted IDs of all partitions whose import time range may
+  /// satisfy the predicate, or `std::nullopt` if the index cannot answer it.
+  auto lookup_import_time(relational_operator op, const data& rhs) const
+    -> std::optional<std::vector<uuid>>;
+
+  /// Returns the sorted IDs of all partitions whose synopsis for the given
+  /// field may satisfy the predicate, or `std::nullopt` if the index cannot
+  /// answer it for all partitions that have the field.
+  auto lookup_field(const qualified_record_field& field, relational_operator op,
+                    const data& rhs) const -> std::optional<std::vector<uuid>>;
+
+  /// Returns all fields that occur in any indexed partition.
+  auto fields() const {
+    return std::views::keys(fields_);
+  }
+
+  /// @returns A best-effort estimate of the memory used by the index.
+  auto memusage() const -> size_t;
+
+private:
+  template <class T>
+  using index_type = detail::interval_index<T, uuid>;
+
+  using any_index_type
+    = std::variant<index_type<time>, index_type<duration>, index_type<int64_t>,
+                   index_type<uint64_t>, index_type<double>>;
+
+  struct field_index {
+    /// The index over the partitions that have a min/max synopsis for the
+    /// field. Set when the first such partition is added.
+    std::optional<any_index_type> index;
+    /// The number of partitions that have the field, but no synopsis that can
+    /// be indexed. The index is only usable if this is zero.
+    size_t unindexed = 0;
+  };
+
+  index_type<time> import_time_;
+  std::unordered_map<qualified_record_field, field_index> fields_;
+};
+
 /// The state of the CATALOG actor.
 struct catalog_state {
 public:
@@ -111,6 +165,10 @@ public:
                      detail::flat_map<uuid, partition_synopsis_ptr>>
     synopses_per_type;
 
+  /// For each type, the range index over the partitions in
+  /// `synopses_per_type`.
+  std::unordered_map<tenzir::type, catalog_range_index> range_indexes;
+
   std::optional<detail::request_cache> cache;
 
   tenzir::taxonomies taxonomies = {};
@@ -0,0 +1,92 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/chunk.hpp"
+#include "tenzir/uuid.hpp"
+
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/settings.hpp>
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace tenzir {
+
+/// Returns the directory that holds the checkpoints of the pipeline with the
+/// given definition, which is a subdirectory of the configured
+/// `tenzir.state-directory`.
+auto checkpoint_directory(const caf::settings& cfg, std::string_view definition)
+  -> std::filesystem::path;
+
+/// Persists the operator snapshots of a single pipeline.
+///
+/// Every checkpoint is written into its own subdirectory with one file per
+/// operator. Committing a checkpoint atomically replaces the `LATEST` file to
+/// point to it and removes all other checkpoints, so a crash at any time leaves
+/// either the previous or the new checkpoint intact.
+///
+/// Snapshots are only ever restored from the checkpoint that was committed when
+/// the store was opened. Operators that load their snapshot after the first
+/// commit of the current run start from scratch.
+///
+/// All functions are thread-safe and perform blocking I/O, so they should be
+/// called through `spawn_blocking`.
+class CheckpointStore {
+public:
+  /// Opens the store in the given directory, creating it if necessary, and
+  /// discards all checkpoints that were never committed.
+  static auto make(std::filesystem::path directory)
+    -> caf::expected<CheckpointStore>;
+
+  CheckpointStore(CheckpointStore&& other) noexcept;
+  auto operator=(CheckpointStore&& other) noexcept -> CheckpointStore&;
+  CheckpointStore(const CheckpointStore&) = delete;
+  auto operator=(const CheckpointStore&) -> CheckpointStore& = delete;
+  ~CheckpointStore() noexcept = default;
+
+  /// Writes the snapshot of the operator with the given key as part of the
+  /// given checkpoint.
+  auto save(const uuid& checkpoint, std::string_view key,
+            std::span<const std::byte> bytes) -> caf::error;
+
+  /// Marks the given checkpoint as complete.
+  auto commit(const uuid& checkpoint) -> caf::error;
+
+  /// Reads the snapshot of the operator with the given key from the restored
+  /// checkpoint, or returns `nullptr` if there is none.
+  auto load(std::string_view key) const -> caf::expected<chunk_ptr>;
+
+  /// Returns the id of the checkpoint that snapshots are restored from.
+  auto restored() const -> std::optional<uuid>;
+
+  /// Removes all checkpoints, e.g., after the pipeline completed.
+  auto clear() -> caf::error;
+
+  /// Returns the directory of the store.
+  auto directory() const -> const std::filesystem::path&;
+
+private:
+  CheckpointStore(std::filesystem::path directory,
+                  std::optional<uuid> restored);
+
+  /// Returns the path of the snapshot file for the given key.
+  auto path(const uuid& checkpoint, std::string_view key) const
+    -> std::filesystem::path;
+
+  std::filesystem::path directory_;
+  mutable std::mutex mutex_;
+  std::optional<uuid> restored_;
+};
+
+} // namespace tenzir
@@ -16,6 +16,8 @@
 #include "tenzir/detail/legacy_deserialize.hpp"
 #include "tenzir/detail/narrow.hpp"
 
+#include <caf/binary_deserializer.hpp>
+#include <caf/binary_serializer.hpp>
 #include <caf/deserializer.hpp>
 #include <caf/intrusive_ptr.hpp>
 #include <caf/ref_counted.hpp>
@@ -26,6 +28,7 @@
 #include <iterator>
 #include <span>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 
 namespace tenzir {
@@ -442,10 +445,19 @@ private:
       }
       auto buffer = std::make_unique_for_overwrite<std::byte[]>(size); // NOLINT
       TENZIR_ASSERT(buffer);
-      for (auto* it = buffer.get(); it != buffer.get() + size; ++it) {
-        if (not f.value(*it)) {
+      if constexpr (std::is_same_v<Inspector, caf::binary_deserializer>) {
+        // Binary formats encode a sequence of bytes as the raw bytes, so we
+        // can read them in one go instead of byte by byte. This is the hot
+        // path for every table slice that crosses a process boundary.
+        if (not f.value(std::span{buffer.get(), size})) {
           return false;
         }
+      } else {
+        for (auto* it = buffer.get(); it != buffer.get() + size; ++it) {
+          if (not f.value(*it)) {
+            return false;
+          }
+        }
       }
       if (not f.end_sequence()) {
         return false;
@@ -500,10 +512,17 @@ private:
       if (not f.begin_sequence(x->size())) {
         return false;
       }
-      for (auto byte : x->view()) {
-        if (not f.value(byte)) {
+      if constexpr (std::is_same_v<Inspector, caf::binary_serializer>) {
+        // Mirrors the bulk read in `load_impl`.
+        if (not f.value(x->view())) {
           return false;
         }
+      } else {
+        for (auto byte : x->view()) {
+          if (not f.value(byte)) {
+            return false;
+          }
+        }
       }
       if (not f.end_sequence()) {
         return false;
@@ -78,12 +78,21 @@ auto community_id_hash_append(HashAlgorithm& h, const ip& src_addr,
   }
 }
 
-/// Computes a hash of a flow according to the community ID specification.
-/// @param h The hash algorithm to use.
-/// @param x The flow to hash.
+/// A flow in the orientation that the Community ID specification hashes.
+struct canonical_flow {
+  /// The flow with its endpoints in canonical order. For ICMP and ICMPv6,
+  /// the destination port holds the dual of the message type, so that
+  /// requests and replies end up with the same key.
+  flow key;
+  /// Whether the endpoints of the original flow were swapped.
+  bool swapped = false;
+};
+
+/// Brings a flow into its canonical orientation, so that both directions of
+/// a connection map to the same key.
+/// @param x The flow to normalize.
 /// @relates flow
-template <incremental_hash HashAlgorithm>
-auto community_id_hash_append(HashAlgorithm& h, const flow& x) -> void {
+inline auto canonicalize(const flow& x) -> canonical_flow {
   TENZIR_ASSERT(x.src_port.type() == x.dst_port.type());
   auto src_port_num = x.src_port.number();
   auto dst_port_num = x.dst_port.number();
@@ -106,25 +115,30 @@ auto community_id_hash_append(HashAlgorithm& h, const flow& x) -> void {
   auto is_ordered
     = is_one_way or x.src_addr < x.dst_addr
       or (x.src_addr == x.dst_addr and src_port_num < dst_port_num);
-  // Adjust byte order - if needed.
-  src_port_num = detail::to_network_order(src_port_num);
-  dst_port_num = detail::to_network_order(dst_port_num);
-  static constexpr auto padding = uint8_t{0};
   if (is_ordered) {
-    community_id_hash_append(h, x.src_addr);
-    community_id_hash_append(h, x.dst_addr);
-    hash_append(h, protocol(x));
-    hash_append(h, padding);
-    hash_append(h, src_port_num);
-    hash_append(h, dst_port_num);
-  } else {
-    community_id_hash_append(h, x.dst_addr);
-    community_id_hash_append(h, x.src_addr);
-    hash_append(h, protocol(x));
-    hash_append(h, padding);
-    hash_append(h, dst_port_num);
-    hash_append(h, src_port_num);
+    return {make_flow(x.src_addr, x.dst_addr, src_port_num, dst_port_num,
+                      protocol(x)),
+            false};
   }
+  return {make_flow(x.dst_addr, x.src_addr, dst_port_num, src_port_num,
+                    protocol(x)),
+          true};
+}
+
+/// Computes a hash of a flow according to the community ID specification.
+/// @param h The hash algorithm to use.
+/// @param x The flow to hash.
+/// @relates flow
+template <incremental_hash HashAlgorithm>
+auto community_id_hash_append(HashAlgorithm& h, const flow& x) -> void {
+  const auto key = canonicalize(x).key;
+  static constexpr auto padding = uint8_t{0};
+  community_id_hash_append(h, key.src_addr);
+  community_id_hash_append(h, key.dst_addr);
+  hash_append(h, protocol(key));
+  hash_append(h, padding);
+  hash_append(h, detail::to_network_order(key.src_port.number()));
+  hash_append(h, detail::to_network_order(key.dst_port.number()));
 }
 
 /// Computes the length of the version prefix.
@@ -14,6 +14,7 @@
 #include "tenzir/concept/printable/to_string.hpp"
 #include "tenzir/data.hpp"
 #include "tenzir/detail/base64.hpp"
+#include "tenzir/detail/json_escape.hpp"
 #include "tenzir/detail/string.hpp"
 #include "tenzir/tql2/tokens.hpp"
 #include "tenzir/view3.hpp"
@@ -43,10 +44,18 @@ struct fmt::formatter<tenzir::json_string_fmt_wrapper> {
               fmt::format_context& ctx) const -> fmt::format_context::iterator {
     auto out = ctx.out();
     *out++ = '"';
-    auto f = x.inner.begin();
-    auto l = x.inner.end();
-    while (f != l) {
+    // Copy everything up to the next character that needs escaping at once.
+    auto pos = size_t{0};
+    while (true) {
+      const auto next = tenzir::detail::find_json_escape(x.inner, pos);
+      const auto run = x.inner.substr(pos, next - pos);
+      out = std::copy(run.begin(), run.end(), out);
+      if (next == std::string_view::npos) {
+        break;
+      }
+      auto f = x.inner.begin() + next;
       tenzir::detail::json_escaper(f, out);
+      pos = next + 1;
     }
     *out++ = '"';
     return out;
@@ -219,6 +219,10 @@ inline constexpr size_t disk_monitor_step_size = 1;
 /// Maximum number of events per INDEX partition.
 inline constexpr size_t max_partition_size = 4'194'304; // 4 Mi
 
+/// Maximum number of bytes that an export may use for the partitions it loads
+/// and the events it buffers.
+inline constexpr uint64_t export_memory_limit = 1'073'741'824; // 1 Gi
+
 /// Timeout after which an active partition is forcibly flushed.
 inline constexpr caf::timespan active_partition_timeout
   = std::chrono::seconds{30};
@@ -0,0 +1,17 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+namespace tenzir::detail {
+
+/// Returns whether the CPU supports AVX2. Always true when the build already
+/// targets AVX2, and always false on architectures other than x86-64.
+auto has_avx2() -> bool;
+
+} // namespace tenzir::detail
@@ -0,0 +1,210 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+namespace tenzir::detail {
+
+/// An index over possibly overlapping `[min, max]` intervals, each of which is
+/// identified by an ID, that selects all intervals whose minimum and maximum
+/// satisfy a pair of bounds.
+///
+/// The intervals are kept sorted by their minimum, with a segment tree over
+/// their maxima on top, so the sorted part answers a lookup in
+/// `O((k + 1) * log n)` for `k` results. Insertions go into an unsorted buffer
+/// that every lookup scans linearly, and that is merged into the sorted
+/// intervals once it holds more than `max(64, n / 16)` entries. A lookup thus
+/// takes `O((k + 1) * log n + n / 16)` in the worst case. Erasures leave a
+/// tombstone in the segment tree. Insertions and erasures are amortized
+/// `O(log n)`.
+template <class T, class Id>
+class interval_index {
+public:
+  /// A bound of a lookup, which may or may not include its value.
+  struct bound {
+    T value;
+    bool inclusive;
+  };
+
+  /// Adds an interval. The ID must not already be in the index.
+  void insert(Id id, T min, T max) {
+    pending_.push_back({std::move(min), std::move(max), std::move(id)});
+    if (pending_.size() > std::max(min_pending, sorted_.size() / 16)) {
+      rebuild();
+    }
+  }
+
+  /// Removes the interval with the given ID and minimum.
+  /// @returns Whether the interval was found.
+  auto erase(const Id& id, const T& min) -> bool {
+    auto pending = std::ranges::find(pending_, id, &entry::id);
+    if (pending != pending_.end()) {
+      *pending = std::move(pending_.back());
+      pending_.pop_back();
+      return true;
+    }
+    auto [first, last]
+      = std::ranges::equal_range(sorted_, min, std::less<>{}, &entry::min);
+    for (auto it = first; it != last; ++it) {
+      const auto index = static_cast<size_t>(it - sorted_.begin());
+      if (it->id != id or not tree_[capacity_ + index]) {
+        continue;
+      }
+      auto node = capacity_ + index;
+      tree_[node] = std::nullopt;
+      for (node /= 2; node > 0; node /= 2) {
+        tree_[node] = combine(tree_[2 * node], tree_[2 * node + 1]);
+      }
+      ++tombstones_;
+      if (tombstones_ > sorted_.size() / 2) {
+        rebuild();
+      }
+      return true;
+    }
+    return false;
+  }
+
+  /// Calls `f` with the ID of every interval whose minimum is below `upper`
+  /// and whose maximum is above `lower`. A missing bound matches everything.
+  template <class F>
+  void for_each(const std::optional<bound>& lower,
+                const std::optional<bound>& upper, F&& f) const {
+    auto below_upper = [&](const T& x) {
+      return not upper or x < upper->value
+             or (upper->inclusive and not(upper->value < x));
+    };
+    auto above_lower = [&](const T& x) {
+      return not lower or lower->value < x
+             or (lower->inclusive and not(x < lower->value));
+    };
+    for (const auto& x : pending_) {
+      if (below_upper(x.min) and above_lower(x.max)) {
+        f(x.id);
+      }
+    }
+    // The minima are sorted, so the matching ones form a prefix.
+    auto end = sorted_.size();
+    if (upper) {
+      auto it = upper->inclusive
+                  ? std::ranges::upper_bound(sorted_, upper->value,
+                                             std::less<>{}, &entry::min)
+                  : std::ranges::lower_bound(sorted_, upper->value,
+                                             std::less<>{}, &entry::min);
+      end = static_cast<size_t>(it - sorted_.begin());
+    }
+    if (end > 0) {
+      visit(1, 0, capacity_, end, above_lower, f);
+    }
+  }
+
+  /// Returns the number of intervals in the index.
+  auto size() const -> size_t {
+    return pending_.size() + sorted_.size() - tombstones_;
+  }
+
+  auto empty() const -> bool {
+    return size() == 0;
+  }
+
+  /// @returns A best-effort estimate of the memory used by the index.
+  auto memusage() const -> size_t {
+    return sizeof(*this)
+           + (pending_.capacity() + sorted_.capacity()) * sizeof(entry)
+           + tree_.capacity() * sizeof(std::optional<T>);
+  }
+
+private:
+  struct entry {
+    T min;
+    T max;
+    Id id;
+  };
+
+  /// The size of the insertion buffer that we tolerate without merging,
+  /// regardless of the number of sorted intervals.
+  static constexpr auto min_pending = size_t{64};
+
+  static auto combine(const std::optional<T>& lhs, const std::optional<T>& rhs)
+    -> std::optional<T> {
+    if (not lhs) {
+      return rhs;
+    }
+    if (not rhs) {
+      return lhs;
+    }
+    return *lhs < *rhs ? rhs : lhs;
+  }
+
+  /// Visits all live leaves below `node`, which covers `[first, last)`, that
+  /// lie within `[0, end)` and whose maximum satisfies `pred`.
+  template <class Pred, class F>
+  void visit(size_t node, size_t first, size_t last, size_t end,
+             const Pred& pred, F& f) const {
+    if (first >= end or not tree_[node] or not pred(*tree_[node])) {
+      return;
+    }
+    if (node >= capacity_) {
+      f(sorted_[first].id);
+      return;
+    }
+    const auto mid = first + (last - first) / 2;
+    visit(2 * node, first, mid, end, pred, f);
+    visit(2 * node + 1, mid, last, end, pred, f);
+  }
+
+  /// Merges the insertion buffer into the sorted intervals, drops all
+  /// tombstones, and rebuilds the segment tree.
+  void rebuild() {
+    auto merged = std::vector<entry>{};
+    merged.reserve(sorted_.size() - tombstones_ + pending_.size());
+    for (auto i = size_t{0}; i < sorted_.size(); ++i) {
+      if (tree_[capacity_ + i]) {
+        merged.push_back(std::move(sorted_[i]));
+      }
+    }
+    const auto middle = merged.size();
+    std::ranges::move(pending_, std::back_inserter(merged));
+    pending_.clear();
+    std::ranges::sort(merged.begin() + middle, merged.end(), std::less<>{},
+                      &entry::min);
+    std::ranges::inplace_merge(merged, merged.begin() + middle, std::less<>{},
+                               &entry::min);
+    sorted_ = std::move(merged);
+    tombstones_ = 0;
+    capacity_ = std::bit_ceil(std::max(sorted_.size(), size_t{1}));
+    tree_.assign(2 * capacity_, std::nullopt);
+    for (auto i = size_t{0}; i < sorted_.size(); ++i) {
+      tree_[capacity_ + i] = sorted_[i].max;
+    }
+    for (auto node = capacity_ - 1; node > 0; --node) {
+      tree_[node] = combine(tree_[2 * node], tree_[2 * node + 1]);
+    }
+  }
+
+  /// Recently inserted intervals in insertion order.
+  std::vector<entry> pending_ = {};
+  /// Intervals sorted by their minimum.
+  std::vector<entry> sorted_ = {};
+  /// A segment tree over the maxima of `sorted_`, with the leaves starting at
+  /// `capacity_`. Erased intervals have an empty leaf.
+  std::vector<std::optional<T>> tree_ = {std::nullopt, std::nullopt};
+  /// The number of leaves of the segment tree.
+  size_t capacity_ = 1;
+  /// The number of erased intervals that are still in `sorted_`.
+  size_t tombstones_ = 0;
+};
+
+} // namespace tenzir::detail
@@ -0,0 +1,29 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace tenzir::detail {
+
+/// Returns the position of the first character of `text` at or after `pos`
+/// that `json_escaper` replaces with an escape sequence, i.e., a quotation
+/// mark, a backslash, or a control character, or `npos` if there is none.
+///
+/// Scans 16 bytes at a time with SSE2, or 32 bytes at a time with AVX2 if the
+/// CPU supports it. Other architectures use a lookup table.
+auto find_json_escape(std::string_view text, size_t pos = 0) -> size_t;
+
+/// Appends `text` as a quoted JSON string to `out`, copying the runs between
+/// the characters that need escaping as a whole.
+auto append_json_string(std::string_view text, std::vector<char>& out) -> void;
+
+} // namespace tenzir::detail
@@ -0,0 +1,90 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <tenzir/ip.hpp>
+#include <tenzir/subnet.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tenzir::detail {
+
+/// The disjoint address ranges of one address family, each labeled with its
+/// longest matching prefix.
+template <class Key>
+struct lpm_ranges {
+  /// The first address of every range in ascending order. The first range
+  /// always starts at 0, and every range ends where the next one starts.
+  std::vector<Key> starts;
+  /// The label of every range.
+  std::vector<uint32_t> labels;
+  /// Maps the upper 16 bits of an address to the range that contains the
+  /// first address with these bits, which narrows down the binary search to
+  /// the ranges in between two neighboring buckets.
+  std::vector<uint32_t> buckets;
+};
+
+/// An immutable table for longest-prefix matches of IP addresses.
+///
+/// Unlike `subnet_tree`, which allocates a node per prefix and chases a
+/// pointer per bit, the table flattens the prefixes into sorted arrays of
+/// disjoint address ranges. A lookup reads a bucket of a direct index over
+/// the upper 16 bits of the address and then binary searches the few
+/// contiguous ranges of that bucket, so it touches about two cache lines
+/// regardless of the number of prefixes. IPv4 addresses use a table of their
+/// own with 32-bit keys.
+///
+/// The table does not store values, but maps every address to the label of
+/// its longest matching prefix. Callers keep the values in an array indexed
+/// by label, and rebuild the table when the set of prefixes changes.
+class lpm_table {
+public:
+  /// The label of addresses that match no prefix.
+  static constexpr auto none = std::numeric_limits<uint32_t>::max();
+
+  /// Constructs an empty table.
+  lpm_table() = default;
+
+  /// Constructs a table from a list of labeled prefixes.
+  /// @pre The prefixes are unique and no label equals `none`.
+  explicit lpm_table(std::span<const std::pair<subnet, uint32_t>> prefixes);
+
+  /// Returns the label of the longest prefix that contains an address, or
+  /// `none` if there is no such prefix.
+  auto match(const ip& addr) const -> uint32_t;
+
+  /// Looks up a batch of addresses at once, interleaving the memory accesses
+  /// of consecutive lookups.
+  /// @param addrs The addresses as consecutive 16-byte values in network
+  ///   byte order, which is the layout of an `ip` array.
+  /// @param result Receives the label of every address.
+  /// @pre `addrs.size() == result.size() * 16`
+  auto match(std::span<const std::byte> addrs, std::span<uint32_t> result) const
+    -> void;
+
+  /// Returns the number of prefixes.
+  auto size() const -> size_t {
+    return size_;
+  }
+
+  /// Returns the number of bytes that the table occupies.
+  auto memory_usage() const -> size_t;
+
+private:
+  lpm_ranges<uint32_t> v4_;
+  lpm_ranges<__uint128_t> v6_;
+  size_t size_ = 0;
+};
+
+} // namespace tenzir::detail
@@ -0,0 +1,224 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2023 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/ether_type.hpp"
+#include "tenzir/ip.hpp"
+#include "tenzir/mac.hpp"
+#include "tenzir/port.hpp"
+
+#include <netinet/in.h>
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+namespace tenzir::detail {
+
+// The headers of layer 2 to 4 that we need to decapsulate packets and to
+// track flows. All parsers take the bytes of a layer and return `std::nullopt`
+// if they are too short or of an unknown type.
+
+/// Reads a 16-bit integer in network byte order.
+inline auto to_uint16(std::span<const std::byte, 2> bytes) -> uint16_t {
+  return uint16_t((uint16_t(bytes[0]) << 8) | uint16_t(bytes[1]));
+}
+
+/// An 802.3 Ethernet frame.
+struct ethernet_frame {
+  // 2 MAC addresses and the 2-byte EtherType.
+  static constexpr size_t header_size = 6 + 6 + 2;
+
+  static auto make(std::span<const std::byte> bytes)
+    -> std::optional<ethernet_frame> {
+    if (bytes.size() < header_size) {
+      return std::nullopt;
+    }
+    auto result = ethernet_frame{};
+    result.dst = mac{bytes.subspan<0, 6>()};
+    result.src = mac{bytes.subspan<6, 6>()};
+    auto type = as_ether_type(bytes.subspan<12, 2>());
+    switch (type) {
+      default:
+        result.type = type;
+        result.payload = bytes.subspan<header_size>();
+        break;
+      case ether_type::ieee_802_1aq: {
+        size_t min_frame_size = 6 + 6 + 4 + 2;
+        if (bytes.size() < min_frame_size) {
+          return std::nullopt;
+        }
+        result.outer_vid = to_uint16(bytes.subspan<14, 2>());
+        *result.outer_vid &= 0x0FFF; // lower 12 bits only
+        result.type = as_ether_type(bytes.subspan<16, 2>());
+        result.payload = bytes.subspan(min_frame_size);
+        // Keep going for QinQ frames (TPID = 0x8100).
+        if (result.type == ether_type::ieee_802_1aq) {
+          min_frame_size += 4;
+          if (bytes.size() < min_frame_size) {
+            return std::nullopt;
+          }
+          result.inner_vid = to_uint16(bytes.subspan<18, 2>());
+          *result.inner_vid &= 0x0FFF; // lower 12 bits only
+          result.type = as_ether_type(bytes.subspan<20, 2>());
+          result.payload = bytes.subspan(min_frame_size);
+        }
+        break;
+      }
+      case ether_type::ieee_802_1q_db: {
+        constexpr size_t min_frame_size = 6 + 6 + 4 + 4 + 2;
+        if (bytes.size() < min_frame_size) {
+          return std::nullopt;
+        }
+        result.outer_vid = to_uint16(bytes.subspan<14, 2>());
+        *result.outer_vid &= 0x0FFF; // lower 12 bits only
+        result.inner_vid = to_uint16(bytes.subspan<18, 2>());
+        *result.inner_vid &= 0x0FFF; // lower 12 bits only
+        result.type = as_ether_type(bytes.subspan<20, 2>());
+        result.payload = bytes.subspan<min_frame_size>();
+        break;
+      }
+    }
+    return result;
+  }
+
+  mac dst;                             ///< Destination MAC address
+  mac src;                             ///< Source MAC address
+  std::optional<uint16_t> outer_vid{}; ///< Outer 802.1Q tag control information
+  std::optional<uint16_t> inner_vid{}; ///< Outer 802.1Q tag control information
+  ether_type type{ether_type::invalid}; ///< EtherType
+  std::span<const std::byte> payload{}; ///< Payload
+};
+
+/// A Linux cooked capture frame in version 2 (SLL2).
+struct sll2_frame {
+  static constexpr size_t header_size = 20;
+
+  static auto make(std::span<const std::byte> bytes)
+    -> std::optional<sll2_frame> {
+    if (bytes.size() < header_size) {
+      return std::nullopt;
+    }
+    auto result = sll2_frame{};
+    result.type = static_cast<ether_type>(to_uint16(bytes.subspan<0, 2>()));
+    result.payload = bytes.subspan<header_size>();
+    return result;
+  }
+
+  ether_type type{ether_type::invalid}; ///< Protocol type
+  std::span<const std::byte> payload{}; ///< Payload
+};
+
+/// An IP packet.
+struct packet {
+  static auto make(std::span<const std::byte> bytes, ether_type type)
+    -> std::optional<packet> {
+    packet result;
+    switch (type) {
+      default:
+        break;
+      case ether_type::ipv4: {
+        constexpr size_t ipv4_header_size = 20;
+        if (bytes.size() < ipv4_header_size) {
+          return std::nullopt;
+        }
+        size_t header_length = (std::to_integer<uint8_t>(bytes[0]) & 0x0f) * 4;
+        if (bytes.size() < header_length) {
+          return std::nullopt;
+        }
+        result.src = ip::v4(bytes.subspan<12, 4>());
+        result.dst = ip::v4(bytes.subspan<16, 4>());
+        result.type = std::to_integer<uint8_t>(bytes[9]);
+        // Only the first fragment of a datagram carries the layer-4 header.
+        result.is_fragment = (to_uint16(bytes.subspan<6, 2>()) & 0x1FFF) != 0;
+        result.payload = bytes.subspan(header_length);
+        return result;
+      }
+      case ether_type::ipv6: {
+        constexpr size_t ipv6_header_size = 40;
+        if (bytes.size() < ipv6_header_size) {
+          return std::nullopt;
+        }
+        result.src = ip::v6(bytes.subspan<8, 16>());
+        result.dst = ip::v6(bytes.subspan<24, 16>());
+        result.type = std::to_integer<uint8_t>(bytes[6]);
+        result.payload = bytes.subspan(40);
+        return result;
+      }
+    }
+    return std::nullopt;
+  }
+
+  ip src{};
+  ip dst{};
+  uint8_t type{0};
+  bool is_fragment{false}; ///< Whether this is not the first fragment
+  std::span<const std::byte> payload{};
+};
+
+/// A layer 4 segment.
+struct segment {
+  static auto make(std::span<const std::byte> bytes, uint8_t type)
+    -> std::optional<segment> {
+    segment result;
+    switch (type) {
+      default:
+        break;
+      case IPPROTO_TCP: {
+        constexpr size_t min_tcp_header_size = 20;
+        if (bytes.size() < min_tcp_header_size) {
+          return std::nullopt;
+        }
+        result.src = to_uint16(bytes.subspan<0, 2>());
+        result.dst = to_uint16(bytes.subspan<2, 2>());
+        result.type = port_type::tcp;
+        result.tcp_flags = std::to_integer<uint8_t>(bytes[13]);
+        size_t data_offset = (std::to_integer<uint8_t>(bytes[12]) >> 4) * 4;
+        if (bytes.size() < data_offset) {
+          return std::nullopt;
+        }
+        result.payload = bytes.subspan(data_offset);
+        return result;
+      }
+      case IPPROTO_UDP: {
+        constexpr size_t udp_header_size = 8;
+        if (bytes.size() < udp_header_size) {
+          return std::nullopt;
+        }
+        result.src = to_uint16(bytes.subspan<0, 2>());
+        result.dst = to_uint16(bytes.subspan<2, 2>());
+        result.type = port_type::udp;
+        result.payload = bytes.subspan<8>();
+        return result;
+      }
+      case IPPROTO_ICMP: {
+        constexpr size_t icmp_header_size = 8;
+        if (bytes.size() < icmp_header_size) {
+          return std::nullopt;
+        }
+        auto message_type = std::to_integer<uint8_t>(bytes[0]);
+        auto message_code = std::to_integer<uint8_t>(bytes[1]);
+        result.src = message_type;
+        result.dst = message_code;
+        result.type = port_type::icmp;
+        result.payload = bytes.subspan<8>();
+        return result;
+      }
+    }
+    return std::nullopt;
+  }
+
+  uint16_t src{0};
+  uint16_t dst{0};
+  port_type type{port_type::unknown};
+  uint8_t tcp_flags{0}; ///< The control bits of a TCP segment
+  std::span<const std::byte> payload{};
+};
+
+} // namespace tenzir::detail
@@ -26,6 +26,8 @@
 #include <tenzir/multi_series_builder.hpp>
 #include <tenzir/tql2/ast.hpp>
 
+#include <iterator>
+#include <memory>
 #include <string_view>
 
 namespace tenzir::plugins::syslog {
@@ -364,6 +366,27 @@ inline auto merge_duplicate_sd_ids(std::vector<structured_data_element>& data)
   }
 }
 
+/// The outcome of `parse_rfc5424_message`.
+enum class rfc5424_parse_result {
+  /// The input is an RFC 5424 message and was parsed entirely.
+  parsed,
+  /// The input does not start with the `<PRI>VERSION ` prefix of RFC 5424
+  /// messages, so `message_parser` would reject it.
+  rejected,
+  /// The input needs the parser combinators, e.g., because it contains Check
+  /// Point structured data or trailing bytes after the structured data.
+  fallback,
+};
+
+/// Parses an RFC 5424 message in a single pass over the input.
+///
+/// This handles the common shape of RFC 5424 messages by hand, which is much
+/// faster than the parser combinators in `message_parser`. It only returns
+/// `parsed` if `message_parser` would consume the entire input and produce the
+/// same message, and leaves `x` untouched otherwise.
+auto parse_rfc5424_message(std::string_view input, message& x)
+  -> rfc5424_parse_result;
+
 /// Parser for RFC 5424 Syslog messages.
 /// @relates message
 struct message_parser : parser_base<message_parser> {
@@ -372,6 +395,26 @@ struct message_parser : parser_base<message_parser> {
   template <class Iterator, class Attribute>
   auto parse(Iterator& f, const Iterator& l, Attribute& x) const -> bool {
     using namespace parsers;
+    if constexpr (std::contiguous_iterator<Iterator>) {
+      auto input = std::string_view{std::to_address(f), std::to_address(l)};
+      auto scratch = message{};
+      auto& result = [&]() -> message& {
+        if constexpr (std::is_same_v<Attribute, message>) {
+          return x;
+        } else {
+          return scratch;
+        }
+      }();
+      switch (parse_rfc5424_message(input, result)) {
+        case rfc5424_parse_result::parsed:
+          f = l;
+          return true;
+        case rfc5424_parse_result::rejected:
+          return false;
+        case rfc5424_parse_result::fallback:
+          break;
+      }
+    }
     auto p = header_parser{} >> ' '
              >> (structured_data_parser{} | checkpoint_structured_data_parser{})
              >> -(' ' >> message_content_parser{});
@@ -461,9 +504,22 @@ struct legacy_message_timestamp_parser
   }
 };
 
-/// Parser for legacy (RFC 3164) Syslog messages.
+/// Parses an RFC 3164 message of the common shape
+/// `<PRI>Mmm dd hh:mm:ss HOSTNAME TAG[PID]: MSG` in a single pass over the
+/// input.
+///
+/// Returns true only if `legacy_message_combinator_parser` would consume the
+/// entire input and produce the same message, and leaves `x` untouched
+/// otherwise. Other timestamp formats, messages without a hostname, and
+/// messages with structured data need the parser combinators.
+auto parse_rfc3164_message(std::string_view input, legacy_message& x) -> bool;
+
+/// Parser for legacy (RFC 3164) Syslog messages that only uses parser
+/// combinators. Prefer `legacy_message_parser`, which tries a faster parser
+/// first.
 /// @relates legacy_message
-struct legacy_message_parser : parser_base<legacy_message_parser> {
+struct legacy_message_combinator_parser
+  : parser_base<legacy_message_combinator_parser> {
   using attribute = legacy_message;
 
   template <typename Iterator, typename Attribute>
@@ -536,6 +592,32 @@ struct legacy_message_parser : parser_base<legacy_message_parser> {
   }
 };
 
+/// Parser for legacy (RFC 3164) Syslog messages.
+/// @relates legacy_message
+struct legacy_message_parser : parser_base<legacy_message_parser> {
+  using attribute = legacy_message;
+
+  template <typename Iterator, typename Attribute>
+  auto parse(Iterator& f, const Iterator& l, Attribute& x) const -> bool {
+    if constexpr (std::contiguous_iterator<Iterator>) {
+      auto input = std::string_view{std::to_address(f), std::to_address(l)};
+      auto scratch = legacy_message{};
+      auto& result = [&]() -> legacy_message& {
+        if constexpr (std::is_same_v<Attribute, legacy_message>) {
+          return x;
+        } else {
+          return scratch;
+        }
+      }();
+      if (parse_rfc3164_message(input, result)) {
+        f = l;
+        return true;
+      }
+    }
+    return legacy_message_combinator_parser{}.parse(f, l, x);
+  }
+};
+
 struct cisco_datetime {
   uint16_t year = 0;
   std::string month;
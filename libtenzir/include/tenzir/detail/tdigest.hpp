@@ -47,6 +47,14 @@ namespace tenzir::detail {
 
 class tdigest {
 public:
+  // exported state of a tdigest, e.g., for serialization
+  struct state {
+    std::vector<double> means;
+    std::vector<double> weights;
+    double min;
+    double max;
+  };
+
   explicit tdigest(uint32_t delta = 100, uint32_t buffer_size = 500);
   ~tdigest();
   tdigest(tdigest&&);
@@ -85,6 +93,12 @@ public:
     add(static_cast<double>(value));
   }
 
+  // export the current state
+  auto save() const -> state;
+
+  // replace the current state with a previously exported one
+  auto load(const state& x) -> void;
+
   // merge with other t-digests, called infrequently
   auto merge(const std::vector<tdigest>& others) -> void;
   auto merge(const tdigest& other) -> void;
@@ -0,0 +1,107 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/detail/string.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tenzir::detail {
+
+/// A small set of bytes that can be searched for 64 bytes at a time.
+///
+/// Sets of up to eight bytes are matched with SSE2, or with AVX2 if the CPU
+/// supports it. Larger sets and other architectures use a lookup table.
+class byte_set {
+public:
+  /// The number of bytes that `mask()` classifies at once.
+  static constexpr auto block_size = size_t{64};
+
+  explicit byte_set(std::string_view bytes);
+
+  /// Returns whether `c` is in the set.
+  auto contains(char c) const -> bool {
+    return table_[static_cast<unsigned char>(c)];
+  }
+
+  /// Returns a bit mask of the bytes of `block` that are in the set, where bit
+  /// `i` corresponds to `block[i]`. Reads exactly `block_size` bytes.
+  auto mask(const char* block) const -> uint64_t;
+
+  /// Returns the position of the first byte of `text` at or after `start` that
+  /// is in the set, or `npos` if there is none.
+  auto find(std::string_view text, size_t start = 0) const -> size_t;
+
+private:
+  static constexpr auto max_vectorized = size_t{8};
+
+  std::array<char, max_vectorized> needles_ = {};
+  size_t num_needles_ = 0;
+  std::array<bool, 256> table_ = {};
+};
+
+/// A field of a line, as split by the `xsv_scanner`.
+struct xsv_field {
+  /// The raw text of the field, including quotes and escape sequences.
+  std::string_view text;
+  /// The value of the field if it needs no unescaping. This is the case if the
+  /// field contains no quotes and backslashes at all, or if the field is quoted
+  /// as a whole and contains neither backslashes nor its quote character.
+  std::optional<std::string_view> value;
+};
+
+/// Splits lines of separated values into fields.
+///
+/// The scanner classifies the bytes of a line in blocks of 64 bytes to find the
+/// separators, quotes, and backslashes in it, and then splits fields that
+/// contain no quotes or escapes without looking at their other bytes. Fields
+/// that do contain them fall back to the `quoting_escaping_policy`, so that the
+/// result is always the same as splitting with `split_at_unquoted` repeatedly.
+class xsv_scanner {
+public:
+  xsv_scanner(quoting_escaping_policy quoting, std::string separator);
+
+  /// Splits `line` at all unquoted separators and appends the fields to
+  /// `result`. The last field of a line that ends with a separator is empty.
+  auto split(std::string_view line, std::vector<xsv_field>& result) const
+    -> void;
+
+  /// Returns the value of a field, unquoting and unescaping it if needed.
+  auto unescape(const xsv_field& field) const -> std::string {
+    if (field.value) {
+      return std::string{*field.value};
+    }
+    return quoting_.unquote_unescape(field.text);
+  }
+
+  auto quoting() const -> const quoting_escaping_policy& {
+    return quoting_;
+  }
+
+  auto separator() const -> std::string_view {
+    return separator_;
+  }
+
+private:
+  quoting_escaping_policy quoting_;
+  std::string separator_;
+  /// The first byte of the separator, all quote characters, and backslashes.
+  byte_set structural_;
+  /// Whether the separator allows for the fast paths, i.e., whether it is
+  /// non-empty and contains no quote characters and backslashes.
+  bool vectorized_ = false;
+};
+
+} // namespace tenzir::detail
@@ -10,6 +10,7 @@
 
 #include <tenzir/fwd.hpp>
 
+#include <filesystem>
 #include <optional>
 
 namespace tenzir {
@@ -40,6 +41,11 @@ struct exec_config {
   bool neo = true;
   bool legacy = false;
   std::optional<std::string> profile;
+  /// Enables periodic checkpoints of the new executor, which resumes the
+  /// pipeline from its last checkpoint when it is restarted.
+  std::optional<duration> checkpoint_interval;
+  /// The directory that holds the checkpoints of the pipeline.
+  std::filesystem::path checkpoint_directory;
 };
 
 auto exec_pipeline(Arc<const Source> source, diagnostic_handler& dh,
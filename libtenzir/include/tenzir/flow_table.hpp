@@ -0,0 +1,198 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/flow.hpp"
+#include "tenzir/time.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace tenzir {
+
+/// Why a flow record was emitted.
+enum class flow_end_reason {
+  /// No packet arrived for the idle timeout.
+  idle,
+  /// The flow lasted longer than the active timeout. Its next record
+  /// continues where this one ended.
+  active,
+  /// The TCP connection was closed or reset.
+  end,
+  /// The flow table was flushed, e.g., at the end of the input.
+  flush,
+};
+
+auto to_string(flow_end_reason x) -> std::string_view;
+
+/// The timeouts of a flow table.
+struct flow_table_options {
+  duration idle_timeout = std::chrono::minutes{1};
+  duration active_timeout = std::chrono::minutes{30};
+  /// How long we keep a closed TCP connection around to absorb trailing
+  /// packets, such as the final ACK.
+  duration close_timeout = std::chrono::seconds{1};
+};
+
+/// The summary of a flow over the time from `start` to `end`.
+struct flow_record {
+  /// The flow in the direction of its first packet, i.e., the source is the
+  /// initiator.
+  flow id;
+  time start;
+  time end;
+  uint64_t src_packets = 0;
+  uint64_t src_bytes = 0;
+  uint64_t dst_packets = 0;
+  uint64_t dst_bytes = 0;
+  /// The union of the TCP control bits of all packets.
+  uint8_t tcp_flags = 0;
+  flow_end_reason reason = flow_end_reason::idle;
+};
+
+/// Aggregates packets into bidirectional flows.
+///
+/// The table is keyed by the flow in the canonical orientation of the
+/// Community ID, so that both directions of a connection share an entry. It
+/// uses open addressing with linear probing over an array of small slots that
+/// only hold a hash tag and the index of the flow state, which keeps probing
+/// within a few cache lines. Timeouts are tracked with a hashed timer wheel:
+/// every flow has a single timer that we only reschedule lazily once it
+/// fires, so that accounting a packet never touches the wheel.
+///
+/// Time advances with the timestamps of the packets, which makes the result
+/// deterministic for recorded traffic.
+class flow_table {
+public:
+  explicit flow_table(flow_table_options options = {});
+
+  /// Accounts a packet of `bytes` bytes, after expiring all flows that timed
+  /// out before it arrived.
+  /// @param id The flow of the packet in the direction of the packet.
+  /// @param ts The timestamp of the packet.
+  /// @param bytes The size of the packet at the IP layer.
+  /// @param tcp_flags The TCP control bits of the packet.
+  /// @param expired Receives the records of the expired flows.
+  auto add(const flow& id, time ts, uint64_t bytes, uint8_t tcp_flags,
+           std::vector<flow_record>& expired) -> void;
+
+  /// Expires all flows that timed out before `now`. Time never goes back, so
+  /// this is a no-op for times before the latest packet.
+  auto advance(time now, std::vector<flow_record>& expired) -> void;
+
+  /// Expires all flows, ordered by their start.
+  auto flush(std::vector<flow_record>& expired) -> void;
+
+  /// Returns the current time of the table, i.e., the latest time that it
+  /// has seen.
+  auto now() const -> time {
+    return now_;
+  }
+
+  /// Returns the number of tracked flows.
+  auto size() const -> size_t {
+    return size_;
+  }
+
+  /// Serializes the tracked flows and the time of the table. Loading a table
+  /// rebuilds its index and timers from the flows, so that it expires the
+  /// same flows at the same times. The options are not part of it.
+  template <class Inspector>
+  friend auto inspect(Inspector& f, flow_table& x) -> bool {
+    auto flows = std::vector<entry>{};
+    if constexpr (not Inspector::is_loading) {
+      flows.reserve(x.size_);
+      for (const auto& e : x.entries_) {
+        if (e.used) {
+          flows.push_back(e);
+        }
+      }
+    }
+    auto ok = f.object(x).fields(f.field("started", x.started_),
+                                 f.field("now", x.now_),
+                                 f.field("tick", x.tick_),
+                                 f.field("flows", flows));
+    if constexpr (Inspector::is_loading) {
+      if (ok) {
+        x.rebuild(std::move(flows));
+      }
+    }
+    return ok;
+  }
+
+private:
+  struct entry {
+    /// The flow in canonical orientation.
+    flow key;
+    /// The flow in the direction of its first packet.
+    flow id;
+    time start;
+    time end;
+    std::array<uint64_t, 2> packets = {};
+    std::array<uint64_t, 2> bytes = {};
+    /// Identifies the only valid timer of this entry.
+    uint32_t timer = 0;
+    /// Whether `id` is in the opposite direction of `key`.
+    bool swapped = false;
+    bool used = false;
+    bool closed = false;
+    uint8_t tcp_flags = 0;
+    /// Which sides sent a FIN, indexed by direction.
+    uint8_t fins = 0;
+
+    friend auto inspect(auto& f, entry& x) -> bool {
+      return f.object(x).fields(
+        f.field("key", x.key), f.field("id", x.id), f.field("start", x.start),
+        f.field("end", x.end), f.field("src_packets", x.packets[0]),
+        f.field("dst_packets", x.packets[1]),
+        f.field("src_bytes", x.bytes[0]), f.field("dst_bytes", x.bytes[1]),
+        f.field("swapped", x.swapped), f.field("closed", x.closed),
+        f.field("tcp_flags", x.tcp_flags), f.field("fins", x.fins));
+    }
+  };
+
+  struct slot {
+    /// The lower bits of the hash of the key, which also determine the
+    /// preferred position of the slot.
+    uint32_t tag;
+    /// The index of the entry, or `empty` for a free slot.
+    uint32_t index;
+  };
+
+  struct timer {
+    uint32_t index;
+    uint32_t id;
+  };
+
+  auto find(const flow& key, uint32_t tag) const -> std::pair<size_t, bool>;
+  auto grow() -> void;
+  auto deadline(const entry& e) const -> std::pair<time, flow_end_reason>;
+  auto schedule(uint32_t index, bool renew) -> void;
+  auto expire(uint32_t index, flow_end_reason reason,
+              std::vector<flow_record>& expired) -> void;
+  auto erase(uint32_t index) -> void;
+  auto rebuild(std::vector<entry> flows) -> void;
+
+  flow_table_options options_;
+  std::vector<slot> slots_;
+  std::vector<entry> entries_;
+  std::vector<uint32_t> free_;
+  std::vector<std::vector<timer>> wheel_;
+  std::vector<timer> fired_;
+  size_t size_ = 0;
+  bool started_ = false;
+  time now_ = {};
+  /// The latest tick of the wheel that we processed.
+  int64_t tick_ = 0;
+};
+
+} // namespace tenzir
@@ -173,6 +173,7 @@ class report;
 class secret_type;
 class segment;
 class shared_diagnostic_handler;
+class shared_table_slice;
 class string_type;
 class subnet_type;
 class subnet;
@@ -501,6 +502,7 @@ CAF_BEGIN_TYPE_ID_BLOCK(tenzir_types, first_tenzir_type_id)
   TENZIR_ADD_TYPE_ID((tenzir::secret))
   TENZIR_ADD_TYPE_ID((tenzir::secret_resolution_result))
   TENZIR_ADD_TYPE_ID((tenzir::shared_diagnostic_handler))
+  TENZIR_ADD_TYPE_ID((tenzir::shared_table_slice))
   TENZIR_ADD_TYPE_ID((tenzir::subnet))
   TENZIR_ADD_TYPE_ID((tenzir::table_slice))
   TENZIR_ADD_TYPE_ID((tenzir::taxonomies))
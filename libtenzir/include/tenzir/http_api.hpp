@@ -120,6 +120,11 @@ struct rest_response {
   /// Create a response from a JSON string.
   static auto from_json_string(std::string json) -> rest_response;
 
+  /// Create a response from a body in a format other than JSON, e.g., after
+  /// the handler negotiated the response format with the client.
+  static auto from_bytes(std::string body, std::string content_type)
+    -> rest_response;
+
   /// Returns an error that uses `{error: "{message}"}` as the response body.
   static auto make_error(uint16_t error_code, std::string_view message,
                          caf::error detail = {}) -> rest_response;
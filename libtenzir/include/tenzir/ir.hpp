@@ -32,6 +32,32 @@ namespace ir {
 /// one already filtered an event out.
 using optimize_filter = std::vector<ast::expression>;
 
+/// A bound on the events of its input that an operator can emit.
+///
+/// For example, `head 10` only ever emits some of the first ten events of its
+/// input, and `tail 10` only ever emits some of the last ten events.
+struct Limit {
+  /// The number of events.
+  uint64_t count = 0;
+  /// Whether the events are counted from the end of the input.
+  bool from_end = false;
+
+  friend auto inspect(auto& f, Limit& x) -> bool {
+    return f.object(x).fields(f.field("count", x.count),
+                              f.field("from_end", x.from_end));
+  }
+};
+
+class Operator;
+
+/// The split of an aggregating operator into two steps: a partial step that
+/// can run on disjoint parts of the input, and a merge step that combines the
+/// outputs of the partial steps into the same result as the original operator.
+struct PartialSplit {
+  Box<Operator> partial;
+  Box<Operator> merge;
+};
+
 /// Base class for all IR operators.
 class Operator {
 public:
@@ -71,6 +97,43 @@ public:
   virtual auto
   optimize(optimize_filter filter, event_order order) && -> optimize_result;
 
+  /// Return the bound on the events of its input that this operator can emit.
+  ///
+  /// This lets the operator directly upstream absorb the limit, see
+  /// `absorb_limit`. Operators that return `None` are not limited.
+  virtual auto limit() const -> Option<Limit> {
+    return None{};
+  }
+
+  /// Absorb the limit of the operator directly downstream of this one.
+  ///
+  /// The downstream operator stays in place, so the operator only needs to
+  /// guarantee that all events that would pass the limit are still emitted,
+  /// in the same order. For example, `sort` uses this to only keep the top-k
+  /// events in memory. Returns whether the limit was absorbed.
+  virtual auto absorb_limit(Limit limit) -> bool {
+    TENZIR_UNUSED(limit);
+    return false;
+  }
+
+  /// Return the split of this operator into a partial and a merge step.
+  ///
+  /// This lets the operator directly upstream absorb the partial step, see
+  /// `absorb_partial`. Operators that return `None` cannot be split.
+  virtual auto split_partial() const -> Option<PartialSplit> {
+    return None{};
+  }
+
+  /// Absorb the partial step of the operator directly downstream of this one.
+  ///
+  /// If this returns true, the downstream operator is replaced by its merge
+  /// step. For example, `parallel` uses this to run the partial step of
+  /// `summarize` in every one of its subpipelines.
+  virtual auto absorb_partial(const Operator& partial) -> bool {
+    TENZIR_UNUSED(partial);
+    return false;
+  }
+
   /// Return the executable matching this operator.
   ///
   /// The implementation may assume that the operator was previously
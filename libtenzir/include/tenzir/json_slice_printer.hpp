@@ -0,0 +1,45 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/concept/printable/tenzir/json_printer_options.hpp"
+#include "tenzir/fwd.hpp"
+
+#include <string_view>
+#include <vector>
+
+namespace tenzir {
+
+/// Prints table slices as JSON one column at a time.
+///
+/// Where `json_printer` visits every value of every row through a
+/// `view3<data>`, the slice printer first builds a printer for every column
+/// of the schema that reads straight from the typed Arrow array. Object keys
+/// are escaped once per slice, timestamps reuse the formatted date and time of
+/// day of the previous value in their column, and strings are copied in runs
+/// between the characters that need escaping.
+///
+/// The output is identical to that of `json_printer` with the same options.
+/// Colors and TQL output are not supported, see `supports()`.
+class json_slice_printer {
+public:
+  explicit json_slice_printer(json_printer_options options);
+
+  /// Returns whether the slice printer can print with the given options.
+  static auto supports(const json_printer_options& options) -> bool;
+
+  /// Appends all rows of a slice to `out`, with `separator` in between.
+  auto print(const table_slice& slice, std::string_view separator,
+             std::vector<char>& out) const -> void;
+
+private:
+  json_printer_options options_;
+};
+
+} // namespace tenzir
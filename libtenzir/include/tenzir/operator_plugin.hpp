@@ -172,6 +172,8 @@ struct Optimization {
 using Optimizer = std::function<
   auto(DescribeCtx&, event_order, ir::optimize_filter)->Optimization>;
 
+using Limiter = std::function<auto(DescribeCtx&)->Option<ir::Limit>>;
+
 struct Description {
   std::string name;
   std::string docs;
@@ -186,6 +188,9 @@ struct Description {
   std::optional<Setter<ir::optimize_filter>> set_filter;
   std::optional<Setter<location>> set_operator_location;
   std::optional<Setter<event_order>> set_order;
+  std::optional<Limiter> limit;
+  std::optional<Setter<ir::Limit>> set_limit;
+  bool absorb_partial = false;
   // FIXME: Document.
   std::optional<Spawner> spawner;
   std::vector<AnySpawn> spawns;
@@ -978,6 +983,32 @@ public:
     desc_.set_order = make_setter(ptr);
   }
 
+  /// Declares which events of its input the operator can emit at most.
+  ///
+  /// The callback returns `None` if the operator is not limited, or if its
+  /// arguments are not evaluated yet.
+  template <class F>
+    requires concepts::invokable_r<Option<ir::Limit>, F&, DescribeCtx&>
+  auto limit(F&& f) {
+    TENZIR_ASSERT(not desc_.limit);
+    desc_.limit = std::forward<F>(f);
+  }
+
+  /// Registers a member of `Args` to be populated with the limit of the
+  /// operator directly downstream, if it declared one.
+  auto absorb_limit(Option<ir::Limit> Args::* ptr) {
+    TENZIR_ASSERT(not desc_.set_limit);
+    desc_.set_limit = make_setter(ptr);
+  }
+
+  /// Declares that the subpipeline runs as independent instances whose outputs
+  /// are combined, so that the partial step of an aggregation directly
+  /// downstream can run within the subpipeline.
+  auto absorb_partial() {
+    TENZIR_ASSERT(desc_.pipeline);
+    desc_.absorb_partial = true;
+  }
+
   /// Registers a member of `Args` to be populated with the optimization
   /// filter, instead of keeping it as a separate `where` after the operator.
   auto optimize_filter(ir::optimize_filter Args::* ptr) -> Description {
@@ -0,0 +1,73 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/fwd.hpp"
+
+#include "tenzir/aliases.hpp"
+#include "tenzir/table_slice.hpp"
+#include "tenzir/uuid.hpp"
+
+#include <caf/expected.hpp>
+#include <caf/node_id.hpp>
+
+#include <optional>
+
+namespace tenzir {
+
+/// A table slice that an execution node hands over to an execution node in
+/// another process on the same host, e.g., between the client and the node
+/// for operators placed with `local` and `remote`.
+///
+/// The sender writes the slice as Arrow IPC stream directly into a sealed
+/// memory file and passes its file descriptor over a Unix socket of the
+/// receiving process with `SCM_RIGHTS`, independently of the CAF middleman.
+/// Both ends of the socket verify that the peer is the expected process of
+/// the same user. The CAF message only carries a token that identifies the
+/// file descriptor. The receiver maps the file read-only and reads the record
+/// batch from the mapping, so the Arrow buffers are copied exactly once.
+class shared_table_slice {
+public:
+  shared_table_slice() = default;
+
+  /// Makes this process accept table slices through shared memory. Safe to
+  /// call repeatedly.
+  static auto listen() -> void;
+
+  /// Places a table slice in shared memory and passes it to the process of
+  /// `receiver`. Returns `std::nullopt` if the slice must travel through CAF
+  /// instead, e.g., because the receiver runs on another host, does not
+  /// accept shared memory, or the slice is too small to benefit.
+  static auto make(const table_slice& slice, const caf::node_id& sender,
+                   const caf::node_id& receiver)
+    -> std::optional<shared_table_slice>;
+
+  /// Maps the memory file that the sender passed for this slice, or returns
+  /// `std::nullopt` if the file descriptor did not arrive yet. Never blocks.
+  auto try_take() const -> std::optional<caf::expected<table_slice>>;
+
+  /// Maps the memory file that the sender passed for this slice. Waits
+  /// briefly if the file descriptor did not arrive yet, so this must not be
+  /// called from a scheduled actor.
+  auto take() && -> caf::expected<table_slice>;
+
+  friend auto inspect(auto& f, shared_table_slice& x) -> bool {
+    return f.object(x)
+      .pretty_name("tenzir.shared_table_slice")
+      .fields(f.field("token", x.token_), f.field("offset", x.offset_),
+              f.field("import-time", x.import_time_));
+  }
+
+private:
+  uuid token_ = uuid::null();
+  id offset_ = invalid_id;
+  time import_time_ = {};
+};
+
+} // namespace tenzir
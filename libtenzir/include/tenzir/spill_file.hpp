@@ -0,0 +1,107 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/chunk.hpp"
+#include "tenzir/file.hpp"
+#include "tenzir/table_slice.hpp"
+
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/settings.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace tenzir {
+
+/// Returns the directory that operators use for spilling state to disk, which
+/// is a subdirectory of the configured `tenzir.cache-directory`.
+auto spill_directory(const caf::settings& cfg) -> std::filesystem::path;
+
+/// A temporary, append-only file for operators that exceed their memory budget.
+///
+/// Records are ZSTD-compressed and length-prefixed, and can be read back
+/// sequentially in the order they were written. Table slices are stored in
+/// their serialized Arrow IPC representation. The file is removed from disk
+/// when the `SpillFile` is destroyed.
+///
+/// All functions perform blocking I/O and should be called through
+/// `spawn_blocking` from within an operator.
+class SpillFile {
+public:
+  /// Sequentially reads the records of a spill file.
+  class Reader {
+  public:
+    /// Reads the next record, or returns `nullptr` when the end of the file is
+    /// reached.
+    auto next() -> caf::expected<chunk_ptr>;
+
+    /// Reads the next record as a table slice, or returns an empty slice when
+    /// the end of the file is reached.
+    auto next_slice() -> caf::expected<table_slice>;
+
+  private:
+    friend class SpillFile;
+
+    explicit Reader(std::filesystem::path path);
+
+    std::unique_ptr<file> file_;
+  };
+
+  /// Creates a new, empty spill file in the given directory.
+  static auto make(const std::filesystem::path& directory)
+    -> caf::expected<SpillFile>;
+
+  SpillFile(SpillFile&&) noexcept = default;
+  auto operator=(SpillFile&&) noexcept -> SpillFile& = default;
+  SpillFile(const SpillFile&) = delete;
+  auto operator=(const SpillFile&) -> SpillFile& = delete;
+  ~SpillFile() noexcept;
+
+  /// Appends a record to the file.
+  auto write(std::span<const std::byte> bytes) -> caf::error;
+
+  /// Appends a table slice to the file.
+  auto write(const table_slice& slice) -> caf::error;
+
+  /// Opens a reader that starts at the first record. Records that are written
+  /// after opening the reader may or may not be visible to it.
+  auto read() const -> caf::expected<Reader>;
+
+  /// Returns the number of records written.
+  auto records() const -> uint64_t;
+
+  /// Returns the number of bytes written to disk.
+  auto bytes() const -> uint64_t;
+
+  /// Returns the path of the file.
+  auto path() const -> const std::filesystem::path&;
+
+private:
+  struct state {
+    explicit state(std::filesystem::path path);
+    state(const state&) = delete;
+    auto operator=(const state&) -> state& = delete;
+    ~state() noexcept;
+
+    std::filesystem::path path;
+    file writer;
+    uint64_t records = {};
+    uint64_t bytes = {};
+  };
+
+  explicit SpillFile(std::unique_ptr<state> state);
+
+  std::unique_ptr<state> state_;
+};
+
+} // namespace tenzir
@@ -0,0 +1,58 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "tenzir/ir.hpp"
+
+#include <string>
+#include <unordered_map>
+
+namespace tenzir {
+
+/// The kind of values in a column of a SQL table, as far as translating
+/// filters is concerned. Columns of other types are never referenced.
+enum class sql_column_kind {
+  integer,
+  floating_point,
+  string,
+};
+
+/// Maps the names of the columns of a SQL table to their kind.
+using sql_columns = std::unordered_map<std::string, sql_column_kind>;
+
+/// The properties of a SQL dialect that affect the translation of filters.
+struct sql_dialect {
+  /// Whether strings compare byte by byte, like they do in TQL. If not, e.g.,
+  /// because of a case-insensitive collation, only equality comparisons of
+  /// strings are translated, and they only narrow down the result.
+  bool binary_strings = false;
+};
+
+/// A filter that was translated into the condition of a SQL `WHERE` clause.
+struct sql_filter {
+  /// The condition, or an empty string if no part of the filter translates.
+  std::string condition;
+  /// Whether the condition selects exactly the rows that the filter keeps.
+  /// Otherwise, it selects a superset of them, and the filter must still be
+  /// applied to the result of the query.
+  bool exact = true;
+};
+
+/// Translates the parts of a filter that only compare columns of a table with
+/// constants into a SQL condition.
+///
+/// The condition follows the semantics of TQL rather than those of SQL, e.g.,
+/// `x != 1` translates to `COALESCE(x <> 1, TRUE)`, because `null != 1` is
+/// true in TQL. Identifiers are quoted with backticks, which both MySQL and
+/// ClickHouse understand.
+auto make_sql_filter(const ir::optimize_filter& filter,
+                     const sql_columns& columns, const sql_dialect& dialect)
+  -> sql_filter;
+
+} // namespace tenzir
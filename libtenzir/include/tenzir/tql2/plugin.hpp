@@ -18,6 +18,7 @@
 #include "tenzir/tql2/plugin_api.hpp"
 
 #include <optional>
+#include <span>
 
 namespace tenzir {
 
@@ -177,6 +178,46 @@ public:
   /// Save and restore the state of the aggregation instance.
   virtual auto save() const -> chunk_ptr = 0;
   virtual auto restore(chunk_ptr chunk) noexcept -> bool = 0;
+
+  /// Merges the saved state of another instance of the same aggregation into
+  /// this one. This allows for aggregating disjoint parts of the input
+  /// independently, and combining the partial results afterwards.
+  virtual auto merge(chunk_ptr partial) noexcept -> bool = 0;
+};
+
+/// An aggregation that tracks the state of many groups at once.
+///
+/// Groups are identified by dense ids starting at zero. This lets `summarize`
+/// update all groups of an input batch in a single pass, instead of gathering
+/// the events of every group and updating one `aggregation_instance` per group.
+class grouped_aggregation_instance {
+public:
+  virtual ~grouped_aggregation_instance() = default;
+
+  /// Updates the groups of all events of the input, where `groups[i]` is the
+  /// group of the `i`-th event. All groups must be less than `size()`.
+  virtual void update(const table_slice& input,
+                      std::span<const uint32_t> groups, session ctx)
+    = 0;
+
+  /// Returns the aggregation result of a group.
+  virtual auto get(uint32_t group) const -> data = 0;
+
+  /// Returns the number of groups.
+  virtual auto size() const -> size_t = 0;
+
+  /// Removes groups from the end or appends empty groups until there are
+  /// exactly `groups` groups.
+  virtual auto resize(size_t groups) -> void = 0;
+
+  /// Save and restore the state of a single group. The format matches the one
+  /// of the corresponding `aggregation_instance`.
+  virtual auto save(uint32_t group) const -> chunk_ptr = 0;
+  virtual auto restore(uint32_t group, chunk_ptr chunk) noexcept -> bool = 0;
+
+  /// Merges the saved state of another aggregation into a single group, see
+  /// `aggregation_instance::merge`.
+  virtual auto merge(uint32_t group, chunk_ptr partial) noexcept -> bool = 0;
 };
 
 class aggregation_plugin : public virtual function_plugin {
@@ -187,6 +228,14 @@ public:
   virtual auto make_aggregation(function_invocation inv, session ctx) const
     -> failure_or<std::unique_ptr<aggregation_instance>>
     = 0;
+
+  /// Creates an aggregation that tracks the state of many groups at once.
+  ///
+  /// Returns `nullptr` if the aggregation does not support this, in which case
+  /// callers need to use one `aggregation_instance` per group.
+  virtual auto make_grouped_aggregation(function_invocation inv,
+                                        session ctx) const
+    -> failure_or<std::unique_ptr<grouped_aggregation_instance>>;
 };
 
 /// This adapter transforms a legacy parser object to an operator.
@@ -25,6 +25,7 @@
 #include <folly/Demangle.h>
 #include <folly/OperationCancelled.h>
 #include <folly/coro/BoundedQueue.h>
+#include <folly/coro/Sleep.h>
 
 #include <mutex>
 
@@ -178,6 +179,14 @@ struct SubPipeline {
   element_type_tag input;
   /// True if this subpipeline received the last checkpoint, requiring a commit.
   bool wants_commit = false;
+  /// True while the parent waits for this subpipeline to return the checkpoint.
+  bool awaiting_checkpoint = false;
+  /// True if the output of this subpipeline is paused after returning the
+  /// checkpoint, until `resume_output` is notified.
+  bool output_paused = false;
+  /// Resumes forwarding the output of the subpipeline, which pauses after
+  /// returning a checkpoint until the checkpoint of the parent is done.
+  Arc<Notify> resume_output{std::in_place};
   /// Diagnostic handler used for running the subpipeline.
   Arc<DiagHandler> sub_dh;
   /// Set when process(SubMessage) observes the from_sub channel drain.
@@ -358,6 +367,19 @@ public:
     return inner_.checkpoint_settings();
   }
 
+  auto save_checkpoint(OpId id, uuid checkpoint, chunk_ptr chunk)
+    -> Task<caf::error> override {
+    return inner_.save_checkpoint(std::move(id), checkpoint, std::move(chunk));
+  }
+
+  auto load_checkpoint(OpId id) -> Task<caf::expected<chunk_ptr>> override {
+    return inner_.load_checkpoint(std::move(id));
+  }
+
+  auto commit_checkpoint(uuid checkpoint) -> Task<caf::error> override {
+    return inner_.commit_checkpoint(checkpoint);
+  }
+
 protected:
   auto make_void(ChannelId id) -> PushPull<OperatorMsg<void>> override {
     return inner_.make_fused_channel<void>(std::move(id));
@@ -568,12 +590,25 @@ private:
   }
 
   auto save_checkpoint(chunk_ptr chunk) -> Task<void> override {
-    TENZIR_UNUSED(chunk);
-    co_return;
+    TENZIR_ASSERT(active_checkpoint_);
+    auto err = co_await exec_ctx_.save_checkpoint(id_, active_checkpoint_->id,
+                                                  std::move(chunk));
+    if (err) {
+      diagnostic::error(err)
+        .note("failed to save checkpoint of `{}`", base_op().name())
+        .emit(dh_);
+    }
   }
 
   auto load_checkpoint() -> Task<chunk_ptr> override {
-    co_return {};
+    auto result = co_await exec_ctx_.load_checkpoint(id_);
+    if (not result) {
+      diagnostic::error(result.error())
+        .note("failed to load checkpoint of `{}`", base_op().name())
+        .emit(dh_);
+      co_return {};
+    }
+    co_return std::move(*result);
   }
 
   auto flush() -> Task<void> override {
@@ -884,6 +919,7 @@ private:
     }
     add_from_sub_recv(it);
     add_to_control_recv(it);
+    auto resume_output = it->second.resume_output;
     // If we already received a graceful stop signal, forward it to the new
     // subpipeline immediately so that nested sources also learn about the
     // shutdown and don't keep producing new work indefinitely.
@@ -896,10 +932,14 @@ private:
                             runner = std::move(runner),
                             pull_sub = std::move(pull_sub),
                             to_parent = std::move(to_parent),
+                            resume_output = std::move(resume_output),
                             sub_cancel_token]() mutable -> Task<void> {
       // The main loop of the subpipeline (or combiner?).
-      using Event = variant<Terminated, Option<AnyOperatorMsg>>;
-      // TODO: Fully implement checkpointing with `allow_output`.
+      struct Resumed {};
+      using Event = variant<Terminated, Resumed, Option<AnyOperatorMsg>>;
+      // Output is blocked between returning a checkpoint to the parent and
+      // the parent finishing that checkpoint, since everything that follows
+      // belongs to the next checkpoint.
       auto allow_output = true;
       auto driver = SelectSet<Event>{};
       co_await driver.activate([&] -> Task<void> {
@@ -950,16 +990,23 @@ private:
                       co_return;
                     },
                     [&](Checkpoint checkpoint) -> Task<void> {
-                      // Notify our parent that we got the checkpoint.
-                      co_await to_parent.send(std::move(checkpoint));
                       // Block all future output until the checkpoint of the
                       // parent operator is done.
                       allow_output = false;
-                      co_return;
+                      driver.add([resume_output] -> Task<Resumed> {
+                        co_await resume_output->wait();
+                        co_return Resumed{};
+                      });
+                      // Notify our parent that we got the checkpoint.
+                      co_await to_parent.send(std::move(checkpoint));
                     });
                 });
               add_pull();
             },
+            [&](Resumed) -> Task<void> {
+              allow_output = true;
+              co_return;
+            },
             [&](Terminated) -> Task<void> {
               // We wait with informing the parent until everything is done to
               // ensure that we don't send anything anymore.
@@ -1175,6 +1222,20 @@ private:
       });
   }
 
+  /// Passes a finished subpipeline to the operator, unless we are forced to
+  /// stop.
+  auto notify_finish_sub(SubKey const& key, Option<failure> error)
+    -> Task<void> {
+    if (phase_ == Phase::stopping_forced) {
+      co_return;
+    }
+    if (error) {
+      co_await call_finish_sub(make_view(key), std::move(*error));
+    } else {
+      co_await call_finish_sub(make_view(key));
+    }
+  }
+
   template <class DataInput>
   auto call_process(DataInput input) -> Task<void> {
     auto& ctx_ref = static_cast<OpCtx&>(*this);
@@ -1199,7 +1260,8 @@ private:
       = co_await folly::coro::co_current_cancellation_token;
     try {
       {
-        // TODO: What if we don't restore? No data? Flag?
+        // Restore the operator state if the pipeline resumes from a checkpoint
+        // that contains a snapshot of this operator.
         auto data = co_await this->load_checkpoint();
         if (data) {
           auto f = caf::binary_deserializer{
@@ -1250,7 +1312,9 @@ private:
           }
           break;
         case OperatorState::done:
-          if (phase_ == Phase::running) {
+          // Finalizing can produce output, which must not overtake an active
+          // checkpoint. We get back here once the checkpoint is finished.
+          if (phase_ == Phase::running and not active_checkpoint_) {
             co_await handle_done(false);
           }
           break;
@@ -1345,17 +1409,22 @@ private:
     // We always pull from upstream, even if the operator is done, since we want
     // to continue receiving checkpoints and our shutdown logic depends on it.
     driver_.add(pull_upstream());
-    if (phase_ == Phase::running and base_op().state() == OperatorState::done) {
+    if (phase_ == Phase::running and not active_checkpoint_
+        and base_op().state() == OperatorState::done) {
       co_await handle_done(false);
     }
   }
 
   auto begin_checkpoint(Checkpoint checkpoint) -> Task<void> {
-    // TODO: This is not fully implement yet. The approach is documented in the
-    // docs of the class, but this implementation is not yet complete.
     LOGI("got checkpoint {} in {}", checkpoint.id, op_name());
+    TENZIR_ASSERT(not active_checkpoint_);
+    active_checkpoint_ = checkpoint;
     co_await to_control_.send(ToControl::checkpoint_begin);
-    co_await call_prepare_snapshot();
+    // Only a running operator may still emit output. Afterwards, the state is
+    // final and we merely snapshot it so that a restore does not redo work.
+    if (phase_ == Phase::running or phase_ == Phase::stopping_gracefully) {
+      co_await call_prepare_snapshot();
+    }
     {
       auto buffer = caf::byte_buffer{};
       auto f = caf::binary_serializer{buffer};
@@ -1367,20 +1436,54 @@ private:
       TENZIR_ASSERT(ok);
       co_await this->save_checkpoint(chunk::make(std::move(buffer)));
     }
-    // TODO: Also checkpoint `subpipelines_`. What else?
-    if (subpipelines_.empty()) {
-      LOGI("finishing checkpoint with no subpipelines in {} ", op_name());
-      co_await to_control_.send(ToControl::checkpoint_done);
-      co_await push_signal(Signal{std::move(checkpoint)});
-      co_return;
+    // Subpipelines that are already shutting down can no longer receive the
+    // checkpoint. They are not part of it, and neither is their output.
+    for (auto& [_, sub] : subpipelines_) {
+      if (not sub.push or sub.from_sub_done) {
+        continue;
+      }
+      co_await sub.send(checkpoint);
+      sub.awaiting_checkpoint = true;
+      pending_sub_checkpoints_ += 1;
     }
-    LOGI("checkpointing {} subpipelines in {}", subpipelines_.size(),
+    LOGI("checkpointing {} subpipelines in {}", pending_sub_checkpoints_,
          op_name());
+    if (pending_sub_checkpoints_ == 0) {
+      co_await finish_checkpoint();
+    }
+  }
+
+  /// Called whenever a subpipeline returned the active checkpoint or will never
+  /// return it because it terminated.
+  auto finish_sub_checkpoint() -> Task<void> {
+    TENZIR_ASSERT(active_checkpoint_);
+    TENZIR_ASSERT(pending_sub_checkpoints_ > 0);
+    pending_sub_checkpoints_ -= 1;
+    if (pending_sub_checkpoints_ == 0) {
+      co_await finish_checkpoint();
+    }
+  }
+
+  auto finish_checkpoint() -> Task<void> {
+    TENZIR_ASSERT(active_checkpoint_);
+    auto checkpoint = std::move(*active_checkpoint_);
+    LOGI("finishing checkpoint {} in {}", checkpoint.id, op_name());
+    co_await to_control_.send(ToControl::checkpoint_done);
+    co_await push_signal(Signal{std::move(checkpoint)});
+    active_checkpoint_ = None{};
     for (auto& [_, sub] : subpipelines_) {
-      co_await sub.send(checkpoint);
-      sub.wants_commit = true;
+      if (std::exchange(sub.output_paused, false)) {
+        sub.resume_output->notify_one();
+      }
     }
-    TENZIR_TODO();
+    // Subpipelines that finished during the checkpoint were recorded instead
+    // of being passed to the operator, as their effect belongs to the next
+    // checkpoint. Now is the time to replay them.
+    auto deferred = std::exchange(deferred_finish_subs_, {});
+    for (auto& [key, error] : deferred) {
+      co_await notify_finish_sub(key, std::move(error));
+    }
+    co_await check_done();
   }
 
   auto process(Option<FromControl> message) -> Task<void> {
@@ -1393,6 +1496,12 @@ private:
       [&](PostCommit) -> Task<void> {
         LOGV("got post commit in {}", op_name());
         co_await base_op().post_commit(*this);
+        for (auto& [_, sub] : subpipelines_) {
+          if (std::exchange(sub.wants_commit, false)
+              and sub.from_control_sender) {
+            co_await sub.from_control_sender->send(PostCommit{});
+          }
+        }
       },
       [&](GracefulStop) -> Task<void> {
         if (phase_ == Phase::stopping_forced or phase_ == Phase::stopped
@@ -1441,14 +1550,17 @@ private:
         co_return;
       }
       auto sub_failure = sub.sub_dh->failure();
+      auto error = Option<failure>{};
+      if (sub_failure.is_error()) {
+        error = sub_failure.error();
+      }
       subpipelines_.erase(it);
-      if (phase_ != Phase::stopping_forced) {
-        if (sub_failure.is_error()) {
-          co_await call_finish_sub(make_view(message.key), sub_failure.error());
-        } else {
-          co_await call_finish_sub(make_view(message.key));
-        }
+      if (active_checkpoint_) {
+        deferred_finish_subs_.emplace_back(std::move(message.key),
+                                           std::move(error));
+        co_return;
       }
+      co_await notify_finish_sub(message.key, std::move(error));
       co_await check_done();
     };
     co_await co_match(
@@ -1456,13 +1568,23 @@ private:
       [&](Option<Checkpoint> checkpoint) -> Task<void> {
         if (not checkpoint) {
           sub.from_sub_done = true;
+          // A subpipeline that terminates without returning the checkpoint
+          // will never do so, so we stop waiting for it.
+          auto was_awaiting = std::exchange(sub.awaiting_checkpoint, false);
           co_await finish_if_closed();
+          if (was_awaiting) {
+            co_await finish_sub_checkpoint();
+          }
           co_return;
         }
-        TENZIR_UNUSED(checkpoint);
-        TENZIR_TODO();
+        TENZIR_ASSERT(active_checkpoint_);
+        TENZIR_ASSERT(checkpoint->id == active_checkpoint_->id);
+        TENZIR_ASSERT(sub.awaiting_checkpoint);
+        sub.awaiting_checkpoint = false;
+        sub.output_paused = true;
+        sub.wants_commit = true;
         add_from_sub_recv(it);
-        co_return;
+        co_await finish_sub_checkpoint();
       },
       [&](Option<ToControl> to_control) -> Task<void> {
         if (not to_control) {
@@ -1493,7 +1615,9 @@ private:
             break;
           case ToControl::checkpoint_begin:
           case ToControl::checkpoint_done:
-            TENZIR_TODO();
+            // The chain runner of the subpipeline does not forward these, as
+            // checkpoints return to us through the data path.
+            break;
         }
         add_to_control_recv(it);
       });
@@ -1572,6 +1696,11 @@ private:
       // We need to wait for all subpipelines to finish.
       co_return;
     }
+    if (active_checkpoint_) {
+      // The checkpoint must leave the operator before its end of data.
+      // `finish_checkpoint()` gets us back here.
+      co_return;
+    }
     if (operator_draining_ and base_op().state() != OperatorState::done) {
       // The operator returned FinalizeBehavior::continue_ and has not
       // transitioned to done yet.
@@ -1638,8 +1767,14 @@ private:
 
   /// The primary stream of events that the main loop reacts to.
   SelectSet<Event> driver_;
-  /// Whether we want to exclusively listen for messages from subpipelines.
-  bool active_checkpoint_{false};
+  /// The checkpoint that we are currently performing, if any. While set, we
+  /// exclusively listen for messages from subpipelines and control.
+  Option<Checkpoint> active_checkpoint_;
+  /// The number of subpipelines that did not yet return the active checkpoint.
+  size_t pending_sub_checkpoints_{0};
+  /// Subpipelines that finished during the active checkpoint, with their
+  /// failure, if any.
+  std::vector<std::pair<SubKey, Option<failure>>> deferred_finish_subs_;
   /// True if there is an `await_task()` not yet processed by the mainloop.
   bool await_task_pending_{false};
   /// Whether `EndOfData` was already received from upstream.
@@ -1949,6 +2084,8 @@ auto new_pipe_id() -> PipeId {
 
 struct GracefulStopRequested {};
 
+struct CheckpointDue {};
+
 auto run_pipeline(OperatorChain<void, void> pipeline, ExecCtx& exec_ctx,
                   caf::actor_system& sys, DiagHandler& dh,
                   Notify* graceful_stop) -> Task<void> {
@@ -1964,8 +2101,30 @@ auto run_pipeline(OperatorChain<void, void> pipeline, ExecCtx& exec_ctx,
       = Option<Sender<FromControl>>{std::move(from_control_sender_raw)};
     auto [to_control_sender, to_control_receiver] = channel<ToControl>(16);
     auto driver
-      = JoinSet<variant<Terminated, GracefulStopRequested, Option<ToControl>,
-                        Option<OperatorMsg<void>>>>{};
+      = JoinSet<variant<Terminated, GracefulStopRequested, CheckpointDue,
+                        Option<ToControl>, Option<OperatorMsg<void>>>>{};
+    // We inject a checkpoint into the pipeline once the interval elapsed after
+    // the previous one was committed, so there is at most one in flight.
+    auto checkpoint_settings = exec_ctx.checkpoint_settings();
+    auto checkpoint_cancel = folly::CancellationSource{};
+    auto checkpoint_in_flight = Option<uuid>{};
+    auto input_closed = false;
+    auto schedule_checkpoint = [&] {
+      if (not checkpoint_settings or input_closed) {
+        return;
+      }
+      driver.add([interval = checkpoint_settings->interval,
+                  token = checkpoint_cancel.getToken()] -> Task<CheckpointDue> {
+        auto merged = folly::cancellation_token_merge(
+          co_await folly::coro::co_current_cancellation_token, token);
+        std::ignore = co_await catch_cancellation(
+          folly::coro::co_withCancellation(
+            merged,
+            folly::coro::sleep(
+              std::chrono::duration_cast<folly::HighResDuration>(interval))));
+        co_return CheckpointDue{};
+      });
+    };
     LOGV("creating pipeline queue scope");
     co_await driver.activate([&] -> Task<void> {
       driver.add([&] -> Task<Terminated> {
@@ -1984,17 +2143,7 @@ auto run_pipeline(OperatorChain<void, void> pipeline, ExecCtx& exec_ctx,
           co_return GracefulStopRequested{};
         });
       }
-#if 0
-      // TODO: We just have this right now to simulate checkpointing.
-      queue.scope().spawn([&] -> Task<std::monostate> {
-        while (true) {
-          auto checkpoint = Checkpoint{uuid::random()};
-          LOGI("injecting checkpoint {} into pipeline", checkpoint.id);
-          co_await push_input(std::move(checkpoint));
-          co_await folly::coro::sleep(std::chrono::seconds{1});
-        }
-      });
-#endif
+      schedule_checkpoint();
       auto terminated = false;
       while (auto next = co_await driver.next()) {
         co_await co_match(
@@ -2003,6 +2152,7 @@ auto run_pipeline(OperatorChain<void, void> pipeline, ExecCtx& exec_ctx,
             LOGI("run_pipeline got info that chain terminated");
             terminated = true;
             from_control_sender = None{};
+            checkpoint_cancel.requestCancellation();
             // If the pipeline terminated without graceful stop,
             // the Notify would block the driver forever, never completing.
             if (graceful_stop) {
@@ -2022,6 +2172,16 @@ auto run_pipeline(OperatorChain<void, void> pipeline, ExecCtx& exec_ctx,
               co_await from_control_sender->send(GracefulStop{});
             }
           },
+          [&](CheckpointDue) -> Task<void> {
+            if (terminated or input_closed) {
+              co_return;
+            }
+            TENZIR_ASSERT(not checkpoint_in_flight);
+            auto checkpoint = Checkpoint{uuid::random()};
+            LOGI("injecting checkpoint {} into pipeline", checkpoint.id);
+            checkpoint_in_flight = checkpoint.id;
+            co_await push_input(Signal{std::move(checkpoint)});
+          },
           [&](Option<ToControl> to_control) -> Task<void> {
             if (not to_control) {
               co_return;
@@ -2036,11 +2196,15 @@ auto run_pipeline(OperatorChain<void, void> pipeline, ExecCtx& exec_ctx,
                   // FIXME: We should not leave this dangling.
                   auto _input = std::move(push_input);
                   from_control_sender = None{};
+                  input_closed = true;
+                  checkpoint_cancel.requestCancellation();
                 }
                 break;
               case ToControl::checkpoint_begin:
               case ToControl::checkpoint_done:
-                TENZIR_TODO();
+                // The chain runner does not forward these, as we learn about
+                // completed checkpoints once they leave the pipeline.
+                break;
             }
             driver.add(to_control_receiver.recv());
           },
@@ -2048,19 +2212,34 @@ auto run_pipeline(OperatorChain<void, void> pipeline, ExecCtx& exec_ctx,
             if (not msg) {
               co_return;
             }
-            co_match(*msg, [&](Signal signal) {
-              co_match(
+            driver.add(pull_output());
+            co_await co_match(*msg, [&](Signal signal) -> Task<void> {
+              co_await co_match(
                 signal,
-                [&](EndOfData) {
+                [&](EndOfData) -> Task<void> {
                   LOGI("end of data is leaving pipeline");
+                  co_return;
                 },
-                [&](Checkpoint checkpoint) {
-                  TENZIR_UNUSED(checkpoint);
+                [&](Checkpoint checkpoint) -> Task<void> {
                   LOGI("checkpoint {} is leaving pipeline", checkpoint.id);
+                  TENZIR_ASSERT(checkpoint_in_flight
+                                and *checkpoint_in_flight == checkpoint.id);
+                  checkpoint_in_flight = None{};
+                  // Every operator persisted its snapshot before forwarding
+                  // the checkpoint, so it is now complete.
+                  if (auto err
+                      = co_await exec_ctx.commit_checkpoint(checkpoint.id)) {
+                    diagnostic::error(err)
+                      .note("failed to commit checkpoint")
+                      .emit(dh);
+                    co_return;
+                  }
+                  if (from_control_sender) {
+                    co_await from_control_sender->send(PostCommit{});
+                  }
+                  schedule_checkpoint();
                 });
             });
-            driver.add(pull_output());
-            co_return;
           });
       }
     });
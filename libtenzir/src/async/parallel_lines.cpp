@@ -0,0 +1,262 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/async/parallel_lines.hpp"
+
+#include "tenzir/detail/assert.hpp"
+
+#include <fmt/format.h>
+#include <folly/OperationCancelled.h>
+
+#include <algorithm>
+
+namespace tenzir {
+
+namespace {
+
+auto as_string_view(const chunk_ptr& chunk) -> std::string_view {
+  return {reinterpret_cast<const char*>(chunk->data()), chunk->size()};
+}
+
+/// Calls `f` with every line of `data`, including an unterminated last line.
+template <class F>
+auto for_each_line(std::string_view data, F&& f) -> void {
+  const auto* begin = data.data();
+  const auto* const end = begin + data.size();
+  for (const auto* current = begin; current != end; ++current) {
+    if (*current != '\n' and *current != '\r') {
+      continue;
+    }
+    f(std::string_view{begin, current});
+    if (*current == '\r' and current + 1 != end and *(current + 1) == '\n') {
+      ++current;
+    }
+    begin = current + 1;
+  }
+  if (begin != end) {
+    f(std::string_view{begin, end});
+  }
+}
+
+auto count_lines(std::string_view data) -> size_t {
+  if (data.find('\r') == std::string_view::npos) {
+    return std::ranges::count(data, '\n')
+           + (data.empty() or data.back() == '\n' ? 0 : 1);
+  }
+  auto result = size_t{0};
+  for_each_line(data, [&](std::string_view) {
+    ++result;
+  });
+  return result;
+}
+
+} // namespace
+
+auto annotate_line(diagnostic d, location operator_location, size_t line)
+  -> diagnostic {
+  if (operator_location) {
+    auto replaced_unknown_location = false;
+    for (auto& annotation : d.annotations) {
+      if (annotation.source) {
+        continue;
+      }
+      annotation.source = operator_location;
+      replaced_unknown_location = true;
+    }
+    if (not replaced_unknown_location and d.annotations.empty()) {
+      d.annotations.emplace(d.annotations.begin(), true, "",
+                            operator_location);
+    }
+  }
+  d.notes.emplace(d.notes.begin(), diagnostic_note_kind::note,
+                  fmt::format("line {}", line));
+  return d;
+}
+
+ParallelLineParser::ParallelLineParser(uint64_t jobs, bool ordered,
+                                       MakeLineParserWorker make_worker,
+                                       StartsBatch starts_batch)
+  : jobs_{jobs},
+    ordered_{ordered},
+    make_worker_{std::move(make_worker)},
+    starts_batch_{std::move(starts_batch)} {
+  TENZIR_ASSERT(jobs_ > 0);
+}
+
+auto ParallelLineParser::start(OpCtx& ctx) -> void {
+  input_ = std::make_shared<InputQueue>(static_cast<uint32_t>(jobs_ * 2));
+  output_ = std::make_shared<OutputQueue>();
+  for (auto i = uint64_t{0}; i < jobs_; ++i) {
+    ctx.spawn_task(work(input_, output_, make_worker_(ctx.dh())));
+  }
+}
+
+auto ParallelLineParser::add(chunk_ptr input) -> Task<void> {
+  TENZIR_ASSERT(not finishing_);
+  if (not input or input->size() == 0) {
+    co_return;
+  }
+  auto data = as_string_view(input);
+  // Skip the second half of a `\r\n` that was split across two chunks.
+  if (ended_on_carriage_return_ and data.front() == '\n') {
+    data.remove_prefix(1);
+  }
+  ended_on_carriage_return_ = false;
+  if (starts_batch_) {
+    if (data.empty()) {
+      co_return;
+    }
+    ended_on_carriage_return_ = data.back() == '\r';
+    const auto scanned = buffer_.size();
+    buffer_.append(data);
+    co_await dispatch_until_last_start(scanned);
+    co_return;
+  }
+  const auto last = data.find_last_of("\r\n");
+  if (last == std::string_view::npos) {
+    buffer_.append(data);
+    co_return;
+  }
+  const auto end = last + 1;
+  if (data[last] == '\r' and end == data.size()) {
+    ended_on_carriage_return_ = true;
+  }
+  auto lines = chunk_ptr{};
+  if (buffer_.empty()) {
+    const auto offset
+      = static_cast<size_t>(data.data() - as_string_view(input).data());
+    lines = input->slice(offset, end);
+  } else {
+    // Copying the buffered prefix together with the complete lines avoids
+    // dispatching tiny batches that would turn into tiny table slices.
+    buffer_.append(data.substr(0, end));
+    lines = chunk::make(std::exchange(buffer_, {}));
+  }
+  buffer_.assign(data.substr(end));
+  co_await dispatch(std::move(lines));
+}
+
+auto ParallelLineParser::finish() -> Task<void> {
+  if (std::exchange(finishing_, true)) {
+    co_return;
+  }
+  if (not buffer_.empty()) {
+    co_await dispatch(chunk::make(std::exchange(buffer_, {})));
+  }
+  co_await input_->enqueue(None{});
+}
+
+auto ParallelLineParser::next() const -> Task<Any> {
+  co_return co_await output_->dequeue();
+}
+
+auto ParallelLineParser::handle(Any result, Push<table_slice>& push)
+  -> Task<void> {
+  auto next = std::move(result).as<Option<Result>>();
+  if (not next) {
+    ++finished_workers_;
+    co_return;
+  }
+  if (not ordered_) {
+    ++emitted_;
+    for (auto& slice : next->slices) {
+      co_await push(std::move(slice));
+    }
+    co_return;
+  }
+  reorder_buffer_.emplace(next->index, std::move(next->slices));
+  while (not reorder_buffer_.empty()
+         and reorder_buffer_.begin()->first == emitted_) {
+    auto slices = std::move(reorder_buffer_.begin()->second);
+    reorder_buffer_.erase(reorder_buffer_.begin());
+    ++emitted_;
+    for (auto& slice : slices) {
+      co_await push(std::move(slice));
+    }
+  }
+}
+
+auto ParallelLineParser::flush(Push<table_slice>& push) -> Task<void> {
+  while (emitted_ < dispatched_) {
+    co_await handle(co_await next(), push);
+  }
+}
+
+auto ParallelLineParser::done() const -> bool {
+  return finished_workers_ == jobs_;
+}
+
+auto ParallelLineParser::snapshot(Serde& serde) -> void {
+  TENZIR_ASSERT(emitted_ == dispatched_);
+  serde("buffer", buffer_);
+  serde("ended_on_carriage_return", ended_on_carriage_return_);
+  serde("lines", lines_);
+}
+
+auto ParallelLineParser::dispatch(chunk_ptr lines) -> Task<void> {
+  auto batch = Batch{
+    .index = dispatched_,
+    .first_line = lines_ + 1,
+    .lines = std::move(lines),
+  };
+  ++dispatched_;
+  lines_ += count_lines(as_string_view(batch.lines));
+  co_await input_->enqueue(std::move(batch));
+}
+
+auto ParallelLineParser::dispatch_until_last_start(size_t scanned)
+  -> Task<void> {
+  // Lines that were complete before could not start a batch, or we would have
+  // dispatched up to them already, so we only check lines that end in the new
+  // part of the buffer.
+  const auto buffer = std::string_view{buffer_};
+  auto line_end = buffer.find_last_of("\r\n");
+  while (line_end != std::string_view::npos and line_end >= scanned
+         and line_end > 0) {
+    const auto previous = buffer.find_last_of("\r\n", line_end - 1);
+    if (previous == std::string_view::npos) {
+      break;
+    }
+    const auto begin = previous + 1;
+    if (begin != line_end
+        and starts_batch_(buffer.substr(begin, line_end - begin))) {
+      auto lines = chunk::make(std::string{buffer.substr(0, begin)});
+      buffer_.erase(0, begin);
+      co_await dispatch(std::move(lines));
+      co_return;
+    }
+    line_end = previous;
+  }
+}
+
+auto ParallelLineParser::work(std::shared_ptr<InputQueue> input,
+                              std::shared_ptr<OutputQueue> output,
+                              std::unique_ptr<LineParserWorker> worker)
+  -> Task<void> {
+  try {
+    while (true) {
+      co_await folly::coro::co_reschedule_on_current_executor;
+      auto next = co_await input->dequeue();
+      if (not next) {
+        // Pass the stop sentinel on to the next worker.
+        co_await input->enqueue(None{});
+        break;
+      }
+      auto line_number = next->first_line;
+      for_each_line(as_string_view(next->lines), [&](std::string_view line) {
+        worker->parse_line(line, line_number);
+        ++line_number;
+      });
+      output->enqueue(Result{next->index, worker->finish()});
+    }
+  } catch (folly::OperationCancelled const&) {
+  }
+  output->enqueue(None{});
+}
+
+} // namespace tenzir
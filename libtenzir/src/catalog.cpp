@@ -24,6 +24,7 @@
 #include "tenzir/io/read.hpp"
 #include "tenzir/io/save.hpp"
 #include "tenzir/logger.hpp"
+#include "tenzir/min_max_synopsis.hpp"
 #include "tenzir/modules.hpp"
 #include "tenzir/partition_synopsis.hpp"
 #include "tenzir/pipeline.hpp"
@@ -39,6 +40,7 @@
 #include <caf/detail/set_thread_name.hpp>
 #include <caf/expected.hpp>
 
+#include <cmath>
 #include <ranges>
 #include <set>
 #include <string_view>
@@ -331,6 +333,10 @@ auto catalog_state::initialize(std::vector<partition_synopsis_pair> partitions)
   for (auto& [type, flat_data] : flat_data_map) {
     std::ranges::sort(flat_data, std::ranges::less{},
                       &flat_data_list::value_type::first);
+    auto& range_index = range_indexes[type];
+    for (const auto& [id, synopsis] : flat_data) {
+      range_index.add(id, *synopsis);
+    }
     synopses_per_type[type]
       = decltype(synopses_per_type)::value_type::second_type::make_unsafe(
         std::move(flat_data));
@@ -341,10 +347,216 @@ auto catalog_state::initialize(std::vector<partition_synopsis_pair> partitions)
   return atom::ok_v;
 }
 
+namespace {
+
+/// Returns the synopsis that a lookup consults for a field of a partition, if
+/// any. This mirrors the fallback to type synopses in `lookup_impl`.
+auto effective_synopsis(const partition_synopsis& partition,
+                        const qualified_record_field& field,
+                        const synopsis_ptr& field_synopsis)
+  -> const synopsis* {
+  if (field_synopsis) {
+    return field_synopsis.get();
+  }
+  auto prune = [&]<concrete_type T>(const T& x) {
+    return type{x};
+  };
+  auto cleaned_type = tenzir::match(field.type(), prune);
+  auto it = partition.type_synopses_.find(cleaned_type);
+  if (it == partition.type_synopses_.end()) {
+    return nullptr;
+  }
+  return it->second.get();
+}
+
+/// Returns the min/max synopsis with the given value type, unless its range
+/// cannot be ordered.
+template <class T>
+auto as_min_max(const synopsis* synopsis) -> const min_max_synopsis<T>* {
+  const auto* result = dynamic_cast<const min_max_synopsis<T>*>(synopsis);
+  if constexpr (std::is_floating_point_v<T>) {
+    if (result and (std::isnan(result->min()) or std::isnan(result->max()))) {
+      return nullptr;
+    }
+  }
+  return result;
+}
+
+/// Selects all intervals that a `min_max_synopsis<T>` does not rule out for
+/// the given predicate, or returns `std::nullopt` for predicates that the
+/// synopsis cannot answer definitively.
+template <class T>
+auto lookup_min_max(const detail::interval_index<T, uuid>& index,
+                    relational_operator op, const data& rhs)
+  -> std::optional<std::vector<uuid>> {
+  using bound = typename detail::interval_index<T, uuid>::bound;
+  auto result = std::vector<uuid>{};
+  auto select = [&](std::optional<bound> lower, std::optional<bound> upper) {
+    index.for_each(lower, upper, [&](const uuid& id) {
+      result.push_back(id);
+    });
+  };
+  if (op == relational_operator::in) {
+    const auto* xs = try_as<list>(&rhs);
+    if (not xs) {
+      return std::nullopt;
+    }
+    for (const auto& x : *xs) {
+      const auto* value = try_as<T>(&x);
+      if (not value) {
+        return std::nullopt;
+      }
+      select(bound{*value, true}, bound{*value, true});
+    }
+  } else {
+    const auto* value = try_as<T>(&rhs);
+    if (not value) {
+      return std::nullopt;
+    }
+    switch (op) {
+      case relational_operator::equal:
+        select(bound{*value, true}, bound{*value, true});
+        break;
+      case relational_operator::less:
+        select(std::nullopt, bound{*value, false});
+        break;
+      case relational_operator::less_equal:
+        select(std::nullopt, bound{*value, true});
+        break;
+      case relational_operator::greater:
+        select(bound{*value, false}, std::nullopt);
+        break;
+      case relational_operator::greater_equal:
+        select(bound{*value, true}, std::nullopt);
+        break;
+      default:
+        return std::nullopt;
+    }
+  }
+  std::ranges::sort(result);
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+} // namespace
+
+void catalog_range_index::add(const uuid& partition,
+                              const partition_synopsis& synopsis) {
+  import_time_.insert(partition, synopsis.min_import_time,
+                      synopsis.max_import_time);
+  for (const auto& [field, field_synopsis] : synopsis.field_synopses_) {
+    auto& entry = fields_[field];
+    const auto* effective
+      = effective_synopsis(synopsis, field, field_synopsis);
+    auto insert = [&]<class T>(tag<T>) {
+      const auto* min_max = as_min_max<T>(effective);
+      if (not min_max) {
+        return false;
+      }
+      if (not entry.index) {
+        entry.index.emplace(std::in_place_type<index_type<T>>);
+      }
+      auto* index = std::get_if<index_type<T>>(&*entry.index);
+      if (not index) {
+        return false;
+      }
+      index->insert(partition, min_max->min(), min_max->max());
+      return true;
+    };
+    auto indexed = insert(tag_v<time>) or insert(tag_v<duration>)
+                   or insert(tag_v<int64_t>) or insert(tag_v<uint64_t>)
+                   or insert(tag_v<double>);
+    if (not indexed) {
+      entry.unindexed += 1;
+    }
+  }
+}
+
+void catalog_range_index::remove(const uuid& partition,
+                                 const partition_synopsis& synopsis) {
+  import_time_.erase(partition, synopsis.min_import_time);
+  for (const auto& [field, field_synopsis] : synopsis.field_synopses_) {
+    auto it = fields_.find(field);
+    if (it == fields_.end()) {
+      continue;
+    }
+    auto& entry = it->second;
+    const auto* effective
+      = effective_synopsis(synopsis, field, field_synopsis);
+    auto erase = [&]<class T>(tag<T>) {
+      const auto* min_max = as_min_max<T>(effective);
+      if (not min_max or not entry.index) {
+        return false;
+      }
+      auto* index = std::get_if<index_type<T>>(&*entry.index);
+      return index and index->erase(partition, min_max->min());
+    };
+    auto indexed = erase(tag_v<time>) or erase(tag_v<duration>)
+                   or erase(tag_v<int64_t>) or erase(tag_v<uint64_t>)
+                   or erase(tag_v<double>);
+    if (not indexed) {
+      TENZIR_ASSERT(entry.unindexed > 0);
+      entry.unindexed -= 1;
+    }
+    auto empty = entry.unindexed == 0
+                 and (not entry.index
+                      or std::visit(
+                        [](const auto& index) {
+                          return index.empty();
+                        },
+                        *entry.index));
+    if (empty) {
+      fields_.erase(it);
+    }
+  }
+}
+
+auto catalog_range_index::lookup_import_time(relational_operator op,
+                                             const data& rhs) const
+  -> std::optional<std::vector<uuid>> {
+  return lookup_min_max(import_time_, op, rhs);
+}
+
+auto catalog_range_index::lookup_field(const qualified_record_field& field,
+                                       relational_operator op,
+                                       const data& rhs) const
+  -> std::optional<std::vector<uuid>> {
+  auto it = fields_.find(field);
+  if (it == fields_.end() or it->second.unindexed > 0
+      or not it->second.index) {
+    return std::nullopt;
+  }
+  return std::visit(
+    [&]<class T>(const detail::interval_index<T, uuid>& index) {
+      return lookup_min_max(index, op, rhs);
+    },
+    *it->second.index);
+}
+
+auto catalog_range_index::memusage() const -> size_t {
+  auto result = import_time_.memusage();
+  for (const auto& [_, entry] : fields_) {
+    result += sizeof(entry);
+    if (entry.index) {
+      result += std::visit(
+        [](const auto& index) {
+          return index.memusage();
+        },
+        *entry.index);
+    }
+  }
+  return result;
+}
+
 auto catalog_state::merge(std::vector<partition_synopsis_pair> partitions)
   -> caf::result<atom::ok> {
   for (auto& [id, synopsis] : partitions) {
+    auto& range_index = range_indexes[synopsis->schema];
     auto& entry = synopses_per_type[synopsis->schema][id];
+    if (entry) {
+      range_index.remove(id, *entry);
+    }
+    range_index.add(id, *synopsis);
     entry = std::move(synopsis);
   }
   return atom::ok_v;
@@ -353,13 +565,19 @@ auto catalog_state::merge(std::vector<partition_synopsis_pair> partitions)
 void catalog_state::erase(const uuid& partition) {
   for (auto it = synopses_per_type.begin(); it != synopses_per_type.end();
        ++it) {
-    const auto num_erased = it->second.erase(partition);
-    if (num_erased > 0) {
-      if (it->second.empty()) {
-        synopses_per_type.erase(it);
-      }
-      return;
+    auto entry = it->second.find(partition);
+    if (entry == it->second.end()) {
+      continue;
+    }
+    if (entry->second) {
+      range_indexes[it->first].remove(partition, *entry->second);
+    }
+    it->second.erase(entry);
+    if (it->second.empty()) {
+      range_indexes.erase(it->first);
+      synopses_per_type.erase(it);
     }
+    return;
   }
 }
 
@@ -522,6 +740,9 @@ auto catalog_state::lookup_impl(const expression& expr,
     return {};
   }
   const auto& partition_synopses = synopsis_map_per_type_it->second;
+  const auto range_index_it = range_indexes.find(schema);
+  TENZIR_ASSERT(range_index_it != range_indexes.end());
+  const auto& range_index = range_index_it->second;
   // The partition UUIDs must be sorted, otherwise the invariants of the
   // inplace union and intersection algorithms are violated, leading to
   // wrong results. So all places where we return an assembled set must
@@ -539,6 +760,17 @@ auto catalog_state::lookup_impl(const expression& expr,
     }
     return memoized_partitions;
   };
+  // Turns the sorted partition IDs selected by the range index into a result.
+  auto selected_partitions = [&](const std::vector<uuid>& partitions) {
+    auto result = catalog_lookup_result::candidate_info{};
+    result.partition_infos.reserve(partitions.size());
+    for (const auto& partition_id : partitions) {
+      auto it = partition_synopses.find(partition_id);
+      TENZIR_ASSERT(it != partition_synopses.end());
+      result.partition_infos.emplace_back(partition_id, *it->second);
+    }
+    return result;
+  };
   auto f = detail::overload{
     [&](const conjunction& x) -> catalog_lookup_result::candidate_info {
       TENZIR_ASSERT(not x.empty());
@@ -593,10 +825,25 @@ auto catalog_state::lookup_impl(const expression& expr,
       auto search = [&](auto match) {
         TENZIR_ASSERT(is<data>(x.rhs));
         const auto& rhs = as<data>(x.rhs);
+        // All matching fields that have a min/max synopsis in every partition
+        // can be answered from the range index. Otherwise, we fall back to
+        // visiting every partition.
+        auto indexed = std::optional<std::vector<uuid>>{std::in_place};
+        for (const auto& field : range_index.fields()) {
+          if (not match(field)) {
+            continue;
+          }
+          auto xs = range_index.lookup_field(field, x.op, rhs);
+          if (not xs) {
+            indexed = std::nullopt;
+            break;
+          }
+          detail::inplace_unify(*indexed, std::move(*xs));
+        }
+        if (indexed) {
+          return selected_partitions(*indexed);
+        }
         catalog_lookup_result::candidate_info result;
-        // dont iterate through all synopses, rewrite lookup_impl to use a
-        // singular type all synopses loops -> relevant anymore? Use type as
-        // synopses key
         for (const auto& [part_id, part_syn] : partition_synopses) {
           for (const auto& [field, syn] : part_syn->field_synopses_) {
             if (match(field)) {
@@ -687,6 +934,9 @@ auto catalog_state::lookup_impl(const expression& expr,
               return result;
             }
             case meta_extractor::import_time: {
+              if (auto indexed = range_index.lookup_import_time(x.op, d)) {
+                return selected_partitions(*indexed);
+              }
               catalog_lookup_result::candidate_info result;
               for (const auto& [part_id, part_syn] : partition_synopses) {
                 TENZIR_ASSERT(
@@ -806,6 +1056,9 @@ auto catalog_state::memusage() const -> size_t {
       result += synopsis->memusage();
     }
   }
+  for (const auto& [type, range_index] : range_indexes) {
+    result += range_index.memusage();
+  }
   return result;
 }
 
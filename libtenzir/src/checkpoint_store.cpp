@@ -0,0 +1,196 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/checkpoint_store.hpp"
+
+#include "tenzir/defaults.hpp"
+#include "tenzir/error.hpp"
+#include "tenzir/hash/hash.hpp"
+#include "tenzir/io/read.hpp"
+#include "tenzir/io/save.hpp"
+#include "tenzir/logger.hpp"
+
+#include <caf/settings.hpp>
+
+#include <algorithm>
+
+namespace tenzir {
+
+namespace {
+
+/// The file that holds the id of the last committed checkpoint.
+constexpr auto latest_filename = std::string_view{"LATEST"};
+
+/// Removes all checkpoint directories except for the given ones.
+auto remove_checkpoints_except(const std::filesystem::path& directory,
+                               std::span<const std::optional<uuid>> keep)
+  -> void {
+  auto ec = std::error_code{};
+  for (const auto& entry : std::filesystem::directory_iterator{directory, ec}) {
+    if (not entry.is_directory(ec)) {
+      continue;
+    }
+    const auto name = entry.path().filename().string();
+    const auto kept = std::ranges::any_of(keep, [&](const auto& id) {
+      return id and fmt::to_string(*id) == name;
+    });
+    if (kept) {
+      continue;
+    }
+    std::filesystem::remove_all(entry.path(), ec);
+    if (ec) {
+      TENZIR_WARN("failed to remove checkpoint {}: {}", entry.path(),
+                  ec.message());
+    }
+  }
+}
+
+} // namespace
+
+auto checkpoint_directory(const caf::settings& cfg, std::string_view definition)
+  -> std::filesystem::path {
+  const auto state_directory = std::filesystem::path{caf::get_or(
+    cfg, "tenzir.state-directory", defaults::state_directory.data())};
+  return state_directory / "checkpoints"
+         / fmt::format("{:016x}", hash(definition));
+}
+
+CheckpointStore::CheckpointStore(std::filesystem::path directory,
+                                 std::optional<uuid> restored)
+  : directory_{std::move(directory)}, restored_{restored} {
+}
+
+CheckpointStore::CheckpointStore(CheckpointStore&& other) noexcept
+  : directory_{std::move(other.directory_)}, restored_{other.restored_} {
+}
+
+auto CheckpointStore::operator=(CheckpointStore&& other) noexcept
+  -> CheckpointStore& {
+  directory_ = std::move(other.directory_);
+  restored_ = other.restored_;
+  return *this;
+}
+
+auto CheckpointStore::make(std::filesystem::path directory)
+  -> caf::expected<CheckpointStore> {
+  auto ec = std::error_code{};
+  std::filesystem::create_directories(directory, ec);
+  if (ec) {
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("failed to create checkpoint directory "
+                                       "{}: {}",
+                                       directory, ec.message()));
+  }
+  auto restored = std::optional<uuid>{};
+  const auto latest = directory / latest_filename;
+  if (std::filesystem::exists(latest, ec)) {
+    auto bytes = io::read(latest);
+    if (not bytes) {
+      return std::move(bytes.error());
+    }
+    if (bytes->size() != uuid::num_bytes) {
+      return caf::make_error(ec::parse_error,
+                             fmt::format("corrupt checkpoint marker {}",
+                                         latest));
+    }
+    restored
+      = uuid{std::span<const std::byte, uuid::num_bytes>{bytes->data(),
+                                                         uuid::num_bytes}};
+  }
+  remove_checkpoints_except(directory, std::array{restored});
+  return CheckpointStore{std::move(directory), restored};
+}
+
+auto CheckpointStore::save(const uuid& checkpoint, std::string_view key,
+                           std::span<const std::byte> bytes) -> caf::error {
+  auto ec = std::error_code{};
+  const auto filename = path(checkpoint, key);
+  std::filesystem::create_directories(filename.parent_path(), ec);
+  if (ec) {
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("failed to create checkpoint directory "
+                                       "{}: {}",
+                                       filename.parent_path(), ec.message()));
+  }
+  return io::save(filename, bytes);
+}
+
+auto CheckpointStore::commit(const uuid& checkpoint) -> caf::error {
+  auto lock = std::scoped_lock{mutex_};
+  auto ec = std::error_code{};
+  // A checkpoint of a pipeline without any snapshots has no directory yet,
+  // but we still need to commit it to replace the previous one.
+  std::filesystem::create_directories(directory_ / fmt::to_string(checkpoint),
+                                      ec);
+  if (ec) {
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("failed to create checkpoint directory "
+                                       "{}: {}",
+                                       directory_, ec.message()));
+  }
+  if (auto err = io::save(directory_ / latest_filename, as_bytes(checkpoint))) {
+    return err;
+  }
+  // From here on, the previous checkpoint is obsolete. We stop restoring
+  // snapshots from it, so it is safe to remove everything else.
+  restored_ = std::nullopt;
+  remove_checkpoints_except(directory_,
+                            std::array{std::optional<uuid>{checkpoint}});
+  return {};
+}
+
+auto CheckpointStore::load(std::string_view key) const
+  -> caf::expected<chunk_ptr> {
+  auto lock = std::scoped_lock{mutex_};
+  if (not restored_) {
+    return chunk_ptr{};
+  }
+  const auto filename = path(*restored_, key);
+  auto ec = std::error_code{};
+  if (not std::filesystem::exists(filename, ec)) {
+    return chunk_ptr{};
+  }
+  auto bytes = io::read(filename);
+  if (not bytes) {
+    return std::move(bytes.error());
+  }
+  return chunk::make(std::move(*bytes));
+}
+
+auto CheckpointStore::restored() const -> std::optional<uuid> {
+  auto lock = std::scoped_lock{mutex_};
+  return restored_;
+}
+
+auto CheckpointStore::clear() -> caf::error {
+  auto lock = std::scoped_lock{mutex_};
+  restored_ = std::nullopt;
+  auto ec = std::error_code{};
+  std::filesystem::remove_all(directory_, ec);
+  if (ec) {
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("failed to remove checkpoints in {}: {}",
+                                       directory_, ec.message()));
+  }
+  return {};
+}
+
+auto CheckpointStore::directory() const -> const std::filesystem::path& {
+  return directory_;
+}
+
+auto CheckpointStore::path(const uuid& checkpoint, std::string_view key) const
+  -> std::filesystem::path {
+  // Operator ids contain slashes to denote nesting, which we flatten so that
+  // every checkpoint is a single directory.
+  auto filename = std::string{key};
+  std::ranges::replace(filename, '/', '_');
+  return directory_ / fmt::to_string(checkpoint) / filename;
+}
+
+} // namespace tenzir
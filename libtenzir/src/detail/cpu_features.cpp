@@ -0,0 +1,24 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/detail/cpu_features.hpp"
+
+namespace tenzir::detail {
+
+auto has_avx2() -> bool {
+#if defined(__AVX2__)
+  return true;
+#elif defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  static const auto result = __builtin_cpu_supports("avx2") != 0;
+  return result;
+#else
+  return false;
+#endif
+}
+
+} // namespace tenzir::detail
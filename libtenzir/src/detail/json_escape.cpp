@@ -0,0 +1,128 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/detail/json_escape.hpp"
+
+#include "tenzir/detail/cpu_features.hpp"
+#include "tenzir/detail/escapers.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define TENZIR_JSON_ESCAPE_X86 1
+#  include <immintrin.h>
+#endif
+
+namespace tenzir::detail {
+
+namespace {
+
+/// Matches the characters that `json_escaper` escapes. `std::iscntrl` also
+/// considers DEL a control character.
+constexpr auto needs_escape = [] {
+  auto result = std::array<bool, 256>{};
+  for (auto c = 0; c < 0x20; ++c) {
+    result[c] = true;
+  }
+  result['"'] = true;
+  result['\\'] = true;
+  result[0x7F] = true;
+  return result;
+}();
+
+auto scalar_find(std::string_view text, size_t pos) -> size_t {
+  for (; pos < text.size(); ++pos) {
+    if (needs_escape[static_cast<unsigned char>(text[pos])]) {
+      return pos;
+    }
+  }
+  return text.npos;
+}
+
+#ifdef TENZIR_JSON_ESCAPE_X86
+
+auto find_sse2(std::string_view text, size_t pos) -> size_t {
+  const auto control = _mm_set1_epi8(0x1F);
+  const auto quote = _mm_set1_epi8('"');
+  const auto backslash = _mm_set1_epi8('\\');
+  const auto del = _mm_set1_epi8(0x7F);
+  for (; pos + 16 <= text.size(); pos += 16) {
+    const auto bytes
+      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+    // Saturating subtraction leaves exactly the bytes up to 0x1F at zero.
+    auto matches
+      = _mm_cmpeq_epi8(_mm_subs_epu8(bytes, control), _mm_setzero_si128());
+    matches = _mm_or_si128(matches, _mm_cmpeq_epi8(bytes, quote));
+    matches = _mm_or_si128(matches, _mm_cmpeq_epi8(bytes, backslash));
+    matches = _mm_or_si128(matches, _mm_cmpeq_epi8(bytes, del));
+    if (const auto bits = static_cast<uint32_t>(_mm_movemask_epi8(matches))) {
+      return pos + std::countr_zero(bits);
+    }
+  }
+  return scalar_find(text, pos);
+}
+
+__attribute__((target("avx2"))) auto find_avx2(std::string_view text,
+                                               size_t pos) -> size_t {
+  const auto control = _mm256_set1_epi8(0x1F);
+  const auto quote = _mm256_set1_epi8('"');
+  const auto backslash = _mm256_set1_epi8('\\');
+  const auto del = _mm256_set1_epi8(0x7F);
+  for (; pos + 32 <= text.size(); pos += 32) {
+    const auto bytes = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(text.data() + pos));
+    auto matches = _mm256_cmpeq_epi8(_mm256_subs_epu8(bytes, control),
+                                     _mm256_setzero_si256());
+    matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(bytes, quote));
+    matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(bytes, backslash));
+    matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(bytes, del));
+    if (const auto bits
+        = static_cast<uint32_t>(_mm256_movemask_epi8(matches))) {
+      return pos + std::countr_zero(bits);
+    }
+  }
+  return find_sse2(text, pos);
+}
+
+#endif
+
+} // namespace
+
+auto find_json_escape(std::string_view text, size_t pos) -> size_t {
+#ifdef TENZIR_JSON_ESCAPE_X86
+  if (has_avx2()) {
+    return find_avx2(text, pos);
+  }
+  return find_sse2(text, pos);
+#else
+  return scalar_find(text, pos);
+#endif
+}
+
+auto append_json_string(std::string_view text, std::vector<char>& out)
+  -> void {
+  out.push_back('"');
+  auto pos = size_t{0};
+  while (true) {
+    const auto next = find_json_escape(text, pos);
+    const auto end = next == text.npos ? text.size() : next;
+    out.insert(out.end(), text.begin() + pos, text.begin() + end);
+    if (next == text.npos) {
+      break;
+    }
+    auto f = text.begin() + next;
+    json_escaper(f, std::back_inserter(out));
+    pos = next + 1;
+  }
+  out.push_back('"');
+}
+
+} // namespace tenzir::detail
@@ -0,0 +1,256 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/detail/lpm_table.hpp"
+
+#include "tenzir/detail/assert.hpp"
+#include "tenzir/detail/narrow.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <tuple>
+
+namespace tenzir::detail {
+
+namespace {
+
+constexpr auto bucket_bits = 16;
+constexpr auto num_buckets = size_t{1} << bucket_bits;
+
+/// The number of lookups that a batch interleaves.
+constexpr auto batch_size = size_t{32};
+
+template <class Key>
+struct prefix {
+  Key first;
+  Key last;
+  /// The length in the 128-bit address space, which orders nested prefixes.
+  uint8_t length;
+  uint32_t label;
+};
+
+/// Splits an address in network byte order into its address family and its
+/// key within that family.
+struct address_key {
+  bool is_v4;
+  uint32_t v4;
+  __uint128_t v6;
+};
+
+auto to_key(const std::byte* bytes) -> address_key {
+  auto result = address_key{};
+  result.is_v4 = std::memcmp(bytes, ip::v4_mapped_prefix.data(),
+                             ip::v4_mapped_prefix.size())
+                 == 0;
+  if (result.is_v4) {
+    for (auto i = 12; i < 16; ++i) {
+      result.v4 = (result.v4 << 8) | std::to_integer<uint32_t>(bytes[i]);
+    }
+    return result;
+  }
+  for (auto i = 0; i < 16; ++i) {
+    result.v6 = (result.v6 << 8) | std::to_integer<uint8_t>(bytes[i]);
+  }
+  return result;
+}
+
+template <class Key>
+auto host_mask(int host_bits) -> Key {
+  constexpr auto bits = static_cast<int>(sizeof(Key) * 8);
+  if (host_bits <= 0) {
+    return Key{0};
+  }
+  if (host_bits >= bits) {
+    return ~Key{0};
+  }
+  return (Key{1} << host_bits) - 1;
+}
+
+/// Flattens nested prefixes into disjoint ranges, each labeled with the
+/// innermost prefix that contains it.
+template <class Key>
+auto build(std::vector<prefix<Key>> prefixes) -> lpm_ranges<Key> {
+  constexpr auto bits = static_cast<int>(sizeof(Key) * 8);
+  constexpr auto max = ~Key{0};
+  // Outer prefixes come before the prefixes that they contain.
+  std::ranges::sort(prefixes, {}, [](const prefix<Key>& x) {
+    return std::tuple{x.first, x.length};
+  });
+  auto result = lpm_ranges<Key>{};
+  auto emit = [&](Key start, uint32_t label) {
+    // Neighboring ranges with the same label collapse into one.
+    if (not result.labels.empty() and result.labels.back() == label) {
+      return;
+    }
+    result.starts.push_back(start);
+    result.labels.push_back(label);
+  };
+  // We sweep over the address space and keep a stack of the prefixes that
+  // contain the current position. `next` is the first address that we have
+  // not yet assigned to a range.
+  auto stack = std::vector<const prefix<Key>*>{};
+  auto next = Key{0};
+  auto exhausted = false;
+  auto close = [&] {
+    const auto* top = stack.back();
+    stack.pop_back();
+    if (exhausted or next > top->last) {
+      return;
+    }
+    emit(next, top->label);
+    if (top->last == max) {
+      exhausted = true;
+    } else {
+      next = top->last + 1;
+    }
+  };
+  for (const auto& x : prefixes) {
+    while (not stack.empty() and stack.back()->last < x.first) {
+      close();
+    }
+    if (next < x.first) {
+      emit(next, stack.empty() ? lpm_table::none : stack.back()->label);
+      next = x.first;
+    }
+    stack.push_back(&x);
+  }
+  while (not stack.empty()) {
+    close();
+  }
+  if (not exhausted) {
+    emit(next, lpm_table::none);
+  }
+  TENZIR_ASSERT(not result.starts.empty() and result.starts.front() == 0);
+  result.starts.shrink_to_fit();
+  result.labels.shrink_to_fit();
+  result.buckets.resize(num_buckets + 1);
+  auto range = size_t{0};
+  for (auto bucket = size_t{0}; bucket < num_buckets; ++bucket) {
+    const auto first = static_cast<Key>(bucket) << (bits - bucket_bits);
+    while (range + 1 < result.starts.size()
+           and result.starts[range + 1] <= first) {
+      ++range;
+    }
+    result.buckets[bucket] = narrow_cast<uint32_t>(range);
+  }
+  result.buckets[num_buckets]
+    = narrow_cast<uint32_t>(result.starts.size() - 1);
+  return result;
+}
+
+template <class Key>
+auto bucket_of(Key key) -> size_t {
+  constexpr auto bits = static_cast<int>(sizeof(Key) * 8);
+  return static_cast<size_t>(key >> (bits - bucket_bits));
+}
+
+/// Finds the range of a key between the bounds of its bucket.
+template <class Key>
+auto find_label(const lpm_ranges<Key>& ranges, Key key, uint32_t lower,
+                uint32_t upper) -> uint32_t {
+  const auto begin = ranges.starts.begin();
+  const auto it = std::upper_bound(begin + lower + 1, begin + upper + 1, key);
+  return ranges.labels[(it - begin) - 1];
+}
+
+template <class Key>
+auto match_key(const lpm_ranges<Key>& ranges, Key key) -> uint32_t {
+  if (ranges.starts.empty()) {
+    return lpm_table::none;
+  }
+  const auto bucket = bucket_of(key);
+  return find_label(ranges, key, ranges.buckets[bucket],
+                    ranges.buckets[bucket + 1]);
+}
+
+template <class Key>
+auto ranges_memory_usage(const lpm_ranges<Key>& ranges) -> size_t {
+  return ranges.starts.capacity() * sizeof(Key)
+         + ranges.labels.capacity() * sizeof(uint32_t)
+         + ranges.buckets.capacity() * sizeof(uint32_t);
+}
+
+} // namespace
+
+lpm_table::lpm_table(std::span<const std::pair<subnet, uint32_t>> prefixes)
+  : size_{prefixes.size()} {
+  auto v4 = std::vector<prefix<uint32_t>>{};
+  auto v6 = std::vector<prefix<__uint128_t>>{};
+  for (const auto& [sn, label] : prefixes) {
+    TENZIR_ASSERT(label != none);
+    const auto key = to_key(as_bytes(sn.network()).data());
+    const auto length = sn.length();
+    if (key.is_v4 and length >= 96) {
+      const auto mask = host_mask<uint32_t>(128 - length);
+      v4.push_back({key.v4 & ~mask, key.v4 | mask, length, label});
+      continue;
+    }
+    const auto mask = host_mask<__uint128_t>(128 - length);
+    const auto first = key.v6 & ~mask;
+    v6.push_back({first, first | mask, length, label});
+    // A short prefix may contain the entire range of IPv4-mapped addresses,
+    // which only exists in the IPv4 table.
+    const auto v4_mapped = __uint128_t{0xFFFF} << 32;
+    if (length <= 96 and (v4_mapped & ~mask) == first) {
+      v4.push_back({0, ~uint32_t{0}, length, label});
+    }
+  }
+  if (not v4.empty()) {
+    v4_ = build(std::move(v4));
+  }
+  if (not v6.empty()) {
+    v6_ = build(std::move(v6));
+  }
+}
+
+auto lpm_table::match(const ip& addr) const -> uint32_t {
+  const auto key = to_key(as_bytes(addr).data());
+  return key.is_v4 ? match_key(v4_, key.v4) : match_key(v6_, key.v6);
+}
+
+auto lpm_table::match(std::span<const std::byte> addrs,
+                      std::span<uint32_t> result) const -> void {
+  TENZIR_ASSERT(addrs.size() == result.size() * 16);
+  // We first resolve the buckets of a whole batch and only then search the
+  // ranges, so that the CPU can overlap the cache misses of independent
+  // lookups instead of waiting for each one in turn.
+  auto keys = std::array<address_key, batch_size>{};
+  auto lower = std::array<uint32_t, batch_size>{};
+  auto upper = std::array<uint32_t, batch_size>{};
+  for (auto offset = size_t{0}; offset < result.size(); offset += batch_size) {
+    const auto n = std::min(batch_size, result.size() - offset);
+    for (auto i = size_t{0}; i < n; ++i) {
+      keys[i] = to_key(addrs.data() + (offset + i) * 16);
+      if (keys[i].is_v4 ? v4_.starts.empty() : v6_.starts.empty()) {
+        lower[i] = none;
+        continue;
+      }
+      const auto& buckets = keys[i].is_v4 ? v4_.buckets : v6_.buckets;
+      const auto bucket
+        = keys[i].is_v4 ? bucket_of(keys[i].v4) : bucket_of(keys[i].v6);
+      lower[i] = buckets[bucket];
+      upper[i] = buckets[bucket + 1];
+    }
+    for (auto i = size_t{0}; i < n; ++i) {
+      if (lower[i] == none) {
+        result[offset + i] = none;
+      } else if (keys[i].is_v4) {
+        result[offset + i] = find_label(v4_, keys[i].v4, lower[i], upper[i]);
+      } else {
+        result[offset + i] = find_label(v6_, keys[i].v6, lower[i], upper[i]);
+      }
+    }
+  }
+}
+
+auto lpm_table::memory_usage() const -> size_t {
+  return ranges_memory_usage(v4_) + ranges_memory_usage(v6_);
+}
+
+} // namespace tenzir::detail
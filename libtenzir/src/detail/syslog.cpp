@@ -0,0 +1,484 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/detail/syslog.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+namespace tenzir::plugins::syslog {
+
+namespace {
+
+// The hand-written parsers below mirror the parser combinators in
+// `syslog.hpp`. Whenever the input deviates from the common shape of a
+// message, they give up and let the caller fall back to the combinators, so
+// that they never need to backtrack.
+
+/// Equivalent to `parsers::printable`, which only rejects control characters.
+auto is_printable(char c) -> bool {
+  const auto byte = static_cast<unsigned char>(c);
+  return byte >= 0x20 and byte != 0x7f;
+}
+
+auto is_digit(char c) -> bool {
+  return c >= '0' and c <= '9';
+}
+
+/// Equivalent to `parsers::space`.
+auto is_space(char c) -> bool {
+  return c == ' ' or (c >= '\t' and c <= '\r');
+}
+
+/// Equivalent to `parsers::alnum`.
+auto is_alnum(char c) -> bool {
+  return is_digit(c) or (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z');
+}
+
+auto skip_spaces(const char*& f, const char* l) -> void {
+  while (f != l and is_space(*f)) {
+    ++f;
+  }
+}
+
+/// Parses between `min_digits` and `max_digits` decimal digits, just like
+/// `integral_parser` does for unsigned integers.
+template <class T>
+auto parse_digits(const char*& f, const char* l, int min_digits,
+                  int max_digits, T& x) -> bool {
+  auto result = T{0};
+  auto digits = 0;
+  for (; f != l and digits < max_digits and is_digit(*f); ++f, ++digits) {
+    result = static_cast<T>(result * 10 + (*f - '0'));
+  }
+  if (digits < min_digits) {
+    return false;
+  }
+  x = result;
+  return true;
+}
+
+/// Parses exactly two digits at `f` into a value no larger than `max`.
+auto parse_two_digits(const char* f, const char* l, int max, int& x) -> bool {
+  if (l - f < 2 or not is_digit(f[0]) or not is_digit(f[1])) {
+    return false;
+  }
+  const auto result = (f[0] - '0') * 10 + (f[1] - '0');
+  if (result > max) {
+    return false;
+  }
+  x = result;
+  return true;
+}
+
+/// Parses an RFC 3339 timestamp like `2003-10-11T22:14:15.003Z` the same way
+/// as `parsers::ymdhms`, but rejects all other formats that it understands.
+auto parse_rfc3339(const char*& f, const char* l, time& x) -> bool {
+  // YYYY-MM-DDThh:mm:ss
+  constexpr auto min_length = 19;
+  if (l - f < min_length) {
+    return false;
+  }
+  auto yrs = 0;
+  auto mons = 0;
+  auto dys = 0;
+  auto hrs = 0;
+  auto mins = 0;
+  auto secs = 0.0;
+  auto it = f;
+  if (not parse_digits(it, l, 4, 4, yrs) or yrs < 1900 or *it != '-'
+      or not parse_two_digits(f + 5, l, 12, mons) or mons < 1 or f[7] != '-'
+      or not parse_two_digits(f + 8, l, 31, dys) or dys < 1 or f[10] != 'T'
+      or not parse_two_digits(f + 11, l, 23, hrs) or f[13] != ':'
+      or not parse_two_digits(f + 14, l, 59, mins) or f[16] != ':'
+      or not is_digit(f[17])) {
+    return false;
+  }
+  it = f + 17;
+  if (not parsers::real_detect_sep(it, l, secs) or secs < 0.0
+      or secs > 60.0) {
+    return false;
+  }
+  auto zsign = 1;
+  auto zhrs = 0;
+  auto zmins = 0;
+  if (it != l) {
+    if (*it == 'Z') {
+      ++it;
+    } else if (*it == '+' or *it == '-') {
+      zsign = *it == '+' ? 1 : -1;
+      if (not parse_two_digits(it + 1, l, 23, zhrs)) {
+        return false;
+      }
+      it += 3;
+      if (it != l and *it == ':' and parse_two_digits(it + 1, l, 59, zmins)) {
+        it += 3;
+      } else if (parse_two_digits(it, l, 59, zmins)) {
+        it += 2;
+      } else if (it != l and *it != ' ') {
+        return false;
+      }
+    } else if (*it == ' ') {
+      // A zone name may follow the seconds after a space, e.g., `UTC`.
+      auto rest = std::string_view{it + 1, l};
+      if (rest.starts_with("GMT") or rest.starts_with("UT")) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  // Compose the time exactly like `ymdhms_parser` to get identical results.
+  using namespace std::chrono;
+  auto ymd = parsers::ymdhms.to_days(yrs, mons, dys);
+  auto zone_offset = (hours{zhrs} + minutes{zmins}) * zsign;
+  auto delta = hours{hrs} + minutes{mins} - zone_offset + double_seconds{secs};
+  x = time{ymd} + duration_cast<tenzir::duration>(delta);
+  f = it;
+  return true;
+}
+
+/// Checks for the `-` that represents a null value, which must be followed by
+/// a space.
+auto parse_nil(const char*& f, const char* l) -> bool {
+  if (l - f >= 2 and f[0] == '-' and f[1] == ' ') {
+    ++f;
+    return true;
+  }
+  return false;
+}
+
+/// Parses the TIMESTAMP field of the header.
+auto parse_timestamp(const char*& f, const char* l, std::optional<time>& x)
+  -> bool {
+  if (parse_nil(f, l)) {
+    x = std::nullopt;
+    return true;
+  }
+  auto result = time{};
+  if (not parse_rfc3339(f, l, result) and not parsers::time(f, l, result)) {
+    return false;
+  }
+  x = result;
+  return true;
+}
+
+/// Parses the HOSTNAME, APP-NAME, PROCID, and MSGID fields of the header.
+auto parse_header_field(const char*& f, const char* l, size_t max_length,
+                        std::optional<std::string>& x) -> bool {
+  if (parse_nil(f, l)) {
+    x = std::nullopt;
+    return true;
+  }
+  const auto* begin = f;
+  while (f != l and *f != ' ' and is_printable(*f)
+         and static_cast<size_t>(f - begin) < max_length) {
+    ++f;
+  }
+  if (f == begin) {
+    return false;
+  }
+  x.emplace(begin, f);
+  return true;
+}
+
+auto parse_space(const char*& f, const char* l) -> bool {
+  if (f == l or *f != ' ') {
+    return false;
+  }
+  ++f;
+  return true;
+}
+
+/// Parses an SD-ID or PARAM-NAME.
+auto parse_sd_name(const char*& f, const char* l, std::string& x) -> bool {
+  const auto* begin = f;
+  while (f != l and is_printable(*f) and *f != ' ' and *f != '='
+         and *f != ']' and *f != '"') {
+    ++f;
+  }
+  if (f == begin) {
+    return false;
+  }
+  x.assign(begin, f);
+  return true;
+}
+
+/// Returns whether the quote before `f` ends a quoted PARAM-VALUE. Like
+/// `parameter_parser`, we permit unescaped quotes within values otherwise.
+auto ends_quoted_value(const char* f, const char* l) -> bool {
+  if (f == l) {
+    return false;
+  }
+  if (*f == ' ') {
+    return true;
+  }
+  if (*f != ']') {
+    return false;
+  }
+  ++f;
+  return f == l or *f == ' ' or *f == '\n' or *f == '[';
+}
+
+/// Parses a PARAM-VALUE, with or without quotes.
+auto parse_param_value(const char*& f, const char* l, std::string& x) -> bool {
+  if (f == l) {
+    return false;
+  }
+  if (*f != '"') {
+    const auto* begin = f;
+    while (f != l and is_printable(*f) and *f != ' ' and *f != ';'
+           and *f != ']') {
+      ++f;
+    }
+    if (f == begin) {
+      return false;
+    }
+    x.assign(begin, f);
+    return true;
+  }
+  ++f;
+  while (f != l) {
+    // Copy the value in runs of bytes that need no special treatment.
+    const auto* begin = f;
+    while (f != l and *f != '"' and *f != '\\' and is_printable(*f)) {
+      ++f;
+    }
+    x.append(begin, f);
+    if (f == l or not is_printable(*f)) {
+      return false;
+    }
+    if (*f == '\\') {
+      if (l - f >= 2 and (f[1] == ']' or f[1] == '\\' or f[1] == '"')) {
+        x += f[1];
+        f += 2;
+      } else {
+        x += '\\';
+        ++f;
+      }
+      continue;
+    }
+    ++f;
+    if (ends_quoted_value(f, l)) {
+      return true;
+    }
+    x += '"';
+  }
+  return false;
+}
+
+/// Parses an SD-ELEMENT with at least one parameter.
+auto parse_sd_element(const char*& f, const char* l, structured_data_element& x)
+  -> bool {
+  if (f == l or *f != '[') {
+    return false;
+  }
+  ++f;
+  if (not parse_sd_name(f, l, x.id)) {
+    return false;
+  }
+  while (f != l and *f == ' ') {
+    ++f;
+    auto& param = x.params.emplace_back();
+    if (not parse_sd_name(f, l, param.first) or f == l or *f != '=') {
+      return false;
+    }
+    ++f;
+    if (not parse_param_value(f, l, param.second)) {
+      return false;
+    }
+  }
+  if (x.params.empty() or f == l or *f != ']') {
+    return false;
+  }
+  ++f;
+  return true;
+}
+
+/// Parses the STRUCTURED-DATA of a message.
+auto parse_structured_data(const char*& f, const char* l,
+                           std::vector<structured_data_element>& x) -> bool {
+  if (parse_nil(f, l)) {
+    return true;
+  }
+  do {
+    if (not parse_sd_element(f, l, x.emplace_back())) {
+      return false;
+    }
+  } while (f != l and *f == '[');
+  return true;
+}
+
+/// Parses an RFC 3164 timestamp like `Oct 11 22:14:15`. Like
+/// `legacy_message_timestamp_parser`, the result keeps the original spacing.
+/// Timestamps with a year need the parser combinators.
+auto parse_rfc3164_timestamp(const char*& f, const char* l, std::string& x)
+  -> bool {
+  constexpr auto months = std::array<std::string_view, 12>{
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec",
+  };
+  const auto* begin = f;
+  if (l - f < 4 or not std::ranges::contains(months, std::string_view{f, 3})
+      or not is_space(f[3])) {
+    return false;
+  }
+  f += 3;
+  skip_spaces(f, l);
+  auto day = 0;
+  if (not parse_digits(f, l, 1, 2, day) or day > 31 or f == l
+      or not is_space(*f)) {
+    return false;
+  }
+  skip_spaces(f, l);
+  // hh:mm:ss
+  auto hrs = 0;
+  auto mins = 0;
+  auto secs = 0;
+  if (l - f < 8 or not parse_two_digits(f, l, 23, hrs) or f[2] != ':'
+      or not parse_two_digits(f + 3, l, 59, mins) or f[5] != ':'
+      or not parse_two_digits(f + 6, l, 59, secs)) {
+    return false;
+  }
+  f += 8;
+  x.assign(begin, f);
+  return true;
+}
+
+} // namespace
+
+auto parse_rfc5424_message(std::string_view input, message& x)
+  -> rfc5424_parse_result {
+  const auto* f = input.data();
+  const auto* const l = f + input.size();
+  auto result = message{};
+  auto& hdr = result.hdr;
+  // Detect the dialect from the PRI and VERSION fields. A message that does
+  // not start with them is not an RFC 5424 message.
+  auto prival = uint16_t{0};
+  if (f == l or *f != '<') {
+    return rfc5424_parse_result::rejected;
+  }
+  ++f;
+  if (not parse_digits(f, l, 1, 3, prival) or prival > 191 or f == l
+      or *f != '>') {
+    return rfc5424_parse_result::rejected;
+  }
+  ++f;
+  if (not parse_digits(f, l, 1, 3, hdr.version) or hdr.version == 0
+      or not parse_space(f, l)) {
+    return rfc5424_parse_result::rejected;
+  }
+  hdr.facility = prival / 8;
+  hdr.severity = prival % 8;
+  // The rest of the header, with the same limits as in `header_parser`.
+  if (not parse_timestamp(f, l, hdr.ts) or not parse_space(f, l)
+      or not parse_header_field(f, l, 255, hdr.hostname)
+      or not parse_space(f, l)
+      or not parse_header_field(f, l, 48, hdr.app_name)
+      or not parse_space(f, l)
+      or not parse_header_field(f, l, 128, hdr.process_id)
+      or not parse_space(f, l) or not parse_header_field(f, l, 32, hdr.msg_id)
+      or not parse_space(f, l)
+      or not parse_structured_data(f, l, result.data)) {
+    return rfc5424_parse_result::fallback;
+  }
+  if (f != l) {
+    if (*f != ' ') {
+      return rfc5424_parse_result::fallback;
+    }
+    ++f;
+    // Strip a leading byte order mark, but reject a message that consists of
+    // nothing else, like `message_content_parser` does.
+    auto content = std::string_view{f, l};
+    if (not content.empty()) {
+      constexpr auto bom = std::string_view{"\xEF\xBB\xBF"};
+      if (content.starts_with(bom)) {
+        content.remove_prefix(bom.size());
+        if (content.empty()) {
+          return rfc5424_parse_result::fallback;
+        }
+      }
+    }
+    result.msg.emplace(content);
+  }
+  x = std::move(result);
+  return rfc5424_parse_result::parsed;
+}
+
+auto parse_rfc3164_message(std::string_view input, legacy_message& x) -> bool {
+  const auto* f = input.data();
+  const auto* const l = f + input.size();
+  auto result = legacy_message{};
+  if (f != l and *f == '<') {
+    ++f;
+    auto prival = uint16_t{0};
+    if (not parse_digits(f, l, 1, 3, prival) or prival > 191 or f == l
+        or *f != '>') {
+      return false;
+    }
+    ++f;
+    result.facility = prival / 8;
+    result.severity = prival % 8;
+    skip_spaces(f, l);
+  }
+  // The timestamp and the hostname must each be followed by whitespace.
+  if (not parse_rfc3164_timestamp(f, l, result.timestamp) or f == l
+      or not is_space(*f)) {
+    return false;
+  }
+  skip_spaces(f, l);
+  const auto* host = f;
+  while (f != l and is_printable(*f) and not is_space(*f) and *f != ':') {
+    ++f;
+  }
+  if (f == host or f == l or not is_space(*f)) {
+    return false;
+  }
+  result.host.emplace(host, f);
+  skip_spaces(f, l);
+  // The TAG and PID are optional. Without the colon that ends them, the
+  // content starts right after the hostname.
+  const auto* it = f;
+  while (it != l
+         and (is_alnum(*it) or *it == '-' or *it == '_' or *it == '.')) {
+    ++it;
+  }
+  const auto* const tag_end = it;
+  auto process_id = std::optional<std::string>{};
+  auto tagged = true;
+  if (it != l and *it == '[') {
+    const auto* pid = ++it;
+    while (it != l and *it != ']' and is_printable(*it)) {
+      ++it;
+    }
+    if (it == pid or it == l or *it != ']') {
+      tagged = false;
+    } else {
+      process_id.emplace(pid, it);
+      ++it;
+    }
+  }
+  if (tagged and it != l and *it == ':' and (it + 1 == l or is_space(it[1]))) {
+    if (tag_end != f) {
+      result.tag.emplace(f, tag_end);
+    }
+    result.process_id = std::move(process_id);
+    f = it + 1;
+    skip_spaces(f, l);
+  }
+  if (f != l and *f == '[') {
+    return false;
+  }
+  result.content.assign(f, l);
+  x = std::move(result);
+  return true;
+}
+
+} // namespace tenzir::plugins::syslog
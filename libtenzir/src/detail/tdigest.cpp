@@ -352,6 +352,32 @@ public:
     return lerp(td[ci_left].mean, td[ci_right].mean, diff);
   }
 
+  auto save() const -> tdigest::state {
+    const auto& td = tdigests_[current_];
+    auto result = tdigest::state{};
+    result.means.reserve(td.size());
+    result.weights.reserve(td.size());
+    for (const auto& c : td) {
+      result.means.push_back(c.mean);
+      result.weights.push_back(c.weight);
+    }
+    result.min = min_;
+    result.max = max_;
+    return result;
+  }
+
+  auto load(const tdigest::state& x) -> void {
+    TENZIR_ASSERT(x.means.size() == x.weights.size());
+    reset();
+    auto& td = tdigests_[current_];
+    for (size_t i = 0; i < x.means.size(); ++i) {
+      td.push_back(centroid{x.means[i], x.weights[i]});
+      total_weight_ += x.weights[i];
+    }
+    min_ = x.min;
+    max_ = x.max;
+  }
+
   auto mean() const -> double {
     auto sum = 0.0;
     for (const auto& c : tdigests_[current_]) {
@@ -402,6 +428,16 @@ auto tdigest::dump() const -> void {
   impl_->dump();
 }
 
+auto tdigest::save() const -> state {
+  merge_input();
+  return impl_->save();
+}
+
+auto tdigest::load(const state& x) -> void {
+  input_.resize(0);
+  impl_->load(x);
+}
+
 auto tdigest::merge(const std::vector<tdigest>& others) -> void {
   merge_input();
   auto other_impls = std::vector<const tdigest_impl*>{};
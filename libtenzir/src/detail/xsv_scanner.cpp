@@ -0,0 +1,244 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/detail/xsv_scanner.hpp"
+
+#include "tenzir/detail/cpu_features.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define TENZIR_XSV_SCANNER_X86 1
+#  include <immintrin.h>
+#endif
+
+namespace tenzir::detail {
+
+namespace {
+
+#ifdef TENZIR_XSV_SCANNER_X86
+
+auto mask_sse2(const char* block, const char* needles, size_t num_needles)
+  -> uint64_t {
+  auto result = uint64_t{0};
+  for (auto offset = size_t{0}; offset < byte_set::block_size; offset += 16) {
+    const auto bytes = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(block + offset));
+    auto matches = _mm_setzero_si128();
+    for (auto i = size_t{0}; i < num_needles; ++i) {
+      matches = _mm_or_si128(
+        matches, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(needles[i])));
+    }
+    const auto bits = static_cast<uint32_t>(_mm_movemask_epi8(matches));
+    result |= uint64_t{bits} << offset;
+  }
+  return result;
+}
+
+__attribute__((target("avx2"))) auto
+mask_avx2(const char* block, const char* needles, size_t num_needles)
+  -> uint64_t {
+  auto result = uint64_t{0};
+  for (auto offset = size_t{0}; offset < byte_set::block_size; offset += 32) {
+    const auto bytes = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(block + offset));
+    auto matches = _mm256_setzero_si256();
+    for (auto i = size_t{0}; i < num_needles; ++i) {
+      matches = _mm256_or_si256(
+        matches, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(needles[i])));
+    }
+    const auto bits = static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+    result |= uint64_t{bits} << offset;
+  }
+  return result;
+}
+
+#endif
+
+} // namespace
+
+byte_set::byte_set(std::string_view bytes) {
+  for (auto c : bytes) {
+    if (contains(c)) {
+      continue;
+    }
+    table_[static_cast<unsigned char>(c)] = true;
+    if (num_needles_ < max_vectorized) {
+      needles_[num_needles_] = c;
+    }
+    ++num_needles_;
+  }
+}
+
+auto byte_set::mask(const char* block) const -> uint64_t {
+#ifdef TENZIR_XSV_SCANNER_X86
+  if (num_needles_ <= max_vectorized) {
+    if (has_avx2()) {
+      return mask_avx2(block, needles_.data(), num_needles_);
+    }
+    return mask_sse2(block, needles_.data(), num_needles_);
+  }
+#endif
+  auto result = uint64_t{0};
+  for (auto i = size_t{0}; i < block_size; ++i) {
+    result |= uint64_t{contains(block[i])} << i;
+  }
+  return result;
+}
+
+auto byte_set::find(std::string_view text, size_t start) const -> size_t {
+  auto pos = start;
+  for (; pos + block_size <= text.size(); pos += block_size) {
+    if (auto bits = mask(text.data() + pos)) {
+      return pos + std::countr_zero(bits);
+    }
+  }
+  for (; pos < text.size(); ++pos) {
+    if (contains(text[pos])) {
+      return pos;
+    }
+  }
+  return text.npos;
+}
+
+namespace {
+
+/// Iterates over the positions of the bytes of a `byte_set` in a text,
+/// classifying one block at a time.
+class structural_cursor {
+public:
+  structural_cursor(const byte_set& set, std::string_view text)
+    : set_{set}, text_{text} {
+  }
+
+  /// Returns the first position at or after `pos` with a byte of the set, or
+  /// `npos` if there is none.
+  auto next(size_t pos) -> size_t {
+    while (pos < text_.size()) {
+      const auto block = pos / byte_set::block_size;
+      if (block != block_) {
+        load(block);
+      }
+      const auto bits = mask_ & (~uint64_t{0} << (pos % byte_set::block_size));
+      if (bits != 0) {
+        return block * byte_set::block_size + std::countr_zero(bits);
+      }
+      pos = (block + 1) * byte_set::block_size;
+    }
+    return text_.npos;
+  }
+
+private:
+  auto load(size_t block) -> void {
+    block_ = block;
+    const auto offset = block * byte_set::block_size;
+    const auto remaining = text_.size() - offset;
+    if (remaining >= byte_set::block_size) {
+      mask_ = set_.mask(text_.data() + offset);
+      return;
+    }
+    // Copy the tail of the text into a padded buffer rather than reading past
+    // its end, and discard the bits of the padding.
+    auto padded = std::array<char, byte_set::block_size>{};
+    std::memcpy(padded.data(), text_.data() + offset, remaining);
+    mask_ = set_.mask(padded.data()) & ((uint64_t{1} << remaining) - 1);
+  }
+
+  const byte_set& set_;
+  std::string_view text_;
+  size_t block_ = std::string_view::npos;
+  uint64_t mask_ = 0;
+};
+
+} // namespace
+
+xsv_scanner::xsv_scanner(quoting_escaping_policy quoting, std::string separator)
+  : quoting_{std::move(quoting)},
+    separator_{std::move(separator)},
+    structural_{separator_.substr(0, 1) + quoting_.quotes + '\\'} {
+  vectorized_ = not separator_.empty()
+                and std::ranges::none_of(separator_, [&](char c) {
+                      return c == '\\' or quoting_.is_quote_character(c);
+                    });
+}
+
+auto xsv_scanner::split(std::string_view line,
+                        std::vector<xsv_field>& result) const -> void {
+  auto start = size_t{0};
+  // Falls back to the quoting policy for the field at `start`.
+  auto split_slow = [&] {
+    auto rest = line.substr(start);
+    if (auto split = quoting_.split_at_unquoted(rest, separator_)) {
+      result.push_back({split->first, std::nullopt});
+      start = line.size() - split->second.size();
+      return true;
+    }
+    result.push_back({rest, std::nullopt});
+    return false;
+  };
+  if (not vectorized_) {
+    while (split_slow()) {
+    }
+    return;
+  }
+  auto cursor = structural_cursor{structural_, line};
+  const auto is_separator = [&](size_t pos) {
+    return line.substr(pos, separator_.size()) == separator_;
+  };
+  while (true) {
+    auto pos = cursor.next(start);
+    // Skip partial matches of a multi-byte separator.
+    while (pos != line.npos and line[pos] == separator_[0]
+           and not is_separator(pos)) {
+      pos = cursor.next(pos + 1);
+    }
+    // A field without quotes and backslashes ends at the next separator.
+    if (pos == line.npos) {
+      const auto text = line.substr(start);
+      result.push_back({text, text});
+      return;
+    }
+    if (line[pos] == separator_[0]) {
+      const auto text = line.substr(start, pos - start);
+      result.push_back({text, text});
+      start = pos + separator_.size();
+      continue;
+    }
+    // A field that is quoted as a whole ends at its closing quote if that is
+    // followed by a separator or the end of the line, unless there is a
+    // backslash in between.
+    if (pos == start and quoting_.is_quote_character(line[pos])) {
+      const auto quote = line[pos];
+      auto close = cursor.next(pos + 1);
+      while (close != line.npos and line[close] != quote
+             and line[close] != '\\') {
+        close = cursor.next(close + 1);
+      }
+      if (close != line.npos and line[close] == quote) {
+        const auto text = line.substr(start, close + 1 - start);
+        const auto value = line.substr(start + 1, close - start - 1);
+        if (close + 1 == line.size()) {
+          result.push_back({text, value});
+          return;
+        }
+        if (is_separator(close + 1)) {
+          result.push_back({text, value});
+          start = close + 1 + separator_.size();
+          continue;
+        }
+      }
+    }
+    if (not split_slow()) {
+      return;
+    }
+  }
+}
+
+} // namespace tenzir::detail
@@ -29,6 +29,7 @@
 #include "tenzir/pipeline_buffer_stats.hpp"
 #include "tenzir/secret_resolution.hpp"
 #include "tenzir/secret_store.hpp"
+#include "tenzir/shared_table_slice.hpp"
 #include "tenzir/si_literals.hpp"
 #include "tenzir/table_slice.hpp"
 
@@ -112,6 +113,21 @@ auto approx_bytes(const chunk_ptr& bytes) -> uint64_t {
   return bytes ? bytes->size() : 0;
 }
 
+/// Receives shared table slices whose file descriptor did not arrive yet.
+/// Waiting for the file descriptor blocks, so this runs detached instead of on
+/// a scheduler thread.
+auto shared_table_slice_reader() -> caf::behavior {
+  return {
+    [](shared_table_slice& events) -> caf::result<table_slice> {
+      auto result = std::move(events).take();
+      if (not result) {
+        return std::move(result.error());
+      }
+      return std::move(*result);
+    },
+  };
+}
+
 template <class Input, class Output>
 struct exec_node_state;
 
@@ -560,6 +576,9 @@ struct exec_node_state {
         auto name_guard
           = exec_node_name_guard{op_name, exec_node_name_guard::type::actor};
         if constexpr (std::is_same_v<Input, table_slice>) {
+          if (not deferred_pushes.empty()) {
+            return defer_push(std::move(events));
+          }
           return push(std::move(events));
         } else {
           return caf::make_error(
@@ -567,6 +586,18 @@ struct exec_node_state {
             fmt::format("{} does not accept events as input", *self));
         }
       },
+      [this](atom::push, shared_table_slice& events) -> caf::result<void> {
+        auto time_scheduled_guard = make_timer_guard(metrics.time_scheduled);
+        auto name_guard
+          = exec_node_name_guard{op_name, exec_node_name_guard::type::actor};
+        if constexpr (std::is_same_v<Input, table_slice>) {
+          return push_shared(events);
+        } else {
+          return caf::make_error(
+            ec::logic_error,
+            fmt::format("{} does not accept events as input", *self));
+        }
+      },
       [this](atom::push, chunk_ptr& bytes) -> caf::result<void> {
         auto time_scheduled_guard = make_timer_guard(metrics.time_scheduled);
         auto name_guard
@@ -660,6 +691,20 @@ struct exec_node_state {
   std::deque<Input> inbound_buffer = {};
   uint64_t inbound_buffer_elements = {};
 
+  /// Pushes that wait for an earlier shared table slice whose file descriptor
+  /// is still on its way, in the order in which they arrived.
+  struct deferred_push {
+    bool done = false;
+    std::optional<table_slice> events = {};
+    caf::error error = {};
+    caf::typed_response_promise<void> rp = {};
+  };
+  std::deque<std::shared_ptr<deferred_push>> deferred_pushes = {};
+
+  /// Receives shared table slices that we could not take right away. Spawned
+  /// on first use.
+  caf::actor shared_slice_reader = {};
+
   /// The currently open demand.
   struct demand {
     demand(caf::typed_response_promise<void> rp, exec_node_sink_actor sink,
@@ -725,6 +770,9 @@ struct exec_node_state {
       }
     }
     emit_generic_op_metrics();
+    if (shared_slice_reader) {
+      caf::anon_send_exit(shared_slice_reader, caf::exit_reason::user_shutdown);
+    }
     instance.reset();
     ctrl.reset();
     if (demand and demand->rp.pending()) {
@@ -971,7 +1019,24 @@ struct exec_node_state {
     // We have to remember whether this is the push that finishes the demand
     // because there can be multiple pushes in flight in parallel.
     auto finished = not has_active_demand();
-    self->mail(atom::push_v, std::move(output))
+    if constexpr (std::is_same_v<Output, table_slice>) {
+      // Execution nodes in another process on the same host, e.g., on the
+      // other side of `local` or `remote`, receive large batches through
+      // shared memory instead of the CAF socket.
+      if (demand->sink->node() != self->node()) {
+        if (auto shared = shared_table_slice::make(output, self->node(),
+                                                   demand->sink->node())) {
+          push_output(std::move(*shared), output_size, finished);
+          return;
+        }
+      }
+    }
+    push_output(std::move(output), output_size, finished);
+  }
+
+  template <class Message>
+  void push_output(Message message, uint64_t output_size, bool finished) {
+    self->mail(atom::push_v, std::move(message))
       .request(demand->sink, caf::infinite)
       .then(
         [this, output_size, finished]() {
@@ -1234,6 +1299,88 @@ struct exec_node_state {
     return {};
   }
 
+  /// Receives events through shared memory without blocking this actor. If
+  /// the file descriptor did not arrive yet, a detached reader waits for it,
+  /// and later pushes queue up behind it so that their order is preserved.
+  auto push_shared(const shared_table_slice& events) -> caf::result<void>
+    requires std::is_same_v<Input, table_slice>
+  {
+    auto slice = events.try_take();
+    if (slice and deferred_pushes.empty()) {
+      if (not *slice) {
+        return shared_error(slice->error());
+      }
+      return push(std::move(**slice));
+    }
+    auto entry = std::make_shared<deferred_push>();
+    entry->rp = self->make_response_promise<void>();
+    deferred_pushes.push_back(entry);
+    if (slice) {
+      entry->done = true;
+      if (*slice) {
+        entry->events = std::move(**slice);
+      } else {
+        entry->error = shared_error(slice->error());
+      }
+      return entry->rp;
+    }
+    if (not shared_slice_reader) {
+      shared_slice_reader
+        = self->system().spawn<caf::detached>(shared_table_slice_reader);
+    }
+    self->mail(events)
+      .request(shared_slice_reader, caf::infinite)
+      .then(
+        [this, entry](table_slice& slice) {
+          entry->done = true;
+          entry->events = std::move(slice);
+          flush_deferred_pushes();
+        },
+        [this, entry](const caf::error& err) {
+          entry->done = true;
+          entry->error = shared_error(err);
+          flush_deferred_pushes();
+        });
+    return entry->rp;
+  }
+
+  /// Queues events behind a shared table slice that is still on its way.
+  auto defer_push(table_slice events) -> caf::result<void>
+    requires std::is_same_v<Input, table_slice>
+  {
+    auto entry = std::make_shared<deferred_push>();
+    entry->done = true;
+    entry->events = std::move(events);
+    entry->rp = self->make_response_promise<void>();
+    deferred_pushes.push_back(entry);
+    return entry->rp;
+  }
+
+  /// Pushes all deferred events up to the first shared table slice that is
+  /// still on its way.
+  void flush_deferred_pushes()
+    requires std::is_same_v<Input, table_slice>
+  {
+    auto time_scheduled_guard = make_timer_guard(metrics.time_scheduled);
+    while (not deferred_pushes.empty() and deferred_pushes.front()->done) {
+      auto entry = std::move(deferred_pushes.front());
+      deferred_pushes.pop_front();
+      if (entry->error) {
+        entry->rp.deliver(std::move(entry->error));
+        continue;
+      }
+      // Pushing to the inbound buffer always succeeds.
+      std::ignore = push(std::move(*entry->events));
+      entry->rp.deliver();
+    }
+  }
+
+  auto shared_error(const caf::error& err) -> caf::error {
+    return diagnostic::error(err)
+      .note("{} failed to receive events through shared memory", *self)
+      .to_error();
+  }
+
   void on_error(caf::error error) {
     if (start_rp.pending()) {
       start_rp.deliver(std::move(error));
@@ -1309,6 +1456,11 @@ auto spawn_exec_node(caf::scheduled_actor* self, operator_ptr op,
   TENZIR_ASSERT(node != nullptr or op->location() != operator_location::remote);
   TENZIR_ASSERT(diagnostics_handler != nullptr);
   TENZIR_ASSERT(metrics_receiver != nullptr);
+  // Execution nodes that accept events may receive them through shared memory
+  // from execution nodes in other processes on this host.
+  if (input_type.is<table_slice>()) {
+    shared_table_slice::listen();
+  }
   auto output_type = op->infer_type(input_type);
   if (not output_type) {
     return caf::make_error(ec::logic_error,
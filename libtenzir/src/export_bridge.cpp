@@ -7,6 +7,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <tenzir/catalog.hpp>
+#include <tenzir/defaults.hpp>
 #include <tenzir/detail/flat_map.hpp>
 #include <tenzir/detail/weak_run_delayed.hpp>
 #include <tenzir/export_bridge.hpp>
@@ -20,14 +21,50 @@
 #include <tenzir/taxonomies.hpp>
 
 #include <caf/actor_registry.hpp>
+#include <caf/actor_system_config.hpp>
 #include <caf/event_based_actor.hpp>
+#include <caf/settings.hpp>
 
+#include <algorithm>
+#include <map>
 #include <queue>
+#include <unordered_set>
 
 namespace tenzir {
 
 namespace {
 
+/// Tags the events of a historical partition with its sequence number, so that
+/// the bridge can emit the events of partitions in order.
+auto sequencer(receiver_actor<table_slice>::pointer self,
+               export_bridge_actor bridge, uint64_t sequence)
+  -> receiver_actor<table_slice>::behavior_type {
+  return {
+    [self, bridge = std::move(bridge),
+     sequence](table_slice& slice) -> caf::result<void> {
+      return self->mail(std::move(slice), sequence).delegate(bridge);
+    },
+  };
+}
+
+/// A partition that we spawned ahead of querying it.
+struct prefetched_partition {
+  uuid id = {};
+  partition_actor actor = {};
+  query_context ctx = {};
+  /// The estimated memory usage of the partition once loaded.
+  uint64_t approx_bytes = {};
+};
+
+/// The events of a partition that runs ahead of the oldest running partition
+/// when we emit in order.
+struct held_partition {
+  std::deque<std::pair<table_slice, caf::typed_response_promise<void>>>
+    events = {};
+  bool done = false;
+  event_source source = event_source::retro;
+};
+
 struct bridge_state {
   static constexpr auto name = "export-bridge";
 
@@ -39,13 +76,26 @@ struct bridge_state {
   std::unordered_map<type, caf::expected<expression>> bound_exprs = {};
 
   export_mode mode = {};
+  size_t partition_capacity = defaults::max_partition_size;
+  /// The number of bytes that the loaded partitions and the buffered events
+  /// may use before we stop loading more partitions.
+  uint64_t memory_limit = defaults::export_memory_limit;
 
   bool checked_candidates = {};
   size_t inflight_partitions = {};
   size_t open_partitions = {};
   std::queue<std::pair<partition_info, query_context>> queued_partitions = {};
+  std::queue<prefetched_partition> prefetched_partitions = {};
+  /// The partitions that we spawned and that did not answer their query yet.
+  std::unordered_set<uuid> unanswered_partitions = {};
   std::optional<std::vector<table_slice>> unpersisted_events = {};
 
+  /// The sequence number of the next partition that we query, and of the
+  /// oldest partition whose events we did not emit completely yet.
+  uint64_t next_sequence = {};
+  uint64_t head_sequence = {};
+  std::map<uint64_t, held_partition> held_partitions = {};
+
   filesystem_actor filesystem = {};
 
   struct metric {
@@ -55,6 +105,10 @@ struct bridge_state {
 
   detail::flat_map<type, metric> metrics = {};
   size_t num_queued_total = {};
+  /// The approximate size of the queued events, and of the partitions that we
+  /// spawned and that did not finish their query yet.
+  uint64_t queued_bytes = {};
+  uint64_t partition_bytes = {};
   metric_handler metrics_handler = {};
 
   std::unique_ptr<diagnostic_handler> diagnostics_handler = {};
@@ -78,12 +132,40 @@ struct bridge_state {
   auto is_done() const -> bool {
     return not mode.live and buffer.empty() and inflight_partitions == 0
            and open_partitions == 0 and checked_candidates
-           and queued_partitions.empty() and not unpersisted_events;
+           and queued_partitions.empty() and prefetched_partitions.empty()
+           and unanswered_partitions.empty() and held_partitions.empty()
+           and not unpersisted_events;
+  }
+
+  /// The number of buffered events beyond which we stop opening partitions,
+  /// which corresponds to one full partition per parallel query.
+  auto buffer_budget() const -> size_t {
+    return partition_capacity * mode.parallel;
+  }
+
+  /// Whether the buffered events exhaust our budget, either by their number or
+  /// together with the loaded partitions by their memory usage.
+  auto over_budget() const -> bool {
+    return num_queued_total >= buffer_budget()
+           or queued_bytes + partition_bytes >= memory_limit;
+  }
+
+  auto count_queued(const table_slice& slice) -> void {
+    num_queued_total += slice.rows();
+    queued_bytes += slice.approx_bytes();
+  }
+
+  auto uncount_queued(const table_slice& slice) -> void {
+    num_queued_total -= slice.rows();
+    queued_bytes -= slice.approx_bytes();
   }
 
   auto try_pop_partition() -> void {
-    const auto size_threshold = defaults::max_partition_size * mode.parallel;
-    if (num_queued_total >= size_threshold) {
+    // Events that are held back for later partitions only drain once we query
+    // the partitions before them, so we must not wait for them when there is
+    // nothing else left to drain.
+    const auto stalled = buffer.empty() and inflight_partitions == 0;
+    if (over_budget() and not stalled) {
       return;
     }
     for (auto i = inflight_partitions; i < mode.parallel; ++i) {
@@ -93,8 +175,47 @@ struct bridge_state {
     }
   }
 
+  /// Spawns the next queued partitions, so that they load their partition
+  /// and store files while we query the partitions before them. Prefetched
+  /// partitions count against the memory limit, but we always load at least
+  /// one partition so that the export makes progress.
+  auto prefetch_partitions() -> void {
+    while (prefetched_partitions.size() < mode.parallel
+           and not queued_partitions.empty()) {
+      const auto approx_bytes = queued_partitions.front().first.approx_bytes;
+      const auto idle
+        = prefetched_partitions.empty() and inflight_partitions == 0;
+      if (not idle
+          and queued_bytes + partition_bytes + approx_bytes > memory_limit) {
+        return;
+      }
+      partition_bytes += approx_bytes;
+      auto [info, ctx] = std::move(queued_partitions.front());
+      queued_partitions.pop();
+      auto actor = self->spawn(
+        passive_partition, info.uuid, filesystem,
+        std::filesystem::path{fmt::format("index/{:l}", info.uuid)},
+        mode.high_priority ? caf::message_priority::high
+                           : caf::message_priority::normal);
+      // A prefetched partition may fail to load before we query it, and a
+      // failed request only tells us that the partition is gone. The monitor
+      // tells us why.
+      unanswered_partitions.insert(info.uuid);
+      self->monitor(actor, [this, uuid = info.uuid](const caf::error& reason) {
+        on_partition_down(uuid, reason);
+      });
+      prefetched_partitions.push({
+        .id = info.uuid,
+        .actor = std::move(actor),
+        .ctx = std::move(ctx),
+        .approx_bytes = approx_bytes,
+      });
+    }
+  }
+
   auto pop_partition() -> void {
-    if (queued_partitions.empty()) {
+    prefetch_partitions();
+    if (prefetched_partitions.empty()) {
       if (open_partitions > 0) {
         --open_partitions;
       }
@@ -103,36 +224,101 @@ struct bridge_state {
       }
       return;
     }
-    // Now, open one partition.
-    auto [info, ctx] = std::move(queued_partitions.front());
-    queued_partitions.pop();
+    // Now, query one partition and replace it with the next one in line.
+    auto partition = std::move(prefetched_partitions.front());
+    prefetched_partitions.pop();
     ++inflight_partitions;
-    auto next = [this] {
+    prefetch_partitions();
+    const auto sequence = next_sequence++;
+    auto next = [this, sequence, approx_bytes = partition.approx_bytes] {
       --inflight_partitions;
+      partition_bytes -= approx_bytes;
+      finish_partition(sequence);
       try_pop_partition();
     };
-    // TODO: We may want to monitor the spawned partitions to be able to return
-    // better diagnostics. As-is, we only get a caf::sec::request_receiver_down
-    // if they quit, but not their actual error message.
-    const auto partition
-      = self->spawn(passive_partition, info.uuid, filesystem,
-                    std::filesystem::path{fmt::format("index/{:l}", info.uuid)},
-                    mode.high_priority ? caf::message_priority::high
-                                       : caf::message_priority::normal);
-    self->mail(atom::query_v, std::move(ctx))
-      .request(partition, caf::infinite)
+    if (mode.ordered) {
+      partition.ctx.cmd = extract_query_context{self->spawn(
+        sequencer, caf::actor_cast<export_bridge_actor>(self), sequence)};
+    }
+    self->mail(atom::query_v, std::move(partition.ctx))
+      .request(partition.actor, caf::infinite)
       .then(
-        [next](uint64_t) {
+        [this, next, uuid = partition.id](uint64_t) {
+          unanswered_partitions.erase(uuid);
           next();
         },
-        [this, next, uuid = info.uuid](const caf::error& error) mutable {
-          diagnostic::warning(error)
-            .note("failed to open partition {}", uuid)
-            .emit(*diagnostics_handler);
+        [this, next, uuid = partition.id](const caf::error& error) mutable {
+          // We report partitions that are down once their monitor tells us
+          // their exit reason.
+          if (error != caf::sec::request_receiver_down
+              and unanswered_partitions.erase(uuid) > 0) {
+            diagnostic::warning(error)
+              .note("failed to open partition {}", uuid)
+              .emit(*diagnostics_handler);
+          }
           next();
         });
   }
 
+  /// Reports a partition that quit before answering its query.
+  auto on_partition_down(const uuid& id, const caf::error& reason) -> void {
+    if (unanswered_partitions.erase(id) == 0) {
+      return;
+    }
+    // Partitions that fail to read their files quit without an error, and
+    // only log the cause.
+    auto builder = reason ? diagnostic::warning(reason)
+                          : diagnostic::warning("partition quit unexpectedly");
+    std::move(builder)
+      .note("failed to open partition {}", id)
+      .emit(*diagnostics_handler);
+    if (buffer_rp.pending() and is_done()) {
+      buffer_rp.deliver(table_slice{});
+    }
+  }
+
+  /// Takes the events of a historical partition when we emit in order. We
+  /// emit the events of the oldest running partition right away, and hold
+  /// back the events of later partitions until all partitions before them
+  /// finished. Partitions may run ahead only as long as the held events fit
+  /// into our buffer budget.
+  auto add_partition_events(uint64_t sequence, table_slice slice,
+                            caf::typed_response_promise<void> rp) -> void {
+    if (not mode.ordered or sequence == head_sequence) {
+      add_events(std::move(slice), event_source::retro, std::move(rp));
+      return;
+    }
+    TENZIR_ASSERT(sequence > head_sequence);
+    count_queued(slice);
+    if (not over_budget()) {
+      rp.deliver();
+    }
+    held_partitions[sequence].events.emplace_back(std::move(slice),
+                                                  std::move(rp));
+  }
+
+  auto finish_partition(uint64_t sequence) -> void {
+    if (not mode.ordered) {
+      return;
+    }
+    held_partitions[sequence].done = true;
+    // Emit the held events of the partitions that are now the oldest, and
+    // skip over those that already finished.
+    for (auto it = held_partitions.find(head_sequence);
+         it != held_partitions.end();
+         it = held_partitions.find(head_sequence)) {
+      for (auto& [slice, rp] : std::exchange(it->second.events, {})) {
+        uncount_queued(slice);
+        add_events(std::move(slice), it->second.source, std::move(rp));
+      }
+      if (not it->second.done) {
+        break;
+      }
+      held_partitions.erase(it);
+      ++head_sequence;
+    }
+  }
+
   auto emit_metrics() -> void {
     TENZIR_ASSERT(not mode.internal);
     TENZIR_DEBUG("{} emits {}", *self, metrics.size());
@@ -206,7 +392,7 @@ struct bridge_state {
       return;
     }
     metrics[slice.schema()].queued += slice.rows();
-    num_queued_total += slice.rows();
+    count_queued(slice);
     buffer.emplace_back(std::move(slice), std::move(rp));
   }
 
@@ -220,6 +406,11 @@ struct bridge_state {
     for (auto& [_, rp] : buffer) {
       rp.deliver();
     }
+    for (auto& [_, held] : held_partitions) {
+      for (auto& [_, rp] : held.events) {
+        rp.deliver();
+      }
+    }
   }
 };
 
@@ -232,6 +423,12 @@ auto make_bridge(export_bridge_actor::stateful_pointer<bridge_state> self,
   self->state().taxonomies.concepts = modules::concepts();
   self->state().expr = normalize(std::move(expr));
   self->state().mode = mode;
+  self->state().partition_capacity
+    = get_or(content(self->system().config()), "tenzir.max-partition-size",
+             defaults::max_partition_size);
+  self->state().memory_limit
+    = get_or(content(self->system().config()), "tenzir.export.memory-limit",
+             defaults::export_memory_limit);
   self->state().metrics_handler = std::move(metrics_handler);
   TENZIR_ASSERT(diagnostics_handler);
   self->state().diagnostics_handler = std::move(diagnostics_handler);
@@ -295,6 +492,8 @@ auto make_bridge(export_bridge_actor::stateful_pointer<bridge_state> self,
     auto on_candidates = [self, query_context](catalog_lookup_result& result) {
       self->state().checked_candidates = true;
       auto max_import_time = time::min();
+      auto candidates
+        = std::vector<std::pair<partition_info, tenzir::query_context>>{};
       for (auto& [type, info] : result.candidate_infos) {
         if (info.partition_infos.empty()) {
           continue;
@@ -309,22 +508,43 @@ auto make_bridge(export_bridge_actor::stateful_pointer<bridge_state> self,
         for (auto& partition_info : info.partition_infos) {
           max_import_time
             = std::max(max_import_time, partition_info.max_import_time);
-          self->state().queued_partitions.emplace(std::move(partition_info),
-                                                  ctx);
-        }
-        while (self->state().open_partitions < self->state().mode.parallel) {
-          ++self->state().open_partitions;
-          detail::weak_run_delayed(self, duration::zero(), [self] {
-            self->state().pop_partition();
-          });
+          candidates.emplace_back(std::move(partition_info), ctx);
         }
       }
+      // We query partitions across all schemas from old to new, which is
+      // the order in which we emit their events when asked to.
+      std::ranges::stable_sort(candidates, {}, [](const auto& candidate) {
+        return candidate.first.max_import_time;
+      });
+      const auto num_candidates = candidates.size();
+      for (auto& candidate : candidates) {
+        self->state().queued_partitions.push(std::move(candidate));
+      }
+      while (not candidates.empty()
+             and self->state().open_partitions < self->state().mode.parallel) {
+        ++self->state().open_partitions;
+        detail::weak_run_delayed(self, duration::zero(), [self] {
+          self->state().pop_partition();
+        });
+      }
       TENZIR_ASSERT(self->state().unpersisted_events);
       for (auto& slice : *self->state().unpersisted_events) {
-        if (slice.import_time() > max_import_time) {
-          self->state().add_events(std::move(slice), event_source::unpersisted,
+        if (slice.import_time() <= max_import_time) {
+          continue;
+        }
+        // When we emit in order, the unpersisted events are newer than all
+        // partitions and must wait for them to finish.
+        if (self->state().mode.ordered and num_candidates > 0) {
+          auto& held = self->state().held_partitions[num_candidates];
+          held.done = true;
+          held.source = event_source::unpersisted;
+          self->state().count_queued(slice);
+          held.events.emplace_back(std::move(slice),
                                    caf::typed_response_promise<void>{});
+          continue;
         }
+        self->state().add_events(std::move(slice), event_source::unpersisted,
+                                 caf::typed_response_promise<void>{});
       }
       self->state().unpersisted_events.reset();
       // In case we get zero partitions back from the catalog we need to
@@ -363,6 +583,11 @@ auto make_bridge(export_bridge_actor::stateful_pointer<bridge_state> self,
         is_importer ? event_source::live : event_source::retro, rp);
       return rp;
     },
+    [self](table_slice& slice, uint64_t sequence) -> caf::result<void> {
+      auto rp = self->make_response_promise<void>();
+      self->state().add_partition_events(sequence, std::move(slice), rp);
+      return rp;
+    },
     [self](atom::get) -> caf::result<table_slice> {
       // Forbid concurrent requests.
       TENZIR_ASSERT(not self->state().buffer_rp.pending());
@@ -377,7 +602,7 @@ auto make_bridge(export_bridge_actor::stateful_pointer<bridge_state> self,
         TENZIR_ASSERT(metric.queued >= slice.rows());
         metric.emitted += slice.rows();
         metric.queued -= slice.rows();
-        self->state().num_queued_total -= slice.rows();
+        self->state().uncount_queued(slice);
         self->state().try_pop_partition();
         rp.deliver();
         return slice;
@@ -0,0 +1,309 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/flow_table.hpp"
+
+#include "tenzir/community_id.hpp"
+#include "tenzir/detail/assert.hpp"
+#include "tenzir/detail/narrow.hpp"
+#include "tenzir/hash/hash.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace tenzir {
+
+namespace {
+
+constexpr auto empty = std::numeric_limits<uint32_t>::max();
+constexpr auto initial_slots = size_t{1024};
+
+// Every tick of the wheel covers a second, and a full turn covers more than
+// an hour. Timers that lie further in the future simply come around again.
+constexpr auto tick_duration = duration{std::chrono::seconds{1}};
+constexpr auto wheel_size = size_t{4096};
+
+constexpr auto tcp_fin = uint8_t{0x01};
+constexpr auto tcp_rst = uint8_t{0x04};
+
+/// Returns the first tick that starts after `t`, so that a timer fires only
+/// once its deadline passed.
+auto tick_after(time t) -> int64_t {
+  return (t.time_since_epoch() / tick_duration) + 1;
+}
+
+auto wheel_index(int64_t tick) -> size_t {
+  return static_cast<size_t>(tick) & (wheel_size - 1);
+}
+
+} // namespace
+
+auto to_string(flow_end_reason x) -> std::string_view {
+  switch (x) {
+    case flow_end_reason::idle:
+      return "idle";
+    case flow_end_reason::active:
+      return "active";
+    case flow_end_reason::end:
+      return "end";
+    case flow_end_reason::flush:
+      return "flush";
+  }
+  TENZIR_UNREACHABLE();
+}
+
+flow_table::flow_table(flow_table_options options)
+  : options_{options},
+    slots_(initial_slots, slot{0, empty}),
+    wheel_(wheel_size) {
+}
+
+auto flow_table::add(const flow& id, time ts, uint64_t bytes,
+                     uint8_t tcp_flags, std::vector<flow_record>& expired)
+  -> void {
+  advance(ts, expired);
+  const auto [key, swapped] = community_id::canonicalize(id);
+  const auto tag = static_cast<uint32_t>(hash(key));
+  auto [pos, found] = find(key, tag);
+  if (not found) {
+    if ((size_ + 1) * 2 > slots_.size()) {
+      grow();
+      pos = find(key, tag).first;
+    }
+    auto index = uint32_t{};
+    if (free_.empty()) {
+      index = detail::narrow_cast<uint32_t>(entries_.size());
+      entries_.emplace_back();
+    } else {
+      index = free_.back();
+      free_.pop_back();
+    }
+    auto& e = entries_[index];
+    // Keep the timer ID, so that timers of the previous flow stay invalid.
+    e = entry{
+      .key = key,
+      .id = id,
+      .start = ts,
+      .end = ts,
+      .timer = e.timer,
+      .swapped = swapped,
+      .used = true,
+    };
+    slots_[pos] = slot{tag, index};
+    ++size_;
+    schedule(index, true);
+  }
+  auto& e = entries_[slots_[pos].index];
+  const auto direction = swapped == e.swapped ? 0 : 1;
+  if (e.packets[0] + e.packets[1] == 0) {
+    e.start = ts;
+  }
+  e.end = std::max(e.end, ts);
+  e.packets[direction] += 1;
+  e.bytes[direction] += bytes;
+  if (protocol(key) != port_type::tcp) {
+    return;
+  }
+  e.tcp_flags |= tcp_flags;
+  if ((tcp_flags & tcp_fin) != 0) {
+    e.fins |= uint8_t{1} << direction;
+  }
+  if (not e.closed and ((tcp_flags & tcp_rst) != 0 or e.fins == 0b11)) {
+    // The connection ends soon, so we need a timer that fires earlier.
+    e.closed = true;
+    schedule(slots_[pos].index, true);
+  }
+}
+
+auto flow_table::advance(time now, std::vector<flow_record>& expired) -> void {
+  if (not started_) {
+    started_ = true;
+    now_ = now;
+    tick_ = tick_after(now) - 1;
+    return;
+  }
+  if (now <= now_) {
+    return;
+  }
+  now_ = now;
+  const auto target = tick_after(now) - 1;
+  if (target <= tick_) {
+    return;
+  }
+  // After a long gap, a single turn of the wheel visits every timer.
+  const auto steps = std::min(target - tick_, static_cast<int64_t>(wheel_size));
+  for (auto tick = target - steps + 1; tick <= target; ++tick) {
+    // Timers that we schedule from here on must go to a later tick.
+    tick_ = tick;
+    fired_.swap(wheel_[wheel_index(tick)]);
+    for (const auto& t : fired_) {
+      const auto& e = entries_[t.index];
+      if (not e.used or e.timer != t.id) {
+        continue;
+      }
+      const auto [when, reason] = deadline(e);
+      if (when < now) {
+        expire(t.index, reason, expired);
+      } else {
+        schedule(t.index, false);
+      }
+    }
+    fired_.clear();
+  }
+}
+
+auto flow_table::flush(std::vector<flow_record>& expired) -> void {
+  auto indices = std::vector<uint32_t>{};
+  indices.reserve(size_);
+  for (auto i = size_t{0}; i < entries_.size(); ++i) {
+    if (entries_[i].used) {
+      indices.push_back(detail::narrow_cast<uint32_t>(i));
+    }
+  }
+  std::ranges::stable_sort(indices, {}, [&](uint32_t i) {
+    return entries_[i].start;
+  });
+  for (auto index : indices) {
+    expire(index, flow_end_reason::flush, expired);
+  }
+}
+
+auto flow_table::find(const flow& key, uint32_t tag) const
+  -> std::pair<size_t, bool> {
+  const auto mask = slots_.size() - 1;
+  auto pos = tag & mask;
+  while (slots_[pos].index != empty) {
+    if (slots_[pos].tag == tag and entries_[slots_[pos].index].key == key) {
+      return {pos, true};
+    }
+    pos = (pos + 1) & mask;
+  }
+  return {pos, false};
+}
+
+auto flow_table::grow() -> void {
+  auto slots = std::vector<slot>(slots_.size() * 2, slot{0, empty});
+  const auto mask = slots.size() - 1;
+  // The tag determines the position, so we never need to rehash a key.
+  for (const auto& s : slots_) {
+    if (s.index == empty) {
+      continue;
+    }
+    auto pos = s.tag & mask;
+    while (slots[pos].index != empty) {
+      pos = (pos + 1) & mask;
+    }
+    slots[pos] = s;
+  }
+  slots_ = std::move(slots);
+}
+
+auto flow_table::deadline(const entry& e) const
+  -> std::pair<time, flow_end_reason> {
+  if (e.closed) {
+    return {e.end + options_.close_timeout, flow_end_reason::end};
+  }
+  const auto idle = e.end + options_.idle_timeout;
+  const auto active = e.start + options_.active_timeout;
+  if (idle <= active) {
+    return {idle, flow_end_reason::idle};
+  }
+  return {active, flow_end_reason::active};
+}
+
+auto flow_table::schedule(uint32_t index, bool renew) -> void {
+  auto& e = entries_[index];
+  if (renew) {
+    // Invalidates all previous timers of the entry.
+    ++e.timer;
+  }
+  const auto tick = std::max(tick_after(deadline(e).first), tick_ + 1);
+  wheel_[wheel_index(tick)].push_back(timer{index, e.timer});
+}
+
+auto flow_table::expire(uint32_t index, flow_end_reason reason,
+                        std::vector<flow_record>& expired) -> void {
+  auto& e = entries_[index];
+  // A flow may have seen no packets since its last active timeout.
+  if (e.packets[0] + e.packets[1] > 0) {
+    const auto& id = e.id;
+    expired.push_back(flow_record{
+      .id = id,
+      .start = e.start,
+      .end = e.end,
+      .src_packets = e.packets[0],
+      .src_bytes = e.bytes[0],
+      .dst_packets = e.packets[1],
+      .dst_bytes = e.bytes[1],
+      .tcp_flags = e.tcp_flags,
+      .reason = reason,
+    });
+  }
+  if (reason == flow_end_reason::active) {
+    // The next record of the flow starts with its next packet.
+    e.packets = {};
+    e.bytes = {};
+    e.tcp_flags = 0;
+    e.start = e.end;
+    schedule(index, true);
+    return;
+  }
+  erase(index);
+}
+
+auto flow_table::erase(uint32_t index) -> void {
+  auto& e = entries_[index];
+  const auto tag = static_cast<uint32_t>(hash(e.key));
+  const auto [pos, found] = find(e.key, tag);
+  TENZIR_ASSERT(found);
+  // Shift the following slots back, so that lookups never stop early at the
+  // hole. A slot can move to the hole only if that does not put it before its
+  // preferred position.
+  const auto mask = slots_.size() - 1;
+  auto hole = pos;
+  auto next = (hole + 1) & mask;
+  while (slots_[next].index != empty) {
+    const auto home = slots_[next].tag & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      slots_[hole] = slots_[next];
+      hole = next;
+    }
+    next = (next + 1) & mask;
+  }
+  slots_[hole].index = empty;
+  e.used = false;
+  free_.push_back(index);
+  --size_;
+}
+
+auto flow_table::rebuild(std::vector<entry> flows) -> void {
+  slots_.assign(initial_slots, slot{0, empty});
+  entries_.clear();
+  free_.clear();
+  for (auto& timers : wheel_) {
+    timers.clear();
+  }
+  size_ = 0;
+  for (auto& e : flows) {
+    if ((size_ + 1) * 2 > slots_.size()) {
+      grow();
+    }
+    const auto tag = static_cast<uint32_t>(hash(e.key));
+    const auto [pos, found] = find(e.key, tag);
+    TENZIR_ASSERT(not found);
+    const auto index = detail::narrow_cast<uint32_t>(entries_.size());
+    e.used = true;
+    e.timer = 0;
+    entries_.push_back(std::move(e));
+    slots_[pos] = slot{tag, index};
+    ++size_;
+    schedule(index, true);
+  }
+}
+
+} // namespace tenzir
@@ -335,6 +335,15 @@ auto rest_response::from_json_string(std::string json) -> rest_response {
   return result;
 }
 
+auto rest_response::from_bytes(std::string body, std::string content_type)
+  -> rest_response {
+  auto result = rest_response{};
+  result.code_ = 200;
+  result.body_ = std::move(body);
+  result.headers_.try_emplace("Content-Type", std::move(content_type));
+  return result;
+}
+
 auto rest_response::is_error() const -> bool {
   return is_error_;
 }
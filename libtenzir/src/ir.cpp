@@ -905,6 +905,23 @@ auto ir::pipeline::optimize(optimize_filter filter,
       std::move_iterator{opt.replacement.operators.begin()},
       std::move_iterator{opt.replacement.operators.end()});
   }
+  // Let operators absorb the limit of their direct downstream. We do this after
+  // pushing filters upstream, which can make operators adjacent, such as
+  // `sort` and `head` in `sort x | where y | head`.
+  for (auto i = size_t{1}; i < replacement.operators.size(); ++i) {
+    if (auto limit = replacement.operators[i]->limit()) {
+      replacement.operators[i - 1]->absorb_limit(*limit);
+    }
+  }
+  // Let operators absorb the partial step of an aggregation directly
+  // downstream, which leaves only the merge step in place.
+  for (auto i = size_t{1}; i < replacement.operators.size(); ++i) {
+    auto split = replacement.operators[i]->split_partial();
+    if (split
+        and replacement.operators[i - 1]->absorb_partial(*split->partial)) {
+      replacement.operators[i] = std::move(split->merge);
+    }
+  }
   return {std::move(filter), order, std::move(replacement)};
 }
 
@@ -0,0 +1,514 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/json_slice_printer.hpp"
+
+#include "tenzir/arrow_utils.hpp"
+#include "tenzir/concept/printable/std/chrono.hpp"
+#include "tenzir/concept/printable/tenzir/ip.hpp"
+#include "tenzir/concept/printable/tenzir/subnet.hpp"
+#include "tenzir/concept/printable/to_string.hpp"
+#include "tenzir/detail/assert.hpp"
+#include "tenzir/detail/base64.hpp"
+#include "tenzir/detail/json_escape.hpp"
+#include "tenzir/table_slice.hpp"
+#include "tenzir/view3.hpp"
+
+#include <arrow/array.h>
+#include <arrow/record_batch.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace tenzir {
+
+namespace {
+
+/// The output of a slice, along with the state that `json_printer` keeps for
+/// indentation.
+class output {
+public:
+  output(const json_printer_options& options, std::vector<char>& buffer)
+    : options_{options}, buffer_{buffer} {
+    if (options_.trailing_commas) {
+      trailing_commas_ = *options_.trailing_commas;
+    }
+  }
+
+  auto append(char c) -> void {
+    buffer_.push_back(c);
+  }
+
+  auto append(std::string_view str) -> void {
+    buffer_.insert(buffer_.end(), str.begin(), str.end());
+  }
+
+  auto append_string(std::string_view str) -> void {
+    detail::append_json_string(str, buffer_);
+  }
+
+  auto append_null() -> void {
+    append("null");
+  }
+
+  template <class T>
+  auto append_integer(T x) -> void {
+    auto digits = std::array<char, 24>{};
+    const auto [end, ec] = std::to_chars(digits.begin(), digits.end(), x);
+    TENZIR_ASSERT(ec == std::errc{});
+    buffer_.insert(buffer_.end(), digits.begin(), end);
+  }
+
+  auto append_double(double x) -> void {
+    switch (std::fpclassify(x)) {
+      case FP_NORMAL:
+      case FP_SUBNORMAL:
+      case FP_ZERO:
+        break;
+      default:
+        append_null();
+        return;
+    }
+    // Like `json_printer`, we append a trailing zero to integral values, but
+    // format into a local buffer instead of a temporary string.
+    auto digits = std::array<char, 32>{};
+    const auto end
+      = fmt::format_to_n(digits.begin(), digits.size(), "{}", x).out;
+    const auto is_integer = std::all_of(digits.begin(), end, [](char ch) {
+      return ('0' <= ch and ch <= '9') or ch == '-';
+    });
+    buffer_.insert(buffer_.end(), digits.begin(), end);
+    if (is_integer) {
+      append(".0");
+    }
+  }
+
+  auto open() -> void {
+    indentation_ += options_.indentation;
+    newline();
+  }
+
+  auto separate() -> void {
+    append(',');
+    newline();
+  }
+
+  auto close() -> void {
+    if (trailing_commas_) {
+      append(',');
+    }
+    indentation_ -= options_.indentation;
+    newline();
+  }
+
+private:
+  auto newline() -> void {
+    if (not options_.oneline) {
+      append('\n');
+      buffer_.insert(buffer_.end(), indentation_, ' ');
+    }
+  }
+
+  const json_printer_options& options_;
+  std::vector<char>& buffer_;
+  bool trailing_commas_ = false;
+  uint32_t indentation_ = 0;
+};
+
+/// Prints the values of a single array.
+class column {
+public:
+  column(const arrow::Array& array, const json_printer_options& options)
+    : array_{array}, options_{options} {
+  }
+
+  virtual ~column() = default;
+  column(const column&) = delete;
+  auto operator=(const column&) -> column& = delete;
+  column(column&&) = delete;
+  auto operator=(column&&) -> column& = delete;
+
+  /// Returns whether the value is omitted, mirroring the `should_skip` of
+  /// `json_printer`.
+  auto skip(int64_t row, bool in_list) const -> bool {
+    if (array_.IsNull(row)) {
+      return (in_list and options_.omit_nulls_in_lists)
+             or options_.omit_null_fields;
+    }
+    return skip_valid(row);
+  }
+
+  auto print(int64_t row, output& out) -> void {
+    if (array_.IsNull(row)) {
+      out.append_null();
+      return;
+    }
+    print_valid(row, out);
+  }
+
+protected:
+  virtual auto skip_valid(int64_t row) const -> bool {
+    TENZIR_UNUSED(row);
+    return false;
+  }
+
+  virtual auto print_valid(int64_t row, output& out) -> void = 0;
+
+  const arrow::Array& array_;
+  const json_printer_options& options_;
+};
+
+auto make_column(const arrow::Array& array,
+                 const json_printer_options& options)
+  -> std::unique_ptr<column>;
+
+class null_column final : public column {
+public:
+  using column::column;
+
+private:
+  auto print_valid(int64_t, output&) -> void override {
+    TENZIR_UNREACHABLE();
+  }
+};
+
+/// Prints the values of an array whose view the output can append directly.
+template <class Array>
+class simple_column final : public column {
+public:
+  simple_column(const Array& array, const json_printer_options& options)
+    : column{array, options}, typed_{array} {
+  }
+
+private:
+  auto print_valid(int64_t row, output& out) -> void override {
+    const auto x = typed_.GetView(row);
+    if constexpr (std::same_as<Array, arrow::BooleanArray>) {
+      out.append(x ? std::string_view{"true"} : std::string_view{"false"});
+    } else if constexpr (std::same_as<Array, arrow::DoubleArray>) {
+      out.append_double(x);
+    } else if constexpr (std::same_as<Array, arrow::StringArray>) {
+      out.append_string({x.data(), x.size()});
+    } else {
+      out.append_integer(x);
+    }
+  }
+
+  const Array& typed_;
+};
+
+class duration_column final : public column {
+public:
+  duration_column(const arrow::DurationArray& array,
+                  const json_printer_options& options)
+    : column{array, options}, typed_{array} {
+  }
+
+private:
+  auto print_valid(int64_t row, output& out) -> void override {
+    const auto x = duration{typed_.GetView(row)};
+    if (options_.numeric_durations) {
+      out.append_double(
+        std::chrono::duration_cast<std::chrono::duration<double>>(x).count());
+      return;
+    }
+    out.append('"');
+    out.append(to_string(x));
+    out.append('"');
+  }
+
+  const arrow::DurationArray& typed_;
+};
+
+/// Prints timestamps in the format of the `time_point_printer`. Consecutive
+/// values in a column often fall into the same second, so we keep the date
+/// and time of day of the previous value and only format the fraction anew.
+class time_column final : public column {
+public:
+  time_column(const arrow::TimestampArray& array,
+              const json_printer_options& options)
+    : column{array, options}, typed_{array} {
+  }
+
+private:
+  auto print_valid(int64_t row, output& out) -> void override {
+    const auto x = time{} + duration{typed_.GetView(row)};
+    const auto seconds = std::chrono::floor<std::chrono::seconds>(x);
+    if (not cached_ or *cached_ != seconds) {
+      cached_ = seconds;
+      prefix_ = to_string(time{seconds});
+      TENZIR_ASSERT(not prefix_.empty() and prefix_.back() == 'Z');
+      prefix_.pop_back();
+    }
+    out.append('"');
+    out.append(prefix_);
+    const auto ns = std::chrono::nanoseconds{x - seconds}.count();
+    if (ns != 0) {
+      auto digits = std::array<char, 10>{};
+      auto value = ns;
+      auto width = 9;
+      if (ns % 1'000'000 == 0) {
+        value = ns / 1'000'000;
+        width = 3;
+      } else if (ns % 1'000 == 0) {
+        value = ns / 1'000;
+        width = 6;
+      }
+      digits[0] = '.';
+      for (auto i = width; i > 0; --i) {
+        digits[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+      }
+      out.append(
+        std::string_view{digits.data(), static_cast<size_t>(width + 1)});
+    }
+    out.append("Z\"");
+  }
+
+  const arrow::TimestampArray& typed_;
+  std::optional<std::chrono::time_point<std::chrono::system_clock,
+                                        std::chrono::seconds>>
+    cached_;
+  std::string prefix_;
+};
+
+/// Prints the values that `json_printer` also converts to a string first.
+template <class Array>
+class stringified_column final : public column {
+public:
+  stringified_column(const Array& array, const json_printer_options& options)
+    : column{array, options}, typed_{array} {
+  }
+
+private:
+  auto print_valid(int64_t row, output& out) -> void override {
+    const auto x = view_at(typed_, row);
+    TENZIR_ASSERT(x);
+    if constexpr (std::same_as<Array, arrow::BinaryArray>) {
+      out.append_string(detail::base64::encode(*x));
+    } else if constexpr (std::same_as<Array, secret_type::array_type>) {
+      out.append_string(fmt::format("{}", *x));
+    } else if constexpr (std::same_as<Array, enumeration_type::array_type>) {
+      out.append_integer(*x);
+    } else {
+      out.append('"');
+      out.append(to_string(*x));
+      out.append('"');
+    }
+  }
+
+  const Array& typed_;
+};
+
+class list_column final : public column {
+public:
+  list_column(const arrow::ListArray& array,
+              const json_printer_options& options)
+    : column{array, options},
+      typed_{array},
+      values_{make_column(*array.values(), options)} {
+  }
+
+private:
+  auto skip_valid(int64_t row) const -> bool override {
+    if (not options_.omit_empty_lists) {
+      return false;
+    }
+    for (auto i = typed_.value_offset(row); i < typed_.value_offset(row + 1);
+         ++i) {
+      if (not values_->skip(i, true)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  auto print_valid(int64_t row, output& out) -> void override {
+    out.append('[');
+    auto printed_once = false;
+    for (auto i = typed_.value_offset(row); i < typed_.value_offset(row + 1);
+         ++i) {
+      if (values_->skip(i, true)) {
+        continue;
+      }
+      if (printed_once) {
+        out.separate();
+      } else {
+        out.open();
+        printed_once = true;
+      }
+      values_->print(i, out);
+    }
+    if (printed_once) {
+      out.close();
+    }
+    out.append(']');
+  }
+
+  const arrow::ListArray& typed_;
+  std::unique_ptr<column> values_;
+};
+
+class record_column final : public column {
+public:
+  record_column(const arrow::StructArray& array,
+                const json_printer_options& options)
+    : column{array, options} {
+    const auto& fields = array.struct_type()->fields();
+    fields_.reserve(fields.size());
+    for (auto i = 0; i < array.num_fields(); ++i) {
+      auto& f = fields_.emplace_back();
+      // Keep the sliced field array alive, as the column only references it.
+      f.array = array.field(i);
+      f.values = make_column(*f.array, options);
+      auto key = std::vector<char>{};
+      detail::append_json_string(fields[i]->name(), key);
+      key.push_back(':');
+      if (not options.oneline) {
+        key.push_back(' ');
+      }
+      f.key.assign(key.begin(), key.end());
+    }
+  }
+
+  /// Prints a row of the top-level record, which is never omitted.
+  auto print_row(int64_t row, output& out) -> void {
+    print_valid(row, out);
+  }
+
+private:
+  struct field {
+    std::shared_ptr<arrow::Array> array;
+    std::unique_ptr<column> values;
+    std::string key;
+  };
+
+  auto skip_valid(int64_t row) const -> bool override {
+    if (not options_.omit_empty_records) {
+      return false;
+    }
+    return std::ranges::all_of(fields_, [&](const field& f) {
+      return f.values->skip(row, false);
+    });
+  }
+
+  auto print_valid(int64_t row, output& out) -> void override {
+    out.append('{');
+    auto printed_once = false;
+    for (auto& f : fields_) {
+      if (f.values->skip(row, false)) {
+        continue;
+      }
+      if (printed_once) {
+        out.separate();
+      } else {
+        out.open();
+        printed_once = true;
+      }
+      out.append(f.key);
+      f.values->print(row, out);
+    }
+    if (printed_once) {
+      out.close();
+    }
+    out.append('}');
+  }
+
+  std::vector<field> fields_;
+};
+
+auto make_column(const arrow::Array& array,
+                 const json_printer_options& options)
+  -> std::unique_ptr<column> {
+  return match(
+    array,
+    [&](const arrow::NullArray& x) -> std::unique_ptr<column> {
+      return std::make_unique<null_column>(x, options);
+    },
+    [&]<class Array>(const Array& x) -> std::unique_ptr<column>
+      requires(std::same_as<Array, arrow::BooleanArray>
+               or std::same_as<Array, arrow::Int64Array>
+               or std::same_as<Array, arrow::UInt64Array>
+               or std::same_as<Array, arrow::DoubleArray>
+               or std::same_as<Array, arrow::StringArray>)
+    {
+      return std::make_unique<simple_column<Array>>(x, options);
+    },
+    [&](const arrow::DurationArray& x) -> std::unique_ptr<column> {
+      return std::make_unique<duration_column>(x, options);
+    },
+    [&](const arrow::TimestampArray& x) -> std::unique_ptr<column> {
+      return std::make_unique<time_column>(x, options);
+    },
+    [&]<class Array>(const Array& x) -> std::unique_ptr<column>
+      requires(std::same_as<Array, arrow::BinaryArray>
+               or std::same_as<Array, ip_type::array_type>
+               or std::same_as<Array, subnet_type::array_type>
+               or std::same_as<Array, secret_type::array_type>
+               or std::same_as<Array, enumeration_type::array_type>)
+    {
+      return std::make_unique<stringified_column<Array>>(x, options);
+    },
+    [&](const arrow::ListArray& x) -> std::unique_ptr<column> {
+      return std::make_unique<list_column>(x, options);
+    },
+    [&](const arrow::StructArray& x) -> std::unique_ptr<column> {
+      return std::make_unique<record_column>(x, options);
+    },
+    [&](const arrow::MapArray&) -> std::unique_ptr<column> {
+      TENZIR_UNREACHABLE();
+    });
+}
+
+auto is_plain(const fmt::text_style& style) -> bool {
+  return not style.has_foreground() and not style.has_background()
+         and not style.has_emphasis();
+}
+
+} // namespace
+
+json_slice_printer::json_slice_printer(json_printer_options options)
+  : options_{options} {
+  TENZIR_ASSERT(supports(options_));
+}
+
+auto json_slice_printer::supports(const json_printer_options& options)
+  -> bool {
+  const auto& s = options.style;
+  return not options.tql
+         and std::ranges::all_of(
+           std::array{s.null_, s.false_, s.true_, s.number, s.string, s.array,
+                      s.object, s.field, s.comma, s.duration, s.time, s.subnet,
+                      s.ip, s.blob, s.colon},
+           is_plain);
+}
+
+auto json_slice_printer::print(const table_slice& slice,
+                               std::string_view separator,
+                               std::vector<char>& out) const -> void {
+  if (slice.rows() == 0) {
+    return;
+  }
+  const auto array = check(to_record_batch(slice)->ToStructArray());
+  auto columns = record_column{*array, options_};
+  auto printer = output{options_, out};
+  for (auto row = int64_t{0}; row < array->length(); ++row) {
+    if (row > 0) {
+      printer.append(separator);
+    }
+    columns.print_row(row, printer);
+  }
+}
+
+} // namespace tenzir
@@ -460,6 +460,9 @@ public:
     if (desc_->set_order) {
       (*desc_->set_order)(args, order_);
     }
+    if (desc_->set_limit and limit_) {
+      (*desc_->set_limit)(args, *limit_);
+    }
     auto with_name = [&](AnyOperator op) -> AnyOperator {
       match(op, [&](auto& op) {
         op->with_name(desc_->name);
@@ -702,6 +705,32 @@ public:
             ir::pipeline{{}, std::move(replacement)}};
   }
 
+  auto limit() const -> Option<ir::Limit> override {
+    if (not desc_->limit) {
+      return None{};
+    }
+    auto noop_dh = null_diagnostic_handler{};
+    auto ctx = DescribeCtx{args_,  named_args_,     pipeline_,
+                           *desc_, main_location(), noop_dh};
+    return (*desc_->limit)(ctx);
+  }
+
+  auto absorb_limit(ir::Limit limit) -> bool override {
+    if (not desc_->set_limit) {
+      return false;
+    }
+    limit_ = limit;
+    return true;
+  }
+
+  auto absorb_partial(const ir::Operator& partial) -> bool override {
+    if (not desc_->absorb_partial or not pipeline_) {
+      return false;
+    }
+    pipeline_->pipeline.inner.operators.push_back(partial.copy());
+    return true;
+  }
+
   auto main_location() const -> location override {
     return op_.get_location();
   }
@@ -711,7 +740,8 @@ private:
     return f.object(x).fields(
       f.field("op", x.op_), f.field("desc", x.desc_), f.field("args", x.args_),
       f.field("filter", x.filter_), f.field("order", x.order_),
-      f.field("named_args", x.named_args_), f.field("pipeline", x.pipeline_));
+      f.field("named_args", x.named_args_), f.field("pipeline", x.pipeline_),
+      f.field("limit", x.limit_));
   }
 
   /// The entity that this operator was created for.
@@ -733,6 +763,9 @@ private:
   /// Initialized to `ordered` (strongest); each call takes the max.
   event_order order_ = event_order::ordered;
 
+  /// The limit absorbed from the downstream operator, if any.
+  std::optional<ir::Limit> limit_;
+
   /// The object describing the available parameters.
   SharedDescription desc_;
 };
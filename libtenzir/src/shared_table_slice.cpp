@@ -0,0 +1,548 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/shared_table_slice.hpp"
+
+#include "tenzir/arrow_memory_pool.hpp"
+#include "tenzir/chunk.hpp"
+#include "tenzir/detail/scope_guard.hpp"
+#include "tenzir/error.hpp"
+#include "tenzir/logger.hpp"
+
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/record_batch.h>
+#include <caf/node_id.hpp>
+#include <fmt/format.h>
+
+#ifdef __linux__
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+
+#  include <array>
+#  include <cerrno>
+#  include <chrono>
+#  include <condition_variable>
+#  include <cstddef>
+#  include <cstring>
+#  include <mutex>
+#  include <span>
+#  include <string>
+#  include <thread>
+#  include <unordered_map>
+#  include <variant>
+#  include <vector>
+#endif
+
+namespace tenzir {
+
+namespace {
+
+#ifdef __linux__
+
+/// The host and process that a CAF node ID identifies.
+struct node_process {
+  caf::hashed_node_id::host_id_type host = {};
+  uint32_t pid = 0;
+};
+
+/// Splits a CAF node ID into host and process. Only node IDs that are derived
+/// from the host identify a process; URI-based node IDs do not.
+auto to_node_process(const caf::node_id& node) -> std::optional<node_process> {
+  if (not node) {
+    return std::nullopt;
+  }
+  const auto* hashed = std::get_if<caf::hashed_node_id>(&node->content);
+  if (not hashed) {
+    return std::nullopt;
+  }
+  return node_process{.host = hashed->host, .pid = hashed->process_id};
+}
+
+/// Returns whether the peer of a connected Unix socket is the given process of
+/// our own user.
+auto is_trusted_peer(int fd, std::optional<uint32_t> pid) -> bool {
+  auto credentials = ucred{};
+  auto length = socklen_t{sizeof(credentials)};
+  if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == -1) {
+    return false;
+  }
+  if (credentials.uid != ::getuid()) {
+    return false;
+  }
+  return not pid or static_cast<uint32_t>(credentials.pid) == *pid;
+}
+
+/// Slices below this size are cheaper to copy through the CAF socket than to
+/// pass as a memory file.
+constexpr auto min_shared_bytes = size_t{64} << 10;
+
+/// How long the receiver waits for a file descriptor that the CAF message
+/// overtook.
+constexpr auto receive_timeout = std::chrono::seconds{10};
+
+/// How long the receiver keeps file descriptors that nobody claims, e.g.,
+/// because the receiving execution node shut down in the meantime.
+constexpr auto unclaimed_timeout = std::chrono::minutes{1};
+
+/// The seals that guarantee that the mapping of the receiver can neither
+/// change nor fault.
+constexpr auto required_seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE;
+
+/// Returns the address of the socket that a process listens on. We use the
+/// abstract namespace, so there is no file to clean up.
+auto socket_address(uint32_t pid) -> std::pair<sockaddr_un, socklen_t> {
+  auto addr = sockaddr_un{};
+  addr.sun_family = AF_UNIX;
+  const auto name = fmt::format("tenzir-shared-table-slice-{}", pid);
+  TENZIR_ASSERT(name.size() + 1 < sizeof(addr.sun_path));
+  std::memcpy(addr.sun_path + 1, name.data(), name.size());
+  return {addr, static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1
+                                       + name.size())};
+}
+
+/// Receives file descriptors from other processes and hands them to the
+/// execution nodes that claim them.
+class receiver {
+public:
+  static auto instance() -> receiver& {
+    // Intentionally leaked: the thread runs until the process exits.
+    static auto* result = new receiver{};
+    return *result;
+  }
+
+  auto start() -> void {
+    auto lock = std::unique_lock{mutex_};
+    if (started_) {
+      return;
+    }
+    started_ = true;
+    const auto fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+      TENZIR_DEBUG("failed to create shared table slice socket: {}",
+                   std::strerror(errno));
+      return;
+    }
+    const auto [addr, len] = socket_address(::getpid());
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), len) == -1
+        or ::listen(fd, SOMAXCONN) == -1) {
+      TENZIR_DEBUG("failed to listen for shared table slices: {}",
+                   std::strerror(errno));
+      ::close(fd);
+      return;
+    }
+    std::thread{[this, fd] {
+      run(fd);
+    }}.detach();
+  }
+
+  /// Returns the file descriptor for a token if it arrived already.
+  auto try_take(const uuid& token) -> std::optional<int> {
+    auto lock = std::unique_lock{mutex_};
+    auto it = fds_.find(token);
+    if (it == fds_.end()) {
+      return std::nullopt;
+    }
+    const auto fd = it->second.fd;
+    fds_.erase(it);
+    return fd;
+  }
+
+  /// Waits for the file descriptor of a token. This blocks the calling
+  /// thread, so it must not run on a scheduler thread of the actor system.
+  auto take(const uuid& token) -> caf::expected<int> {
+    auto lock = std::unique_lock{mutex_};
+    const auto arrived = ready_.wait_for(lock, receive_timeout, [&] {
+      return fds_.contains(token);
+    });
+    if (not arrived) {
+      return caf::make_error(ec::timeout,
+                             "shared table slice did not arrive in time");
+    }
+    auto it = fds_.find(token);
+    const auto fd = it->second.fd;
+    fds_.erase(it);
+    return fd;
+  }
+
+private:
+  struct entry {
+    int fd = -1;
+    std::chrono::steady_clock::time_point received;
+  };
+
+  receiver() = default;
+
+  auto run(int listen_fd) -> void {
+    auto fds = std::vector<pollfd>{{.fd = listen_fd, .events = POLLIN}};
+    while (true) {
+      if (::poll(fds.data(), fds.size(), -1) == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+        TENZIR_WARN("stopped receiving shared table slices: {}",
+                    std::strerror(errno));
+        return;
+      }
+      for (auto i = size_t{1}; i < fds.size(); ++i) {
+        if (fds[i].revents != 0 and not receive(fds[i].fd)) {
+          ::close(fds[i].fd);
+          fds[i].fd = -1;
+        }
+      }
+      std::erase_if(fds, [](const pollfd& x) {
+        return x.fd == -1;
+      });
+      if ((fds[0].revents & POLLIN) != 0) {
+        if (auto fd = accept(listen_fd); fd != -1) {
+          fds.push_back({.fd = fd, .events = POLLIN});
+        }
+      }
+    }
+  }
+
+  /// Accepts a connection, but only from processes of our own user.
+  static auto accept(int listen_fd) -> int {
+    const auto fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd == -1) {
+      return -1;
+    }
+    if (not is_trusted_peer(fd, std::nullopt)) {
+      ::close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  /// Receives a token with its file descriptor. Returns false if the
+  /// connection closed.
+  auto receive(int fd) -> bool {
+    auto token = std::array<std::byte, uuid::num_bytes>{};
+    auto iov = iovec{.iov_base = token.data(), .iov_len = token.size()};
+    alignas(cmsghdr) auto control = std::array<char, CMSG_SPACE(sizeof(int))>{};
+    auto msg = msghdr{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    const auto n = ::recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+    if (n <= 0) {
+      return n == -1 and errno == EINTR;
+    }
+    auto received = -1;
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET and cmsg->cmsg_type == SCM_RIGHTS
+          and cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+        std::memcpy(&received, CMSG_DATA(cmsg), sizeof(int));
+      }
+    }
+    if (received == -1) {
+      return true;
+    }
+    if (static_cast<size_t>(n) != token.size()
+        or (msg.msg_flags & MSG_CTRUNC) != 0) {
+      ::close(received);
+      return true;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    auto lock = std::unique_lock{mutex_};
+    std::erase_if(fds_, [&](const auto& x) {
+      if (now - x.second.received < unclaimed_timeout) {
+        return false;
+      }
+      ::close(x.second.fd);
+      return true;
+    });
+    if (not fds_.try_emplace(uuid{token}, entry{received, now}).second) {
+      ::close(received);
+    }
+    lock.unlock();
+    ready_.notify_all();
+    return true;
+  }
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  bool started_ = false;
+  std::unordered_map<uuid, entry> fds_;
+};
+
+/// Passes file descriptors to other processes, with one connection per
+/// receiving process.
+class sender {
+public:
+  static auto instance() -> sender& {
+    static auto result = sender{};
+    return result;
+  }
+
+  /// Passes a file descriptor to a process. Returns false if the process does
+  /// not accept them.
+  auto send(uint32_t pid, const uuid& token, int fd) -> bool {
+    auto lock = std::unique_lock{mutex_};
+    auto it = sockets_.find(pid);
+    if (it == sockets_.end()) {
+      it = sockets_.emplace(pid, connect(pid)).first;
+    }
+    if (it->second == -1) {
+      return false;
+    }
+    auto iov = iovec{
+      .iov_base = const_cast<std::byte*>(token.begin()),
+      .iov_len = uuid::num_bytes,
+    };
+    alignas(cmsghdr) auto control = std::array<char, CMSG_SPACE(sizeof(int))>{};
+    auto msg = msghdr{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    auto* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    while (::sendmsg(it->second, &msg, MSG_NOSIGNAL) == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // The receiving process most likely exited. Process IDs can be reused,
+      // so we try to connect again next time.
+      TENZIR_DEBUG("failed to pass shared table slice to process {}: {}", pid,
+                   std::strerror(errno));
+      ::close(it->second);
+      sockets_.erase(it);
+      return false;
+    }
+    return true;
+  }
+
+private:
+  /// Connects to the socket of a process. Anyone could bind the abstract
+  /// address first, so we only hand out events if the listening end belongs
+  /// to the expected process of our own user.
+  static auto connect(uint32_t pid) -> int {
+    const auto fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+      return -1;
+    }
+    const auto [addr, len] = socket_address(pid);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), len) == -1) {
+      TENZIR_DEBUG("process {} does not accept shared table slices: {}", pid,
+                   std::strerror(errno));
+      ::close(fd);
+      return -1;
+    }
+    if (not is_trusted_peer(fd, pid)) {
+      TENZIR_WARN("refusing to pass table slices to a socket of process {} "
+                  "that belongs to another process or user",
+                  pid);
+      ::close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<uint32_t, int> sockets_;
+};
+
+/// Writes a record batch as an Arrow IPC stream to an output stream.
+auto write_ipc(const arrow::RecordBatch& batch, arrow::io::OutputStream& out)
+  -> arrow::Status {
+  auto options = arrow::ipc::IpcWriteOptions::Defaults();
+  options.memory_pool = arrow_memory_pool();
+  auto writer = arrow::ipc::MakeStreamWriter(&out, batch.schema(), options);
+  if (not writer.ok()) {
+    return writer.status();
+  }
+  ARROW_RETURN_NOT_OK((*writer)->WriteRecordBatch(batch));
+  return (*writer)->Close();
+}
+
+/// Creates a sealed memory file that contains a record batch as Arrow IPC
+/// stream of the given size. The buffers of the record batch are copied into
+/// the shared mapping directly, without an intermediate buffer.
+auto make_memory_file(const arrow::RecordBatch& batch, size_t size) -> int {
+  const auto fd
+    = ::memfd_create("tenzir-table-slice", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd == -1) {
+    return -1;
+  }
+  auto close_fd = detail::scope_guard{[fd]() noexcept {
+    ::close(fd);
+  }};
+  if (::ftruncate(fd, static_cast<off_t>(size)) == -1) {
+    return -1;
+  }
+  auto* data
+    = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    return -1;
+  }
+  auto status = [&] {
+    auto out
+      = arrow::io::FixedSizeBufferWriter{std::make_shared<arrow::MutableBuffer>(
+        static_cast<uint8_t*>(data), static_cast<int64_t>(size))};
+    auto status = write_ipc(batch, out);
+    return status.ok() ? out.Close() : status;
+  }();
+  // The write seal requires that no writable mapping remains.
+  ::munmap(data, size);
+  if (not status.ok()) {
+    TENZIR_DEBUG("failed to write table slice to memory file: {}",
+                 status.ToString());
+    return -1;
+  }
+  if (::fcntl(fd, F_ADD_SEALS, required_seals | F_SEAL_SEAL) == -1) {
+    return -1;
+  }
+  close_fd.disable();
+  return fd;
+}
+
+/// Maps a memory file that the sender passed and reads the record batch from
+/// it. The Arrow buffers of the result point into the mapping.
+auto map_memory_file(int fd, id offset, time import_time)
+  -> caf::expected<table_slice> {
+  const auto close_fd = detail::scope_guard{[fd]() noexcept {
+    ::close(fd);
+  }};
+  const auto seals = ::fcntl(fd, F_GET_SEALS);
+  if (seals == -1 or (seals & required_seals) != required_seals) {
+    return caf::make_error(ec::system_error,
+                           "shared table slice is not sealed");
+  }
+  struct stat status {};
+  if (::fstat(fd, &status) == -1 or status.st_size <= 0) {
+    return caf::make_error(ec::system_error,
+                           fmt::format("failed to inspect shared table "
+                                       "slice: {}",
+                                       std::strerror(errno)));
+  }
+  const auto size = static_cast<size_t>(status.st_size);
+  auto* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    return caf::make_error(ec::system_error,
+                           fmt::format("failed to map shared table slice: {}",
+                                       std::strerror(errno)));
+  }
+  auto chunk = chunk::make(data, size, [data, size]() noexcept {
+    ::munmap(data, size);
+  });
+  auto input
+    = std::make_shared<arrow::io::BufferReader>(as_arrow_buffer(chunk));
+  auto reader = arrow::ipc::RecordBatchStreamReader::Open(input);
+  if (not reader.ok()) {
+    return caf::make_error(ec::parse_error,
+                           fmt::format("failed to read shared table slice: {}",
+                                       reader.status().ToString()));
+  }
+  auto batch = (*reader)->Next();
+  if (not batch.ok() or not *batch) {
+    return caf::make_error(ec::parse_error,
+                           fmt::format("failed to read shared table slice: {}",
+                                       batch.status().ToString()));
+  }
+  auto result = table_slice{*batch};
+  result.offset(offset);
+  result.import_time(import_time);
+  return result;
+}
+
+#endif
+
+} // namespace
+
+auto shared_table_slice::listen() -> void {
+#ifdef __linux__
+  receiver::instance().start();
+#endif
+}
+
+auto shared_table_slice::make(const table_slice& slice,
+                              const caf::node_id& sender,
+                              const caf::node_id& receiver)
+  -> std::optional<shared_table_slice> {
+#ifdef __linux__
+  const auto from = to_node_process(sender);
+  const auto to = to_node_process(receiver);
+  if (not from or not to or from->host != to->host or from->pid == to->pid) {
+    return std::nullopt;
+  }
+  // Measure the IPC stream first, so that we can write it into the memory
+  // file in one go.
+  const auto batch = to_record_batch(slice);
+  auto counter = arrow::io::MockOutputStream{};
+  if (not write_ipc(*batch, counter).ok()) {
+    return std::nullopt;
+  }
+  const auto size = static_cast<size_t>(counter.GetExtentBytesWritten());
+  if (size < min_shared_bytes) {
+    return std::nullopt;
+  }
+  const auto fd = make_memory_file(*batch, size);
+  if (fd == -1) {
+    TENZIR_DEBUG("failed to create memory file for table slice: {}",
+                 std::strerror(errno));
+    return std::nullopt;
+  }
+  auto result = shared_table_slice{};
+  result.token_ = uuid::random();
+  result.offset_ = slice.offset();
+  result.import_time_ = slice.import_time();
+  const auto sent = sender::instance().send(to->pid, result.token_, fd);
+  // The receiving process holds its own reference to the file now.
+  ::close(fd);
+  if (not sent) {
+    return std::nullopt;
+  }
+  return result;
+#else
+  (void)slice;
+  (void)sender;
+  (void)receiver;
+  return std::nullopt;
+#endif
+}
+
+auto shared_table_slice::try_take() const
+  -> std::optional<caf::expected<table_slice>> {
+#ifdef __linux__
+  auto fd = receiver::instance().try_take(token_);
+  if (not fd) {
+    return std::nullopt;
+  }
+  return map_memory_file(*fd, offset_, import_time_);
+#else
+  return caf::make_error(ec::unimplemented,
+                         "shared table slices require Linux");
+#endif
+}
+
+auto shared_table_slice::take() && -> caf::expected<table_slice> {
+#ifdef __linux__
+  auto fd = receiver::instance().take(token_);
+  if (not fd) {
+    return std::move(fd.error());
+  }
+  return map_memory_file(*fd, offset_, import_time_);
+#else
+  return caf::make_error(ec::unimplemented,
+                         "shared table slices require Linux");
+#endif
+}
+
+} // namespace tenzir
@@ -0,0 +1,193 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/spill_file.hpp"
+
+#include "tenzir/arrow_table_slice.hpp"
+#include "tenzir/as_bytes.hpp"
+#include "tenzir/detail/assert.hpp"
+#include "tenzir/detail/narrow.hpp"
+#include "tenzir/detail/posix.hpp"
+#include "tenzir/error.hpp"
+#include "tenzir/logger.hpp"
+
+#include <caf/settings.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include <unistd.h>
+
+namespace tenzir {
+
+namespace {
+
+/// The fixed-size header in front of every record of a spill file.
+struct record_header {
+  uint64_t compressed_size = {};
+  uint64_t decompressed_size = {};
+};
+
+} // namespace
+
+auto spill_directory(const caf::settings& cfg) -> std::filesystem::path {
+  if (const auto* cache_dir
+      = get_if<std::string>(&cfg, "tenzir.cache-directory")) {
+    return std::filesystem::path{*cache_dir} / "spill";
+  }
+  return std::filesystem::temp_directory_path() / "tenzir" / "spill";
+}
+
+SpillFile::Reader::Reader(std::filesystem::path path)
+  : file_{std::make_unique<file>(std::move(path))} {
+}
+
+auto SpillFile::Reader::next() -> caf::expected<chunk_ptr> {
+  TENZIR_ASSERT(file_);
+  auto header = record_header{};
+  auto read = file_->read(&header, sizeof(header));
+  if (not read) {
+    return std::move(read.error());
+  }
+  if (*read == 0) {
+    return chunk_ptr{};
+  }
+  if (*read != sizeof(header)) {
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("truncated record header in spill file "
+                                       "{}",
+                                       file_->path()));
+  }
+  auto buffer = std::vector<std::byte>{};
+  buffer.resize(detail::narrow<size_t>(header.compressed_size));
+  read = file_->read(buffer.data(), buffer.size());
+  if (not read) {
+    return std::move(read.error());
+  }
+  if (*read != buffer.size()) {
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("truncated record in spill file {}",
+                                       file_->path()));
+  }
+  return chunk::decompress(as_bytes(buffer),
+                           detail::narrow<size_t>(header.decompressed_size));
+}
+
+auto SpillFile::Reader::next_slice() -> caf::expected<table_slice> {
+  auto chunk = next();
+  if (not chunk) {
+    return std::move(chunk.error());
+  }
+  if (not *chunk) {
+    return table_slice{};
+  }
+  return table_slice{std::move(*chunk), table_slice::verify::no};
+}
+
+SpillFile::state::state(std::filesystem::path path)
+  : path{std::move(path)}, writer{this->path} {
+}
+
+SpillFile::state::~state() noexcept {
+  writer.close();
+  auto ec = std::error_code{};
+  std::filesystem::remove(path, ec);
+  if (ec) {
+    TENZIR_WARN("failed to remove spill file {}: {}", path, ec.message());
+  }
+}
+
+SpillFile::SpillFile(std::unique_ptr<state> state) : state_{std::move(state)} {
+}
+
+SpillFile::~SpillFile() noexcept = default;
+
+auto SpillFile::make(const std::filesystem::path& directory)
+  -> caf::expected<SpillFile> {
+  auto ec = std::error_code{};
+  std::filesystem::create_directories(directory, ec);
+  if (ec) {
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("failed to create spill directory {}: "
+                                       "{}",
+                                       directory, ec.message()));
+  }
+  // We use mkstemp(3) only to reserve a unique file name, and then reopen the
+  // file through our own file abstraction.
+  auto path = (directory / "spill-XXXXXX").string();
+  auto fd = ::mkstemp(path.data());
+  if (fd == -1) {
+    return caf::make_error(ec::filesystem_error,
+                           fmt::format("failed to create spill file in {}: {}",
+                                       directory, detail::describe_errno()));
+  }
+  ::close(fd);
+  auto result = std::make_unique<state>(std::move(path));
+  if (auto opened = result->writer.open(file::write_only, true); not opened) {
+    return std::move(opened.error());
+  }
+  return SpillFile{std::move(result)};
+}
+
+auto SpillFile::write(std::span<const std::byte> bytes) -> caf::error {
+  TENZIR_ASSERT(state_);
+  auto compressed = chunk::compress(bytes);
+  if (not compressed) {
+    return std::move(compressed.error());
+  }
+  const auto header = record_header{
+    .compressed_size = (*compressed)->size(),
+    .decompressed_size = bytes.size(),
+  };
+  if (auto err = state_->writer.write(&header, sizeof(header))) {
+    return err;
+  }
+  if (auto err
+      = state_->writer.write((*compressed)->data(), (*compressed)->size())) {
+    return err;
+  }
+  state_->records += 1;
+  state_->bytes += sizeof(header) + (*compressed)->size();
+  return {};
+}
+
+auto SpillFile::write(const table_slice& slice) -> caf::error {
+  if (slice.is_serialized()) {
+    return write(as_bytes(slice));
+  }
+  auto serialized = table_slice{to_record_batch(slice), slice.schema(),
+                                table_slice::serialize::yes};
+  serialized.import_time(slice.import_time());
+  return write(as_bytes(serialized));
+}
+
+auto SpillFile::read() const -> caf::expected<Reader> {
+  TENZIR_ASSERT(state_);
+  auto result = Reader{state_->path};
+  if (auto opened = result.file_->open(file::read_only); not opened) {
+    return std::move(opened.error());
+  }
+  return result;
+}
+
+auto SpillFile::records() const -> uint64_t {
+  TENZIR_ASSERT(state_);
+  return state_->records;
+}
+
+auto SpillFile::bytes() const -> uint64_t {
+  TENZIR_ASSERT(state_);
+  return state_->bytes;
+}
+
+auto SpillFile::path() const -> const std::filesystem::path& {
+  TENZIR_ASSERT(state_);
+  return state_->path;
+}
+
+} // namespace tenzir
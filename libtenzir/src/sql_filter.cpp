@@ -0,0 +1,295 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/sql_filter.hpp"
+
+#include "tenzir/expression.hpp"
+#include "tenzir/tql2/ast.hpp"
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include <cmath>
+#include <optional>
+
+namespace tenzir {
+
+namespace {
+
+/// A translated part of a filter.
+struct translation {
+  std::string sql;
+  /// Whether the SQL condition is true for exactly the rows for which the
+  /// expression is true. Otherwise, it is true for a superset of them.
+  bool exact = false;
+  /// Whether the expression is never null, which makes the negation of an
+  /// exact translation exact as well.
+  bool total = false;
+};
+
+auto quote_identifier(std::string_view name) -> std::optional<std::string> {
+  // We only reference columns whose names need no escaping.
+  for (auto c : name) {
+    if (c == '`' or c == '\\' or static_cast<unsigned char>(c) < 0x20) {
+      return std::nullopt;
+    }
+  }
+  return fmt::format("`{}`", name);
+}
+
+/// Formats a constant as a SQL literal if it is of the given kind.
+auto make_literal(const data& value, sql_column_kind kind)
+  -> std::optional<std::string> {
+  switch (kind) {
+    case sql_column_kind::integer:
+      if (const auto* x = try_as<int64_t>(&value)) {
+        return fmt::format("{}", *x);
+      }
+      if (const auto* x = try_as<uint64_t>(&value)) {
+        return fmt::format("{}", *x);
+      }
+      return std::nullopt;
+    case sql_column_kind::floating_point:
+      if (const auto* x = try_as<double>(&value); x and std::isfinite(*x)) {
+        // The exponent makes this a floating-point literal in MySQL, which
+        // would otherwise parse it as a decimal.
+        return fmt::format("{:.17e}", *x);
+      }
+      return std::nullopt;
+    case sql_column_kind::string:
+      if (const auto* x = try_as<std::string>(&value)) {
+        // A backslash is an escape character unless MySQL runs with
+        // `NO_BACKSLASH_ESCAPES`, so we cannot quote it reliably.
+        if (x->find('\\') != std::string::npos
+            or x->find('\0') != std::string::npos) {
+          return std::nullopt;
+        }
+        auto result = std::string{"'"};
+        for (auto c : *x) {
+          if (c == '\'') {
+            result += '\'';
+          }
+          result += c;
+        }
+        result += '\'';
+        return result;
+      }
+      return std::nullopt;
+  }
+  TENZIR_UNREACHABLE();
+}
+
+class translator {
+public:
+  translator(const sql_columns& columns, const sql_dialect& dialect)
+    : columns_{columns}, dialect_{dialect} {
+  }
+
+  auto translate(const expression& expr) const -> std::optional<translation> {
+    return match(
+      expr,
+      [](caf::none_t) -> std::optional<translation> {
+        return std::nullopt;
+      },
+      [&](const conjunction& x) -> std::optional<translation> {
+        // Dropping a part of a conjunction still yields a superset.
+        auto parts = std::vector<std::string>{};
+        auto result = translation{.exact = true, .total = true};
+        for (const auto& operand : x) {
+          auto part = translate(operand);
+          if (not part) {
+            result.exact = false;
+            result.total = false;
+            continue;
+          }
+          parts.push_back(fmt::format("({})", part->sql));
+          result.exact &= part->exact;
+          result.total &= part->total;
+        }
+        if (parts.empty()) {
+          return std::nullopt;
+        }
+        result.sql = fmt::format("{}", fmt::join(parts, " AND "));
+        return result;
+      },
+      [&](const disjunction& x) -> std::optional<translation> {
+        auto parts = std::vector<std::string>{};
+        auto result = translation{.exact = true, .total = true};
+        for (const auto& operand : x) {
+          auto part = translate(operand);
+          if (not part) {
+            return std::nullopt;
+          }
+          parts.push_back(fmt::format("({})", part->sql));
+          result.exact &= part->exact;
+          result.total &= part->total;
+        }
+        if (parts.empty()) {
+          return std::nullopt;
+        }
+        result.sql = fmt::format("{}", fmt::join(parts, " OR "));
+        return result;
+      },
+      [&](const negation& x) -> std::optional<translation> {
+        // `not null` is null in TQL, so we can only negate conditions that
+        // are exact and never null.
+        auto inner = translate(x.expr());
+        if (not inner or not inner->exact or not inner->total) {
+          return std::nullopt;
+        }
+        return translation{
+          .sql = fmt::format("NOT ({})", inner->sql),
+          .exact = true,
+          .total = true,
+        };
+      },
+      [&](const predicate& x) -> std::optional<translation> {
+        return translate(x);
+      });
+  }
+
+private:
+  auto translate(const predicate& pred) const -> std::optional<translation> {
+    const auto* field = try_as<field_extractor>(&pred.lhs);
+    const auto* value = try_as<data>(&pred.rhs);
+    auto op = pred.op;
+    if (not field or not value) {
+      field = try_as<field_extractor>(&pred.rhs);
+      value = try_as<data>(&pred.lhs);
+      op = flip(op);
+    }
+    if (not field or not value) {
+      return std::nullopt;
+    }
+    const auto column = columns_.find(field->field);
+    if (column == columns_.end()) {
+      return std::nullopt;
+    }
+    auto name = quote_identifier(column->first);
+    if (not name) {
+      return std::nullopt;
+    }
+    const auto kind = column->second;
+    // Comparisons with null are the only ones that SQL and TQL agree on for
+    // every type.
+    if (is<caf::none_t>(*value)) {
+      switch (op) {
+        case relational_operator::equal:
+          return translation{fmt::format("{} IS NULL", *name), true, true};
+        case relational_operator::not_equal:
+          return translation{fmt::format("{} IS NOT NULL", *name), true, true};
+        default:
+          return std::nullopt;
+      }
+    }
+    const auto collated = kind == sql_column_kind::string
+                          and not dialect_.binary_strings;
+    if (op == relational_operator::in or op == relational_operator::not_in) {
+      const auto* xs = try_as<list>(value);
+      if (not xs or xs->empty()
+          or (collated and op != relational_operator::in)) {
+        return std::nullopt;
+      }
+      auto literals = std::vector<std::string>{};
+      for (const auto& x : *xs) {
+        auto literal = make_literal(x, kind);
+        if (not literal) {
+          return std::nullopt;
+        }
+        literals.push_back(std::move(*literal));
+      }
+      // We do not know whether `null in [...]` is false or null, and what
+      // this means for `not in`.
+      if (op == relational_operator::in) {
+        return translation{
+          fmt::format("COALESCE({} IN ({}), FALSE)", *name,
+                      fmt::join(literals, ", ")),
+          not collated,
+          false,
+        };
+      }
+      return translation{
+        fmt::format("COALESCE({} NOT IN ({}), TRUE)", *name,
+                    fmt::join(literals, ", ")),
+        false,
+        false,
+      };
+    }
+    auto literal = make_literal(*value, kind);
+    if (not literal) {
+      return std::nullopt;
+    }
+    // The result of the comparison if the column is null, and the SQL
+    // operator.
+    auto null_result = std::string_view{"FALSE"};
+    auto sql_op = std::string_view{};
+    switch (op) {
+      case relational_operator::equal:
+        sql_op = "=";
+        break;
+      case relational_operator::not_equal:
+        sql_op = "<>";
+        null_result = "TRUE";
+        break;
+      case relational_operator::less:
+        sql_op = "<";
+        break;
+      case relational_operator::less_equal:
+        sql_op = "<=";
+        break;
+      case relational_operator::greater:
+        sql_op = ">";
+        break;
+      case relational_operator::greater_equal:
+        sql_op = ">=";
+        break;
+      default:
+        return std::nullopt;
+    }
+    // With a collation, strings that differ in TQL may compare equal in SQL.
+    // This makes equality a superset, but breaks every other comparison.
+    if (collated and op != relational_operator::equal) {
+      return std::nullopt;
+    }
+    const auto total = op == relational_operator::equal
+                       or op == relational_operator::not_equal;
+    return translation{
+      fmt::format("COALESCE({} {} {}, {})", *name, sql_op, *literal,
+                  null_result),
+      not collated,
+      total,
+    };
+  }
+
+  const sql_columns& columns_;
+  const sql_dialect& dialect_;
+};
+
+} // namespace
+
+auto make_sql_filter(const ir::optimize_filter& filter,
+                     const sql_columns& columns, const sql_dialect& dialect)
+  -> sql_filter {
+  auto result = sql_filter{};
+  auto parts = std::vector<std::string>{};
+  const auto t = translator{columns, dialect};
+  for (const auto& expr : filter) {
+    auto [legacy, remainder] = split_legacy_expression(expr);
+    auto translated = t.translate(legacy);
+    if (not translated) {
+      result.exact = false;
+      continue;
+    }
+    parts.push_back(fmt::format("({})", translated->sql));
+    result.exact &= translated->exact and is_true_literal(remainder);
+  }
+  result.condition = fmt::format("{}", fmt::join(parts, " AND "));
+  return result;
+}
+
+} // namespace tenzir
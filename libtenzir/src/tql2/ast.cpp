@@ -10,6 +10,8 @@
 
 #include "tenzir/compile_ctx.hpp"
 #include "tenzir/concept/parseable/string/char_class.hpp"
+#include "tenzir/concept/parseable/tenzir/subnet.hpp"
+#include "tenzir/concept/parseable/to.hpp"
 #include "tenzir/detail/assert.hpp"
 #include "tenzir/expression.hpp"
 #include "tenzir/substitute_ctx.hpp"
@@ -450,6 +452,67 @@ auto optimize_now(const ast::expression& left, const relational_operator& rop,
   return std::nullopt;
 }
 
+/// Returns a legacy expression that holds for every event where a call to one
+/// of the builtin predicate functions returns `true`, which allows the catalog
+/// to skip partitions without evaluating the call.
+auto imply_function_call(const ast::function_call& x)
+  -> std::optional<expression> {
+  if (x.fn.path.size() != 1 or x.args.empty()) {
+    return std::nullopt;
+  }
+  const auto& name = x.fn.path[0].name;
+  auto field = to_field_extractor(x.args[0]);
+  if (not field) {
+    return std::nullopt;
+  }
+  // IPv4 addresses are stored as IPv4-mapped IPv6 addresses, so these subnets
+  // match the definitions in `ip.cpp` exactly.
+  auto in_subnets = [&](std::initializer_list<std::string_view> subnets) {
+    auto result = disjunction{};
+    for (auto subnet_str : subnets) {
+      auto sn = to<subnet>(subnet_str);
+      TENZIR_ASSERT(sn);
+      result.emplace_back(
+        predicate{*field, relational_operator::in, data{*sn}});
+    }
+    return result.size() == 1 ? std::move(result[0])
+                              : expression{std::move(result)};
+  };
+  if (x.args.size() == 1) {
+    if (name == "is_v4") {
+      return in_subnets({"::ffff:0.0.0.0/96"});
+    }
+    if (name == "is_private") {
+      return in_subnets(
+        {"10.0.0.0/8", "172.16.0.0/12", "192.168.0.0/16", "fc00::/7"});
+    }
+    if (name == "is_loopback") {
+      return in_subnets({"127.0.0.0/8", "::1/128"});
+    }
+    if (name == "is_link_local") {
+      return in_subnets({"169.254.0.0/16", "fe80::/10"});
+    }
+    if (name == "is_multicast") {
+      return in_subnets({"224.0.0.0/4", "ff00::/8"});
+    }
+    return std::nullopt;
+  }
+  if (x.args.size() == 2 and (name == "starts_with" or name == "ends_with")) {
+    // An affix is in particular a substring, which the catalog can at least
+    // check against the type of the field.
+    const auto* affix = try_as<ast::constant>(x.args[1]);
+    if (not affix) {
+      return std::nullopt;
+    }
+    const auto* str = try_as<std::string>(affix->value);
+    if (not str) {
+      return std::nullopt;
+    }
+    return expression{predicate{*field, relational_operator::ni, data{*str}}};
+  }
+  return std::nullopt;
+}
+
 } // namespace
 
 auto is_true_literal(const ast::expression& y) -> bool {
@@ -566,6 +629,12 @@ auto split_legacy_expression(const ast::expression& x)
         if (is_true_literal(ln) and is_true_literal(rn)) {
           return std::pair{expression{disjunction{lo, ro}}, std::move(ln)};
         }
+        // Otherwise, `lo or ro` still holds for every matching event, so we
+        // can use it for pruning as long as we keep the entire expression.
+        if (lo != trivially_true_expression()
+            and ro != trivially_true_expression()) {
+          return std::pair{expression{disjunction{lo, ro}}, x};
+        }
       }
       return std::pair{trivially_true_expression(), x};
     },
@@ -586,6 +655,14 @@ auto split_legacy_expression(const ast::expression& x)
       }
       return std::pair{trivially_true_expression(), x};
     },
+    [&](const ast::function_call& y) {
+      if (auto implied = imply_function_call(y)) {
+        if (auto normalized = normalize_and_validate(std::move(*implied))) {
+          return std::pair{std::move(*normalized), x};
+        }
+      }
+      return std::pair{trivially_true_expression(), x};
+    },
     [&](const auto&) {
       if (auto field = to_field_extractor(x)) {
         return std::pair{
@@ -9,10 +9,12 @@
 #include "tenzir/tql2/exec.hpp"
 
 #include "tenzir/arc.hpp"
+#include "tenzir/async/blocking_executor.hpp"
 #include "tenzir/async/executor.hpp"
 #include "tenzir/async/fused.hpp"
 #include "tenzir/async/mutex.hpp"
 #include "tenzir/atomic.hpp"
+#include "tenzir/checkpoint_store.hpp"
 #include "tenzir/co_match.hpp"
 #include "tenzir/compile_ctx.hpp"
 #include "tenzir/configuration.hpp"
@@ -988,17 +990,32 @@ auto build_profiler_snapshot(std::span<ChannelProfile const> channel_profiles,
                              std::unordered_map<OpId, OpSnapshot>& prev)
   -> ProfilerSnapshot;
 
+/// Returns the key under which the snapshot of an operator is stored.
+///
+/// Operator ids start with the id of the top-level pipeline, which is assigned
+/// anew in every run, so we strip it for restarts to find their snapshots.
+auto checkpoint_key(OpId const& id) -> std::string_view {
+  auto const slash = id.value.find('/');
+  TENZIR_ASSERT(slash != std::string::npos);
+  return std::string_view{id.value}.substr(slash + 1);
+}
+
 class TestExecCtx final : public ExecCtx {
 public:
   explicit TestExecCtx(Profiler const& profiler, bool has_terminal = false,
-                       bool is_hidden = false)
+                       bool is_hidden = false,
+                       Option<CheckpointSettings> checkpoint_settings = None{},
+                       CheckpointStore* checkpoints = nullptr)
     : profiling_{not is<NoProfiler>(profiler)},
       record_backpressure_{is<PerfettoProfiler>(profiler)},
       metrics_receiver_{try_as<NodeProfiler>(profiler)
                           ? try_as<NodeProfiler>(profiler)->metrics
                           : metrics_receiver_actor{}},
       has_terminal_{has_terminal},
-      is_hidden_{is_hidden} {
+      is_hidden_{is_hidden},
+      checkpoint_settings_{std::move(checkpoint_settings)},
+      checkpoints_{checkpoints} {
+    TENZIR_ASSERT(checkpoint_settings_.is_none() or checkpoints_);
   }
 
   /// Return the current set of channel profiles.
@@ -1065,8 +1082,35 @@ public:
 
   auto checkpoint_settings() const
     -> Option<CheckpointSettings const&> override {
-    // No checkpointing for now.
-    return None{};
+    if (not checkpoint_settings_) {
+      return None{};
+    }
+    return *checkpoint_settings_;
+  }
+
+  auto save_checkpoint(OpId id, uuid checkpoint, chunk_ptr chunk)
+    -> Task<caf::error> override {
+    TENZIR_ASSERT(checkpoints_);
+    co_return co_await spawn_blocking([&] {
+      return checkpoints_->save(checkpoint, checkpoint_key(id),
+                                as_bytes(chunk));
+    });
+  }
+
+  auto load_checkpoint(OpId id) -> Task<caf::expected<chunk_ptr>> override {
+    if (not checkpoints_) {
+      co_return chunk_ptr{};
+    }
+    co_return co_await spawn_blocking([&] {
+      return checkpoints_->load(checkpoint_key(id));
+    });
+  }
+
+  auto commit_checkpoint(uuid checkpoint) -> Task<caf::error> override {
+    TENZIR_ASSERT(checkpoints_);
+    co_return co_await spawn_blocking([&] {
+      return checkpoints_->commit(checkpoint);
+    });
   }
 
 protected:
@@ -1199,6 +1243,8 @@ private:
   metrics_receiver_actor metrics_receiver_;
   bool has_terminal_;
   bool is_hidden_;
+  Option<CheckpointSettings> checkpoint_settings_;
+  CheckpointStore* checkpoints_;
   std::mutex mutex_;
   std::vector<ChannelProfile> channels_;
   std::vector<ExecutorProfile> executors_;
@@ -2066,10 +2112,14 @@ auto run_profiler(Profiler const& profiler, TestExecCtx& exec_ctx,
 
 auto run_plan(OperatorChain<void, void> chain, caf::actor_system& sys,
               DiagHandler& dh, Profiler profiler, bool has_terminal,
-              bool is_hidden, Notify* graceful_stop) -> Task<failure_or<void>> {
+              bool is_hidden, Notify* graceful_stop,
+              Option<CheckpointSettings> checkpoint_settings = None{},
+              CheckpointStore* checkpoints = nullptr)
+  -> Task<failure_or<void>> {
   auto num_ops = chain.size();
   LOGW("spawning plan with {} operators", num_ops);
-  auto exec_ctx = TestExecCtx{profiler, has_terminal, is_hidden};
+  auto exec_ctx = TestExecCtx{profiler, has_terminal, is_hidden,
+                              std::move(checkpoint_settings), checkpoints};
   co_await async_scope([&](AsyncScope& scope) -> Task<void> {
     scope.spawn(run_profiler(profiler, exec_ctx, num_ops));
     LOGW("blocking on pipeline");
@@ -2140,12 +2190,41 @@ private:
 };
 
 auto run_plan_blocking(OperatorChain<void, void> chain, caf::actor_system& sys,
-                       diagnostic_handler& dh,
-                       std::optional<std::string> const& profile_path)
+                       diagnostic_handler& dh, exec_config const& cfg)
   -> failure_or<void> {
   auto profiler = Profiler{};
-  if (profile_path) {
-    profiler = PerfettoProfiler{*profile_path};
+  if (cfg.profile) {
+    profiler = PerfettoProfiler{*cfg.profile};
+  }
+  auto checkpoint_settings = Option<CheckpointSettings>{};
+  auto checkpoints = Option<CheckpointStore>{};
+  if (cfg.checkpoint_interval) {
+    // Restoring operator state without the read position of the source would
+    // replay input into state that already accounts for it.
+    TENZIR_ASSERT(chain.size() > 0);
+    auto const& source
+      = match(chain[0], [](auto const& op) -> OperatorBase const& {
+          return *op;
+        });
+    if (not source.resumable()) {
+      diagnostic::error("`{}` cannot resume from a checkpoint", source.name())
+        .note("`--checkpoint-interval` requires a source that persists its "
+              "read position")
+        .emit(dh);
+      return failure::promise();
+    }
+    auto store = CheckpointStore::make(cfg.checkpoint_directory);
+    if (not store) {
+      diagnostic::error(store.error())
+        .note("failed to open checkpoints in `{}`", cfg.checkpoint_directory)
+        .emit(dh);
+      return failure::promise();
+    }
+    if (auto restored = store->restored()) {
+      TENZIR_VERBOSE("resuming pipeline from checkpoint {}", *restored);
+    }
+    checkpoints = std::move(*store);
+    checkpoint_settings = CheckpointSettings{*cfg.checkpoint_interval, false};
   }
   auto cancel_source = folly::CancellationSource{};
   auto diag_handler = ExecDiagHandler{dh, cancel_source};
@@ -2164,7 +2243,9 @@ auto run_plan_blocking(OperatorChain<void, void> chain, caf::actor_system& sys,
     co_return co_await catch_cancellation(folly::coro::co_withCancellation(
       cancel_source.getToken(),
       run_plan(std::move(chain), sys, diag_handler, std::move(profiler),
-               has_terminal, false, &graceful_stop)));
+               has_terminal, false, &graceful_stop,
+               std::move(checkpoint_settings),
+               checkpoints ? &*checkpoints : nullptr)));
   });
 #if 0
   TENZIR_DEBUG("running pipeline on a single thread");
@@ -2189,6 +2270,13 @@ auto run_plan_blocking(OperatorChain<void, void> chain, caf::actor_system& sys,
   if (result->is_error()) {
     panic("got failure from run_plan but not in diagnostic handler");
   }
+  // The pipeline ran to completion, so restarting it must not resume from its
+  // last checkpoint.
+  if (checkpoints) {
+    if (auto err = checkpoints->clear()) {
+      diagnostic::warning(err).note("failed to remove checkpoints").emit(dh);
+    }
+  }
   return {};
 }
 
@@ -2373,7 +2461,7 @@ auto exec_with_ir(ast::pipeline ast, const exec_config& cfg, session ctx,
   auto chain = OperatorChain<void, void>::try_from(std::move(spawned))
                  .expect("we already checked the type");
   // Start the actual execution.
-  TRY(run_plan_blocking(std::move(chain), sys, ctx, cfg.profile));
+  TRY(run_plan_blocking(std::move(chain), sys, ctx, cfg));
   return true;
 }
 
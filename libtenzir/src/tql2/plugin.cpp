@@ -48,6 +48,13 @@ auto function_use::evaluator::operator()(const ast::lambda_expr& expr,
     .eval(expr, input);
 }
 
+auto aggregation_plugin::make_grouped_aggregation(function_invocation inv,
+                                                  session ctx) const
+  -> failure_or<std::unique_ptr<grouped_aggregation_instance>> {
+  TENZIR_UNUSED(inv, ctx);
+  return std::unique_ptr<grouped_aggregation_instance>{};
+}
+
 auto aggregation_plugin::make_function(function_invocation inv,
                                        session ctx) const
   -> failure_or<function_ptr> {
@@ -0,0 +1,199 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/catalog.hpp"
+
+#include "tenzir/index_config.hpp"
+#include "tenzir/partition_synopsis.hpp"
+#include "tenzir/series_builder.hpp"
+#include "tenzir/synopsis.hpp"
+#include "tenzir/synopsis_factory.hpp"
+#include "tenzir/test/test.hpp"
+#include "tenzir/time_synopsis.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace tenzir;
+
+namespace {
+
+const auto epoch = time{};
+
+/// Creates the synopsis of a partition with random values in random ranges.
+/// With `nan`, the `d` column contains a NaN, so that the range index cannot
+/// order its range.
+auto make_partition(std::mt19937_64& rng, bool nan = false)
+  -> partition_synopsis_ptr {
+  auto uniform = [&](int64_t lo, int64_t hi) {
+    return std::uniform_int_distribution<int64_t>{lo, hi}(rng);
+  };
+  const auto x0 = uniform(-1'000, 1'000);
+  const auto t0 = uniform(0, 10'000);
+  auto b = series_builder{};
+  for (auto row = 0; row < 4; ++row) {
+    auto event = b.record();
+    event.field("x").data(x0 + uniform(0, 100));
+    event.field("t").data(epoch + std::chrono::seconds{t0 + uniform(0, 500)});
+    auto d = static_cast<double>(uniform(-500, 500)) / 4;
+    if (nan and row == 0) {
+      d = std::numeric_limits<double>::quiet_NaN();
+    }
+    event.field("d").data(d);
+  }
+  auto slice = b.finish_assert_one_slice("test");
+  auto result = caf::make_copy_on_write<partition_synopsis>();
+  auto& synopsis = result.unshared();
+  synopsis.add(slice, 1'000, index_config{});
+  synopsis.shrink();
+  synopsis.events = slice.rows();
+  const auto imported = epoch + std::chrono::seconds{uniform(0, 10'000)};
+  synopsis.min_import_time = imported;
+  synopsis.max_import_time = imported + std::chrono::seconds{uniform(0, 600)};
+  return result;
+}
+
+auto ids_of(const catalog_lookup_result::candidate_info& info)
+  -> std::vector<uuid> {
+  auto result = std::vector<uuid>{};
+  for (const auto& partition : info.partition_infos) {
+    result.push_back(partition.uuid);
+  }
+  return result;
+}
+
+/// Selects the candidates of a predicate on a field by looking at the synopsis
+/// of every partition, which is what the catalog did before it had a range
+/// index.
+auto synopsis_lookup(const catalog_state& state, const type& schema,
+                     std::string_view name, relational_operator op,
+                     const data& rhs) -> std::vector<uuid> {
+  auto result = std::vector<uuid>{};
+  for (const auto& [id, partition] : state.synopses_per_type.at(schema)) {
+    for (const auto& [field, field_synopsis] : partition->field_synopses_) {
+      if (field.field_name() != name) {
+        continue;
+      }
+      auto selected = true;
+      if (field_synopsis) {
+        selected = field_synopsis->lookup(op, make_view(rhs)).value_or(true);
+      } else if (auto it = partition->type_synopses_.find(field.type());
+                 it != partition->type_synopses_.end() and it->second) {
+        selected = it->second->lookup(op, make_view(rhs)).value_or(true);
+      }
+      if (selected) {
+        result.push_back(id);
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+auto import_time_lookup(const catalog_state& state, const type& schema,
+                        relational_operator op, time rhs)
+  -> std::vector<uuid> {
+  auto result = std::vector<uuid>{};
+  for (const auto& [id, partition] : state.synopses_per_type.at(schema)) {
+    auto synopsis
+      = time_synopsis{partition->min_import_time, partition->max_import_time};
+    if (synopsis.lookup(op, rhs).value_or(true)) {
+      result.push_back(id);
+    }
+  }
+  return result;
+}
+
+/// Compares the lookups of the catalog with the synopsis lookups for a range
+/// of predicates on every field and the import time.
+auto check_lookups(const catalog_state& state, const type& schema,
+                   std::mt19937_64& rng) -> void {
+  const auto ops = std::vector<relational_operator>{
+    relational_operator::less,          relational_operator::less_equal,
+    relational_operator::greater,       relational_operator::greater_equal,
+    relational_operator::equal,         relational_operator::not_equal,
+  };
+  auto uniform = [&](int64_t lo, int64_t hi) {
+    return std::uniform_int_distribution<int64_t>{lo, hi}(rng);
+  };
+  auto check_field = [&](std::string_view name, relational_operator op,
+                         const data& rhs) {
+    auto expr = expression{
+      predicate{field_extractor{std::string{name}}, op, rhs},
+    };
+    auto actual = ids_of(state.lookup_impl(expr, schema));
+    auto expected = synopsis_lookup(state, schema, name, op, rhs);
+    if (actual != expected) {
+      MESSAGE("mismatch for {}", expr);
+    }
+    CHECK(actual == expected);
+  };
+  for (auto i = 0; i < 20; ++i) {
+    for (auto op : ops) {
+      check_field("x", op, data{uniform(-1'200, 1'200)});
+      check_field("t", op,
+                  data{epoch + std::chrono::seconds{uniform(0, 11'000)}});
+      check_field("d", op, data{static_cast<double>(uniform(-600, 600)) / 4});
+      const auto imported = epoch + std::chrono::seconds{uniform(0, 11'000)};
+      auto expr = expression{
+        predicate{meta_extractor{meta_extractor::import_time}, op,
+                  data{imported}},
+      };
+      CHECK(ids_of(state.lookup_impl(expr, schema))
+            == import_time_lookup(state, schema, op, imported));
+    }
+    auto values = list{};
+    for (auto j = 0; j < 3; ++j) {
+      values.emplace_back(uniform(-1'200, 1'200));
+    }
+    check_field("x", relational_operator::in, data{std::move(values)});
+  }
+}
+
+} // namespace
+
+TEST("range index lookups match the synopsis lookups") {
+  factory<synopsis>::initialize();
+  auto rng = std::mt19937_64{42};
+  auto state = catalog_state{};
+  auto partitions = std::vector<partition_synopsis_pair>{};
+  for (auto i = size_t{0}; i < 300; ++i) {
+    partitions.push_back({uuid::random(), make_partition(rng)});
+  }
+  const auto schema = partitions.front().synopsis->schema;
+  auto ids = std::vector<uuid>{};
+  for (const auto& partition : partitions) {
+    ids.push_back(partition.uuid);
+  }
+  // Merge in several batches so that some intervals are still buffered in the
+  // range index while others are already sorted.
+  for (auto first = size_t{0}; first < partitions.size(); first += 70) {
+    const auto last = std::min(first + 70, partitions.size());
+    auto batch = std::vector<partition_synopsis_pair>(
+      partitions.begin() + first, partitions.begin() + last);
+    state.merge(std::move(batch));
+    MESSAGE("check lookups after merging {} partitions", last);
+    check_lookups(state, schema, rng);
+  }
+  MESSAGE("check lookups after erasing partitions");
+  std::ranges::shuffle(ids, rng);
+  for (auto i = size_t{0}; i < 120; ++i) {
+    state.erase(ids[i]);
+  }
+  check_lookups(state, schema, rng);
+  MESSAGE("check lookups after replacing partition synopses, some of which "
+          "fall back to the synopsis lookups");
+  auto replaced = std::vector<partition_synopsis_pair>{};
+  for (auto i = size_t{100}; i < 160; ++i) {
+    replaced.push_back({ids[i], make_partition(rng, i % 10 == 0)});
+  }
+  state.merge(std::move(replaced));
+  check_lookups(state, schema, rng);
+}
@@ -0,0 +1,118 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/checkpoint_store.hpp"
+
+#include "tenzir/test/fixtures/filesystem.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <string_view>
+
+using namespace tenzir;
+
+namespace {
+
+struct fixture : public fixtures::filesystem {
+  fixture() : fixtures::filesystem(TENZIR_PP_STRINGIFY(CAF_TEST_SUITE_NAME)) {
+  }
+};
+
+auto load_string(const CheckpointStore& store, std::string_view key)
+  -> std::string {
+  auto chunk = unbox(store.load(key));
+  if (not chunk) {
+    return {};
+  }
+  return std::string{reinterpret_cast<const char*>(chunk->data()),
+                     chunk->size()};
+}
+
+} // namespace
+
+WITH_FIXTURE(fixture) {
+  TEST("empty store restores nothing") {
+    auto store = unbox(CheckpointStore::make(directory / "empty"));
+    CHECK(not store.restored());
+    CHECK_EQUAL(unbox(store.load("0")), nullptr);
+  }
+
+  TEST("committed checkpoints are restored") {
+    const auto path = directory / "committed";
+    const auto first = uuid::random();
+    {
+      auto store = unbox(CheckpointStore::make(path));
+      REQUIRE_EQUAL(store.save(first, "0", as_bytes(std::string_view{"foo"})),
+                    caf::none);
+      REQUIRE_EQUAL(
+        store.save(first, "1-0/0", as_bytes(std::string_view{"bar"})),
+        caf::none);
+      REQUIRE_EQUAL(store.commit(first), caf::none);
+    }
+    auto store = unbox(CheckpointStore::make(path));
+    REQUIRE(store.restored());
+    CHECK_EQUAL(*store.restored(), first);
+    CHECK_EQUAL(load_string(store, "0"), "foo");
+    CHECK_EQUAL(load_string(store, "1-0/0"), "bar");
+    CHECK_EQUAL(unbox(store.load("2")), nullptr);
+  }
+
+  TEST("uncommitted checkpoints are discarded") {
+    const auto path = directory / "uncommitted";
+    const auto first = uuid::random();
+    const auto second = uuid::random();
+    {
+      auto store = unbox(CheckpointStore::make(path));
+      REQUIRE_EQUAL(store.save(first, "0", as_bytes(std::string_view{"foo"})),
+                    caf::none);
+      REQUIRE_EQUAL(store.commit(first), caf::none);
+      REQUIRE_EQUAL(store.save(second, "0", as_bytes(std::string_view{"bar"})),
+                    caf::none);
+    }
+    auto store = unbox(CheckpointStore::make(path));
+    REQUIRE(store.restored());
+    CHECK_EQUAL(*store.restored(), first);
+    CHECK_EQUAL(load_string(store, "0"), "foo");
+    CHECK(not std::filesystem::exists(path / fmt::to_string(second)));
+  }
+
+  TEST("committing stops restoring") {
+    const auto path = directory / "restoring";
+    const auto first = uuid::random();
+    const auto second = uuid::random();
+    {
+      auto store = unbox(CheckpointStore::make(path));
+      REQUIRE_EQUAL(store.save(first, "0", as_bytes(std::string_view{"foo"})),
+                    caf::none);
+      REQUIRE_EQUAL(store.commit(first), caf::none);
+    }
+    auto store = unbox(CheckpointStore::make(path));
+    REQUIRE_EQUAL(store.save(second, "0", as_bytes(std::string_view{"bar"})),
+                  caf::none);
+    REQUIRE_EQUAL(store.commit(second), caf::none);
+    CHECK(not store.restored());
+    CHECK_EQUAL(unbox(store.load("0")), nullptr);
+    CHECK(not std::filesystem::exists(path / fmt::to_string(first)));
+    auto reopened = unbox(CheckpointStore::make(path));
+    REQUIRE(reopened.restored());
+    CHECK_EQUAL(*reopened.restored(), second);
+    CHECK_EQUAL(load_string(reopened, "0"), "bar");
+  }
+
+  TEST("clearing removes all checkpoints") {
+    const auto path = directory / "cleared";
+    const auto first = uuid::random();
+    auto store = unbox(CheckpointStore::make(path));
+    REQUIRE_EQUAL(store.save(first, "0", as_bytes(std::string_view{"foo"})),
+                  caf::none);
+    REQUIRE_EQUAL(store.commit(first), caf::none);
+    REQUIRE_EQUAL(store.clear(), caf::none);
+    CHECK(not std::filesystem::exists(path));
+    auto reopened = unbox(CheckpointStore::make(path));
+    CHECK(not reopened.restored());
+  }
+}
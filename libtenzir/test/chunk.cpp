@@ -13,6 +13,8 @@
 #include "tenzir/test/fixtures/filesystem.hpp"
 #include "tenzir/test/test.hpp"
 
+#include <caf/binary_deserializer.hpp>
+
 #include <cstddef>
 #include <span>
 #include <string_view>
@@ -101,6 +103,27 @@ TEST("as_bytes") {
   CHECK_EQUAL(bytes, as_bytes(x));
 }
 
+TEST("binary serialization") {
+  auto x = chunk::copy(std::string_view{"foobarbaz"},
+                       chunk_metadata{.content_type = "text/plain"});
+  auto buf = caf::byte_buffer{};
+  REQUIRE(detail::serialize(buf, x));
+  auto y = chunk_ptr{};
+  auto deserializer = caf::binary_deserializer{buf};
+  REQUIRE(inspect(deserializer, y));
+  REQUIRE(y);
+  CHECK_EQUAL(as_bytes(x), as_bytes(y));
+  CHECK_EQUAL(y->metadata().content_type, "text/plain");
+  MESSAGE("null chunk");
+  buf.clear();
+  auto null = chunk_ptr{};
+  REQUIRE(detail::serialize(buf, null));
+  auto w = chunk::make_empty();
+  auto null_deserializer = caf::binary_deserializer{buf};
+  REQUIRE(inspect(null_deserializer, w));
+  CHECK(not w);
+}
+
 namespace {
 
 struct fixture : public fixtures::filesystem {
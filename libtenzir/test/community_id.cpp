@@ -106,3 +106,22 @@ TEST("ICMPv6 oneway") {
   CHECK_EQUAL(hex, "1:118a3bbf175529a3d55dca55c4364ec47f1c4152");
   CHECK_EQUAL(b64, "1:EYo7vxdVKaPVXcpVxDZOxH8cQVI=");
 }
+
+TEST("canonical orientation") {
+  auto request = make_tcp_flow("10.0.0.2", "10.0.0.1", 49152, 443);
+  auto response = make_tcp_flow("10.0.0.1", "10.0.0.2", 443, 49152);
+  auto x = community_id::canonicalize(request);
+  auto y = community_id::canonicalize(response);
+  CHECK(x.swapped);
+  CHECK(not y.swapped);
+  CHECK(x.key == y.key);
+  CHECK(x.key == response);
+  // An ICMP echo request and its reply share the same key.
+  auto echo_request = make_icmp_flow("1.2.3.4", "5.6.7.8", 8, 0);
+  auto echo_reply = make_icmp_flow("5.6.7.8", "1.2.3.4", 0, 0);
+  x = community_id::canonicalize(echo_request);
+  y = community_id::canonicalize(echo_reply);
+  CHECK(not x.swapped);
+  CHECK(y.swapped);
+  CHECK(x.key == y.key);
+}
@@ -0,0 +1,114 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/detail/interval_index.hpp"
+
+#include "tenzir/test/test.hpp"
+
+#include <map>
+#include <random>
+
+using namespace tenzir;
+
+namespace {
+
+using index_type = detail::interval_index<int, int>;
+using bound = index_type::bound;
+
+auto select(const index_type& index, std::optional<bound> lower,
+            std::optional<bound> upper) -> std::vector<int> {
+  auto result = std::vector<int>{};
+  index.for_each(lower, upper, [&](int id) {
+    result.push_back(id);
+  });
+  std::ranges::sort(result);
+  return result;
+}
+
+} // namespace
+
+TEST("interval index lookup") {
+  auto index = index_type{};
+  index.insert(1, 0, 10);
+  index.insert(2, 5, 15);
+  index.insert(3, 20, 30);
+  CHECK_EQUAL(index.size(), 3u);
+  // Equality: min <= 7 and max >= 7.
+  CHECK_EQUAL(select(index, bound{7, true}, bound{7, true}),
+              (std::vector{1, 2}));
+  CHECK_EQUAL(select(index, bound{10, true}, bound{10, true}),
+              (std::vector{1, 2}));
+  CHECK_EQUAL(select(index, bound{10, false}, bound{10, false}),
+              (std::vector{2}));
+  CHECK_EQUAL(select(index, bound{17, true}, bound{17, true}),
+              std::vector<int>{});
+  // One-sided bounds.
+  CHECK_EQUAL(select(index, std::nullopt, bound{5, false}), (std::vector{1}));
+  CHECK_EQUAL(select(index, std::nullopt, bound{5, true}), (std::vector{1, 2}));
+  CHECK_EQUAL(select(index, bound{15, true}, std::nullopt),
+              (std::vector{2, 3}));
+  CHECK_EQUAL(select(index, std::nullopt, std::nullopt),
+              (std::vector{1, 2, 3}));
+}
+
+TEST("interval index erase") {
+  auto index = index_type{};
+  index.insert(1, 0, 10);
+  index.insert(2, 0, 20);
+  CHECK(not index.erase(1, 5));
+  CHECK(index.erase(1, 0));
+  CHECK(not index.erase(1, 0));
+  CHECK_EQUAL(index.size(), 1u);
+  CHECK_EQUAL(select(index, bound{5, true}, bound{5, true}), (std::vector{2}));
+}
+
+TEST("interval index matches a linear scan") {
+  auto index = index_type{};
+  auto reference = std::map<int, std::pair<int, int>>{};
+  auto engine = std::mt19937{42};
+  auto random = [&](int n) {
+    return static_cast<int>(engine() % n);
+  };
+  for (auto step = 0; step < 10'000; ++step) {
+    const auto action = random(10);
+    if (action < 6) {
+      const auto min = random(1000);
+      const auto max = min + random(100);
+      index.insert(step, min, max);
+      reference.emplace(step, std::pair{min, max});
+    } else if (action < 8 and not reference.empty()) {
+      auto it = std::next(reference.begin(), random(reference.size()));
+      REQUIRE(index.erase(it->first, it->second.first));
+      reference.erase(it);
+    } else {
+      auto lower = std::optional<bound>{};
+      auto upper = std::optional<bound>{};
+      if (random(3) != 0) {
+        lower = bound{random(1100), random(2) == 0};
+      }
+      if (random(3) != 0) {
+        upper = bound{random(1100), random(2) == 0};
+      }
+      auto expected = std::vector<int>{};
+      for (const auto& [id, range] : reference) {
+        const auto& [min, max] = range;
+        if (upper
+            and (upper->inclusive ? min > upper->value : min >= upper->value)) {
+          continue;
+        }
+        if (lower
+            and (lower->inclusive ? max < lower->value : max <= lower->value)) {
+          continue;
+        }
+        expected.push_back(id);
+      }
+      REQUIRE_EQUAL(select(index, lower, upper), expected);
+    }
+    REQUIRE_EQUAL(index.size(), reference.size());
+  }
+}
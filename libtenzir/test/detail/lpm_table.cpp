@@ -0,0 +1,136 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/detail/lpm_table.hpp"
+
+#include "tenzir/concept/parseable/tenzir/data.hpp"
+#include "tenzir/concept/parseable/to.hpp"
+#include "tenzir/detail/subnet_tree.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <algorithm>
+#include <any>
+#include <random>
+
+using namespace tenzir;
+using namespace tenzir::detail;
+
+namespace {
+
+auto make_table(std::initializer_list<std::string_view> subnets)
+  -> lpm_table {
+  auto prefixes = std::vector<std::pair<subnet, uint32_t>>{};
+  for (auto sn : subnets) {
+    prefixes.emplace_back(*to<subnet>(sn),
+                          static_cast<uint32_t>(prefixes.size()));
+  }
+  return lpm_table{prefixes};
+}
+
+auto match(const lpm_table& table, std::string_view addr) -> uint32_t {
+  return table.match(*to<ip>(addr));
+}
+
+} // namespace
+
+TEST("lpm table prefix matching") {
+  const auto table = make_table({
+    "192.168.0.0/24",
+    "192.168.0.0/25",
+    "192.168.1.0/24",
+    "192.168.0.0/23",
+  });
+  CHECK_EQUAL(table.size(), 4u);
+  CHECK_EQUAL(match(table, "192.168.0.1"), 1u);
+  CHECK_EQUAL(match(table, "192.168.0.128"), 0u);
+  CHECK_EQUAL(match(table, "192.168.0.255"), 0u);
+  CHECK_EQUAL(match(table, "192.168.1.255"), 2u);
+  CHECK_EQUAL(match(table, "192.168.2.0"), lpm_table::none);
+  CHECK_EQUAL(match(table, "192.167.255.255"), lpm_table::none);
+  CHECK_EQUAL(match(table, "10.0.0.1"), lpm_table::none);
+  CHECK_EQUAL(match(table, "::ffff:192.168.0.1"), 1u);
+  CHECK_EQUAL(match(table, "2001:db8::1"), lpm_table::none);
+}
+
+TEST("lpm table separates address families") {
+  const auto table = make_table({
+    "10.0.0.0/8",
+    "2001:db8::/32",
+    "2001:db8:1::/48",
+    "0.0.0.0/0",
+  });
+  CHECK_EQUAL(match(table, "10.1.2.3"), 0u);
+  CHECK_EQUAL(match(table, "11.1.2.3"), 3u);
+  CHECK_EQUAL(match(table, "255.255.255.255"), 3u);
+  CHECK_EQUAL(match(table, "2001:db8::1"), 1u);
+  CHECK_EQUAL(match(table, "2001:db8:1::1"), 2u);
+  CHECK_EQUAL(match(table, "2001:db9::1"), lpm_table::none);
+  CHECK_EQUAL(match(table, "::1"), lpm_table::none);
+}
+
+TEST("lpm table short IPv6 prefixes contain IPv4 addresses") {
+  const auto table = make_table({"::/0", "10.0.0.0/8"});
+  CHECK_EQUAL(match(table, "10.0.0.1"), 1u);
+  CHECK_EQUAL(match(table, "192.168.0.1"), 0u);
+  CHECK_EQUAL(match(table, "2001:db8::1"), 0u);
+  CHECK_EQUAL(match(table, "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"), 0u);
+}
+
+TEST("lpm table without prefixes") {
+  const auto table = lpm_table{};
+  CHECK_EQUAL(table.size(), 0u);
+  CHECK_EQUAL(match(table, "10.0.0.1"), lpm_table::none);
+  CHECK_EQUAL(match(table, "::1"), lpm_table::none);
+}
+
+TEST("lpm table agrees with subnet tree") {
+  auto rng = std::mt19937_64{42};
+  auto random_ip = [&](bool v4) {
+    auto bytes = std::array<uint8_t, 16>{};
+    for (auto& x : bytes) {
+      x = static_cast<uint8_t>(rng());
+    }
+    if (v4) {
+      std::copy(ip::v4_mapped_prefix.begin(), ip::v4_mapped_prefix.end(),
+                bytes.begin());
+    }
+    return ip::v6(std::span<const uint8_t, 16>{bytes});
+  };
+  auto tree = subnet_tree{};
+  auto prefixes = std::vector<std::pair<subnet, uint32_t>>{};
+  for (auto i = 0; i < 2000; ++i) {
+    const auto v4 = i % 3 != 0;
+    const auto length = v4 ? 96 + rng() % 33 : rng() % 129;
+    const auto sn = subnet{random_ip(v4), static_cast<uint8_t>(length)};
+    const auto label = static_cast<uint32_t>(prefixes.size());
+    if (tree.insert(sn, label)) {
+      prefixes.emplace_back(sn, label);
+    }
+  }
+  // Reuse the networks of the prefixes so that many addresses actually match.
+  auto addrs = std::vector<ip>{};
+  for (const auto& [sn, _] : prefixes) {
+    addrs.push_back(sn.network());
+    addrs.push_back(random_ip(sn.network().is_v4()));
+  }
+  const auto table = lpm_table{prefixes};
+  auto bytes = std::vector<std::byte>{};
+  for (const auto& addr : addrs) {
+    const auto x = as_bytes(addr);
+    bytes.insert(bytes.end(), x.begin(), x.end());
+  }
+  auto labels = std::vector<uint32_t>(addrs.size());
+  table.match(bytes, labels);
+  for (auto i = size_t{0}; i < addrs.size(); ++i) {
+    const auto [_, expected] = tree.match(addrs[i]);
+    const auto label
+      = expected ? std::any_cast<uint32_t>(*expected) : lpm_table::none;
+    CHECK_EQUAL(labels[i], label);
+    CHECK_EQUAL(table.match(addrs[i]), label);
+  }
+}
@@ -0,0 +1,95 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/detail/xsv_scanner.hpp"
+
+#include "tenzir/test/test.hpp"
+
+#include <random>
+
+using namespace tenzir;
+
+namespace {
+
+auto policy() -> detail::quoting_escaping_policy {
+  return {
+    .quotes = R"("')",
+    .backslashes_escape = true,
+    .doubled_quotes_escape = true,
+  };
+}
+
+auto split(const detail::xsv_scanner& scanner, std::string_view line)
+  -> std::vector<std::string> {
+  auto fields = std::vector<detail::xsv_field>{};
+  scanner.split(line, fields);
+  auto result = std::vector<std::string>{};
+  for (const auto& field : fields) {
+    result.push_back(scanner.unescape(field));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST("byte set find") {
+  const auto set = detail::byte_set{"\r\n"};
+  CHECK_EQUAL(set.find(""), std::string_view::npos);
+  CHECK_EQUAL(set.find("foo\nbar"), 3u);
+  CHECK_EQUAL(set.find("foo\nbar\r", 4), 7u);
+  const auto long_text = std::string(100, 'x') + '\n';
+  CHECK_EQUAL(set.find(long_text), 100u);
+  CHECK_EQUAL(set.find(long_text, 101), std::string_view::npos);
+}
+
+TEST("xsv scanner splits fields") {
+  const auto scanner = detail::xsv_scanner{policy(), ","};
+  CHECK_EQUAL(split(scanner, ""), (std::vector<std::string>{""}));
+  CHECK_EQUAL(split(scanner, "a,b,"), (std::vector<std::string>{"a", "b", ""}));
+  CHECK_EQUAL(split(scanner, R"("a,b",c)"),
+              (std::vector<std::string>{"a,b", "c"}));
+  CHECK_EQUAL(split(scanner, R"("a""b",'c\'d',e\tf)"),
+              (std::vector<std::string>{R"(a"b)", "c'd", "e\tf"}));
+  CHECK_EQUAL(split(scanner, R"("a"b,c)"),
+              (std::vector<std::string>{R"("a"b)", "c"}));
+  auto fields = std::vector<detail::xsv_field>{};
+  scanner.split(R"(a,"b",c\,d)", fields);
+  REQUIRE_EQUAL(fields.size(), 4u);
+  REQUIRE(fields[0].value);
+  CHECK_EQUAL(*fields[0].value, "a");
+  CHECK_EQUAL(fields[1].text, R"("b")");
+  REQUIRE(fields[1].value);
+  CHECK_EQUAL(*fields[1].value, "b");
+  CHECK(not fields[2].value);
+}
+
+TEST("xsv scanner matches the quoting policy") {
+  const auto quoting = policy();
+  const auto separators = std::vector<std::string>{",", "\t", ", ", "ab", "'"};
+  const auto tokens = std::vector<std::string_view>{
+    "a", "xyz", ",", "\t", " ", "\"", "'", "\\", "ab", ";",
+  };
+  auto engine = std::mt19937{42};
+  for (auto i = 0; i < 10'000; ++i) {
+    const auto& separator = separators[engine() % separators.size()];
+    auto line = std::string{};
+    const auto length = engine() % (i % 4 == 0 ? 100 : 15);
+    for (auto j = size_t{0}; j < length; ++j) {
+      line += engine() % 2 == 0 ? "a" : tokens[engine() % tokens.size()];
+    }
+    auto expected = std::vector<std::string>{};
+    auto rest = std::string_view{line};
+    while (auto split = quoting.split_at_unquoted(rest, separator)) {
+      expected.push_back(quoting.unquote_unescape(split->first));
+      rest = split->second;
+    }
+    expected.push_back(quoting.unquote_unescape(rest));
+    REQUIRE_EQUAL(split(detail::xsv_scanner{quoting, separator}, line),
+                  expected);
+  }
+}
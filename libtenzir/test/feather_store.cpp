@@ -0,0 +1,342 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/arrow_memory_pool.hpp"
+#include "tenzir/arrow_table_slice.hpp"
+#include "tenzir/arrow_utils.hpp"
+#include "tenzir/chunk.hpp"
+#include "tenzir/concept/parseable/tenzir/expression.hpp"
+#include "tenzir/concept/parseable/to.hpp"
+#include "tenzir/data.hpp"
+#include "tenzir/expression.hpp"
+#include "tenzir/plugin.hpp"
+#include "tenzir/plugin/store.hpp"
+#include "tenzir/store.hpp"
+#include "tenzir/table_slice.hpp"
+#include "tenzir/test/test.hpp"
+#include "tenzir/view3.hpp"
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/record_batch.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <optional>
+
+using namespace tenzir;
+
+namespace {
+
+auto test_schema() -> type {
+  return type{
+    "test",
+    record_type{
+      {"s", string_type{}},
+      {"n", record_type{{"t", string_type{}}}},
+    },
+  };
+}
+
+/// Creates a slice with a flat and a nested string column that both have few
+/// distinct values. Every fourth row has a null `n` whose child still holds
+/// the string "hidden", which Arrow permits.
+auto make_slice(int64_t rows, time import_time) -> table_slice {
+  constexpr auto flat_values = std::array{"a", "b", "c"};
+  constexpr auto nested_values = std::array{"hidden", "x", "y"};
+  auto flat = arrow::StringBuilder{arrow_memory_pool()};
+  auto nested = arrow::StringBuilder{arrow_memory_pool()};
+  auto valid = arrow::BooleanBuilder{arrow_memory_pool()};
+  auto null_count = int64_t{0};
+  for (auto i = int64_t{0}; i < rows; ++i) {
+    if (i % 7 == 0) {
+      check(flat.AppendNull());
+    } else {
+      check(flat.Append(flat_values[i % flat_values.size()]));
+    }
+    const auto j = i % 4;
+    if (j == 3) {
+      check(nested.AppendNull());
+    } else {
+      check(nested.Append(nested_values[j]));
+    }
+    check(valid.Append(j != 0));
+    null_count += j == 0 ? 1 : 0;
+  }
+  const auto validity = check(valid.Finish());
+  const auto n
+    = check(arrow::StructArray::Make({check(nested.Finish())}, {"t"},
+                                     validity->data()->buffers[1], null_count));
+  const auto event
+    = check(arrow::StructArray::Make({check(flat.Finish()), n}, {"s", "n"}));
+  auto schema = test_schema();
+  auto result = table_slice{
+    record_batch_from_struct_array(schema.to_arrow_schema(), *event),
+    std::move(schema),
+  };
+  result.import_time(import_time);
+  return result;
+}
+
+auto append_rows(list& result, const table_slice& slice) -> void {
+  for (auto row : slice.values()) {
+    result.emplace_back(materialize(row));
+  }
+}
+
+auto numbers_schema() -> type {
+  return type{
+    "numbers",
+    record_type{
+      {"x", int64_type{}},
+      {"y", string_type{}},
+    },
+  };
+}
+
+/// Creates a slice whose `x` column holds `first` and the following integers.
+/// Every `null_stride`th value of `y` is null, so a stride of 1 makes the
+/// whole column null and a stride of 0 makes none of it null.
+auto make_numbers(int64_t first, int64_t rows, int64_t null_stride,
+                  time import_time) -> table_slice {
+  auto x = arrow::Int64Builder{arrow_memory_pool()};
+  auto y = arrow::StringBuilder{arrow_memory_pool()};
+  for (auto i = int64_t{0}; i < rows; ++i) {
+    check(x.Append(first + i));
+    if (null_stride > 0 and i % null_stride == 0) {
+      check(y.AppendNull());
+    } else {
+      check(y.Append(fmt::format("{}", first / 100)));
+    }
+  }
+  const auto event = check(
+    arrow::StructArray::Make({check(x.Finish()), check(y.Finish())},
+                             {"x", "y"}));
+  auto schema = numbers_schema();
+  auto result = table_slice{
+    record_batch_from_struct_array(schema.to_arrow_schema(), *event),
+    std::move(schema),
+  };
+  result.import_time(import_time);
+  return result;
+}
+
+/// Rewrites a store file. Truncating a record batch makes its zone map
+/// disagree with the data, so the store fails as soon as it reads the batch.
+/// Dropping the zone maps makes the file look like one that predates them.
+auto rewrite_store(const chunk_ptr& chunk, std::optional<int> truncate,
+                   bool keep_zone_maps) -> chunk_ptr {
+  auto reader
+    = check(arrow::ipc::RecordBatchFileReader::Open(as_arrow_file(chunk)));
+  auto schema = reader->schema();
+  if (not keep_zone_maps) {
+    auto metadata = schema->metadata()->Copy();
+    check(metadata->Delete("TENZIR:store:zone_maps"));
+    schema = schema->WithMetadata(std::move(metadata));
+  }
+  auto stream
+    = check(arrow::io::BufferOutputStream::Create(4096, arrow_memory_pool()));
+  auto writer = check(arrow::ipc::MakeFileWriter(stream, schema));
+  for (auto i = 0; i < reader->num_record_batches(); ++i) {
+    auto batch = check(reader->ReadRecordBatch(i));
+    if (i == truncate) {
+      batch = batch->Slice(0, batch->num_rows() - 1);
+    }
+    check(writer->WriteRecordBatch(*batch));
+  }
+  check(writer->Close());
+  return chunk::make(check(stream->Finish()));
+}
+
+struct extracted {
+  list rows = {};
+  std::vector<id> offsets = {};
+};
+
+auto extract(const passive_store& store, const expression& expr)
+  -> caf::expected<extracted> {
+  auto result = extracted{};
+  for (auto&& slice : store.extract(expr)) {
+    if (not slice) {
+      return std::move(slice.error());
+    }
+    append_rows(result.rows, *slice);
+    result.offsets.push_back(slice->offset());
+  }
+  return result;
+}
+
+} // namespace
+
+TEST("dictionary-encoded strings round-trip through the feather store") {
+  const auto* plugin = plugins::find<store_plugin>("feather");
+  REQUIRE(plugin);
+  // Different import-time hours make the store write separate record
+  // batches that share their dictionaries.
+  const auto input = std::vector<table_slice>{
+    make_slice(1000, time{} + std::chrono::hours{1}),
+    make_slice(500, time{} + std::chrono::hours{2}),
+  };
+  auto active = unbox(plugin->make_active_store());
+  REQUIRE(not active->add(input));
+  auto chunk = unbox(active->finish());
+  MESSAGE("both string columns are dictionary-encoded");
+  {
+    auto reader = check(
+      arrow::ipc::RecordBatchFileReader::Open(as_arrow_file(chunk)));
+    REQUIRE_EQUAL(reader->num_record_batches(), 2);
+    for (auto i = 0; i < reader->num_record_batches(); ++i) {
+      const auto batch = check(reader->ReadRecordBatch(i));
+      const auto event_type = batch->GetColumnByName("event")->type();
+      CHECK_EQUAL(event_type->field(0)->type()->id(),
+                  arrow::Type::DICTIONARY);
+      CHECK_EQUAL(event_type->field(1)->type()->field(0)->type()->id(),
+                  arrow::Type::DICTIONARY);
+    }
+  }
+  auto passive = unbox(plugin->make_passive_store());
+  REQUIRE(not passive->load(chunk));
+  MESSAGE("reading all events yields the input");
+  {
+    auto expected = list{};
+    for (const auto& slice : input) {
+      append_rows(expected, slice);
+    }
+    auto actual = list{};
+    for (auto&& slice : passive->slices()) {
+      REQUIRE(slice);
+      append_rows(actual, *slice);
+    }
+    CHECK_EQUAL(data{actual}, data{expected});
+  }
+  MESSAGE("filters match the unencoded input");
+  const auto queries = std::array{
+    R"__(s == "a")__",
+    R"__(s != "b")__",
+    R"__(s in ["a", "c"])__",
+    R"__(s in ["d"])__",
+    R"__(n.t == "x")__",
+    R"__(n.t == "hidden")__",
+    R"__(n.t in ["x", "hidden"])__",
+    R"__(n.t != "y")__",
+  };
+  for (const auto* query : queries) {
+    MESSAGE("query: {}", query);
+    const auto expr = unbox(tailor(unbox(to<expression>(query)),
+                                   test_schema()));
+    auto expected = list{};
+    for (const auto& slice : input) {
+      if (auto filtered = filter(slice, expr)) {
+        append_rows(expected, *filtered);
+      }
+    }
+    auto actual = list{};
+    for (auto&& slice : passive->extract(expr)) {
+      REQUIRE(slice);
+      append_rows(actual, *slice);
+    }
+    CHECK_EQUAL(data{actual}, data{expected});
+  }
+}
+
+TEST("zone maps skip record batches that cannot match") {
+  const auto* plugin = plugins::find<store_plugin>("feather");
+  REQUIRE(plugin);
+  const auto hour = [](int64_t n) {
+    return time{} + std::chrono::hours{n};
+  };
+  // Every slice gets its own record batch with a disjoint range of `x`. The
+  // `y` column is all null in the first batch, never null in the second and
+  // fourth, and partially null in the third.
+  auto input = std::vector<table_slice>{
+    make_numbers(0, 100, 1, hour(1)),
+    make_numbers(100, 100, 0, hour(2)),
+    make_numbers(200, 100, 2, hour(3)),
+    make_numbers(300, 100, 0, hour(4)),
+  };
+  auto offset = id{0};
+  for (auto& slice : input) {
+    slice.offset(offset);
+    offset += slice.rows();
+  }
+  auto active = unbox(plugin->make_active_store());
+  REQUIRE(not active->add(input));
+  const auto chunk = unbox(active->finish());
+  const auto reader
+    = check(arrow::ipc::RecordBatchFileReader::Open(as_arrow_file(chunk)));
+  REQUIRE_EQUAL(reader->num_record_batches(), 4);
+  const auto import_time_at_least = [&](int64_t n) {
+    return expression{predicate{meta_extractor{meta_extractor::import_time},
+                                relational_operator::greater_equal,
+                                data{hour(n)}}};
+  };
+  const auto parse = [](std::string_view query) {
+    return unbox(tailor(unbox(to<expression>(query)), numbers_schema()));
+  };
+  struct query {
+    expression expr;
+    std::vector<int> batches;
+  };
+  const auto queries = std::vector<query>{
+    {parse("x < 100"), {0}},
+    {parse("x > 299"), {3}},
+    {parse("x == 150"), {1}},
+    {parse("x == 1000"), {}},
+    {parse("x in [50, 350]"), {0, 3}},
+    {parse("y == null"), {0, 2}},
+    {parse("y != null"), {1, 2, 3}},
+    {parse("x < 100 || x > 299"), {0, 3}},
+    {parse("x < 100 && y != null"), {}},
+    {import_time_at_least(3), {2, 3}},
+    {conjunction{import_time_at_least(2), parse("y == null")}, {2}},
+  };
+  const auto expected_for = [&](const expression& expr) {
+    auto result = extracted{};
+    for (const auto& slice : input) {
+      if (auto filtered = filter(slice, expr)) {
+        append_rows(result.rows, *filtered);
+        result.offsets.push_back(filtered->offset());
+      }
+    }
+    return result;
+  };
+  for (const auto& [expr, batches] : queries) {
+    MESSAGE("query: {}", expr);
+    const auto expected = expected_for(expr);
+    auto passive = unbox(plugin->make_passive_store());
+    REQUIRE(not passive->load(chunk));
+    const auto actual = unbox(extract(*passive, expr));
+    CHECK_EQUAL(data{actual.rows}, data{expected.rows});
+    CHECK_EQUAL(actual.offsets, expected.offsets);
+    // A truncated batch fails the query exactly when the store reads it. The
+    // offsets of later batches must not depend on the data of skipped ones.
+    for (auto i = 0; i < 4; ++i) {
+      auto tampered = unbox(plugin->make_passive_store());
+      REQUIRE(not tampered->load(rewrite_store(chunk, i, true)));
+      const auto result = extract(*tampered, expr);
+      if (std::ranges::find(batches, i) != batches.end()) {
+        CHECK(not result);
+      } else {
+        REQUIRE(result);
+        CHECK_EQUAL(data{result->rows}, data{expected.rows});
+        CHECK_EQUAL(result->offsets, expected.offsets);
+      }
+    }
+    MESSAGE("stores without zone maps scan all batches");
+    auto legacy = unbox(plugin->make_passive_store());
+    REQUIRE(not legacy->load(rewrite_store(chunk, std::nullopt, false)));
+    const auto scanned = unbox(extract(*legacy, expr));
+    CHECK_EQUAL(data{scanned.rows}, data{expected.rows});
+    CHECK_EQUAL(scanned.offsets, expected.offsets);
+  }
+}
@@ -0,0 +1,200 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/flow_table.hpp"
+
+#include "tenzir/detail/serialize.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <caf/binary_deserializer.hpp>
+
+#include <string_view>
+
+using namespace tenzir;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto syn = uint8_t{0x02};
+constexpr auto ack = uint8_t{0x10};
+constexpr auto fin = uint8_t{0x01};
+constexpr auto rst = uint8_t{0x04};
+
+auto at(int64_t seconds) -> time {
+  return time{std::chrono::seconds{1'700'000'000 + seconds}};
+}
+
+auto tcp(std::string_view src, std::string_view dst, uint16_t sport,
+         uint16_t dport) -> flow {
+  return test::unbox(make_flow<port_type::tcp>(src, dst, sport, dport));
+}
+
+auto udp(std::string_view src, std::string_view dst, uint16_t sport,
+         uint16_t dport) -> flow {
+  return test::unbox(make_flow<port_type::udp>(src, dst, sport, dport));
+}
+
+} // namespace
+
+TEST("flow table merges both directions") {
+  auto table = flow_table{};
+  auto expired = std::vector<flow_record>{};
+  const auto request = tcp("10.0.0.2", "10.0.0.1", 50000, 80);
+  const auto response = tcp("10.0.0.1", "10.0.0.2", 80, 50000);
+  table.add(request, at(0), 60, syn, expired);
+  table.add(response, at(0), 60, syn | ack, expired);
+  table.add(request, at(1), 1000, ack, expired);
+  CHECK_EQUAL(table.size(), 1u);
+  table.flush(expired);
+  REQUIRE_EQUAL(expired.size(), 1u);
+  const auto& r = expired[0];
+  CHECK(r.id == request);
+  CHECK_EQUAL(r.start, at(0));
+  CHECK_EQUAL(r.end, at(1));
+  CHECK_EQUAL(r.src_packets, 2u);
+  CHECK_EQUAL(r.src_bytes, 1060u);
+  CHECK_EQUAL(r.dst_packets, 1u);
+  CHECK_EQUAL(r.dst_bytes, 60u);
+  CHECK(r.tcp_flags == (syn | ack));
+  CHECK(r.reason == flow_end_reason::flush);
+  CHECK_EQUAL(table.size(), 0u);
+}
+
+TEST("flow table expires idle flows") {
+  auto table = flow_table{{.idle_timeout = 10s}};
+  auto expired = std::vector<flow_record>{};
+  const auto x = udp("10.0.0.1", "10.0.0.2", 53, 53);
+  const auto y = udp("10.0.0.3", "10.0.0.4", 53, 53);
+  table.add(x, at(0), 100, 0, expired);
+  table.add(y, at(5), 100, 0, expired);
+  table.advance(at(10), expired);
+  CHECK(expired.empty());
+  table.advance(at(12), expired);
+  REQUIRE_EQUAL(expired.size(), 1u);
+  CHECK(expired[0].id == x);
+  CHECK(expired[0].reason == flow_end_reason::idle);
+  // Another packet defers the timeout.
+  table.add(y, at(14), 100, 0, expired);
+  table.advance(at(20), expired);
+  CHECK_EQUAL(expired.size(), 1u);
+  // A large jump in time expires everything at once.
+  table.advance(at(100'000), expired);
+  REQUIRE_EQUAL(expired.size(), 2u);
+  CHECK(expired[1].id == y);
+  CHECK_EQUAL(expired[1].src_packets, 2u);
+  CHECK_EQUAL(table.size(), 0u);
+}
+
+TEST("flow table splits long flows at the active timeout") {
+  auto table = flow_table{{.idle_timeout = 10s, .active_timeout = 30s}};
+  auto expired = std::vector<flow_record>{};
+  const auto x = udp("10.0.0.1", "10.0.0.2", 1234, 53);
+  for (auto i = 0; i <= 50; i += 5) {
+    table.add(x, at(i), 100, 0, expired);
+  }
+  REQUIRE_EQUAL(expired.size(), 1u);
+  CHECK(expired[0].reason == flow_end_reason::active);
+  CHECK_EQUAL(expired[0].start, at(0));
+  CHECK_EQUAL(expired[0].end, at(30));
+  CHECK_EQUAL(expired[0].src_packets, 7u);
+  table.flush(expired);
+  REQUIRE_EQUAL(expired.size(), 2u);
+  CHECK_EQUAL(expired[1].start, at(35));
+  CHECK_EQUAL(expired[1].end, at(50));
+  CHECK_EQUAL(expired[1].src_packets, 4u);
+}
+
+TEST("flow table ends closed connections early") {
+  auto table = flow_table{{.close_timeout = 1s}};
+  auto expired = std::vector<flow_record>{};
+  const auto x = tcp("10.0.0.1", "10.0.0.2", 1234, 22);
+  const auto y = tcp("10.0.0.2", "10.0.0.1", 22, 1234);
+  table.add(x, at(0), 60, fin | ack, expired);
+  table.add(y, at(0), 60, fin | ack, expired);
+  table.add(x, at(0), 60, ack, expired);
+  table.advance(at(5), expired);
+  REQUIRE_EQUAL(expired.size(), 1u);
+  CHECK(expired[0].reason == flow_end_reason::end);
+  CHECK_EQUAL(expired[0].src_packets, 2u);
+  // The same 5-tuple starts a new flow afterwards.
+  table.add(y, at(6), 60, rst, expired);
+  table.advance(at(10), expired);
+  REQUIRE_EQUAL(expired.size(), 2u);
+  CHECK(expired[1].id == y);
+  CHECK(expired[1].reason == flow_end_reason::end);
+}
+
+TEST("flow table grows and erases") {
+  auto table = flow_table{{.idle_timeout = 10s}};
+  auto expired = std::vector<flow_record>{};
+  constexpr auto n = uint16_t{5000};
+  for (auto i = uint16_t{0}; i < n; i += 2) {
+    table.add(tcp("10.0.0.1", "10.0.0.2", i, 80), at(0), 60, ack, expired);
+  }
+  for (auto i = uint16_t{1}; i < n; i += 2) {
+    table.add(tcp("10.0.0.1", "10.0.0.2", i, 80), at(20), 60, ack, expired);
+  }
+  // The first half timed out before we added the second half.
+  CHECK_EQUAL(expired.size(), n / 2u);
+  CHECK_EQUAL(table.size(), n / 2u);
+  // Lookups still find the remaining flows after erasing the others.
+  for (auto i = uint16_t{1}; i < n; i += 2) {
+    table.add(tcp("10.0.0.2", "10.0.0.1", 80, i), at(21), 60, ack, expired);
+  }
+  CHECK_EQUAL(table.size(), n / 2u);
+  expired.clear();
+  table.flush(expired);
+  REQUIRE_EQUAL(expired.size(), n / 2u);
+  for (const auto& r : expired) {
+    CHECK_EQUAL(r.src_packets, 1u);
+    CHECK_EQUAL(r.dst_packets, 1u);
+  }
+}
+
+TEST("flow table resumes from a serialized copy") {
+  const auto options = flow_table_options{.idle_timeout = 10s};
+  auto table = flow_table{options};
+  auto expired = std::vector<flow_record>{};
+  const auto x = udp("10.0.0.1", "10.0.0.2", 53, 53);
+  const auto y = tcp("10.0.0.3", "10.0.0.4", 1234, 80);
+  const auto z = tcp("10.0.0.4", "10.0.0.3", 80, 1234);
+  table.add(x, at(0), 100, 0, expired);
+  table.add(y, at(3), 60, syn, expired);
+  table.add(z, at(4), 60, syn | ack, expired);
+  auto buf = caf::byte_buffer{};
+  REQUIRE(detail::serialize(buf, table));
+  auto copy = flow_table{options};
+  auto deserializer = caf::binary_deserializer{buf};
+  REQUIRE(inspect(deserializer, copy));
+  CHECK_EQUAL(copy.size(), 2u);
+  CHECK_EQUAL(copy.now(), at(4));
+  MESSAGE("feed both tables the same packets");
+  const auto feed = [&](flow_table& t, std::vector<flow_record>& out) {
+    t.add(z, at(5), 1000, ack, out);
+    t.advance(at(11), out);
+    t.add(x, at(12), 100, 0, out);
+    t.flush(out);
+  };
+  auto copy_expired = std::vector<flow_record>{};
+  feed(table, expired);
+  feed(copy, copy_expired);
+  REQUIRE_EQUAL(expired.size(), 3u);
+  REQUIRE_EQUAL(copy_expired.size(), expired.size());
+  for (auto i = size_t{0}; i < expired.size(); ++i) {
+    CHECK(copy_expired[i].id == expired[i].id);
+    CHECK_EQUAL(copy_expired[i].start, expired[i].start);
+    CHECK_EQUAL(copy_expired[i].end, expired[i].end);
+    CHECK_EQUAL(copy_expired[i].src_packets, expired[i].src_packets);
+    CHECK_EQUAL(copy_expired[i].dst_bytes, expired[i].dst_bytes);
+    CHECK(copy_expired[i].reason == expired[i].reason);
+  }
+  // The UDP flow timed out at 10s, and its next packet starts a new flow.
+  CHECK(expired[0].id == x);
+  CHECK(expired[0].reason == flow_end_reason::idle);
+  CHECK_EQUAL(expired[1].dst_bytes, 1060u);
+}
@@ -0,0 +1,135 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/json_slice_printer.hpp"
+
+#include "tenzir/concept/parseable/tenzir/ip.hpp"
+#include "tenzir/concept/parseable/tenzir/subnet.hpp"
+#include "tenzir/concept/parseable/to.hpp"
+#include "tenzir/concept/printable/tenzir/json.hpp"
+#include "tenzir/detail/json_escape.hpp"
+#include "tenzir/series_builder.hpp"
+#include "tenzir/test/test.hpp"
+#include "tenzir/view3.hpp"
+
+#include <string>
+
+using namespace tenzir;
+using namespace std::chrono_literals;
+
+namespace {
+
+auto make_slice() -> table_slice {
+  auto b = series_builder{};
+  for (auto i = int64_t{0}; i < 3; ++i) {
+    auto r = b.record();
+    r.field("int").data(-i);
+    r.field("uint").data(static_cast<uint64_t>(i));
+    r.field("double").data(i == 2 ? 1e300 : 0.5 * static_cast<double>(i));
+    r.field("string").data(
+      i == 0 ? std::string_view{"plain"}
+             : std::string_view{"a \"quote\", a \\, a\ttab, a \x7f, and "
+                                "non-ASCII text: \xc3\xbc\xc3\xb1\xc3\xad"});
+    r.field("time").data(time{1'700'000'000s} + i * 1ms + (i == 2 ? 7ns : 0ns));
+    r.field("duration").data(duration{i * 1500ms});
+    r.field("ip").data(*to<ip>(i == 0 ? "10.0.0.1" : "2001:db8::1"));
+    r.field("subnet").data(*to<subnet>("10.0.0.0/8"));
+    if (i != 1) {
+      r.field("null").null();
+    }
+    auto xs = r.field("list").list();
+    if (i > 0) {
+      xs.data(i);
+      xs.null();
+    }
+    auto nested = r.field("nested").record();
+    nested.field("empty").list();
+    if (i == 2) {
+      nested.field("x").data(std::string_view{"y"});
+    } else {
+      nested.field("x").null();
+    }
+    auto records = r.field("records").list();
+    records.record().field("z").data(i);
+    records.record().field("z").null();
+  }
+  return b.finish_assert_one_slice("test");
+}
+
+auto print_reference(const table_slice& slice,
+                     const json_printer_options& options) -> std::string {
+  auto printer = json_printer{options};
+  auto result = std::string{};
+  auto out = std::back_inserter(result);
+  for (auto&& row : values3(slice)) {
+    if (not result.empty()) {
+      result += '\n';
+    }
+    REQUIRE(printer.print(out, row));
+  }
+  return result;
+}
+
+auto print(const table_slice& slice, const json_printer_options& options)
+  -> std::string {
+  auto buffer = std::vector<char>{};
+  json_slice_printer{options}.print(slice, "\n", buffer);
+  return {buffer.begin(), buffer.end()};
+}
+
+} // namespace
+
+TEST("json slice printer matches json printer") {
+  const auto slice = make_slice();
+  for (auto flags = 0; flags < (1 << 7); ++flags) {
+    const auto options = json_printer_options{
+      .style = no_style(),
+      .oneline = (flags & 1) != 0,
+      .trailing_commas = (flags & 2) != 0 ? std::optional{true} : std::nullopt,
+      .numeric_durations = (flags & 4) != 0,
+      .omit_null_fields = (flags & 8) != 0,
+      .omit_nulls_in_lists = (flags & 16) != 0,
+      .omit_empty_records = (flags & 32) != 0,
+      .omit_empty_lists = (flags & 64) != 0,
+    };
+    REQUIRE(json_slice_printer::supports(options));
+    CHECK_EQUAL(print(slice, options), print_reference(slice, options));
+  }
+}
+
+TEST("json slice printer requires plain JSON") {
+  CHECK(json_slice_printer::supports(json_printer_options{
+    .style = no_style(),
+  }));
+  CHECK(not json_slice_printer::supports(json_printer_options{
+    .tql = true,
+    .style = no_style(),
+  }));
+  CHECK(not json_slice_printer::supports(json_printer_options{
+    .style = jq_style(),
+  }));
+}
+
+TEST("find characters that need escaping") {
+  for (auto size : {0, 1, 15, 16, 17, 31, 32, 33, 100}) {
+    auto text = std::string(size, 'a');
+    CHECK_EQUAL(detail::find_json_escape(text), std::string_view::npos);
+    for (auto pos = 0; pos < size; ++pos) {
+      for (auto c : {'"', '\\', '\0', '\n', '\x1f', '\x7f'}) {
+        text[pos] = c;
+        CHECK_EQUAL(detail::find_json_escape(text), size_t(pos));
+        CHECK_EQUAL(detail::find_json_escape(text, pos + 1),
+                    std::string_view::npos);
+      }
+      text[pos] = 'a';
+    }
+  }
+  // Bytes of multi-byte UTF-8 sequences and spaces never need escaping.
+  CHECK_EQUAL(detail::find_json_escape("\xc3\xbc \x80\xff"),
+              std::string_view::npos);
+}
@@ -64,3 +64,46 @@ TEST("split aligns substring in predicate") {
   CHECK_EQUAL(p->op, relational_operator::ni);
   CHECK_EQUAL(p->rhs, operand{data{std::string{"needle"}}});
 }
+
+TEST("split implies predicates from function calls") {
+  // Calls to builtin predicate functions stay in the remainder, but we still
+  // derive a legacy expression from them that allows for partition pruning.
+  auto dh = collecting_diagnostic_handler{};
+  auto provider = session_provider::make(dh);
+  auto s = session{provider};
+  const auto split = [&](std::string_view str) {
+    auto expr
+      = parse_expression_with_location_override(str, location::unknown, s);
+    REQUIRE(expr);
+    auto result = split_legacy_expression(std::move(expr).unwrap());
+    CHECK(not is_true_literal(result.second));
+    return std::move(result.first);
+  };
+  {
+    auto legacy = split(R"(x.starts_with("foo"))");
+    const auto* p = try_as<predicate>(&legacy.get_data());
+    REQUIRE(p);
+    CHECK_EQUAL(p->lhs, operand{field_extractor{"x"}});
+    CHECK_EQUAL(p->op, relational_operator::ni);
+    CHECK_EQUAL(p->rhs, operand{data{std::string{"foo"}}});
+  }
+  {
+    auto legacy = split("a.b.is_private()");
+    const auto* d = try_as<disjunction>(&legacy.get_data());
+    REQUIRE(d);
+    CHECK_EQUAL(d->size(), 4u);
+    const auto* p = try_as<predicate>(&d->front().get_data());
+    REQUIRE(p);
+    CHECK_EQUAL(p->lhs, operand{field_extractor{"a.b"}});
+    CHECK_EQUAL(p->op, relational_operator::in);
+  }
+  {
+    // A disjunction is implied by the disjunction of what its sides imply.
+    auto legacy = split(R"(x == 1 or (y == 2 and z.ends_with("bar")))");
+    const auto* d = try_as<disjunction>(&legacy.get_data());
+    REQUIRE(d);
+    CHECK_EQUAL(d->size(), 2u);
+  }
+  CHECK_EQUAL(split("f(x)"), trivially_true_expression());
+  CHECK_EQUAL(split(R"(x.starts_with(y))"), trivially_true_expression());
+}
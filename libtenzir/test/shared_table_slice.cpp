@@ -0,0 +1,118 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/shared_table_slice.hpp"
+
+#include "tenzir/detail/serialize.hpp"
+#include "tenzir/series_builder.hpp"
+#include "tenzir/table_slice.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <caf/binary_deserializer.hpp>
+#include <caf/node_id.hpp>
+#include <fmt/format.h>
+
+#ifdef __linux__
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#include <array>
+
+using namespace tenzir;
+
+#ifdef __linux__
+
+namespace {
+
+auto make_node(pid_t pid) -> caf::node_id {
+  auto host = caf::hashed_node_id::host_id_type{};
+  host.fill(0x2a);
+  return caf::make_node_id(static_cast<uint32_t>(pid), host);
+}
+
+/// Creates a slice that is large enough to travel through shared memory.
+auto make_large_slice() -> table_slice {
+  auto b = series_builder{};
+  for (auto i = int64_t{0}; i < 10'000; ++i) {
+    auto event = b.record();
+    event.field("id").data(i);
+    event.field("message").data(fmt::format("{:064}", i));
+  }
+  auto slice = b.finish_assert_one_slice("test");
+  slice.offset(1'000);
+  slice.import_time(time{} + std::chrono::seconds{42});
+  return slice;
+}
+
+} // namespace
+
+TEST("table slices pass through shared memory to another process") {
+  shared_table_slice::listen();
+  const auto slice = make_large_slice();
+  const auto parent = make_node(::getpid());
+  auto fds = std::array<int, 2>{};
+  REQUIRE_EQUAL(::pipe(fds.data()), 0);
+  const auto child = ::fork();
+  REQUIRE(child != -1);
+  if (child == 0) {
+    ::close(fds[0]);
+    auto shared
+      = shared_table_slice::make(slice, make_node(::getpid()), parent);
+    auto buffer = caf::byte_buffer{};
+    if (not shared or not detail::serialize(buffer, *shared)) {
+      ::_exit(1);
+    }
+    const auto n = ::write(fds[1], buffer.data(), buffer.size());
+    ::_exit(n == static_cast<ssize_t>(buffer.size()) ? 0 : 1);
+  }
+  ::close(fds[1]);
+  auto buffer = caf::byte_buffer{};
+  auto chunk = std::array<std::byte, 256>{};
+  while (true) {
+    const auto n = ::read(fds[0], chunk.data(), chunk.size());
+    if (n <= 0) {
+      break;
+    }
+    buffer.insert(buffer.end(), chunk.begin(), chunk.begin() + n);
+  }
+  ::close(fds[0]);
+  auto status = 0;
+  REQUIRE_EQUAL(::waitpid(child, &status, 0), child);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE_EQUAL(WEXITSTATUS(status), 0);
+  auto shared = shared_table_slice{};
+  auto deserializer = caf::binary_deserializer{buffer};
+  REQUIRE(inspect(deserializer, shared));
+  auto result = std::move(shared).take();
+  REQUIRE(result);
+  CHECK_EQUAL(result->offset(), id{1'000});
+  CHECK_EQUAL(result->import_time(), slice.import_time());
+  CHECK_EQUAL(result->rows(), slice.rows());
+  CHECK(*result == slice);
+}
+
+TEST("taking a shared table slice that did not arrive does not block") {
+  shared_table_slice::listen();
+  CHECK(not shared_table_slice{}.try_take());
+}
+
+TEST("small table slices and other hosts use the CAF socket") {
+  auto b = series_builder{};
+  b.record().field("id").data(int64_t{42});
+  const auto small = b.finish_assert_one_slice("test");
+  const auto self = make_node(::getpid());
+  CHECK(not shared_table_slice::make(small, self, make_node(::getpid() + 1)));
+  auto other_host = caf::hashed_node_id::host_id_type{};
+  other_host.fill(0x17);
+  const auto remote = caf::make_node_id(1, other_host);
+  CHECK(not shared_table_slice::make(make_large_slice(), self, remote));
+  CHECK(not shared_table_slice::make(make_large_slice(), self, self));
+}
+
+#endif
@@ -0,0 +1,77 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/spill_file.hpp"
+
+#include "tenzir/series_builder.hpp"
+#include "tenzir/test/fixtures/filesystem.hpp"
+#include "tenzir/test/test.hpp"
+
+#include <string_view>
+
+using namespace tenzir;
+
+namespace {
+
+struct fixture : public fixtures::filesystem {
+  fixture() : fixtures::filesystem(TENZIR_PP_STRINGIFY(CAF_TEST_SUITE_NAME)) {
+  }
+};
+
+auto make_test_slice(int64_t first, int64_t count) -> table_slice {
+  auto b = series_builder{};
+  for (auto i = first; i < first + count; ++i) {
+    b.record().field("x").data(i);
+  }
+  auto slices = b.finish_as_table_slice("test");
+  REQUIRE_EQUAL(slices.size(), size_t{1});
+  return std::move(slices[0]);
+}
+
+} // namespace
+
+WITH_FIXTURE(fixture) {
+  TEST("records round-trip in order") {
+    auto file = unbox(SpillFile::make(directory));
+    CHECK(std::filesystem::exists(file.path()));
+    for (auto record : {"foo", "bar", "baz"}) {
+      const auto str = std::string_view{record};
+      REQUIRE_EQUAL(file.write(as_bytes(str)), caf::none);
+    }
+    CHECK_EQUAL(file.records(), uint64_t{3});
+    auto reader = unbox(file.read());
+    for (auto record : {"foo", "bar", "baz"}) {
+      auto chunk = unbox(reader.next());
+      REQUIRE(chunk);
+      CHECK_EQUAL(as_bytes(chunk), as_bytes(std::string_view{record}));
+    }
+    CHECK_EQUAL(unbox(reader.next()), nullptr);
+  }
+
+  TEST("table slices round-trip") {
+    auto file = unbox(SpillFile::make(directory));
+    const auto first = make_test_slice(0, 100);
+    const auto second = make_test_slice(100, 10);
+    REQUIRE_EQUAL(file.write(first), caf::none);
+    REQUIRE_EQUAL(file.write(second), caf::none);
+    auto reader = unbox(file.read());
+    CHECK_EQUAL(unbox(reader.next_slice()), first);
+    CHECK_EQUAL(unbox(reader.next_slice()), second);
+    CHECK_EQUAL(unbox(reader.next_slice()).rows(), uint64_t{0});
+  }
+
+  TEST("file is removed on destruction") {
+    auto path = std::filesystem::path{};
+    {
+      auto file = unbox(SpillFile::make(directory));
+      path = file.path();
+      CHECK(std::filesystem::exists(path));
+    }
+    CHECK(not std::filesystem::exists(path));
+  }
+}
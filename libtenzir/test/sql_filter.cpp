@@ -0,0 +1,101 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tenzir/sql_filter.hpp"
+
+#include "tenzir/test/test.hpp"
+#include "tenzir/tql2/ast.hpp"
+#include "tenzir/tql2/parser.hpp"
+
+#include <string_view>
+
+using namespace tenzir;
+
+namespace {
+
+auto translate(std::string_view str, sql_dialect dialect = {true})
+  -> sql_filter {
+  auto dh = collecting_diagnostic_handler{};
+  auto provider = session_provider::make(dh);
+  auto s = session{provider};
+  auto expr
+    = parse_expression_with_location_override(str, location::unknown, s);
+  REQUIRE(expr);
+  const auto columns = sql_columns{
+    {"x", sql_column_kind::integer},
+    {"y", sql_column_kind::floating_point},
+    {"name", sql_column_kind::string},
+  };
+  return make_sql_filter({std::move(expr).unwrap()}, columns, dialect);
+}
+
+} // namespace
+
+TEST("sql filter comparisons") {
+  auto result = translate("x > 5");
+  CHECK_EQUAL(result.condition, "(COALESCE(`x` > 5, FALSE))");
+  CHECK(result.exact);
+  result = translate("x != -1");
+  CHECK_EQUAL(result.condition, "(COALESCE(`x` <> -1, TRUE))");
+  CHECK(result.exact);
+  result = translate("x == null");
+  CHECK_EQUAL(result.condition, "(`x` IS NULL)");
+  CHECK(result.exact);
+  result = translate(R"(name == "it's")");
+  CHECK_EQUAL(result.condition, "(COALESCE(`name` = 'it''s', FALSE))");
+  CHECK(result.exact);
+  result = translate("y <= 1.5");
+  CHECK_EQUAL(result.condition,
+              "(COALESCE(`y` <= 1.50000000000000000e+00, FALSE))");
+  CHECK(result.exact);
+  result = translate("x in [1, 2]");
+  CHECK_EQUAL(result.condition, "(COALESCE(`x` IN (1, 2), FALSE))");
+  CHECK(result.exact);
+}
+
+TEST("sql filter keeps untranslatable parts local") {
+  // Unknown columns and mismatching types do not translate.
+  auto result = translate("z == 1");
+  CHECK_EQUAL(result.condition, "");
+  CHECK(not result.exact);
+  result = translate("x == 1.0");
+  CHECK_EQUAL(result.condition, "");
+  CHECK(not result.exact);
+  // A conjunction keeps its translatable parts.
+  result = translate("x == 1 and z == 2");
+  CHECK_EQUAL(result.condition, "((COALESCE(`x` = 1, FALSE)))");
+  CHECK(not result.exact);
+  // A disjunction needs all of its parts.
+  result = translate("x == 1 or z == 2");
+  CHECK_EQUAL(result.condition, "");
+  result = translate("x == 1 and name.length() > 3");
+  CHECK_EQUAL(result.condition, "(COALESCE(`x` = 1, FALSE))");
+  CHECK(not result.exact);
+  // Backslashes cannot be quoted portably.
+  result = translate(R"(name == "a\\b")");
+  CHECK_EQUAL(result.condition, "");
+}
+
+TEST("sql filter negations") {
+  auto result = translate("not (x == 1)");
+  CHECK_EQUAL(result.condition, "(NOT (COALESCE(`x` = 1, FALSE)))");
+  CHECK(result.exact);
+  // `x < 1` may be null, which `not` would turn into true in SQL.
+  result = translate("not (x < 1)");
+  CHECK_EQUAL(result.condition, "");
+}
+
+TEST("sql filter with collated strings") {
+  auto result = translate(R"(name == "foo")", sql_dialect{false});
+  CHECK_EQUAL(result.condition, "(COALESCE(`name` = 'foo', FALSE))");
+  CHECK(not result.exact);
+  result = translate(R"(name < "foo")", sql_dialect{false});
+  CHECK_EQUAL(result.condition, "");
+  result = translate(R"(name != "foo")", sql_dialect{false});
+  CHECK_EQUAL(result.condition, "");
+}
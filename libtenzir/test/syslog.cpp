@@ -10,8 +10,103 @@
 
 #include <tenzir/detail/syslog.hpp>
 
+#include <random>
+
 namespace tenzir {
 
+namespace {
+
+/// Parses a message with the parser combinators only, bypassing the fast path
+/// of `message_parser`.
+auto parse_with_combinators(std::string_view line,
+                            plugins::syslog::message& msg) -> bool {
+  using namespace plugins::syslog;
+  auto p = header_parser{} >> ' '
+           >> (structured_data_parser{} | checkpoint_structured_data_parser{})
+           >> -(' ' >> message_content_parser{});
+  const auto* f = line.begin();
+  const auto* const l = line.end();
+  return p(f, l, msg.hdr, msg.data, msg.msg) and f == l;
+}
+
+auto check_fast_path(std::string_view line) -> void {
+  using namespace plugins::syslog;
+  auto fast = message{};
+  const auto result = parse_rfc5424_message(line, fast);
+  if (result == rfc5424_parse_result::fallback) {
+    return;
+  }
+  auto slow = message{};
+  const auto parsed = parse_with_combinators(line, slow);
+  REQUIRE_EQUAL(parsed, result == rfc5424_parse_result::parsed);
+  if (not parsed) {
+    return;
+  }
+  CHECK_EQUAL(fast.hdr.facility, slow.hdr.facility);
+  CHECK_EQUAL(fast.hdr.severity, slow.hdr.severity);
+  CHECK_EQUAL(fast.hdr.version, slow.hdr.version);
+  CHECK(fast.hdr.ts == slow.hdr.ts);
+  CHECK(fast.hdr.hostname == slow.hdr.hostname);
+  CHECK(fast.hdr.app_name == slow.hdr.app_name);
+  CHECK(fast.hdr.process_id == slow.hdr.process_id);
+  CHECK(fast.hdr.msg_id == slow.hdr.msg_id);
+  REQUIRE_EQUAL(fast.data.size(), slow.data.size());
+  for (auto i = size_t{0}; i < fast.data.size(); ++i) {
+    CHECK_EQUAL(fast.data[i].id, slow.data[i].id);
+    CHECK(fast.data[i].params == slow.data[i].params);
+  }
+  CHECK(fast.msg == slow.msg);
+}
+
+auto check_legacy_fast_path(std::string_view line) -> void {
+  using namespace plugins::syslog;
+  auto fast = legacy_message{};
+  if (not parse_rfc3164_message(line, fast)) {
+    return;
+  }
+  auto slow = legacy_message{};
+  const auto* f = line.begin();
+  const auto* const l = line.end();
+  REQUIRE(legacy_message_combinator_parser{}.parse(f, l, slow));
+  CHECK(f == l);
+  CHECK(fast.facility == slow.facility);
+  CHECK(fast.severity == slow.severity);
+  CHECK_EQUAL(fast.timestamp, slow.timestamp);
+  CHECK(fast.host == slow.host);
+  CHECK(fast.tag == slow.tag);
+  CHECK(fast.process_id == slow.process_id);
+  CHECK(slow.data.empty());
+  CHECK_EQUAL(fast.content, slow.content);
+}
+
+/// Applies up to three random insertions, replacements, and deletions of
+/// characters from `alphabet`.
+auto mutate(std::string& line, std::string_view alphabet, std::mt19937& engine)
+  -> void {
+  const auto mutations = 1 + engine() % 3;
+  for (auto j = size_t{0}; j < mutations; ++j) {
+    const auto pos = engine() % (line.size() + 1);
+    const auto c = alphabet[engine() % alphabet.size()];
+    switch (engine() % 3) {
+      case 0:
+        line.insert(pos, 1, c);
+        break;
+      case 1:
+        if (pos < line.size()) {
+          line[pos] = c;
+        }
+        break;
+      case 2:
+        if (pos < line.size()) {
+          line.erase(pos, 1);
+        }
+        break;
+    }
+  }
+}
+
+} // namespace
+
 TEST("RFC 5424 message parser accepts an empty message") {
   auto line = std::string{
     "<34>1 2003-10-11T22:14:15.003Z host app - - [sd@1 a=\"1\"] "};
@@ -54,4 +149,102 @@ TEST("syslog builder keeps pending multiline state when flushing committed "
               std::string{"First\nstack trace continuation"});
 }
 
+TEST("RFC 5424 fast path parses common messages") {
+  using namespace plugins::syslog;
+  auto msg = message{};
+  auto line = std::string_view{
+    "<165>1 2003-10-11T22:14:15.003Z mymachine.example.com evntslog - ID47 "
+    "[exampleSDID@32473 iut=\"3\" eventSource=\"Application\"]"
+    "[x@1 a=b c=\"q\\\"uo\\]te\\\\\"] \xEF\xBB\xBF"
+    "An application event"};
+  REQUIRE(parse_rfc5424_message(line, msg) == rfc5424_parse_result::parsed);
+  CHECK_EQUAL(msg.hdr.facility, uint16_t{20});
+  CHECK_EQUAL(msg.hdr.severity, uint16_t{5});
+  CHECK(msg.hdr.hostname == "mymachine.example.com");
+  CHECK(not msg.hdr.process_id);
+  REQUIRE_EQUAL(msg.data.size(), size_t{2});
+  CHECK(msg.data[1].params
+        == (std::vector<parameter>{{"a", "b"}, {"c", "q\"uo]te\\"}}));
+  CHECK(msg.msg == "An application event");
+  check_fast_path(line);
+  // Messages in other dialects are rejected from their first bytes.
+  CHECK(parse_rfc5424_message("Oct 11 22:14:15 host su: failed", msg)
+        == rfc5424_parse_result::rejected);
+  CHECK(parse_rfc5424_message("<34>Oct 11 22:14:15 host su: failed", msg)
+        == rfc5424_parse_result::rejected);
+  // Check Point structured data needs the parser combinators.
+  CHECK(parse_rfc5424_message(
+          "<134>1 2023-01-01T00:00:00Z host CP-GW - Log [action:\"Accept\"]",
+          msg)
+        == rfc5424_parse_result::fallback);
+}
+
+TEST("RFC 5424 fast path matches the parser combinators") {
+  const auto lines = std::vector<std::string>{
+    "<34>1 2003-10-11T22:14:15.003Z host app - - [sd@1 a=\"1\"] ",
+    "<165>1 2003-08-24T05:14:15.000003-07:00 192.0.2.1 myproc 8710 - - %% x",
+    "<165>1 2003-08-24T05:14:15+0730 h a p m - msg",
+    "<165>1 2003-08-24T05:14:15 UTC h a p m - msg",
+    "<165>1 2003-08-24 05:14:15 h a p m - msg",
+    "<0>1 - - - - - [a b=\"x\"y\"][c d=\"\"]",
+    "<191>999 - - - - - [a b=\"x\"]y\"] z",
+  };
+  for (const auto& line : lines) {
+    check_fast_path(line);
+  }
+  // Mutate the lines randomly to cover the edge cases of the fast path.
+  const auto alphabet = std::string_view{" -\"[]=\\;:Z+T0123456789aU\t\n"};
+  auto engine = std::mt19937{42};
+  for (auto i = 0; i < 100'000; ++i) {
+    auto line = lines[engine() % lines.size()];
+    mutate(line, alphabet, engine);
+    check_fast_path(line);
+  }
+}
+
+TEST("RFC 3164 fast path parses common messages") {
+  using namespace plugins::syslog;
+  auto msg = legacy_message{};
+  REQUIRE(parse_rfc3164_message(
+    "<34>Oct 11 22:14:15 mymachine su[1234]: 'su root' failed", msg));
+  CHECK(msg.facility == uint16_t{4});
+  CHECK(msg.severity == uint16_t{2});
+  CHECK_EQUAL(msg.timestamp, std::string{"Oct 11 22:14:15"});
+  CHECK(msg.host == "mymachine");
+  CHECK(msg.tag == "su");
+  CHECK(msg.process_id == "1234");
+  CHECK_EQUAL(msg.content, std::string{"'su root' failed"});
+  REQUIRE(parse_rfc3164_message("Feb  5 01:02:03 host no tag here", msg));
+  CHECK(not msg.facility);
+  CHECK_EQUAL(msg.timestamp, std::string{"Feb  5 01:02:03"});
+  CHECK(not msg.tag);
+  CHECK_EQUAL(msg.content, std::string{"no tag here"});
+  // Other timestamps, a missing hostname, and structured data need the
+  // parser combinators.
+  CHECK(not parse_rfc3164_message("Oct 11 2024 22:14:15 host su: x", msg));
+  CHECK(not parse_rfc3164_message("2024-10-11T22:14:15Z host su: x", msg));
+  CHECK(not parse_rfc3164_message("Oct 11 22:14:15 su: x", msg));
+  CHECK(not parse_rfc3164_message("Oct 11 22:14:15 host [a b=\"c\"] x", msg));
+}
+
+TEST("RFC 3164 fast path matches the parser combinators") {
+  const auto lines = std::vector<std::string>{
+    "<34>Oct 11 22:14:15 mymachine su[1234]: 'su root' failed",
+    "<0>Jan  1 00:00:00 host: tag-x_y.z: message",
+    "Dec 31 23:59:59 host [pid]: [not structured",
+    "<191>  Jun 30 12:00:00\thost\tapp[1 2]:",
+    "Mar 3 03:03:03 10.0.0.1 kernel: \xC3\xA4 non-ASCII",
+  };
+  for (const auto& line : lines) {
+    check_legacy_fast_path(line);
+  }
+  const auto alphabet = std::string_view{" <>[]:-_.0123456789JanOct\t\x01\xC3"};
+  auto engine = std::mt19937{42};
+  for (auto i = 0; i < 100'000; ++i) {
+    auto line = lines[engine() % lines.size()];
+    mutate(line, alphabet, engine);
+    check_legacy_fast_path(line);
+  }
+}
+
 } // namespace tenzir
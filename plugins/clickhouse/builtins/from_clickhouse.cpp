@@ -16,6 +16,7 @@
 #include "tenzir/co_match.hpp"
 #include "tenzir/operator_plugin.hpp"
 #include "tenzir/plugin/register.hpp"
+#include "tenzir/sql_filter.hpp"
 #include "tenzir/tql2/filter.hpp"
 #include "tenzir/tql2/plugin.hpp"
 
@@ -24,6 +25,7 @@
 #include <folly/coro/BoundedQueue.h>
 
 #include <algorithm>
+#include <memory>
 #include <unordered_set>
 #include <utility>
 
@@ -44,11 +46,21 @@ struct FromClickhouseArgs {
   Option<located<std::string>> sql;
   Option<located<data>> tls;
   location operator_location;
+  /// The filter pushed down by `describer.optimize_filter`.
+  ir::optimize_filter filter;
+  /// The limit of the operator directly downstream.
+  Option<ir::Limit> limit;
 };
 
 struct QueryPlan {
   std::string query;
   std::string schema_name;
+  /// The table to read from in table mode, which allows for pushing the
+  /// filter and limit into the query.
+  Option<std::string> table;
+  /// The filter that must be applied to the result of the query.
+  ir::optimize_filter filter;
+  Option<uint64_t> limit;
 };
 
 struct SliceMessage {
@@ -62,6 +74,81 @@ using MessageQueue = folly::coro::BoundedQueue<Message, true, true>;
 constexpr auto message_queue_capacity = uint32_t{16};
 constexpr auto message_queue_backoff = std::chrono::milliseconds{1};
 
+/// Returns the kind of a column for translating filters from its ClickHouse
+/// type, e.g., `Nullable(Int32)`.
+auto column_kind(std::string_view type) -> Option<sql_column_kind> {
+  for (auto wrapper : {"Nullable(", "LowCardinality("}) {
+    if (type.starts_with(wrapper) and type.ends_with(')')) {
+      return column_kind(
+        type.substr(std::string_view{wrapper}.size(),
+                    type.size() - std::string_view{wrapper}.size() - 1));
+    }
+  }
+  if (type == "Int8" or type == "Int16" or type == "Int32" or type == "Int64"
+      or type == "UInt8" or type == "UInt16" or type == "UInt32"
+      or type == "UInt64") {
+    return sql_column_kind::integer;
+  }
+  if (type == "Float64") {
+    return sql_column_kind::floating_point;
+  }
+  if (type == "String") {
+    return sql_column_kind::string;
+  }
+  return None{};
+}
+
+/// Fetches the columns of a table that filters can reference.
+auto describe_columns(::clickhouse::Client& client, std::string_view table)
+  -> sql_columns {
+  auto result = sql_columns{};
+  client.Select(
+    fmt::format("DESCRIBE TABLE {}", table),
+    [&](::clickhouse::Block const& block) {
+      if (block.GetColumnCount() < 2) {
+        return;
+      }
+      auto names = block[0]->As<::clickhouse::ColumnString>();
+      auto types = block[1]->As<::clickhouse::ColumnString>();
+      if (not names or not types) {
+        return;
+      }
+      for (auto i = size_t{0}; i < block.GetRowCount(); ++i) {
+        auto name = names->At(i);
+        // Subcolumns of `Nested` columns have a dot in their name, which
+        // would refer to a nested field in TQL instead.
+        if (name.find('.') != std::string_view::npos) {
+          continue;
+        }
+        if (auto kind = column_kind(types->At(i))) {
+          result.emplace(std::string{name}, *kind);
+        }
+      }
+    });
+  return result;
+}
+
+/// Moves as much of the filter and the limit of the plan into its query as
+/// possible. The limit only moves if the entire filter does.
+auto push_down(::clickhouse::Client& client, QueryPlan& plan) -> void {
+  TENZIR_ASSERT(plan.table);
+  if (not plan.filter.empty()) {
+    auto columns = describe_columns(client, *plan.table);
+    auto filter = make_sql_filter(plan.filter, columns,
+                                  sql_dialect{.binary_strings = true});
+    if (not filter.condition.empty()) {
+      plan.query += fmt::format(" WHERE {}", filter.condition);
+    }
+    if (not filter.exact) {
+      return;
+    }
+    plan.filter.clear();
+  }
+  if (plan.limit) {
+    plan.query += fmt::format(" LIMIT {}", *plan.limit);
+  }
+}
+
 auto has_primary_annotation(diagnostic const& diag) -> bool {
   return std::any_of(diag.annotations.begin(), diag.annotations.end(),
                      [](auto const& annotation) {
@@ -168,11 +255,17 @@ public:
       plan = {
         .query = fmt::format("SELECT * FROM {}", qualified),
         .schema_name = make_schema_name_from_table(args_.table->inner),
+        .table = qualified,
+        .filter = args_.filter,
       };
+      if (args_.limit and not args_.limit->from_end) {
+        plan.limit = args_.limit->count;
+      }
     } else {
       plan = {
         .query = args_.sql->inner,
         .schema_name = "clickhouse.query",
+        .filter = args_.filter,
       };
     }
     // Helper task to shutdown our query on cancellation.
@@ -252,6 +345,13 @@ private:
   auto run_query(::clickhouse::ClientOptions options, QueryPlan plan,
                  diagnostic_handler& dh) -> Task<void> {
     try {
+      auto client = std::unique_ptr<::clickhouse::Client>{};
+      co_await spawn_blocking([&]() {
+        client = std::make_unique<::clickhouse::Client>(options);
+        if (plan.table) {
+          push_down(*client, plan);
+        }
+      });
       auto first_schema = Option<type>{};
       auto query = ::clickhouse::Query{plan.query};
       query.SetSetting("max_block_size",
@@ -269,6 +369,12 @@ private:
         if (not slice) {
           return not runtime_->should_cancel();
         }
+        for (auto const& expr : plan.filter) {
+          *slice = filter2(*slice, expr, dh, false);
+        }
+        if (slice->rows() == 0) {
+          return not runtime_->should_cancel();
+        }
         if (not first_schema) {
           first_schema = slice->schema();
         } else if (slice->schema() != *first_schema) {
@@ -280,9 +386,8 @@ private:
         runtime_->produce_data(std::move(*slice));
         return not runtime_->should_cancel();
       });
-      co_await spawn_blocking([&options, &query]() {
-        auto client = ::clickhouse::Client{options};
-        client.Select(query);
+      co_await spawn_blocking([&client, &query]() {
+        client->Select(query);
       });
     } catch (const panic_exception&) {
       throw;
@@ -371,7 +476,8 @@ public:
       }
       return {};
     });
-    return d.without_optimize();
+    d.absorb_limit(&FromClickhouseArgs::limit);
+    return d.optimize_filter(&FromClickhouseArgs::filter);
   }
 };
 
@@ -6,11 +6,16 @@
 // SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
 // SPDX-License-Identifier: BSD-3-Clause
 
+#include "packet_ring.hpp"
+
 #include <tenzir/async.hpp>
+#include <tenzir/async/blocking_executor.hpp>
 #include <tenzir/async/notify.hpp>
+#include <tenzir/atomic.hpp>
 #include <tenzir/base_ctx.hpp>
 #include <tenzir/compile_ctx.hpp>
 #include <tenzir/detail/narrow.hpp>
+#include <tenzir/detail/scope_guard.hpp>
 #include <tenzir/operator_plugin.hpp>
 #include <tenzir/pcap.hpp>
 #include <tenzir/pipeline_metrics.hpp>
@@ -31,6 +36,12 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#  include <net/if.h>
+#endif
 
 namespace tenzir::plugins::nic {
 
@@ -41,6 +52,12 @@ constexpr auto queue_capacity = uint32_t{16};
 // monopolize the shared IO executor. If a dispatch saturates this limit, we
 // reschedule ourselves immediately to continue draining.
 constexpr auto dispatch_packet_limit = size_t{1024};
+// Capture threads retry enqueuing chunks with this backoff while the queue is
+// full, and fetch the drop counters of their ring at this interval.
+constexpr auto chunk_queue_backoff = std::chrono::milliseconds{1};
+constexpr auto ring_stats_interval = std::chrono::seconds{1};
+constexpr auto max_workers = uint64_t{64};
+constexpr auto filter_handle_buffer_size = int{1} << 16;
 
 using ChunkQueue = folly::coro::BoundedQueue<chunk_ptr>;
 using PcapHandle = std::unique_ptr<pcap_t, decltype(&pcap_close)>;
@@ -50,6 +67,8 @@ struct FromNicArgs {
   Option<located<uint64_t>> snaplen;
   Option<located<std::string>> filter;
   Option<located<ir::pipeline>> parser;
+  Option<located<uint64_t>> workers;
+  Option<located<std::string>> fanout;
   location self;
 };
 
@@ -247,6 +266,24 @@ private:
   Notify notify_;
 };
 
+auto compile_capture_filter(pcap_t& pcap, std::string const& iface,
+                            located<std::string> const& filter,
+                            diagnostic_handler& dh) -> Option<bpf_program> {
+  TENZIR_DEBUG("applying capture filter `{}` on {}", filter.inner, iface);
+  auto program = bpf_program{};
+  auto netmask = lookup_capture_netmask(iface);
+  if (pcap_compile(&pcap, &program, filter.inner.c_str(), 1, netmask) < 0) {
+    auto err = std::string_view{::pcap_geterr(&pcap)};
+    diagnostic::error("failed to compile capture filter: {}", err)
+      .primary(filter.source)
+      .note("capture filter: {}", filter.inner)
+      .note("from `nic`")
+      .emit(dh);
+    return None{};
+  }
+  return program;
+}
+
 auto make_capture_setup(std::string const& iface, uint32_t snaplen,
                         Option<located<std::string>> const& filter,
                         diagnostic_handler& dh) -> Option<CaptureSetup> {
@@ -267,22 +304,12 @@ auto make_capture_setup(std::string const& iface, uint32_t snaplen,
   }
   auto result = CaptureSetup{PcapHandle{raw, &pcap_close}};
   if (filter) {
-    TENZIR_DEBUG("applying capture filter `{}` on {}", filter->inner, iface);
-    auto program = bpf_program{};
-    auto netmask = lookup_capture_netmask(iface);
-    if (pcap_compile(result.pcap.get(), &program, filter->inner.c_str(), 1,
-                     netmask)
-        < 0) {
-      auto err = std::string_view{::pcap_geterr(result.pcap.get())};
-      diagnostic::error("failed to compile capture filter: {}", err)
-        .primary(filter->source)
-        .note("capture filter: {}", filter->inner)
-        .note("from `nic`")
-        .emit(dh);
+    auto program = compile_capture_filter(*result.pcap, iface, *filter, dh);
+    if (not program) {
       return None{};
     }
-    auto set_filter_result = pcap_setfilter(result.pcap.get(), &program);
-    pcap_freecode(&program);
+    auto set_filter_result = pcap_setfilter(result.pcap.get(), &*program);
+    pcap_freecode(&*program);
     if (set_filter_result < 0) {
       auto err = std::string_view{::pcap_geterr(result.pcap.get())};
       diagnostic::error("failed to install capture filter: {}", err)
@@ -322,6 +349,172 @@ auto dispatch_packets(u_char* user, const pcap_pkthdr* pkt_hdr,
   }
 }
 
+#ifdef __linux__
+
+/// State that the operator shares with the threads that read from rings.
+struct RingCapture {
+  explicit RingCapture(std::shared_ptr<ChunkQueue> queue)
+    : queue{std::move(queue)} {
+  }
+
+  std::shared_ptr<ChunkQueue> queue;
+  Atomic<bool> stop_requested = false;
+  /// The last capture thread to finish closes the queue.
+  Atomic<size_t> running_workers = 0;
+
+  auto produce(chunk_ptr const& chunk) -> void {
+    while (not stop_requested.load(std::memory_order_acquire)) {
+      if (queue->try_enqueue(chunk)) {
+        return;
+      }
+      std::this_thread::sleep_for(chunk_queue_backoff);
+    }
+  }
+
+  auto request_stop() -> void {
+    stop_requested.store(true, std::memory_order_release);
+  }
+
+  /// Reads packets from a ring until we stop, and returns a description of
+  /// the problem if capturing fails. This blocks, so it must run on a thread
+  /// of its own.
+  auto run(PacketRing& ring, uint32_t snaplen, MetricsCounter& dropped)
+    -> Option<std::string> {
+    auto builder = CaptureChunkBuilder{snaplen, ring.linktype()};
+    auto on_packet = PacketRing::packet_callback{
+      [&](const pcap_pkthdr& pkt_hdr, const u_char* pkt_data) {
+        if (auto chunk = builder.append(pkt_hdr, pkt_data)) {
+          produce(chunk);
+        }
+      }};
+    auto result = Option<std::string>{};
+    auto error = std::string{};
+    auto last_stats = std::chrono::steady_clock::now();
+    while (not stop_requested.load(std::memory_order_acquire)) {
+      if (not ring.wait(defaults::import::read_timeout, error)) {
+        result = std::move(error);
+        break;
+      }
+      while (not stop_requested.load(std::memory_order_acquire)
+             and ring.read_block(on_packet)) {
+      }
+      auto now = std::chrono::steady_clock::now();
+      if (auto chunk = builder.flush_if_ready(now)) {
+        produce(chunk);
+      }
+      if (now - last_stats >= ring_stats_interval) {
+        dropped.add(ring.stats().drops);
+        last_stats = now;
+      }
+    }
+    if (auto chunk = builder.flush()) {
+      produce(chunk);
+    }
+    dropped.add(ring.stats().drops);
+    return result;
+  }
+};
+
+/// Activates a libpcap handle for an interface only to compile capture
+/// filters for it. It never reads packets, so its buffer stays small.
+auto make_filter_handle(located<std::string> const& iface, uint32_t snaplen,
+                        diagnostic_handler& dh) -> Option<PcapHandle> {
+  auto error = std::array<char, PCAP_ERRBUF_SIZE>{};
+  auto result
+    = PcapHandle{pcap_create(iface.inner.c_str(), error.data()), &pcap_close};
+  if (not result) {
+    diagnostic::error("failed to open interface: {}",
+                      std::string_view{error.data()})
+      .primary(iface.source)
+      .note("from `nic`")
+      .emit(dh);
+    return None{};
+  }
+  pcap_set_snaplen(result.get(), detail::narrow_cast<int>(snaplen));
+  pcap_set_buffer_size(result.get(), filter_handle_buffer_size);
+  // Positive values are warnings, which do not affect compiling filters.
+  if (pcap_activate(result.get()) < 0) {
+    diagnostic::error("failed to open interface: {}",
+                      std::string_view{::pcap_geterr(result.get())})
+      .primary(iface.source)
+      .note("from `nic`")
+      .emit(dh);
+    return None{};
+  }
+  return result;
+}
+
+/// Opens one ring per worker. Multiple rings share the packets of the
+/// interface through a fanout group.
+auto make_packet_rings(FromNicArgs const& args, uint32_t snaplen,
+                       diagnostic_handler& dh)
+  -> Option<std::vector<std::unique_ptr<PacketRing>>> {
+  auto workers = args.workers ? args.workers->inner : uint64_t{1};
+  auto fanout = Option<FanoutMode>{};
+  if (args.fanout) {
+    fanout = args.fanout->inner == "cpu" ? FanoutMode::cpu : FanoutMode::hash;
+  } else if (workers > 1) {
+    fanout = FanoutMode::hash;
+  }
+  // The kernel runs the same classic BPF programs as libpcap. A dead handle
+  // would not do, though: only for an activated handle of a Linux interface
+  // does libpcap match VLAN tags that the kernel already stripped through
+  // BPF extensions instead of the packet bytes, and our rings see the same
+  // packets as its socket. So we activate a handle just for compiling.
+  auto program = Option<bpf_program>{};
+  if (args.filter) {
+    auto live = make_filter_handle(args.iface, snaplen, dh);
+    if (not live) {
+      return None{};
+    }
+    program
+      = compile_capture_filter(**live, args.iface.inner, *args.filter, dh);
+    if (not program) {
+      return None{};
+    }
+  }
+  auto free_program = detail::scope_guard{[&]() noexcept {
+    if (program) {
+      pcap_freecode(&*program);
+    }
+  }};
+  auto options = PacketRingOptions{
+    .iface = args.iface.inner,
+    .snaplen = snaplen,
+    .filter = program ? &*program : nullptr,
+    .block_timeout = defaults::import::read_timeout,
+  };
+  auto result = std::vector<std::unique_ptr<PacketRing>>{};
+  auto group = Option<uint16_t>{};
+  auto error = std::string{};
+  for (auto i = uint64_t{0}; i < workers; ++i) {
+    auto ring = PacketRing::make(options, error);
+    if (ring and fanout) {
+      if (not group) {
+        group = ring->create_fanout_group(*fanout, error);
+        if (not group) {
+          ring = nullptr;
+        }
+      } else if (not ring->join_fanout_group(*group, *fanout, error)) {
+        ring = nullptr;
+      }
+    }
+    if (not ring) {
+      diagnostic::error("failed to open interface: {}", error)
+        .primary(args.iface.source)
+        .note("from `nic`")
+        .emit(dh);
+      return None{};
+    }
+    result.push_back(std::move(ring));
+  }
+  TENZIR_DEBUG("capturing from {} with {} TPACKET_V3 ring(s)", args.iface.inner,
+               result.size());
+  return result;
+}
+
+#endif
+
 class FromNic final : public Operator<void, table_slice> {
 public:
   explicit FromNic(FromNicArgs args) : args_{std::move(args)} {
@@ -346,20 +539,39 @@ public:
     auto snaplen
       = args_.snaplen ? args_.snaplen->inner : uint64_t{pcap::maximum_snaplen};
     auto capture_snaplen = detail::narrow_cast<uint32_t>(snaplen);
+#ifdef __linux__
+    // Capture from memory-mapped rings where we can, and leave all other link
+    // types to libpcap.
+    if (PacketRing::linktype(args_.iface.inner)) {
+      auto rings = make_packet_rings(args_, capture_snaplen, ctx.dh());
+      if (not rings) {
+        done_ = true;
+        co_return;
+      }
+      make_counters(ctx);
+      co_await ctx.spawn_sub<chunk_ptr>(caf::none, std::move(parser));
+      start_workers(ctx, std::move(*rings), capture_snaplen);
+      co_return;
+    }
+    auto wants_rings
+      = (args_.workers and args_.workers->inner > 1) or args_.fanout;
+    if (wants_rings and ::if_nametoindex(args_.iface.inner.c_str()) != 0) {
+      diagnostic::error("`workers` and `fanout` require an Ethernet or "
+                        "loopback interface")
+        .primary(args_.fanout ? args_.fanout->source : args_.workers->source)
+        .note("from `nic`")
+        .emit(ctx);
+      done_ = true;
+      co_return;
+    }
+#endif
     auto setup = make_capture_setup(args_.iface.inner, capture_snaplen,
                                     args_.filter, ctx.dh());
     if (not setup) {
       done_ = true;
       co_return;
     }
-    bytes_read_counter_
-      = ctx.make_counter(MetricsLabel{"operator", "from_nic"},
-                         MetricsDirection::read, MetricsVisibility::external_,
-                         MetricsUnit::bytes);
-    events_read_counter_
-      = ctx.make_counter(MetricsLabel{"operator", "from_nic"},
-                         MetricsDirection::read, MetricsVisibility::external_,
-                         MetricsUnit::events);
+    make_counters(ctx);
     co_await ctx.spawn_sub<chunk_ptr>(caf::none, std::move(parser));
     auto io_executor = ctx.io_executor();
     auto* evb = io_executor->getEventBase();
@@ -422,11 +634,70 @@ public:
     events_read_counter_.add(rows);
   }
 
+  auto stop(OpCtx&) -> Task<void> override {
+#ifdef __linux__
+    if (ring_capture_) {
+      ring_capture_->request_stop();
+    }
+#endif
+    co_return;
+  }
+
   auto state() -> OperatorState override {
     return done_ ? OperatorState::done : OperatorState::normal;
   }
 
 private:
+  auto make_counters(OpCtx& ctx) -> void {
+    bytes_read_counter_
+      = ctx.make_counter(MetricsLabel{"operator", "from_nic"},
+                         MetricsDirection::read, MetricsVisibility::external_,
+                         MetricsUnit::bytes);
+    events_read_counter_
+      = ctx.make_counter(MetricsLabel{"operator", "from_nic"},
+                         MetricsDirection::read, MetricsVisibility::external_,
+                         MetricsUnit::events);
+  }
+
+#ifdef __linux__
+  auto start_workers(OpCtx& ctx, std::vector<std::unique_ptr<PacketRing>> rings,
+                     uint32_t snaplen) -> void {
+    // Packets that the kernel dropped because a ring was full.
+    auto dropped
+      = ctx.make_counter(MetricsLabel{"dropped_by", "kernel"},
+                         MetricsDirection::read, MetricsVisibility::internal_,
+                         MetricsUnit::events);
+    ring_capture_ = std::make_shared<RingCapture>(chunk_queue_);
+    ring_capture_->running_workers.store(rings.size(),
+                                         std::memory_order_release);
+    // Helper task to stop the capture threads on cancellation.
+    ctx.spawn_task([capture = ring_capture_]() -> Task<void> {
+      if (not co_await catch_cancellation(wait_forever())) {
+        capture->request_stop();
+      }
+    });
+    for (auto& ring : rings) {
+      ctx.spawn_task([capture = ring_capture_, ring = std::move(ring), snaplen,
+                      dropped,
+                      &dh = ctx.dh()]() mutable -> Task<void> {
+        // The thread owns the ring, so that it outlives this task if we get
+        // cancelled while waiting for the thread to notice.
+        auto error = co_await spawn_blocking(
+          [capture, ring = std::move(ring), snaplen, dropped]() mutable {
+            return capture->run(*ring, snaplen, dropped);
+          });
+        if (error) {
+          diagnostic::error("{}", *error).note("from `nic`").emit(dh);
+        }
+        if (capture->running_workers.fetch_sub(1, std::memory_order_acq_rel)
+            == 1) {
+          co_await capture->queue->enqueue(chunk_ptr{});
+        }
+      });
+    }
+  }
+#endif
+
   static auto capture_loop(std::shared_ptr<ChunkQueue> queue, std::string iface,
                            uint32_t snaplen, CaptureSetup setup,
                            folly::EventBase& evb, diagnostic_handler& dh)
@@ -494,6 +765,9 @@ private:
   mutable std::shared_ptr<Notify> sub_finished_ = std::make_shared<Notify>();
   mutable std::shared_ptr<ChunkQueue> chunk_queue_
     = std::make_shared<ChunkQueue>(queue_capacity);
+#ifdef __linux__
+  std::shared_ptr<RingCapture> ring_capture_;
+#endif
 };
 
 class FromNicPlugin final : public virtual OperatorPlugin {
@@ -510,6 +784,8 @@ public:
     auto filter = d.named("filter", &FromNicArgs::filter);
     auto parser
       = d.pipeline(&FromNicArgs::parser, SubOptimize::from_downstream);
+    auto workers = d.named("workers", &FromNicArgs::workers);
+    auto fanout = d.named("fanout", &FromNicArgs::fanout);
     d.validate([=](DescribeCtx& ctx) -> Empty {
       TRY(auto iface_value, ctx.get(iface));
       if (iface_value.inner.empty()) {
@@ -535,6 +811,31 @@ public:
             .emit(ctx);
         }
       }
+      if (auto workers_value = ctx.get(workers)) {
+        if (workers_value->inner == 0
+            or workers_value->inner > max_workers) {
+          diagnostic::error("`workers` must be between 1 and {}", max_workers)
+            .primary(workers_value->source)
+            .emit(ctx);
+        }
+#ifndef __linux__
+        diagnostic::error("`workers` is only supported on Linux")
+          .primary(workers_value->source)
+          .emit(ctx);
+#endif
+      }
+      if (auto fanout_value = ctx.get(fanout)) {
+        if (fanout_value->inner != "hash" and fanout_value->inner != "cpu") {
+          diagnostic::error("`fanout` must be `hash` or `cpu`")
+            .primary(fanout_value->source)
+            .emit(ctx);
+        }
+#ifndef __linux__
+        diagnostic::error("`fanout` is only supported on Linux")
+          .primary(fanout_value->source)
+          .emit(ctx);
+#endif
+      }
       if (auto parser_value = ctx.get(parser)) {
         auto output = parser_value->inner.infer_type(tag_v<chunk_ptr>, ctx);
         if (output.is_error()) {
@@ -0,0 +1,144 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#ifdef __linux__
+
+#  include <tenzir/option.hpp>
+
+#  include <pcap/pcap.h>
+
+#  include <chrono>
+#  include <cstddef>
+#  include <cstdint>
+#  include <functional>
+#  include <memory>
+#  include <string>
+#  include <vector>
+
+namespace tenzir::plugins::nic {
+
+/// How the kernel distributes packets among the rings of a fanout group.
+enum class FanoutMode {
+  /// By a hash over the flow, so that all packets of a flow end up in the
+  /// same ring.
+  hash,
+  /// By the CPU that received the packet.
+  cpu,
+};
+
+/// The configuration of a single ring.
+struct PacketRingOptions {
+  std::string iface;
+  uint32_t snaplen = 0;
+  /// The compiled capture filter, if any. The kernel keeps its own copy.
+  const bpf_program* filter = nullptr;
+  /// The maximum time the kernel waits before it hands a partially filled
+  /// block to user space.
+  std::chrono::milliseconds block_timeout{};
+};
+
+/// Counters of the kernel since the previous call to `PacketRing::stats()`.
+struct PacketRingStats {
+  uint64_t packets = 0;
+  uint64_t drops = 0;
+};
+
+/// Converts the packets of TPACKET_V3 blocks into the format of libpcap.
+class PacketBlockReader {
+public:
+  /// Called for every packet of a block with a header in the format of
+  /// libpcap and the captured bytes.
+  using packet_callback
+    = std::function<void(const pcap_pkthdr&, const u_char*)>;
+
+  PacketBlockReader(int linktype, uint32_t snaplen, bool loopback)
+    : linktype_{linktype}, snaplen_{snaplen}, loopback_{loopback} {
+  }
+
+  /// Invokes the callback for every packet of a block that the kernel handed
+  /// over. The block must start with a `tpacket_block_desc`.
+  auto read(const std::byte* block, const packet_callback& f) -> void;
+
+private:
+  int linktype_ = 0;
+  uint32_t snaplen_ = 0;
+  bool loopback_ = false;
+  /// Holds a packet whose VLAN tag the kernel stripped, after reinserting it.
+  std::vector<u_char> scratch_;
+};
+
+/// A packet socket with a memory-mapped TPACKET_V3 receive ring.
+///
+/// The kernel writes packets into fixed-size blocks of a ring that is shared
+/// with user space, and only hands over a block once it is full or its
+/// timeout expired. Reading a block thus requires no system call and no copy
+/// on the side of the kernel, which is what makes capturing at line rate
+/// feasible. A ring is not thread-safe, but multiple rings can share the
+/// packets of an interface through a fanout group.
+class PacketRing {
+public:
+  using packet_callback = PacketBlockReader::packet_callback;
+
+  /// Returns the libpcap link type of an interface, or `None` if the
+  /// interface does not exist or its link type is not supported by rings.
+  static auto linktype(const std::string& iface) -> Option<int>;
+
+  /// Opens a ring on an interface in promiscuous mode. On failure, returns
+  /// `nullptr` and a description of the problem in `error`.
+  static auto make(const PacketRingOptions& options, std::string& error)
+    -> std::unique_ptr<PacketRing>;
+
+  ~PacketRing();
+  PacketRing(const PacketRing&) = delete;
+  auto operator=(const PacketRing&) -> PacketRing& = delete;
+  PacketRing(PacketRing&&) = delete;
+  auto operator=(PacketRing&&) -> PacketRing& = delete;
+
+  /// Makes this ring the first member of a new fanout group and returns the
+  /// ID of the group.
+  auto create_fanout_group(FanoutMode mode, std::string& error)
+    -> Option<uint16_t>;
+
+  /// Joins the fanout group that another ring created.
+  auto join_fanout_group(uint16_t group, FanoutMode mode, std::string& error)
+    -> bool;
+
+  /// Waits until the kernel hands over a block or the timeout expires.
+  /// Returns `false` and a description of the problem in `error` on failure.
+  auto wait(std::chrono::milliseconds timeout, std::string& error) -> bool;
+
+  /// Invokes the callback for every packet of the next block, if the kernel
+  /// already handed it over, and returns the block to the kernel afterwards.
+  /// Returns whether there was such a block.
+  auto read_block(const packet_callback& f) -> bool;
+
+  /// Fetches and resets the counters of the kernel.
+  auto stats() -> PacketRingStats;
+
+  auto linktype() const -> int {
+    return linktype_;
+  }
+
+private:
+  PacketRing() = default;
+
+  int fd_ = -1;
+  int linktype_ = 0;
+  std::byte* map_ = nullptr;
+  size_t map_size_ = 0;
+  size_t block_size_ = 0;
+  size_t num_blocks_ = 0;
+  size_t next_block_ = 0;
+  PacketBlockReader reader_{0, 0, false};
+};
+
+} // namespace tenzir::plugins::nic
+
+#endif
@@ -0,0 +1,340 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifdef __linux__
+
+#  include "packet_ring.hpp"
+
+#  include <tenzir/detail/assert.hpp>
+#  include <tenzir/detail/narrow.hpp>
+#  include <tenzir/logger.hpp>
+
+#  include <arpa/inet.h>
+#  include <fmt/format.h>
+#  include <linux/if_ether.h>
+#  include <linux/if_packet.h>
+#  include <net/if.h>
+#  include <net/if_arp.h>
+#  include <poll.h>
+#  include <sys/ioctl.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+
+#  include <algorithm>
+#  include <array>
+#  include <cerrno>
+#  include <cstring>
+
+namespace tenzir::plugins::nic {
+
+namespace {
+
+// Every ring maps 64 MiB, which buffers about 50 ms of a saturated 10G link.
+constexpr auto block_size = size_t{1} << 20;
+constexpr auto num_blocks = size_t{64};
+// TPACKET_V3 packs packets of variable size into blocks, so the frame size
+// only matters for the bookkeeping of the kernel.
+constexpr auto frame_size = size_t{2048};
+constexpr auto vlan_tag_size = size_t{4};
+constexpr auto ethernet_addresses_size = size_t{12};
+
+auto system_error(std::string_view what) -> std::string {
+  return fmt::format("{}: {}", what, std::strerror(errno));
+}
+
+auto to_fanout_type(FanoutMode mode) -> int {
+  switch (mode) {
+    case FanoutMode::hash:
+      // Reassemble fragments first, so that they hash like the rest of their
+      // flow.
+      return PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG;
+    case FanoutMode::cpu:
+      return PACKET_FANOUT_CPU;
+  }
+  TENZIR_UNREACHABLE();
+}
+
+} // namespace
+
+auto PacketRing::linktype(const std::string& iface) -> Option<int> {
+  auto fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    return None{};
+  }
+  auto ifr = ifreq{};
+  if (iface.size() >= sizeof(ifr.ifr_name)) {
+    ::close(fd);
+    return None{};
+  }
+  std::memcpy(ifr.ifr_name, iface.data(), iface.size());
+  auto result = ::ioctl(fd, SIOCGIFHWADDR, &ifr);
+  ::close(fd);
+  if (result == -1) {
+    return None{};
+  }
+  // libpcap also presents the loopback interface as Ethernet on Linux. We
+  // leave all other link types to libpcap, which knows how to translate them.
+  switch (ifr.ifr_hwaddr.sa_family) {
+    case ARPHRD_ETHER:
+    case ARPHRD_LOOPBACK:
+      return DLT_EN10MB;
+    default:
+      return None{};
+  }
+}
+
+auto PacketRing::make(const PacketRingOptions& options, std::string& error)
+  -> std::unique_ptr<PacketRing> {
+  auto linktype = PacketRing::linktype(options.iface);
+  if (not linktype) {
+    error = fmt::format("unsupported interface `{}`", options.iface);
+    return nullptr;
+  }
+  auto ifindex = ::if_nametoindex(options.iface.c_str());
+  if (ifindex == 0) {
+    error = system_error("failed to look up interface");
+    return nullptr;
+  }
+  auto result = std::unique_ptr<PacketRing>{new PacketRing};
+  result->linktype_ = *linktype;
+  result->reader_ = PacketBlockReader{*linktype, options.snaplen,
+                                      ::if_nametoindex("lo") == ifindex};
+  // A protocol of zero means that the socket receives nothing until we bind
+  // it, so no packet bypasses the filter.
+  result->fd_ = ::socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0);
+  if (result->fd_ == -1) {
+    error = system_error("failed to create packet socket");
+    return nullptr;
+  }
+  auto fd = result->fd_;
+  auto version = int{TPACKET_V3};
+  if (::setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version))
+      == -1) {
+    error = system_error("failed to select TPACKET_V3");
+    return nullptr;
+  }
+  if (options.filter) {
+    // The instructions of libpcap and the kernel share the same layout.
+    auto program = sock_fprog{
+      .len = detail::narrow_cast<unsigned short>(options.filter->bf_len),
+      .filter = reinterpret_cast<sock_filter*>(options.filter->bf_insns),
+    };
+    if (::setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &program,
+                     sizeof(program))
+        == -1) {
+      error = system_error("failed to attach capture filter");
+      return nullptr;
+    }
+  }
+  auto req = tpacket_req3{};
+  req.tp_block_size = detail::narrow_cast<unsigned int>(block_size);
+  req.tp_block_nr = detail::narrow_cast<unsigned int>(num_blocks);
+  req.tp_frame_size = detail::narrow_cast<unsigned int>(frame_size);
+  req.tp_frame_nr
+    = detail::narrow_cast<unsigned int>(block_size * num_blocks / frame_size);
+  req.tp_retire_blk_tov = detail::narrow_cast<unsigned int>(
+    std::max(options.block_timeout.count(), int64_t{1}));
+  if (::setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == -1) {
+    error = system_error("failed to set up receive ring");
+    return nullptr;
+  }
+  result->block_size_ = block_size;
+  result->num_blocks_ = num_blocks;
+  result->map_size_ = block_size * num_blocks;
+  auto* map = ::mmap(nullptr, result->map_size_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_LOCKED, fd, 0);
+  if (map == MAP_FAILED) {
+    // Locking the ring may exceed `RLIMIT_MEMLOCK`, which is only a matter of
+    // performance.
+    map = ::mmap(nullptr, result->map_size_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd, 0);
+  }
+  if (map == MAP_FAILED) {
+    error = system_error("failed to map receive ring");
+    return nullptr;
+  }
+  result->map_ = static_cast<std::byte*>(map);
+  auto addr = sockaddr_ll{};
+  addr.sll_family = AF_PACKET;
+  addr.sll_protocol = htons(ETH_P_ALL);
+  addr.sll_ifindex = detail::narrow_cast<int>(ifindex);
+  if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+    error = system_error("failed to bind packet socket");
+    return nullptr;
+  }
+  // The kernel drops the membership when we close the socket.
+  auto mreq = packet_mreq{};
+  mreq.mr_ifindex = detail::narrow_cast<int>(ifindex);
+  mreq.mr_type = PACKET_MR_PROMISC;
+  if (::setsockopt(fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq))
+      == -1) {
+    error = system_error("failed to enable promiscuous mode");
+    return nullptr;
+  }
+  TENZIR_DEBUG("opened TPACKET_V3 ring with {} blocks of {} bytes on {}",
+               num_blocks, block_size, options.iface);
+  return result;
+}
+
+PacketRing::~PacketRing() {
+  if (map_) {
+    ::munmap(map_, map_size_);
+  }
+  if (fd_ != -1) {
+    ::close(fd_);
+  }
+}
+
+auto PacketRing::create_fanout_group(FanoutMode mode, std::string& error)
+  -> Option<uint16_t> {
+#  ifdef PACKET_FANOUT_FLAG_UNIQUEID
+  // Let the kernel pick an ID, so that we never join the group of another
+  // process by accident.
+  auto arg = (to_fanout_type(mode) | PACKET_FANOUT_FLAG_UNIQUEID) << 16;
+  if (::setsockopt(fd_, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg)) == -1) {
+    error = system_error("failed to create fanout group");
+    return None{};
+  }
+  auto value = int{0};
+  auto length = socklen_t{sizeof(value)};
+  if (::getsockopt(fd_, SOL_PACKET, PACKET_FANOUT, &value, &length) == -1) {
+    error = system_error("failed to query fanout group");
+    return None{};
+  }
+  return static_cast<uint16_t>(value & 0xffff);
+#  else
+  // Without unique IDs, we derive one from our PID and retry on collisions
+  // with groups of a different type.
+  for (auto attempt = 0; attempt < 16; ++attempt) {
+    auto group = static_cast<uint16_t>(::getpid() + attempt * 4099);
+    if (join_fanout_group(group, mode, error)) {
+      return group;
+    }
+  }
+  return None{};
+#  endif
+}
+
+auto PacketRing::join_fanout_group(uint16_t group, FanoutMode mode,
+                                   std::string& error) -> bool {
+  auto arg = group | (to_fanout_type(mode) << 16);
+  if (::setsockopt(fd_, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg)) == -1) {
+    error = system_error("failed to join fanout group");
+    return false;
+  }
+  return true;
+}
+
+auto PacketRing::wait(std::chrono::milliseconds timeout, std::string& error)
+  -> bool {
+  auto pfd = pollfd{.fd = fd_, .events = POLLIN, .revents = 0};
+  auto result = ::poll(&pfd, 1, detail::narrow_cast<int>(timeout.count()));
+  if (result == -1) {
+    if (errno == EINTR) {
+      return true;
+    }
+    error = system_error("failed to wait for packets");
+    return false;
+  }
+  if ((pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
+    // The kernel reports, e.g., an interface that went down as a pending
+    // error on the socket.
+    auto value = int{0};
+    auto length = socklen_t{sizeof(value)};
+    if (::getsockopt(fd_, SOL_SOCKET, SO_ERROR, &value, &length) == 0
+        and value != 0) {
+      error = fmt::format("failed to capture packets: {}",
+                          std::strerror(value));
+      return false;
+    }
+  }
+  return true;
+}
+
+auto PacketBlockReader::read(const std::byte* block, const packet_callback& f)
+  -> void {
+  const auto* desc = reinterpret_cast<const tpacket_block_desc*>(block);
+  const auto num_packets = desc->hdr.bh1.num_pkts;
+  const auto* packet = block + desc->hdr.bh1.offset_to_first_pkt;
+  for (auto i = uint32_t{0}; i < num_packets; ++i) {
+    const auto* hdr = reinterpret_cast<const tpacket3_hdr*>(packet);
+    const auto* addr = reinterpret_cast<const sockaddr_ll*>(
+      packet + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+    const auto* data = reinterpret_cast<const u_char*>(packet + hdr->tp_mac);
+    packet += hdr->tp_next_offset;
+    // On the loopback interface, every packet shows up once as outgoing and
+    // once as incoming, and libpcap skips the former.
+    if (loopback_ and addr->sll_pkttype == PACKET_OUTGOING) {
+      continue;
+    }
+    auto pkt_hdr = pcap_pkthdr{};
+    pkt_hdr.ts.tv_sec = hdr->tp_sec;
+    pkt_hdr.ts.tv_usec = hdr->tp_nsec / 1000;
+    pkt_hdr.len = hdr->tp_len;
+    pkt_hdr.caplen = std::min(hdr->tp_snaplen, snaplen_);
+    // The kernel strips VLAN tags that the NIC already parsed, so we put them
+    // back where they belong, as libpcap does.
+    if ((hdr->tp_status & TP_STATUS_VLAN_VALID) != 0
+        and linktype_ == DLT_EN10MB
+        and hdr->tp_snaplen >= ethernet_addresses_size) {
+      const auto tpid
+        = (hdr->tp_status & TP_STATUS_VLAN_TPID_VALID) != 0
+            ? hdr->hv1.tp_vlan_tpid
+            : static_cast<decltype(hdr->hv1.tp_vlan_tpid)>(ETH_P_8021Q);
+      const auto tag = std::array<uint16_t, 2>{
+        htons(tpid),
+        htons(static_cast<uint16_t>(hdr->hv1.tp_vlan_tci)),
+      };
+      scratch_.resize(hdr->tp_snaplen + vlan_tag_size);
+      std::memcpy(scratch_.data(), data, ethernet_addresses_size);
+      std::memcpy(scratch_.data() + ethernet_addresses_size, tag.data(),
+                  vlan_tag_size);
+      std::memcpy(scratch_.data() + ethernet_addresses_size + vlan_tag_size,
+                  data + ethernet_addresses_size,
+                  hdr->tp_snaplen - ethernet_addresses_size);
+      pkt_hdr.len += vlan_tag_size;
+      pkt_hdr.caplen = std::min(
+        hdr->tp_snaplen + detail::narrow_cast<uint32_t>(vlan_tag_size),
+        snaplen_);
+      data = scratch_.data();
+    }
+    f(pkt_hdr, data);
+  }
+}
+
+auto PacketRing::read_block(const packet_callback& f) -> bool {
+  auto* block = reinterpret_cast<tpacket_block_desc*>(
+    map_ + (next_block_ * block_size_));
+  auto& status = block->hdr.bh1.block_status;
+  // Pairs with the release of the kernel once it retires the block.
+  if ((__atomic_load_n(&status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0) {
+    return false;
+  }
+  reader_.read(reinterpret_cast<const std::byte*>(block), f);
+  __atomic_store_n(&status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+  next_block_ = (next_block_ + 1) % num_blocks_;
+  return true;
+}
+
+auto PacketRing::stats() -> PacketRingStats {
+  auto stats = tpacket_stats_v3{};
+  auto length = socklen_t{sizeof(stats)};
+  if (::getsockopt(fd_, SOL_PACKET, PACKET_STATISTICS, &stats, &length)
+      == -1) {
+    return {};
+  }
+  return {
+    .packets = stats.tp_packets,
+    .drops = stats.tp_drops,
+  };
+}
+
+} // namespace tenzir::plugins::nic
+
+#endif
@@ -0,0 +1,179 @@
+//
+//  ▀▀█▀▀ █▀▀▀ █▄  █ ▀▀▀█▀ ▀█▀ █▀▀▄
+//    █   █▀▀  █ ▀▄█  ▄▀    █  █▀▀▄
+//    ▀   ▀▀▀▀ ▀   ▀ ▀▀▀▀▀ ▀▀▀ ▀  ▀
+//
+// SPDX-FileCopyrightText: (c) 2026 The Tenzir Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifdef __linux__
+
+#  include "packet_ring.hpp"
+
+#  include <tenzir/test/test.hpp>
+
+#  include <linux/if_ether.h>
+#  include <linux/if_packet.h>
+
+#  include <array>
+#  include <cstring>
+#  include <span>
+#  include <vector>
+
+using namespace tenzir::plugins::nic;
+
+namespace {
+
+struct TestPacket {
+  std::vector<u_char> bytes;
+  uint32_t status = TP_STATUS_USER;
+  uint16_t vlan_tci = 0;
+  uint16_t vlan_tpid = 0;
+  unsigned char pkttype = PACKET_HOST;
+};
+
+struct ReadPacket {
+  pcap_pkthdr hdr;
+  std::vector<u_char> bytes;
+};
+
+/// Lays out packets the way the kernel fills a TPACKET_V3 block.
+auto make_block(std::span<const TestPacket> packets) -> std::vector<std::byte> {
+  auto result = std::vector<std::byte>{};
+  auto offset = size_t{TPACKET_ALIGN(sizeof(tpacket_block_desc))};
+  auto desc = tpacket_block_desc{};
+  desc.version = TPACKET_V3;
+  desc.hdr.bh1.block_status = TP_STATUS_USER;
+  desc.hdr.bh1.num_pkts = static_cast<uint32_t>(packets.size());
+  desc.hdr.bh1.offset_to_first_pkt = static_cast<uint32_t>(offset);
+  result.resize(offset);
+  std::memcpy(result.data(), &desc, sizeof(desc));
+  const auto mac = TPACKET_ALIGN(sizeof(tpacket3_hdr))
+                   + TPACKET_ALIGN(sizeof(sockaddr_ll));
+  for (const auto& packet : packets) {
+    const auto size = TPACKET_ALIGN(mac + packet.bytes.size());
+    auto hdr = tpacket3_hdr{};
+    hdr.tp_next_offset = static_cast<uint32_t>(size);
+    hdr.tp_sec = 42;
+    hdr.tp_nsec = 7000;
+    hdr.tp_snaplen = static_cast<uint32_t>(packet.bytes.size());
+    hdr.tp_len = static_cast<uint32_t>(packet.bytes.size());
+    hdr.tp_status = packet.status;
+    hdr.tp_mac = static_cast<uint16_t>(mac);
+    hdr.hv1.tp_vlan_tci = packet.vlan_tci;
+    hdr.hv1.tp_vlan_tpid = packet.vlan_tpid;
+    auto addr = sockaddr_ll{};
+    addr.sll_pkttype = packet.pkttype;
+    result.resize(offset + size);
+    auto* base = result.data() + offset;
+    std::memcpy(base, &hdr, sizeof(hdr));
+    std::memcpy(base + TPACKET_ALIGN(sizeof(tpacket3_hdr)), &addr,
+                sizeof(addr));
+    std::memcpy(base + mac, packet.bytes.data(), packet.bytes.size());
+    offset += size;
+  }
+  return result;
+}
+
+auto read_packets(PacketBlockReader& reader,
+                  std::span<const TestPacket> packets)
+  -> std::vector<ReadPacket> {
+  const auto block = make_block(packets);
+  auto result = std::vector<ReadPacket>{};
+  reader.read(block.data(), [&](const pcap_pkthdr& hdr, const u_char* data) {
+    result.push_back({hdr, {data, data + hdr.caplen}});
+  });
+  return result;
+}
+
+/// An Ethernet frame with IPv4 as EtherType and a few bytes of payload.
+auto make_frame() -> std::vector<u_char> {
+  return {
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, // destination
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, // source
+    0x08, 0x00,                         // EtherType
+    0xde, 0xad, 0xbe, 0xef,             // payload
+  };
+}
+
+/// The same frame with a VLAN tag between the addresses and the EtherType.
+auto make_tagged_frame(uint16_t tpid, uint16_t tci) -> std::vector<u_char> {
+  auto result = make_frame();
+  const auto tag = std::array<u_char, 4>{
+    static_cast<u_char>(tpid >> 8),
+    static_cast<u_char>(tpid & 0xff),
+    static_cast<u_char>(tci >> 8),
+    static_cast<u_char>(tci & 0xff),
+  };
+  result.insert(result.begin() + 12, tag.begin(), tag.end());
+  return result;
+}
+
+} // namespace
+
+TEST("untagged packets pass unchanged") {
+  auto reader = PacketBlockReader{DLT_EN10MB, 65535, false};
+  const auto packets = std::vector<TestPacket>{{.bytes = make_frame()}};
+  const auto result = read_packets(reader, packets);
+  REQUIRE_EQUAL(result.size(), size_t{1});
+  CHECK_EQUAL(result[0].hdr.ts.tv_sec, 42);
+  CHECK_EQUAL(result[0].hdr.ts.tv_usec, 7);
+  CHECK_EQUAL(result[0].hdr.len, uint32_t{18});
+  CHECK_EQUAL(result[0].hdr.caplen, uint32_t{18});
+  CHECK(result[0].bytes == make_frame());
+}
+
+TEST("stripped VLAN tags are reinserted") {
+  auto reader = PacketBlockReader{DLT_EN10MB, 65535, false};
+  const auto packets = std::vector<TestPacket>{
+    {
+      .bytes = make_frame(),
+      .status = TP_STATUS_USER | TP_STATUS_VLAN_VALID,
+      .vlan_tci = 100,
+    },
+    {
+      .bytes = make_frame(),
+      .status = TP_STATUS_USER | TP_STATUS_VLAN_VALID
+                | TP_STATUS_VLAN_TPID_VALID,
+      .vlan_tci = 0x2064,
+      .vlan_tpid = ETH_P_8021AD,
+    },
+  };
+  const auto result = read_packets(reader, packets);
+  REQUIRE_EQUAL(result.size(), size_t{2});
+  MESSAGE("without a TPID, the tag is 802.1Q");
+  CHECK_EQUAL(result[0].hdr.len, uint32_t{22});
+  CHECK_EQUAL(result[0].hdr.caplen, uint32_t{22});
+  CHECK(result[0].bytes == make_tagged_frame(ETH_P_8021Q, 100));
+  MESSAGE("the TPID and the priority bits of the kernel are kept");
+  CHECK_EQUAL(result[1].hdr.len, uint32_t{22});
+  CHECK(result[1].bytes == make_tagged_frame(ETH_P_8021AD, 0x2064));
+}
+
+TEST("reinserted VLAN tags respect the snapshot length") {
+  auto reader = PacketBlockReader{DLT_EN10MB, 16, false};
+  const auto packets = std::vector<TestPacket>{{
+    .bytes = make_frame(),
+    .status = TP_STATUS_USER | TP_STATUS_VLAN_VALID,
+    .vlan_tci = 100,
+  }};
+  const auto result = read_packets(reader, packets);
+  REQUIRE_EQUAL(result.size(), size_t{1});
+  CHECK_EQUAL(result[0].hdr.len, uint32_t{22});
+  CHECK_EQUAL(result[0].hdr.caplen, uint32_t{16});
+  auto expected = make_tagged_frame(ETH_P_8021Q, 100);
+  expected.resize(16);
+  CHECK(result[0].bytes == expected);
+}
+
+TEST("outgoing loopback packets are skipped") {
+  auto reader = PacketBlockReader{DLT_EN10MB, 65535, true};
+  const auto packets = std::vector<TestPacket>{
+    {.bytes = make_frame(), .pkttype = PACKET_OUTGOING},
+    {.bytes = make_frame(), .pkttype = PACKET_HOST},
+  };
+  const auto result = read_packets(reader, packets);
+  CHECK_EQUAL(result.size(), size_t{1});
+}
+
+#endif
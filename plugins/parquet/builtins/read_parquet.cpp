@@ -10,15 +10,332 @@
 
 #include <tenzir/chunk.hpp>
 #include <tenzir/defaults.hpp>
+#include <tenzir/double_synopsis.hpp>
+#include <tenzir/expression.hpp>
+#include <tenzir/int64_synopsis.hpp>
 #include <tenzir/operator_plugin.hpp>
 #include <tenzir/plugin/register.hpp>
 #include <tenzir/read_detection.hpp>
+#include <tenzir/time_synopsis.hpp>
+#include <tenzir/tql2/filter.hpp>
 #include <tenzir/tql2/plugin.hpp>
+#include <tenzir/uint64_synopsis.hpp>
+
+#include <parquet/bloom_filter.h>
+#include <parquet/bloom_filter_reader.h>
+#include <parquet/metadata.h>
+#include <parquet/statistics.h>
+
+#include <cmath>
+#include <limits>
 
 namespace tenzir::plugins::parquet {
 
 namespace {
 
+/// Converts a value of a Parquet timestamp column into a time.
+auto from_timestamp_unit(int64_t value,
+                         ::parquet::LogicalType::TimeUnit::unit unit) -> time {
+  switch (unit) {
+    case ::parquet::LogicalType::TimeUnit::MILLIS:
+      return time{std::chrono::milliseconds{value}};
+    case ::parquet::LogicalType::TimeUnit::MICROS:
+      return time{std::chrono::microseconds{value}};
+    case ::parquet::LogicalType::TimeUnit::NANOS:
+    case ::parquet::LogicalType::TimeUnit::UNKNOWN:
+      return time{std::chrono::nanoseconds{value}};
+  }
+  TENZIR_UNREACHABLE();
+}
+
+/// Converts a time into the unit of a Parquet timestamp column, if the unit
+/// can represent it exactly.
+auto to_timestamp_unit(time value, ::parquet::LogicalType::TimeUnit::unit unit)
+  -> std::optional<int64_t> {
+  const auto ns = value.time_since_epoch().count();
+  const auto factor = std::invoke([&]() -> int64_t {
+    switch (unit) {
+      case ::parquet::LogicalType::TimeUnit::MILLIS:
+        return 1'000'000;
+      case ::parquet::LogicalType::TimeUnit::MICROS:
+        return 1'000;
+      case ::parquet::LogicalType::TimeUnit::NANOS:
+      case ::parquet::LogicalType::TimeUnit::UNKNOWN:
+        return 1;
+    }
+    TENZIR_UNREACHABLE();
+  });
+  if (ns % factor != 0) {
+    return std::nullopt;
+  }
+  return ns / factor;
+}
+
+auto is_unsigned_int(const ::parquet::LogicalType& logical) -> bool {
+  return logical.is_int()
+         and not static_cast<const ::parquet::IntLogicalType&>(logical)
+                   .is_signed();
+}
+
+auto timestamp_unit(const ::parquet::LogicalType& logical)
+  -> ::parquet::LogicalType::TimeUnit::unit {
+  return static_cast<const ::parquet::TimestampLogicalType&>(logical)
+    .time_unit();
+}
+
+/// Creates a synopsis over the range of the non-null values in a column chunk
+/// from its statistics, or returns nullptr if the statistics do not allow for
+/// it.
+auto make_range_synopsis(const ::parquet::Statistics& stats) -> synopsis_ptr {
+  if (not stats.HasMinMax()) {
+    return nullptr;
+  }
+  const auto& logical = *stats.descr()->logical_type();
+  switch (stats.physical_type()) {
+    case ::parquet::Type::INT32: {
+      const auto& typed
+        = static_cast<const ::parquet::Int32Statistics&>(stats);
+      if (is_unsigned_int(logical)) {
+        return std::make_unique<uint64_synopsis>(
+          static_cast<uint32_t>(typed.min()),
+          static_cast<uint32_t>(typed.max()));
+      }
+      if (logical.is_none() or logical.is_int()) {
+        return std::make_unique<int64_synopsis>(typed.min(), typed.max());
+      }
+      return nullptr;
+    }
+    case ::parquet::Type::INT64: {
+      const auto& typed
+        = static_cast<const ::parquet::Int64Statistics&>(stats);
+      if (is_unsigned_int(logical)) {
+        return std::make_unique<uint64_synopsis>(
+          static_cast<uint64_t>(typed.min()),
+          static_cast<uint64_t>(typed.max()));
+      }
+      if (logical.is_timestamp()) {
+        const auto unit = timestamp_unit(logical);
+        return std::make_unique<time_synopsis>(
+          from_timestamp_unit(typed.min(), unit),
+          from_timestamp_unit(typed.max(), unit));
+      }
+      if (logical.is_none() or logical.is_int()) {
+        return std::make_unique<int64_synopsis>(typed.min(), typed.max());
+      }
+      return nullptr;
+    }
+    case ::parquet::Type::FLOAT: {
+      const auto& typed
+        = static_cast<const ::parquet::FloatStatistics&>(stats);
+      if (std::isnan(typed.min()) or std::isnan(typed.max())) {
+        return nullptr;
+      }
+      return std::make_unique<double_synopsis>(typed.min(), typed.max());
+    }
+    case ::parquet::Type::DOUBLE: {
+      const auto& typed
+        = static_cast<const ::parquet::DoubleStatistics&>(stats);
+      if (std::isnan(typed.min()) or std::isnan(typed.max())) {
+        return nullptr;
+      }
+      return std::make_unique<double_synopsis>(typed.min(), typed.max());
+    }
+    default:
+      return nullptr;
+  }
+}
+
+/// Hashes a value the way that a bloom filter of the given column does, if the
+/// column can contain a value that compares equal to it.
+auto hash_for_bloom_filter(const ::parquet::BloomFilter& filter,
+                           const ::parquet::ColumnDescriptor& column,
+                           const data& value) -> std::optional<uint64_t> {
+  const auto& logical = *column.logical_type();
+  // Returns the value as an integer within the given bounds.
+  auto as_integer = [&](int64_t min, uint64_t max) -> std::optional<int64_t> {
+    if (const auto* x = try_as<int64_t>(&value)) {
+      if (*x >= min and (*x < 0 or static_cast<uint64_t>(*x) <= max)) {
+        return *x;
+      }
+    } else if (const auto* x = try_as<uint64_t>(&value)) {
+      if (*x <= max) {
+        return static_cast<int64_t>(*x);
+      }
+    }
+    return std::nullopt;
+  };
+  switch (column.physical_type()) {
+    case ::parquet::Type::INT32: {
+      if (is_unsigned_int(logical)) {
+        if (auto x = as_integer(0, std::numeric_limits<uint32_t>::max())) {
+          return filter.Hash(static_cast<int32_t>(static_cast<uint32_t>(*x)));
+        }
+      } else if (logical.is_none() or logical.is_int()) {
+        if (auto x = as_integer(std::numeric_limits<int32_t>::min(),
+                                std::numeric_limits<int32_t>::max())) {
+          return filter.Hash(static_cast<int32_t>(*x));
+        }
+      }
+      return std::nullopt;
+    }
+    case ::parquet::Type::INT64: {
+      if (logical.is_timestamp()) {
+        if (const auto* x = try_as<time>(&value)) {
+          if (auto y = to_timestamp_unit(*x, timestamp_unit(logical))) {
+            return filter.Hash(*y);
+          }
+        }
+      } else if (is_unsigned_int(logical)) {
+        if (auto x = as_integer(0, std::numeric_limits<uint64_t>::max())) {
+          return filter.Hash(*x);
+        }
+      } else if (logical.is_none() or logical.is_int()) {
+        if (auto x = as_integer(std::numeric_limits<int64_t>::min(),
+                                std::numeric_limits<int64_t>::max())) {
+          return filter.Hash(*x);
+        }
+      }
+      return std::nullopt;
+    }
+    case ::parquet::Type::BYTE_ARRAY: {
+      const auto* x = try_as<std::string>(&value);
+      if (not x or not logical.is_string()) {
+        return std::nullopt;
+      }
+      const auto bytes = ::parquet::ByteArray{
+        detail::narrow_cast<uint32_t>(x->size()),
+        reinterpret_cast<const uint8_t*>(x->data())};
+      return filter.Hash(&bytes);
+    }
+    default:
+      // We do not use the bloom filters of floating-point columns, because
+      // `0.0` and `-0.0` compare equal but hash differently.
+      return std::nullopt;
+  }
+}
+
+/// Decides which row groups of a Parquet file cannot contain events that
+/// match a filter, based on the statistics and bloom filters of their column
+/// chunks.
+///
+/// The filter is a legacy expression as returned by `split_legacy_expression`.
+/// Apart from `!=` and `not in`, comparisons with null never match, so the
+/// statistics only need to cover the non-null values of a column.
+class row_group_filter {
+public:
+  row_group_filter(::parquet::ParquetFileReader& reader, expression expr)
+    : reader_{reader}, expr_{std::move(expr)} {
+    const auto& schema = *reader_.metadata()->schema();
+    for (auto i = 0; i < schema.num_columns(); ++i) {
+      const auto& column = *schema.Column(i);
+      // Values within lists do not map to a field of an event.
+      if (column.max_repetition_level() == 0) {
+        columns_.emplace(column.path()->ToDotString(), i);
+      }
+    }
+  }
+
+  /// Returns whether no event in the row group can match the filter.
+  auto excludes(int row_group) const -> bool {
+    return excludes(row_group, expr_);
+  }
+
+private:
+  auto excludes(int row_group, const expression& expr) const -> bool {
+    auto f = detail::overload{
+      [](caf::none_t) {
+        return false;
+      },
+      [&](const conjunction& x) {
+        return std::ranges::any_of(x, [&](const expression& operand) {
+          return excludes(row_group, operand);
+        });
+      },
+      [&](const disjunction& x) {
+        return std::ranges::all_of(x, [&](const expression& operand) {
+          return excludes(row_group, operand);
+        });
+      },
+      [](const negation&) {
+        // A negation excludes nothing, since the statistics and bloom filters
+        // only tell us which values a column chunk may contain.
+        return false;
+      },
+      [&](const predicate& x) {
+        return excludes(row_group, x);
+      },
+    };
+    return match(expr, f);
+  }
+
+  auto excludes(int row_group, const predicate& pred) const -> bool {
+    const auto* field = try_as<field_extractor>(&pred.lhs);
+    const auto* value = try_as<data>(&pred.rhs);
+    auto op = pred.op;
+    if (not field or not value) {
+      field = try_as<field_extractor>(&pred.rhs);
+      value = try_as<data>(&pred.lhs);
+      op = flip(op);
+    }
+    if (not field or not value) {
+      return false;
+    }
+    const auto column = columns_.find(field->field);
+    if (column == columns_.end()) {
+      return false;
+    }
+    const auto chunk
+      = reader_.metadata()->RowGroup(row_group)->ColumnChunk(column->second);
+    // Null compares unequal to every value, so a column chunk with nulls may
+    // always contain matches for `!=` and `not in`.
+    if (op == relational_operator::not_equal
+        or op == relational_operator::not_in) {
+      const auto stats = chunk->statistics();
+      if (not stats or not stats->HasNullCount() or stats->null_count() != 0) {
+        return false;
+      }
+    }
+    if (chunk->is_stats_set()) {
+      if (auto synopsis = make_range_synopsis(*chunk->statistics())) {
+        auto result = synopsis->lookup(op, make_view(*value));
+        if (result and not *result) {
+          return true;
+        }
+      }
+    }
+    if (op != relational_operator::equal and op != relational_operator::in) {
+      return false;
+    }
+    auto bloom_filter = std::unique_ptr<::parquet::BloomFilter>{};
+    try {
+      auto bloom_filters = reader_.GetBloomFilterReader().RowGroup(row_group);
+      bloom_filter = bloom_filters->GetColumnBloomFilter(column->second);
+    } catch (const ::parquet::ParquetException& err) {
+      TENZIR_DEBUG("read_parquet ignores unreadable bloom filter: {}",
+                   err.what());
+      return false;
+    }
+    if (not bloom_filter) {
+      return false;
+    }
+    const auto& descr = *reader_.metadata()->schema()->Column(column->second);
+    auto absent = [&](const data& x) {
+      auto hash = hash_for_bloom_filter(*bloom_filter, descr, x);
+      return hash and not bloom_filter->FindHash(*hash);
+    };
+    if (op == relational_operator::equal) {
+      return absent(*value);
+    }
+    const auto* xs = try_as<list>(value);
+    return xs and std::ranges::all_of(*xs, absent);
+  }
+
+  ::parquet::ParquetFileReader& reader_;
+  expression expr_;
+  /// Maps the dotted paths of all non-repeated leaf columns to their index.
+  std::unordered_map<std::string, int> columns_;
+};
+
 auto inject_tenzir_metadata(std::shared_ptr<arrow::RecordBatch> batch)
   -> std::shared_ptr<arrow::RecordBatch> {
   auto needs_name = true;
@@ -60,12 +377,14 @@ auto inject_tenzir_metadata(std::shared_ptr<arrow::RecordBatch> batch)
     arrow::key_value_metadata(std::move(keys), std::move(values)));
 }
 
-struct ReadParquetArgs {};
+struct ReadParquetArgs {
+  /// The filter pushed down by `describer.optimize_filter`.
+  ir::optimize_filter filter;
+};
 
 class ReadParquet final : public Operator<chunk_ptr, table_slice> {
 public:
-  explicit ReadParquet(ReadParquetArgs args) {
-    TENZIR_UNUSED(args);
+  explicit ReadParquet(ReadParquetArgs args) : args_{std::move(args)} {
   }
 
   auto process(chunk_ptr input, Push<table_slice>&, OpCtx&)
@@ -111,7 +430,34 @@ public:
         .emit(ctx);
       co_return FinalizeBehavior::done;
     }
-    auto rb_reader = out_buffer->GetRecordBatchReader();
+    // Only decode the row groups that may contain matching events.
+    auto row_groups = std::vector<int>{};
+    const auto num_row_groups = out_buffer->num_row_groups();
+    auto legacy_filter = std::vector<expression>{};
+    for (const auto& filter : args_.filter) {
+      auto [legacy, remainder] = split_legacy_expression(filter);
+      if (legacy != trivially_true_expression()) {
+        legacy_filter.push_back(std::move(legacy));
+      }
+    }
+    auto pruner = std::optional<row_group_filter>{};
+    if (not legacy_filter.empty()) {
+      pruner.emplace(*out_buffer->parquet_reader(),
+                     legacy_filter.size() == 1
+                       ? std::move(legacy_filter[0])
+                       : expression{conjunction{std::move(legacy_filter)}});
+    }
+    for (auto i = 0; i < num_row_groups; ++i) {
+      if (not pruner or not pruner->excludes(i)) {
+        row_groups.push_back(i);
+      }
+    }
+    TENZIR_DEBUG("read_parquet reads {} of {} row groups", row_groups.size(),
+                 num_row_groups);
+    if (row_groups.empty()) {
+      co_return FinalizeBehavior::done;
+    }
+    auto rb_reader = out_buffer->GetRecordBatchReader(row_groups);
     if (not rb_reader.ok()) {
       diagnostic::error("{}", rb_reader.status().ToStringWithoutContextLines())
         .note("failed create record batches from input data")
@@ -138,7 +484,15 @@ public:
           .emit(ctx);
         co_return FinalizeBehavior::done;
       }
-      co_await push(std::move(*maybe_slice));
+      // The pruning only skips row groups, so we must still apply the filter
+      // to every event.
+      auto slice = std::move(*maybe_slice);
+      for (const auto& filter : args_.filter) {
+        slice = filter2(slice, filter, ctx, false);
+      }
+      if (slice.rows() > 0) {
+        co_await push(std::move(slice));
+      }
     }
     co_return FinalizeBehavior::done;
   }
@@ -151,6 +505,7 @@ public:
   }
 
 private:
+  ReadParquetArgs args_;
   std::vector<chunk_ptr> chunks_;
 };
 
@@ -162,7 +517,7 @@ public:
 
   auto describe() const -> Description override {
     auto d = Describer<ReadParquetArgs, ReadParquet>{};
-    return d.without_optimize();
+    return d.optimize_filter(&ReadParquetArgs::filter);
   }
 
   auto read_detection_candidates() const
@@ -45,6 +45,9 @@ public:
   // Add a custom response header.
   void add_header(std::string field, std::string value);
 
+  // Replace the content type that the endpoint declares.
+  void set_content_type(std::string value);
+
   // Get a handle to the original request.
   [[nodiscard]] const request_handle_t& request() const;
 
@@ -73,6 +73,11 @@ void restinio_response::add_header(std::string field, std::string value) {
   response_.append_header(std::move(field), std::move(value));
 }
 
+void restinio_response::set_content_type(std::string value) {
+  response_.header().set_field(restinio::http_field::content_type,
+                               std::move(value));
+}
+
 auto restinio_response::request() const -> const request_handle_t& {
   return request_;
 }
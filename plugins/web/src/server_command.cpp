@@ -200,6 +200,15 @@ request_dispatcher_actor::behavior_type request_dispatcher(
           }
           body_params.emplace(std::string{name}, std::move(*maybe_param));
         }
+        // Endpoints that negotiate their response format take an `accept`
+        // parameter, which defaults to the `Accept` header of the request.
+        auto const& params = body_params.params();
+        auto const* accept
+          = header.try_get_field(restinio::http_field_t::accept);
+        if (accept and endpoint.params->resolve_key("accept")
+            and params.find("accept") == params.end()) {
+          body_params.emplace("accept", std::string{*accept});
+        }
       }
       auto params = parse_endpoint_parameters(endpoint, body_params);
       if (not params) {
@@ -213,6 +222,13 @@ request_dispatcher_actor::behavior_type request_dispatcher(
         .request(handler, caf::infinite)
         .then(
           [response](rest_response& rsp) {
+            // Handlers may answer in another format than the one that the
+            // endpoint declares after negotiating it with the client.
+            auto const& headers = rsp.headers();
+            if (auto it = headers.find("Content-Type");
+                it != headers.end() and it->second != "application/json") {
+              response->set_content_type(it->second);
+            }
             response->finish(rsp.body());
           },
           [response](const caf::error& e) {
@@ -0,0 +1,53 @@
+#!/bin/sh
+# runner: shell
+# timeout: 60
+set -eu
+
+dir=$(CDPATH='' cd -- "$(dirname -- "$0")" && pwd)
+state=$(mktemp -d)
+trap 'rm -rf "$state"' EXIT
+
+# Runs a pipeline file with checkpoints.
+run() {
+  env TENZIR_EXEC__DUMP_DIAGNOSTICS=false TENZIR_STATE_DIRECTORY="$state" \
+    "$TENZIR_BINARY" --bare-mode --console-verbosity=warning \
+    --checkpoint-interval=100ms -f "$1"
+}
+
+committed() {
+  ls "$state"/checkpoints/*/LATEST >/dev/null 2>&1
+}
+
+# The pipeline takes three seconds, so we kill it as soon as the first
+# checkpoint is committed. The command is not wrapped in `run` so that `$!` is
+# the PID of the `tenzir` process rather than of a subshell.
+printf '=== interrupted run ===\n'
+env TENZIR_EXEC__DUMP_DIAGNOSTICS=false TENZIR_STATE_DIRECTORY="$state" \
+  "$TENZIR_BINARY" --bare-mode --console-verbosity=warning \
+  --checkpoint-interval=100ms -f "$dir/resume.tql.in" >/dev/null 2>&1 &
+pid=$!
+while ! committed && kill -0 "$pid" 2>/dev/null; do
+  sleep 0.01
+done
+kill -KILL "$pid" 2>/dev/null || true
+wait "$pid" 2>/dev/null || true
+if committed; then
+  printf 'checkpoint committed\n'
+fi
+
+# The restarted pipeline resumes from the checkpoint, so every event must be
+# counted exactly once.
+printf '=== resumed run ===\n'
+run "$dir/resume.tql.in" 2>/dev/null
+if ! committed; then
+  printf 'checkpoints removed\n'
+fi
+
+# Sources that do not persist their read position cannot take part.
+printf '=== non-resumable source ===\n'
+if run "$dir/reject.tql.in" >/dev/null 2>"$state/stderr"; then
+  printf 'accepted\n'
+else
+  printf 'rejected\n'
+fi
+grep -c 'cannot resume from a checkpoint' "$state/stderr"
@@ -0,0 +1,222 @@
+# runner: python
+# timeout: 60
+
+"""/serve answers with Arrow IPC streams when the client prefers them.
+
+Clients negotiate the response format through the `Accept` header, or through
+the `accept` parameter, which takes precedence over the header. Arrow
+responses carry the serve id, the next continuation token, and the state in
+the schema metadata of every IPC stream.
+
+Flow against the static `serve_arrow` pipeline (three events s: "arrow 1..3"):
+  1. Poll the first page with `Accept: application/vnd.apache.arrow.stream`
+     -> an Arrow IPC stream that contains the events.
+  2. Retry the first page with the header and `accept: application/json` in
+     the body -> the same events as JSON.
+  3. Retry the first page as Arrow with ZSTD compression -> an Arrow IPC
+     stream with the same metadata and events.
+
+Flow against the static `serve_arrow_mixed` pipeline, whose events have two
+schemas:
+  4. Poll the first page as Arrow -> a `multipart/mixed` body with one Arrow
+     IPC stream per run of events with the same schema.
+
+The test runner has no Arrow library, so we inspect the raw bytes of the IPC
+streams for the metadata keys of the schema, and read the events back with
+`read_feather`, which stops at the end of the first IPC stream like any other
+standard reader.
+"""
+
+from __future__ import annotations
+
+import json
+import os
+import re
+import shlex
+import socket
+import subprocess
+import time
+import urllib.error
+import urllib.request
+from collections.abc import Mapping
+from pathlib import Path
+
+API = "/api/v0"
+
+ARROW_STREAM = "application/vnd.apache.arrow.stream"
+
+CONTINUATION_MARKER = b"\xff\xff\xff\xff"
+
+
+def _free_port() -> int:
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+
+def _post_raw(
+    url: str, path: str, body: dict | None = None, accept: str | None = None
+) -> tuple[int, str, bytes]:
+    data = json.dumps(body or {}).encode()
+    headers = {"Content-Type": "application/json"}
+    if accept is not None:
+        headers["Accept"] = accept
+    req = urllib.request.Request(
+        f"{url}{API}{path}",
+        data=data,
+        headers=headers,
+        method="POST",
+    )
+    try:
+        with urllib.request.urlopen(req, timeout=30) as r:
+            return r.status, r.headers.get("Content-Type", ""), r.read()
+    except urllib.error.HTTPError as e:
+        return e.code, e.headers.get("Content-Type", ""), e.read()
+
+
+def _wait_for_api(url: str, timeout: int = 30) -> None:
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            status, _, _ = _post_raw(url, "/ping")
+            if status == 200:
+                return
+        except (urllib.error.URLError, ConnectionError, OSError):
+            pass
+        time.sleep(0.2)
+    raise RuntimeError("REST API did not come up")
+
+
+def start_web_server(
+    env: Mapping[str, str],
+) -> tuple[subprocess.Popen[str], str]:
+    binary = shlex.split(env["TENZIR_NODE_CLIENT_BINARY"])
+    tenzir_ctl = str(Path(binary[0]).with_name("tenzir-ctl"))
+    endpoint = env["TENZIR_NODE_CLIENT_ENDPOINT"]
+    port = _free_port()
+    proc = subprocess.Popen(
+        [
+            tenzir_ctl,
+            "--bare-mode",
+            "--console-verbosity=warning",
+            f"--endpoint={endpoint}",
+            "web",
+            "server",
+            "--mode=dev",
+            "--bind=127.0.0.1",
+            f"--port={port}",
+        ],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        text=True,
+    )
+    api_url = f"http://127.0.0.1:{port}"
+    _wait_for_api(api_url)
+    return proc, api_url
+
+
+def _serve(
+    api: str, accept: str | None, **params: object
+) -> tuple[int, str, bytes]:
+    body: dict = {
+        "serve_id": "serve_arrow",
+        "max_events": 3,
+        "min_events": 3,
+        "timeout": "5s",
+        **params,
+    }
+    return _post_raw(api, "/serve", body, accept)
+
+
+def _read_arrow(stream: bytes) -> list[dict]:
+    """Reads the events of an Arrow IPC stream with `read_feather`."""
+    binary = shlex.split(os.environ["TENZIR_BINARY"])
+    result = subprocess.run(
+        [
+            *binary,
+            "--console-verbosity=warning",
+            "from_stdin { read_feather }\nto_stdout { write_ndjson }",
+        ],
+        input=stream,
+        capture_output=True,
+        timeout=30,
+        check=True,
+    )
+    return [json.loads(line) for line in result.stdout.splitlines()]
+
+
+def _split_multipart(content_type: str, body: bytes) -> list[tuple[str, bytes]]:
+    """Splits a `multipart/mixed` body into its content types and payloads."""
+    match = re.fullmatch(r"multipart/mixed; boundary=(\S+)", content_type)
+    assert match, f"unexpected content type: {content_type}"
+    delimiter = b"\r\n--" + match.group(1).encode()
+    # The first delimiter is not preceded by a line break.
+    *parts, epilogue = (b"\r\n" + body).split(delimiter)
+    assert parts[0] == b"", f"unexpected preamble: {parts[0]!r}"
+    assert epilogue == b"--\r\n", f"unexpected epilogue: {epilogue!r}"
+    result = []
+    for part in parts[1:]:
+        headers, _, payload = part.partition(b"\r\n\r\n")
+        header = headers.decode().strip()
+        assert header.startswith("Content-Type: "), f"bad part header: {header}"
+        result.append((header.removeprefix("Content-Type: "), payload))
+    return result
+
+
+def _describe_arrow(label: str, content_type: str, body: bytes) -> None:
+    print(f"{label}-content-type: {content_type}")
+    print(f"{label}-starts-with-marker: {body.startswith(CONTINUATION_MARKER)}")
+    print(f"{label}-streams: {body.count(b'TENZIR:serve:serve_id')}")
+    print(f"{label}-has-token: {b'TENZIR:serve:next_continuation_token' in body}")
+    print(f"{label}-has-state: {b'TENZIR:serve:state' in body}")
+    print(f"{label}-events: {[e['s'] for e in _read_arrow(body)]}")
+
+
+def main() -> None:
+    proc, api = start_web_server(os.environ)
+    try:
+        # 1. The Accept header selects Arrow.
+        status, content_type, body = _serve(api, f"{ARROW_STREAM}, */*;q=0.5")
+        assert status == 200, f"arrow poll failed ({status}): {body!r}"
+        _describe_arrow("arrow", content_type, body)
+
+        # 2. The `accept` parameter overrides the header.
+        status, content_type, body = _serve(
+            api, ARROW_STREAM, accept="application/json"
+        )
+        assert status == 200, f"json poll failed ({status}): {body!r}"
+        print(f"json-content-type: {content_type}")
+        response = json.loads(body.decode())
+        print(f"json-events: {[e['data']['s'] for e in response['events']]}")
+
+        # 3. Record batches can be compressed with ZSTD.
+        status, content_type, body = _serve(api, ARROW_STREAM, compression="zstd")
+        assert status == 200, f"zstd poll failed ({status}): {body!r}"
+        _describe_arrow("zstd", content_type, body)
+
+        # 4. Events with different schemas arrive as a multipart body.
+        status, content_type, body = _serve(
+            api, ARROW_STREAM, serve_id="serve_arrow_mixed"
+        )
+        assert status == 200, f"mixed poll failed ({status}): {body!r}"
+        print(f"mixed-content-type: {content_type.split(';')[0]}")
+        for part_type, part in _split_multipart(content_type, body):
+            print(f"mixed-part-content-type: {part_type}")
+            print(f"mixed-part-events: {_read_arrow(part)}")
+
+        # An unknown compression is a client error.
+        _, content_type, body = _serve(api, ARROW_STREAM, compression="brotli")
+        print(f"invalid-compression-content-type: {content_type}")
+        print(f"invalid-compression-error: {json.loads(body.decode())['error']}")
+    finally:
+        if proc.poll() is None:
+            proc.terminate()
+            try:
+                proc.wait(timeout=10)
+            except subprocess.TimeoutExpired:
+                proc.kill()
+                proc.wait()
+
+
+if __name__ == "__main__":
+    main()